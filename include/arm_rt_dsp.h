@@ -15,6 +15,9 @@
 // This includes the basic fixed point types and support macros/functions.
 #include "arm_rt_dsp_core.h"
 
+// Packed dual q15_t arithmetic.
+#include "arm_rt_dsp_q15x2.h"
+
 // Limit and min/max functions.
 #include "arm_rt_dsp_limit.h"
 
@@ -30,4 +33,7 @@
 // Misc functions, convert, sample, and threshold.
 #include "arm_rt_dsp_misc.h"
 
+// Runtime selection of the block kernels.
+#include "arm_rt_dsp_dispatch.h"
+
 #endif
\ No newline at end of file
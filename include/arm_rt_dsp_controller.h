@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "arm_rt_dsp_core.h"
+#include "arm_rt_dsp_q15x2.h"
 
 
 /**
@@ -93,6 +94,78 @@ static inline q15_t iir_pi_q15(iir_pi_instance_q15 * S, q15_t in) {
 }
 
 
+/**
+ * \brief Runs the q15_t PI controller over a block of input samples.
+ *
+ * Gives exactly the same outputs as calling \ref iir_pi_q15 once per sample, but
+ * keeps the state in registers and writes it back to the instance once at the end.
+ * The output array may be the input array.
+ *
+ * \param S Pointer to the PI instance structure.
+ * \param in Input sample values.
+ * \param out Controller output values.
+ * \param n Number of samples.
+ */
+void iir_pi_q15_run(iir_pi_instance_q15 * S, const q15_t *in, q15_t *out, uint32_t n);
+
+
+/**
+ * \brief Instance structure for two iir PI controllers packed into q15x2_t lanes.
+ *
+ * Lane 0 is the first channel and lane 1 the second, e.g. two phases of a converter.
+ * To initialize, set the packed gains Kp and Ki.  The init function derives
+ * A0 = Kp + Ki and A1 = -Kp for both lanes and arranges them per channel.
+ */
+typedef struct
+{
+  q15x2_t A[2];         // Channel c uses A[c] = A0 | A1 << 16.
+  q15x2_t state[PI_Q15_STATE_BUFFER_SIZE];  // Packed x[n-1] and y[n-1].
+  q15x2_t Kp;           // Packed acc16_t gains.
+  q15x2_t Ki;
+} iir_pi_instance_q15x2;
+
+
+/**
+ * \brief Initializes a dual PI instance structure.
+ *
+ * \param S Pointer to the dual PI instance structure.
+ * \param resetStateFlag Set this to true to clear the state buffer.
+ */
+void iir_pi_init_q15x2(iir_pi_instance_q15x2 * S, int32_t resetStateFlag);
+
+
+/**
+ * \brief Dual channel PI process function that uses q15x2_t data types.
+ *
+ * Each lane gives exactly the same result as \ref iir_pi_q15 with the same gains.
+ * Each channel is one dual multiply-accumulate (SMLAD) of (A0, A1) with (x[n], x[n-1]).
+ *
+ * \param S Pointer to the dual PI instance structure.
+ * \param in Packed input sample values.
+ * \return The packed controller output values.
+ */
+static inline q15x2_t iir_pi_q15x2(iir_pi_instance_q15x2 * S, q15x2_t in) {
+    int32_t temp0;
+    int32_t temp1;
+    q15x2_t out;
+
+    // Rounding of the last bit plus y[n-1] moved from 1.15 to 10.22 format.
+    temp0 = ((int32_t)q15x2_lo(S->state[1]) << 7) + (1 << 6);
+    temp1 = ((int32_t)q15x2_hi(S->state[1]) << 7) + (1 << 6);
+
+    // 9.7 * 1.15 => 10.22, (x[n], x[n-1]) of each channel lines up with (A0, A1).
+    temp0 = mac_q15x2(S->A[0], __PKHBT(in, S->state[0], 16), temp0);
+    temp1 = mac_q15x2(S->A[1], __PKHTB(S->state[0], in, 16), temp1);
+
+    out = q15x2_pack((q15_t)__SSAT(temp0 >> 7, 16), (q15_t)__SSAT(temp1 >> 7, 16));
+
+    // Update state
+    S->state[0] = in;
+    S->state[1] = out;
+    return out;
+}
+
+
 #define PI_Q31_STATE_BUFFER_SIZE 2
 
 /**
@@ -192,6 +265,131 @@ static inline q31_t iir_pi_q31(iir_pi_instance_q31 *S, q31_t in)
     return out;
 }
 
+
+/**
+ * \brief Runs the q31_t PI controller over a block of input samples.
+ *
+ * Gives exactly the same outputs as calling \ref iir_pi_q31 once per sample, but
+ * keeps the state in registers and writes it back to the instance once at the end.
+ * The output array may be the input array.
+ *
+ * \param S Pointer to the PI instance structure.
+ * \param in Input sample values.
+ * \param out Controller output values.
+ * \param n Number of samples.
+ */
+void iir_pi_q31_run(iir_pi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+
+/**
+ * \brief Instance structure for a bank of iir PI controllers that use q31_t data types.
+ *
+ * The bank keeps every field of \ref iir_pi_instance_q31 in its own array, one element
+ * per controller, so all N controllers are stepped in one vectorized call.  The arrays
+ * are supplied by the caller, \ref IIR_PI_BANK_Q31_DEFINE declares aligned ones.  To
+ * initialize, set the gains Kp[i] and Ki[i] and call \ref iir_pi_bank_init_q31.
+ */
+typedef struct
+{
+  uint32_t n;            // The number of controllers.
+  acc32_t *Kp;
+  acc32_t *Ki;
+  acc32_t *A0;
+  acc32_t *A1;
+  q31_t *state[PI_Q31_STATE_BUFFER_SIZE];  // state[0] is x[n-1], state[1] is y[n-1].
+} iir_pi_bank_instance_q31;
+
+
+/**
+ * \brief Defines a PI bank instance named name with cache line aligned arrays for N controllers.
+ */
+#define IIR_PI_BANK_Q31_DEFINE(name, N)                                             \
+    static acc32_t name##_Kp[N] RT_DSP_ALIGNED(64);                                 \
+    static acc32_t name##_Ki[N] RT_DSP_ALIGNED(64);                                 \
+    static acc32_t name##_A0[N] RT_DSP_ALIGNED(64);                                 \
+    static acc32_t name##_A1[N] RT_DSP_ALIGNED(64);                                 \
+    static q31_t name##_x1[N] RT_DSP_ALIGNED(64);                                   \
+    static q31_t name##_y1[N] RT_DSP_ALIGNED(64);                                   \
+    iir_pi_bank_instance_q31 name = { (N), name##_Kp, name##_Ki, name##_A0,         \
+                                      name##_A1, { name##_x1, name##_y1 } }
+
+
+/**
+ * \brief Initializes a PI bank instance structure.
+ *
+ * \param S Pointer to the PI bank instance structure.
+ * \param resetStateFlag Set this to true to clear the state buffers.
+ */
+void iir_pi_bank_init_q31(iir_pi_bank_instance_q31 *S, int32_t resetStateFlag);
+
+
+/**
+ * \brief Steps every controller of a PI bank once.
+ *
+ * Controller i gives exactly the same result as \ref iir_pi_q31 on an instance with
+ * the same gains and state, and each saturated output is counted in the Q flag.  The
+ * output array may be the input array but must not be one of the state arrays.
+ *
+ * \param S Pointer to the PI bank instance structure.
+ * \param in Input sample values, one per controller.
+ * \param out Controller output values, one per controller.
+ */
+void iir_pi_bank_q31(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out);
+
+
+/**
+ * \brief Instance structure for a bank of iir PI controllers that use q15_t data types.
+ *
+ * This is the structure of arrays twin of \ref iir_pi_instance_q15, see
+ * \ref iir_pi_bank_instance_q31.
+ */
+typedef struct
+{
+  uint32_t n;            // The number of controllers.
+  acc16_t *Kp;
+  acc16_t *Ki;
+  acc16_t *A0;
+  acc16_t *A1;
+  q15_t *state[PI_Q15_STATE_BUFFER_SIZE];  // state[0] is x[n-1], state[1] is y[n-1].
+} iir_pi_bank_instance_q15;
+
+
+/**
+ * \brief Defines a PI bank instance named name with cache line aligned arrays for N controllers.
+ */
+#define IIR_PI_BANK_Q15_DEFINE(name, N)                                             \
+    static acc16_t name##_Kp[N] RT_DSP_ALIGNED(64);                                 \
+    static acc16_t name##_Ki[N] RT_DSP_ALIGNED(64);                                 \
+    static acc16_t name##_A0[N] RT_DSP_ALIGNED(64);                                 \
+    static acc16_t name##_A1[N] RT_DSP_ALIGNED(64);                                 \
+    static q15_t name##_x1[N] RT_DSP_ALIGNED(64);                                   \
+    static q15_t name##_y1[N] RT_DSP_ALIGNED(64);                                   \
+    iir_pi_bank_instance_q15 name = { (N), name##_Kp, name##_Ki, name##_A0,         \
+                                      name##_A1, { name##_x1, name##_y1 } }
+
+
+/**
+ * \brief Initializes a PI bank instance structure.
+ *
+ * \param S Pointer to the PI bank instance structure.
+ * \param resetStateFlag Set this to true to clear the state buffers.
+ */
+void iir_pi_bank_init_q15(iir_pi_bank_instance_q15 *S, int32_t resetStateFlag);
+
+
+/**
+ * \brief Steps every controller of a PI bank once.
+ *
+ * Controller i gives exactly the same result as \ref iir_pi_q15 on an instance with
+ * the same gains and state, and each saturated output is counted in the Q flag.  The
+ * output array may be the input array but must not be one of the state arrays.
+ *
+ * \param S Pointer to the PI bank instance structure.
+ * \param in Input sample values, one per controller.
+ * \param out Controller output values, one per controller.
+ */
+void iir_pi_bank_q15(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out);
+
+
 /**
  * \brief PID process function that uses q31_t data types.
  *
@@ -239,6 +437,21 @@ static inline q31_t iir_pid_q31(iir_pid_instance_q31 *S, q31_t in)
 }
 
 
+/**
+ * \brief Runs the q31_t PID controller over a block of input samples.
+ *
+ * Gives exactly the same outputs as calling \ref iir_pid_q31 once per sample, but
+ * keeps the state in registers and writes it back to the instance once at the end.
+ * The output array may be the input array.
+ *
+ * \param S Pointer to the PID instance structure.
+ * \param in Input sample values.
+ * \param out Controller output values.
+ * \param n Number of samples.
+ */
+void iir_pid_q31_run(iir_pid_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+
+
 /**
  * \brief Instance structure for the iir PI controller that uses a q31_t data type.
  *
@@ -420,5 +633,256 @@ static inline q31_t iir_pid_v2_q31(iir_pid_instance_v2_q31 *S, q31_t in, int32_t
 }
 
 
+/**
+ * \brief Runs the q31_t PID controller over a block of input samples.
+ *
+ * Gives exactly the same outputs as calling \ref iir_pid_v2_q31 once per sample with
+ * the same b_select, but keeps the state in registers and writes it back to the
+ * instance once at the end.  The output array may be the input array.
+ *
+ * \param S Pointer to the PID instance structure.
+ * \param in Input sample values.
+ * \param out Controller output values.
+ * \param n Number of samples.
+ * \param b_select True if using alternative set of gains (B).
+ */
+void iir_pid_v2_q31_run(iir_pid_instance_v2_q31 *S, const q31_t *in, q31_t *out, uint32_t n,
+                        int32_t b_select);
+
+
+#define PR_Q31_STATE_BUFFER_SIZE 3
+
+/**
+ * \brief Instance structure for the iir proportional resonant controller that uses a
+ * q31_t data type.
+ *
+ * The resonant term is Kr * s / (s^2 + w0^2) discretized by impulse invariance,
+ * Kr * (1 - cos(w0) z^-1) / (1 - 2 cos(w0) z^-1 + z^-2), in parallel with the
+ * proportional gain.  The poles stay exactly on the unit circle however cos(w0) is
+ * rounded, so the gain at w0 is unbounded and the tracking error of a sinusoid at w0
+ * goes to zero.  Kr already includes the sample period.
+ *
+ * To initialize, set the gains Kp and Kr and the resonant frequency phase =
+ * f0 / fs * 2^32.  The derived gains are calculated as A0 = Kr, A1 = -Kr * cos(w0)
+ * and C = cos(w0) in the init function.
+ */
+typedef struct
+{
+  acc32_t Kp;            // The proportional gain.
+  acc32_t Kr;            // The resonant gain.
+  uint32_t phase;        // The resonant frequency, 2^32 is the sample rate.
+  acc32_t A0;            // The derived gain, A0 = Kr.
+  acc32_t A1;            // The derived gain, A1 = -Kr * cos(w0).
+  q31_t C;               // The derived coefficient, C = cos(w0) in Q30.
+  q31_t state[PR_Q31_STATE_BUFFER_SIZE];  // x[n-1], r[n-1] and r[n-2].
+} iir_pr_instance_q31;
+
+
+/**
+ * \brief Initializes PR instance structure.
+ *
+ * \param S Pointer to the PR instance structure.
+ * \param resetStateFlag Set this to true to clear the state buffer.
+ */
+void iir_pr_init_q31(iir_pr_instance_q31 *S, int32_t resetStateFlag);
+
+
+/**
+ * \brief One step of a resonant term.
+ *
+ * r[n] = A0 * x[n] + A1 * x[n-1] + 2C * r[n-1] - r[n-2] in a 64 bit accumulator with
+ * the gains in acc32_t and C in Q30, saturated to 32 bits.  Shared by the single and
+ * the multi harmonic controllers so they give the same results.
+ */
+static inline q31_t iir_resonant_step_q31(acc32_t A0, acc32_t A1, q31_t C, q31_t x, q31_t x1,
+                                          q31_t y1, q31_t y2)
+{
+    int64_t acc;
+
+    // 17.15 * 1.31 => 18.46, and 2 * 2.30 * 1.31 => 3.61 >> 15 => 18.46
+    acc = (int64_t)A0 * (int64_t)x;
+    acc += (int64_t)A1 * (int64_t)x1;
+    acc += ((int64_t)C * (int64_t)y1) >> 14;
+    acc -= ((int64_t)y2) << 15;
+
+    return (q31_t)ssat_i64(acc >> 15, 32);
+}
+
+
+/**
+ * \brief PR process function that uses q31_t data types.
+ *
+ * The output is Kp * x[n] + r[n], saturated to 32 bits.  The resonant state r is
+ * saturated on its own, so a saturated resonator behaves nonlinearly like a
+ * saturated PI integrator.
+ *
+ * \param S Pointer to the PR instance structure.
+ * \param in Input sample value.
+ * \return The controller output value.
+ */
+static inline q31_t iir_pr_q31(iir_pr_instance_q31 *S, q31_t in)
+{
+    q31_t r = iir_resonant_step_q31(S->A0, S->A1, S->C, in, S->state[0], S->state[1],
+                                    S->state[2]);
+
+    S->state[0] = in;
+    S->state[2] = S->state[1];
+    S->state[1] = r;
+    return (q31_t)ssat_i64((((int64_t)S->Kp * (int64_t)in) >> 15) + r, 32);
+}
+
+
+/**
+ * \brief The number of harmonics the SIMD kernels of \ref iir_pr_multi_q31_run keep in
+ * registers.  Controllers with more harmonics run on the scalar kernel.
+ */
+#define IIR_PR_MAX_HARMONICS 8
+
+/**
+ * \brief Instance structure for a PR controller with resonant terms at several
+ * harmonics of one fundamental.
+ *
+ * Every resonant term sees the same input and the outputs are summed, so one call
+ * steps all of them with the harmonics spread across SIMD lanes.  Each term is
+ * exactly an \ref iir_pr_instance_q31 resonator at h[i] times the fundamental.  The
+ * arrays are supplied by the caller, \ref IIR_PR_MULTI_Q31_DEFINE declares aligned
+ * ones.  To initialize, set Kp, phase (of the fundamental), h[i] and Kr[i] and call
+ * \ref iir_pr_multi_init_q31.
+ */
+typedef struct
+{
+  uint32_t H;            // The number of harmonics.
+  acc32_t Kp;            // The proportional gain.
+  uint32_t phase;        // The fundamental frequency, 2^32 is the sample rate.
+  uint16_t *h;           // The harmonic numbers, e.g. 1, 5, 7, 11, 13.
+  acc32_t *Kr;           // The resonant gains.
+  acc32_t *A0;           // The derived gains, A0 = Kr.
+  acc32_t *A1;           // The derived gains, A1 = -Kr * cos(h w0).
+  q31_t *C;              // The derived coefficients, C = cos(h w0) in Q30.
+  q31_t x1;              // x[n-1], shared by all harmonics.
+  q31_t *y1;             // r[n-1] of each harmonic.
+  q31_t *y2;             // r[n-2] of each harmonic.
+} iir_pr_multi_instance_q31;
+
+
+/**
+ * \brief Defines a multi harmonic PR instance named name with aligned arrays for H harmonics.
+ */
+#define IIR_PR_MULTI_Q31_DEFINE(name, H)                                            \
+    static uint16_t name##_h[H];                                                    \
+    static acc32_t name##_Kr[H] RT_DSP_ALIGNED(64);                                 \
+    static acc32_t name##_A0[H] RT_DSP_ALIGNED(64);                                 \
+    static acc32_t name##_A1[H] RT_DSP_ALIGNED(64);                                 \
+    static q31_t name##_C[H] RT_DSP_ALIGNED(64);                                    \
+    static q31_t name##_y1[H] RT_DSP_ALIGNED(64);                                   \
+    static q31_t name##_y2[H] RT_DSP_ALIGNED(64);                                   \
+    iir_pr_multi_instance_q31 name = { (H), 0, 0, name##_h, name##_Kr, name##_A0,  \
+                                       name##_A1, name##_C, 0, name##_y1, name##_y2 }
+
+
+/**
+ * \brief Initializes a multi harmonic PR instance structure.
+ *
+ * \param S Pointer to the multi harmonic PR instance structure.
+ * \param resetStateFlag Set this to true to clear the state buffers.
+ */
+void iir_pr_multi_init_q31(iir_pr_multi_instance_q31 *S, int32_t resetStateFlag);
+
+
+/**
+ * \brief Runs a multi harmonic PR controller over a block of input samples.
+ *
+ * The output is Kp * x[n] plus the sum of the resonant terms, saturated to 32 bits.
+ * With H = 1 it gives exactly the same outputs as \ref iir_pr_q31.  The state stays in
+ * registers for the whole block.  The output array may be the input array.
+ *
+ * \param S Pointer to the multi harmonic PR instance structure.
+ * \param in Input sample values.
+ * \param out Controller output values.
+ * \param n Number of samples.
+ */
+void iir_pr_multi_q31_run(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Multi harmonic PR process function that uses q31_t data types.
+ *
+ * \param S Pointer to the multi harmonic PR instance structure.
+ * \param in Input sample value.
+ * \return The controller output value.
+ */
+static inline q31_t iir_pr_multi_q31(iir_pr_multi_instance_q31 *S, q31_t in)
+{
+    q31_t out;
+
+    iir_pr_multi_q31_run(S, &in, &out, 1);
+    return out;
+}
+
+
+#define NOTCH_Q31_STATE_BUFFER_SIZE 4
+
+/**
+ * \brief Instance structure for the iir resonant notch filter that uses a q31_t data type.
+ *
+ * H(z) = (1 - 2 cos(w0) z^-1 + z^-2) / (1 - 2 r cos(w0) z^-1 + r^2 z^-2), zeros on the
+ * unit circle at w0 and poles at radius r behind them.  The closer r is to one the
+ * narrower the notch.  The gain away from w0 is close to one when r is.
+ *
+ * To initialize, set the notch frequency phase = f0 / fs * 2^32 and the pole radius r.
+ * The derived coefficients A1 = cos(w0), B1 = r cos(w0) and B2 = r^2, all in Q30, are
+ * calculated in the init function.
+ */
+typedef struct
+{
+  uint32_t phase;        // The notch frequency, 2^32 is the sample rate.
+  q31_t r;               // The pole radius.
+  q31_t A1;              // The derived coefficient, A1 = cos(w0) in Q30.
+  q31_t B1;              // The derived coefficient, B1 = r cos(w0) in Q30.
+  q31_t B2;              // The derived coefficient, B2 = r^2 in Q30.
+  q31_t state[NOTCH_Q31_STATE_BUFFER_SIZE];  // x[n-1], x[n-2], y[n-1] and y[n-2].
+} iir_notch_instance_q31;
+
+
+/**
+ * \brief Initializes notch instance structure.
+ *
+ * \param S Pointer to the notch instance structure.
+ * \param resetStateFlag Set this to true to clear the state buffer.
+ */
+void iir_notch_init_q31(iir_notch_instance_q31 *S, int32_t resetStateFlag);
+
+
+/**
+ * \brief Notch filter process function that uses q31_t data types.
+ *
+ * The accumulator is in 4.60 format, which holds the worst case sum of all five
+ * terms, and the output is saturated to 32 bits.
+ *
+ * \param S Pointer to the notch instance structure.
+ * \param in Input sample value.
+ * \return The filter output value.
+ */
+static inline q31_t iir_notch_q31(iir_notch_instance_q31 *S, q31_t in)
+{
+    int64_t acc;
+    q31_t out;
+
+    // 2.30 * 1.31 => 3.61, which is 2 * 4.60
+    acc = ((int64_t)in) << 29;
+    acc -= (int64_t)S->A1 * (int64_t)S->state[0];
+    acc += ((int64_t)S->state[1]) << 29;
+    acc += (int64_t)S->B1 * (int64_t)S->state[2];
+    acc -= ((int64_t)S->B2 * (int64_t)S->state[3]) >> 1;
+
+    out = (q31_t)ssat_i64(acc >> 29, 32);
+
+    S->state[1] = S->state[0];
+    S->state[0] = in;
+    S->state[3] = S->state[2];
+    S->state[2] = out;
+    return out;
+}
+
 
 #endif /* ARM_RT_DSP_CONTROLLER_ */
\ No newline at end of file
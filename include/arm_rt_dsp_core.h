@@ -66,6 +66,13 @@ typedef int32_t acc32_t;
  */
 typedef int64_t acc64_t;
 
+/** \brief Aligns a variable or array, e.g. to a cache line for the bank structures. */
+#if defined(__GNUC__)
+#define RT_DSP_ALIGNED(n) __attribute__((aligned(n)))
+#else
+#define RT_DSP_ALIGNED(n)
+#endif
+
 /** \brief Macro for defining a q15_t constant value in the range [-1.0, 1.0). */
 #define Q15(x) ((q15_t)((x) < 0.999969482421875 ? ((x) >= -1 ? (x)*0x8000 : 0x8000) : 0x7FFF))
 
@@ -81,46 +88,188 @@ typedef int64_t acc64_t;
 
 // For when the arm dsp library isn't present.
 // I hope to either emulate ARM or setup a real test platform someday. AM 5/20/23
+//
+// The mock intrinsics match the ARM instructions bit for bit, including saturation.
+// Instructions that set the sticky Q flag on ARM bump a thread local counter instead.
+// The counter is updated without a branch so it costs next to nothing in a hot loop.
 #ifdef MOCK_ARM_MATH
 
+#ifdef __cplusplus
+#define RT_DSP_THREAD_LOCAL thread_local
+#else
+#define RT_DSP_THREAD_LOCAL _Thread_local
+#endif
+
+/**
+ * \brief Number of mock operations that saturated since the last \ref dsp_q_flag_clear.
+ *
+ * This stands in for the Q bit of the APSR.  Use the accessor functions.
+ */
+extern RT_DSP_THREAD_LOCAL uint32_t dsp_q_count;
+
 static inline int32_t __SSAT(int32_t value, uint32_t sat)
 {
-    int32_t max = (1 << (sat - 1)) - 1;
+    // Unsigned math so sat = 32 doesn't overflow.
+    int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
     int32_t min = -max - 1;
+    int32_t out;
 
-    if (value > max) {
-        return max;
-    } else if (value < min) {
-        return min;
-    } else {
-        return value;
-    }
+    out = (value > max) ? max : value;
+    out = (out < min) ? min : out;
+    dsp_q_count += (out != value);
+    return out;
 }
 
-// Adds the two int32_t values.
-// Need to check on what this really does in arm_math.h
+// Saturating add of two int32_t values.  Sets the Q flag on saturation.
 static inline int32_t __QADD(int32_t x, int32_t y)
 {
-    return x + y;
+    int32_t out;
+#if defined(__GNUC__)
+    uint32_t ovf = __builtin_add_overflow(x, y, &out);
+#else
+    int64_t wide = (int64_t)x + y;
+    uint32_t ovf = (wide != (int32_t)wide);
+    out = (int32_t)wide;
+#endif
+    dsp_q_count += ovf;
+    // An overflow always goes the way of the sign of x.
+    return ovf ? ((x >> 31) ^ INT32_MAX) : out;
 }
 
-// subtracts the two int32_t values.
-// Need to check on what this really does in arm_math.h
+// Saturating subtract of two int32_t values.  Sets the Q flag on saturation.
 static inline int32_t __QSUB(int32_t x, int32_t y)
 {
-    return x - y;
+    int32_t out;
+#if defined(__GNUC__)
+    uint32_t ovf = __builtin_sub_overflow(x, y, &out);
+#else
+    int64_t wide = (int64_t)x - y;
+    uint32_t ovf = (wide != (int32_t)wide);
+    out = (int32_t)wide;
+#endif
+    dsp_q_count += ovf;
+    return ovf ? ((x >> 31) ^ INT32_MAX) : out;
+}
+
+// Saturates a 32-bit intermediate to one int16_t lane.  QADD16 and QSUB16 don't set Q.
+static inline uint32_t mock_sat16(int32_t x)
+{
+    x = (x > INT16_MAX) ? INT16_MAX : x;
+    x = (x < INT16_MIN) ? INT16_MIN : x;
+    return (uint16_t)x;
+}
+
+// Dual saturating add of the two int16_t halves of each operand.
+static inline uint32_t __QADD16(uint32_t x, uint32_t y)
+{
+    uint32_t lo = mock_sat16((int32_t)(int16_t)x + (int16_t)y);
+    uint32_t hi = mock_sat16((int32_t)(int16_t)(x >> 16) + (int16_t)(y >> 16));
+    return (hi << 16) | lo;
+}
+
+// Dual saturating subtract of the two int16_t halves of each operand.
+static inline uint32_t __QSUB16(uint32_t x, uint32_t y)
+{
+    uint32_t lo = mock_sat16((int32_t)(int16_t)x - (int16_t)y);
+    uint32_t hi = mock_sat16((int32_t)(int16_t)(x >> 16) - (int16_t)(y >> 16));
+    return (hi << 16) | lo;
+}
+
+// Dual 16x16 multiply, adds the products.  Sets the Q flag if the sum overflows.
+static inline uint32_t __SMUAD(uint32_t x, uint32_t y)
+{
+    int64_t sum = (int64_t)((int32_t)(int16_t)x * (int16_t)y)
+                + (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+    dsp_q_count += (sum != (int32_t)sum);
+    return (uint32_t)sum;
+}
+
+// Dual 16x16 multiply, adds the products and the accumulator.  Sets the Q flag if the sum overflows.
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t acc)
+{
+    int64_t sum = (int64_t)(int32_t)acc
+                + (int32_t)(int16_t)x * (int16_t)y
+                + (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+    dsp_q_count += (sum != (int32_t)sum);
+    return (uint32_t)sum;
+}
+
+// Dual 16x16 multiply, subtracts the high product from the low one.  This can't overflow.
+static inline uint32_t __SMUSD(uint32_t x, uint32_t y)
+{
+    return (uint32_t)((int32_t)(int16_t)x * (int16_t)y
+                    - (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+}
+
+// Dual 16x16 multiply, adds the products to a 64-bit accumulator.  Wraps, no Q flag.
+static inline uint64_t __SMLALD(uint32_t x, uint32_t y, uint64_t acc)
+{
+    return acc + (uint64_t)(int64_t)((int32_t)(int16_t)x * (int16_t)y)
+               + (uint64_t)(int64_t)((int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+}
+
+// Packs the bottom half of x with the top half of (y << sh).
+static inline uint32_t __PKHBT(uint32_t x, uint32_t y, uint32_t sh)
+{
+    return (x & 0x0000FFFFU) | ((y << sh) & 0xFFFF0000U);
+}
+
+// Packs the top half of x with the bottom half of (y >> sh), arithmetic shift.
+static inline uint32_t __PKHTB(uint32_t x, uint32_t y, uint32_t sh)
+{
+    return (x & 0xFFFF0000U) | ((uint32_t)((int32_t)y >> sh) & 0x0000FFFFU);
+}
+
+/**
+ * \brief Reads the sticky saturation (Q) flag.
+ *
+ * \return True if an operation saturated since the flag was last cleared.
+ */
+static inline uint32_t dsp_q_flag_get(void)
+{
+    return dsp_q_count != 0;
+}
+
+/**
+ * \brief Reads the number of saturation events since the flag was last cleared.
+ *
+ * On the target only the flag exists, so this returns 0 or 1 there.
+ *
+ * \return The number of operations that saturated.
+ */
+static inline uint32_t dsp_q_count_get(void)
+{
+    return dsp_q_count;
 }
 
-// Adds two int16_t values.
-static inline int16_t __QADD16(int16_t x, int16_t y)
+/**
+ * \brief Clears the sticky saturation (Q) flag and the event count.
+ */
+static inline void dsp_q_flag_clear(void)
 {
-    return x + y;
+    dsp_q_count = 0;
 }
 
-// Subtracts two int16_t values.
-static inline int16_t __QSUB16(int16_t x, int16_t y)
+#else
+
+// The Q flag is bit 27 of the APSR.
+static inline uint32_t dsp_q_flag_get(void)
 {
-    return x - y;
+    uint32_t apsr;
+    __asm volatile ("MRS %0, APSR" : "=r" (apsr));
+    return (apsr >> 27) & 1U;
+}
+
+static inline uint32_t dsp_q_count_get(void)
+{
+    return dsp_q_flag_get();
+}
+
+static inline void dsp_q_flag_clear(void)
+{
+    uint32_t apsr;
+    __asm volatile ("MRS %0, APSR" : "=r" (apsr));
+    __asm volatile ("MSR APSR_nzcvq, %0" : : "r" (apsr & ~(1U << 27)) : "cc");
 }
 
 #endif
@@ -218,8 +367,9 @@ static inline q31_t abs_sat_q31(q31_t parVal)
 {
     int32_t wResult;
 
-    /* Take opposite of value and test value in the process */
-    wResult = -parVal;
+    /* Take opposite of value and test value in the process.  Negate in unsigned
+       arithmetic so 0x80000000 wraps instead of overflowing. */
+    wResult = (int32_t)(0U - (uint32_t)parVal);
 
     if (wResult < 0)
     {
@@ -293,4 +443,267 @@ static inline q31_t mulsat_q31(q31_t x, q31_t y) {
 }
 
 
+/**
+ * \brief Integer square root.
+ *
+ * Bit by bit, two bits of the input per step from the highest set bit down, so it takes
+ * at most 32 steps of shifts, adds and compares and no divide or multiply.
+ *
+ * \param x The input value.
+ * \return floor(sqrt(x)).
+ */
+static inline uint32_t sqrt_u64(uint64_t x) {
+    uint64_t r = 0;
+    uint64_t b;
+
+    if (x == 0) {
+        return 0;
+    }
+    b = (uint64_t)1 << ((63 - __builtin_clzll(x)) & ~1);
+    while (b != 0) {
+        if (x >= r + b) {
+            x -= r + b;
+            r = (r >> 1) + b;
+        } else {
+            r >>= 1;
+        }
+        b >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+
+/**
+ * \brief Square root of a Q31.
+ *
+ * \param x The input value, negative values give 0.
+ * \return The square root rounded down, in the range [0, 1.0).
+ */
+static inline q31_t sqrt_q31(q31_t x) {
+    if (x <= 0) {
+        return 0;
+    }
+    return (q31_t)sqrt_u64((uint64_t)x << 31);
+}
+
+
+/**
+ * \brief Cosine and sine of a phase.
+ *
+ * Meant for working out coefficients in init functions, it is an integer CORDIC and
+ * needs no floating point library.  The results are within one LSB and never reach
+ * +-1.0, so a Q30 product with a q31_t always fits back in a q31_t.
+ *
+ * \param phase The angle, 2^32 per cycle.
+ * \param c The cosine in Q30.
+ * \param s The sine in Q30.
+ */
+void sincos_q30(uint32_t phase, q31_t *c, q31_t *s);
+
+
+/**
+ * \brief Multiplies two arrays of Q15s element by element.
+ *
+ * The result of each element is bit-identical to \ref mul_q15.  The output array
+ * may be the same as either input array.
+ *
+ * \param x The first multiplicand array.
+ * \param y The second multiplicand array.
+ * \param out The product array.
+ * \param n The number of elements in each array.
+ */
+void mul_q15_block(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+
+
+/**
+ * \brief Multiplies two arrays of Q31s element by element.
+ *
+ * The result of each element is bit-identical to \ref mul_q31.  The output array
+ * may be the same as either input array.
+ *
+ * \param x The first multiplicand array.
+ * \param y The second multiplicand array.
+ * \param out The product array.
+ * \param n The number of elements in each array.
+ */
+void mul_q31_block(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Multiplies two arrays of Q15s element by element with saturation.
+ *
+ * The result of each element is bit-identical to \ref mulsat_q15 and each saturated
+ * element is counted in the Q flag.  The output array may be the same as either
+ * input array.
+ *
+ * \param x The first multiplicand array.
+ * \param y The second multiplicand array.
+ * \param out The saturated product array.
+ * \param n The number of elements in each array.
+ */
+void mulsat_q15_block(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+
+
+/**
+ * \brief Multiplies two arrays of Q31s element by element with saturation.
+ *
+ * The result of each element is bit-identical to \ref mulsat_q31 and each saturated
+ * element is counted in the Q flag.  The output array may be the same as either
+ * input array.
+ *
+ * \param x The first multiplicand array.
+ * \param y The second multiplicand array.
+ * \param out The saturated product array.
+ * \param n The number of elements in each array.
+ */
+void mulsat_q31_block(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Calculates the saturated absolute value of an array of Q15s.
+ *
+ * The result of each element is bit-identical to \ref abs_sat_q15 and each -1.0 is
+ * counted in the Q flag.  The output array may be the same as the input array.
+ *
+ * \param x The input array.
+ * \param out The output array.
+ * \param n The number of elements in each array.
+ */
+void abs_sat_q15_block(const q15_t *x, q15_t *out, uint32_t n);
+
+
+/**
+ * \brief Calculates the saturated absolute value of an array of Q31s.
+ *
+ * The result of each element is bit-identical to \ref abs_sat_q31 and each -1.0 is
+ * counted in the Q flag.  The output array may be the same as the input array.
+ *
+ * \param x The input array.
+ * \param out The output array.
+ * \param n The number of elements in each array.
+ */
+void abs_sat_q31_block(const q31_t *x, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Calculates the dot product of two arrays of Q15s.
+ *
+ * The products are summed exactly in a 64-bit accumulator, so the result is in 34.30
+ * format and the order of the additions doesn't matter.
+ *
+ * \param x The first array.
+ * \param y The second array.
+ * \param n The number of elements in each array.
+ * \return The sum of the products in 34.30 format.
+ */
+int64_t dot_q15_block(const q15_t *x, const q15_t *y, uint32_t n);
+
+
+/**
+ * \brief Calculates the dot product of two arrays of Q31s.
+ *
+ * The products are summed in a 64-bit accumulator in 2.62 format.  There are no guard
+ * bits, the sum wraps if it leaves the range [-2.0, 2.0), so scale the inputs down by
+ * log2(n) bits if that can happen.  The wrapped result is the same on every kernel.
+ *
+ * \param x The first array.
+ * \param y The second array.
+ * \param n The number of elements in each array.
+ * \return The sum of the products in 2.62 format.
+ */
+int64_t dot_q31_block(const q31_t *x, const q31_t *y, uint32_t n);
+
+
+/**
+ * \brief Sums an array of Q31s with saturation.
+ *
+ * The sum is formed exactly and saturated once at the end, so unlike saturating after
+ * every addition the result doesn't depend on the order of the elements.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \return The saturated sum.
+ */
+q31_t sum_q31_block(const q31_t *x, uint32_t n);
+
+
+/**
+ * \brief Sums an array of Q15s with saturation, see \ref sum_q31_block.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \return The saturated sum.
+ */
+q15_t sum_q15_block(const q15_t *x, uint32_t n);
+
+
+/**
+ * \brief Sums an array of int16_t with saturation, see \ref sum_q31_block.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \return The saturated sum.
+ */
+int16_t sum_i16_block(const int16_t *x, uint32_t n);
+
+
+/**
+ * \brief Sums an array of uint16_t with saturation, see \ref sum_q31_block.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \return The sum, saturated at UINT16_MAX.
+ */
+uint16_t sum_u16_block(const uint16_t *x, uint32_t n);
+
+
+/**
+ * \brief Calculates the sum of the squares of an array of Q31s.
+ *
+ * Each square is truncated to Q31, (x * x) >> 31, before it is added, so the 64-bit sum
+ * can't wrap for any n.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \return The sum of the squares in 33.31 format.
+ */
+uint64_t sumsq_q31_block(const q31_t *x, uint32_t n);
+
+
+/**
+ * \brief Calculates the sum of the squares of an array of Q15s.
+ *
+ * The squares are summed exactly.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \return The sum of the squares in 34.30 format.
+ */
+uint64_t sumsq_q15_block(const q15_t *x, uint32_t n);
+
+
+/**
+ * \brief Calculates the sum of the squares of an array of int16_t.
+ *
+ * The squares are summed exactly.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \return The sum of the squares.
+ */
+uint64_t sumsq_i16_block(const int16_t *x, uint32_t n);
+
+
+/**
+ * \brief Calculates the sum of the squares of an array of uint16_t.
+ *
+ * The squares are summed exactly.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \return The sum of the squares.
+ */
+uint64_t sumsq_u16_block(const uint16_t *x, uint32_t n);
+
+
 #endif  // ARM_RT_DSP_CORE_
\ No newline at end of file
@@ -0,0 +1,197 @@
+/**
+ * \file arm_rt_dsp_dispatch.h
+ * \brief Runtime selection of the block kernels.
+ *
+*/
+
+#ifndef ARM_RT_DSP_DISPATCH_
+#define ARM_RT_DSP_DISPATCH_
+
+#include <stdint.h>
+#include "arm_rt_dsp_core.h"
+#include "arm_rt_dsp_limit.h"
+#include "arm_rt_dsp_filter.h"
+#include "arm_rt_dsp_controller.h"
+#include "arm_rt_dsp_misc.h"
+
+
+/**
+ * \defgroup dispatch_group Kernel Dispatch
+ *
+ * Every block function calls through the \ref dsp_kernels table.  The table starts out
+ * bound to the portable scalar kernels, which is all a Cortex-M target ever uses.  On a
+ * host the CPU is checked once at load time and the widest supported kernels are bound.
+ * The environment variable ARM_RT_DSP_ISA (scalar, sse4.1, avx2, avx512 or neon) caps
+ * the level that is picked, which is handy for benchmarking one binary on one machine.
+ *
+ * @{
+*/
+
+/**
+ * \brief Instruction set levels the kernels can be bound to.
+ *
+ * The x86 levels are ordered, each one includes the levels below it.
+ */
+typedef enum {
+    DSP_ISA_SCALAR = 0,  //!< Portable C, always available.
+    DSP_ISA_SSE41,       //!< x86 SSE4.1.
+    DSP_ISA_AVX2,        //!< x86 AVX2.
+    DSP_ISA_AVX512,      //!< x86 AVX-512F and AVX-512BW.
+    DSP_ISA_NEON,        //!< AArch64 Advanced SIMD.
+    DSP_ISA_COUNT
+} dsp_isa_t;
+
+
+/**
+ * \brief The ADC formats of ADC_CONVERSION_DEFINE, width and justification.
+ */
+typedef enum {
+    ADC_FORMAT_10r = 0,
+    ADC_FORMAT_10l,
+    ADC_FORMAT_12r,
+    ADC_FORMAT_12l,
+    ADC_FORMAT_14r,
+    ADC_FORMAT_14l,
+    ADC_FORMAT_16r,
+    ADC_FORMAT_16l,
+    ADC_FORMAT_COUNT
+} adc_format_t;
+
+
+typedef void (*adc_block_q15_fn)(const uint16_t *raw, uint32_t M, const int16_t *offset, const q15_t *slope, uint32_t nScans, q15_t *out);
+typedef void (*adc_block_q31_fn)(const uint16_t *raw, uint32_t M, const int16_t *offset, const q31_t *slope, uint32_t nScans, q31_t *out);
+
+/**
+ * \brief The ADC block kernels of one level, one per format with its shifts built in.
+ */
+typedef struct {
+    adc_block_q15_fn q15[ADC_FORMAT_COUNT];     //!< The adc_process_block_q15_* kernels.
+    adc_block_q31_fn q31[ADC_FORMAT_COUNT];     //!< The adc_process_block_q31_* kernels.
+    adc_block_q31_fn u_q31[ADC_FORMAT_COUNT];   //!< The adc_process_block_u_q31_* kernels.
+} adc_block_kernels_t;
+
+
+/**
+ * \brief Table of the block kernels currently in use.
+ *
+ * Kernels that have no version for the selected level use the best lower level.
+ */
+typedef struct {
+    dsp_isa_t isa;  //!< The level the table is bound to.
+
+    void (*mul_q15_block)(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+    void (*mul_q31_block)(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+    void (*mulsat_q15_block)(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+    void (*mulsat_q31_block)(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+    void (*abs_sat_q15_block)(const q15_t *x, q15_t *out, uint32_t n);
+    void (*abs_sat_q31_block)(const q31_t *x, q31_t *out, uint32_t n);
+    int64_t (*dot_q15_block)(const q15_t *x, const q15_t *y, uint32_t n);
+    int64_t (*dot_q31_block)(const q31_t *x, const q31_t *y, uint32_t n);
+
+    void (*iir_pi_bank_q31)(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out);
+    void (*iir_pi_bank_q15)(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out);
+
+    void (*filter_pma_bank_q31)(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out);
+    void (*filter_biquad_bank_q31)(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out);
+
+    void (*goertzel_bank_q31)(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+    void (*sdft_bank_q31)(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+
+    uint32_t (*rms_bank_q31)(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+
+    void (*iir_pr_multi_q31_run)(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+
+    void (*ramp_fill_q31)(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n);
+    void (*ramp_fill_i16)(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out, uint32_t n);
+
+    void (*limit_q31_block)(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n, uint32_t *count);
+    void (*limit_i16_block)(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out, uint32_t n, uint32_t *count);
+    void (*limit_u16_block)(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out, uint32_t n, uint32_t *count);
+    void (*limit_f32_block)(const float *x, float llim, float ulim, float *out, uint32_t n, uint32_t *count);
+
+    void (*minmax_q31_block)(const q31_t *x, uint32_t n, minmax_result_t *r);
+    void (*minmax_i16_block)(const int16_t *x, uint32_t n, minmax_result_t *r);
+    void (*minmax_u16_block)(const uint16_t *x, uint32_t n, minmax_result_t *r);
+    int64_t (*sum64_q31_block)(const q31_t *x, uint32_t n);
+    int64_t (*sum64_i16_block)(const int16_t *x, uint32_t n);
+    int64_t (*sum64_u16_block)(const uint16_t *x, uint32_t n);
+    uint64_t (*sumsq_q31_block)(const q31_t *x, uint32_t n);
+    uint64_t (*sumsq_i16_block)(const int16_t *x, uint32_t n);
+    uint64_t (*sumsq_u16_block)(const uint16_t *x, uint32_t n);
+
+    const adc_block_kernels_t *adc_block;
+
+    void (*convert_u16_to_q31_block)(const uint16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+    void (*convert_i16_to_q31_block)(const int16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+    void (*convert_i32_to_q31_block)(const int32_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+    void (*convert_q31_to_i16_block)(const q31_t *x, const uint32_t *scale, convert_round_t mode, int16_t *out, uint32_t n);
+    void (*convert_q31_to_u16_block)(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint16_t *out, uint32_t n);
+    void (*convert_q31_to_u32_block)(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint32_t *out, uint32_t n);
+    void (*convert_q31_to_i32_block)(const q31_t *x, const uint32_t *scale, convert_round_t mode, int32_t *out, uint32_t n);
+
+    uint32_t (*hyst_bank_q31)(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+    uint32_t (*hyst_bank_i16)(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+} dsp_dispatch_t;
+
+
+/**
+ * \brief The kernel table used by all block functions.
+ */
+extern dsp_dispatch_t dsp_kernels;
+
+
+/**
+ * \brief Checks the CPU and binds the widest supported kernels.
+ *
+ * This is called automatically when the library is loaded on a host.  It honours the
+ * ARM_RT_DSP_ISA environment variable.  Calling it again is harmless.
+ *
+ * \return The level the table was bound to.
+ */
+dsp_isa_t dsp_dispatch_init(void);
+
+
+/**
+ * \brief Binds the kernels to the requested level.
+ *
+ * If the CPU does not support the requested level, the best supported level below it
+ * is used instead.  This is not thread safe, call it before starting any processing.
+ *
+ * \param isa The requested level.
+ * \return The level the table was bound to.
+ */
+dsp_isa_t dsp_dispatch_set_isa(dsp_isa_t isa);
+
+
+/**
+ * \brief Checks whether the CPU (and the build) supports a level.
+ *
+ * \param isa The level to check.
+ * \return True if the level can be used.
+ */
+int32_t dsp_isa_supported(dsp_isa_t isa);
+
+
+/**
+ * \brief Returns the name of a level, as used by ARM_RT_DSP_ISA.
+ *
+ * \param isa The level.
+ * \return The name or "unknown".
+ */
+const char *dsp_isa_name(dsp_isa_t isa);
+
+
+/**
+ * \brief Parses a level name, as used by ARM_RT_DSP_ISA.
+ *
+ * \param name The level name.
+ * \return The level or \ref DSP_ISA_COUNT if the name is not recognised.
+ */
+dsp_isa_t dsp_isa_from_name(const char *name);
+
+/**
+ * @}
+*/
+
+
+#endif // ARM_RT_DSP_DISPATCH_
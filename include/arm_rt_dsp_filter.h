@@ -15,10 +15,9 @@
 /**
  * \brief Pseudo windowed moving average data structure.
  *
- * The init function from the 56800EX DSP library sets the accumulator to a value that would output
- * the desired initial value on the first iteration.  For now, just initialize the the structure
- * to the desired window size and zero the accumulator.  Remember the accumulator will have to wind
- * up when the filter is used.  For glacially slow filters, winding up might take eons.
+ * Initialize the structure to the desired window size and zero the accumulator.  Remember the
+ * accumulator will have to wind up when the filter is used.  For glacially slow filters, winding up
+ * might take eons, so use \ref filter_pma_precharge_q31 to start the filter at a known value instead.
  */
 typedef struct {
     acc64_t acc; //!< A 64-bit accumulator.
@@ -49,5 +48,1150 @@ static inline q31_t filter_pma_q31(q31_t inx, filter_pma_a63_t *param) {
 }
 
 
+/**
+ * \brief Precharges a pseudo windowed moving average filter.
+ *
+ * Like the init function from the 56800EX DSP library, this sets the accumulator to the
+ * value that the filter settles to for a constant input y0.  The next output is y0 if the
+ * next input is y0.  The window size must already be set and sh must be at most 32.
+ *
+ * \param param The filter's configuration and state data.
+ * \param y0 The initial output value.
+ */
+static inline void filter_pma_precharge_q31(filter_pma_a63_t *param, q31_t y0) {
+    // acc + y0 == y0 * 2^sh after the next accumulate.
+    param->acc = (acc64_t)y0 * ((acc64_t)1 << param->sh) - y0;
+}
+
+
+/**
+ * \brief A bank of pseudo windowed moving average filters stored as a structure of arrays.
+ *
+ * Channel i behaves exactly like a \ref filter_pma_a63_t with acc[i] and sh[i].  The arrays
+ * are normally defined with \ref FILTER_PMA_BANK_A63_DEFINE.  Set sh[] and then call
+ * \ref filter_pma_bank_init, which also finds out whether all channels share one window size
+ * so the block kernels can use a single shift count.  Call it again after changing sh[].
+ */
+typedef struct {
+    uint32_t n;         //!< The number of channels.
+    acc64_t *acc;       //!< The 64-bit accumulators, one per channel.
+    uint16_t *sh;       //!< The window size of channel i is equal to 2^sh[i].
+    int32_t sh_common;  //!< The shared sh if all channels have the same window, else -1.
+} filter_pma_bank_a63_t;
+
+
+/**
+ * \brief Defines a filter bank instance named name with cache line aligned arrays for N channels.
+ */
+#define FILTER_PMA_BANK_A63_DEFINE(name, N)                                         \
+    static acc64_t name##_acc[N] RT_DSP_ALIGNED(64);                                \
+    static uint16_t name##_sh[N] RT_DSP_ALIGNED(64);                                \
+    filter_pma_bank_a63_t name = { (N), name##_acc, name##_sh, -1 }
+
+
+/**
+ * \brief Initializes a filter bank instance structure.
+ *
+ * \param S Pointer to the filter bank instance structure.
+ * \param resetStateFlag Set this to true to zero the accumulators.
+ */
+void filter_pma_bank_init(filter_pma_bank_a63_t *S, int32_t resetStateFlag);
+
+
+/**
+ * \brief Precharges every channel of a filter bank, see \ref filter_pma_precharge_q31.
+ *
+ * \param S Pointer to the filter bank instance structure.
+ * \param y0 The initial output values, one per channel.
+ */
+void filter_pma_bank_precharge_q31(filter_pma_bank_a63_t *S, const q31_t *y0);
+
+
+/**
+ * \brief Filters one new sample on every channel of a filter bank.
+ *
+ * Channel i gives exactly the same result as \ref filter_pma_q31.  The output array may
+ * be the input array.
+ *
+ * \param S Pointer to the filter bank instance structure.
+ * \param in The new input samples, one per channel.
+ * \param out The filtered output samples, one per channel.
+ */
+void filter_pma_bank_q31(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out);
+
+
+/**
+ * \brief Divides a boxcar sum by the window length with a reciprocal multiply.
+ *
+ * Gives exactly floor(sum / N) for any sum of N q31_t samples.  The sum is biased to
+ * [0, N * 2^32) and multiplied by magic = ceil(2^(32 + 2l) / N), where 2^l >= N, which
+ * is exact for that range (Granlund and Montgomery).  The 32 x 32 bit partial products
+ * map onto UMULL on the target.
+ *
+ * \param sum The sum of N q31_t samples.
+ * \param magic The reciprocal, see \ref filter_boxcar_a63_t.
+ * \param l The reciprocal shift.
+ * \param N The window length.
+ * \return floor(sum / N).
+ */
+static inline q31_t filter_boxcar_div(acc64_t sum, uint64_t magic, uint32_t l, uint32_t N) {
+    uint64_t x = (uint64_t)sum + ((uint64_t)N << 31);
+    uint64_t xh = x >> 32;
+    uint64_t xl = x & 0xFFFFFFFFU;
+    uint64_t mh = magic >> 32;
+    uint64_t ml = magic & 0xFFFFFFFFU;
+
+    // (x * magic) >> 32 is a * 2^32 + b, then the last 2l bits go.
+    uint64_t a = xh * mh;
+    uint64_t b = xh * ml + xl * mh + ((xl * ml) >> 32);
+    uint64_t q = (a << (32U - 2U * l)) + (b >> (2U * l));
+    return (q31_t)(int64_t)(q - ((uint64_t)1 << 31));
+}
+
+
+/**
+ * \brief Works out the reciprocal of N for \ref filter_boxcar_div.
+ *
+ * \param N The divisor, 1 to 65535.
+ * \param l Set to the reciprocal shift.
+ * \param magic Set to the reciprocal.
+ */
+void filter_boxcar_reciprocal(uint32_t N, uint16_t *l, uint64_t *magic);
+
+
+/**
+ * \brief Boxcar (exact moving average) filter data structure.
+ *
+ * Keeps the last N samples in a ring buffer and their exact sum, so each new sample costs
+ * one add, one subtract and a reciprocal multiply for any N from 1 to 65535.  Define it
+ * with \ref FILTER_BOXCAR_A63_DEFINE and set it up with \ref filter_boxcar_init_q31.
+ */
+typedef struct {
+    acc64_t sum;        //!< The sum of the samples in the window.
+    uint16_t N;         //!< The window length.
+    uint16_t idx;       //!< Position of the oldest sample in pState.
+    uint16_t l;         //!< The reciprocal shift, 2^l >= N.
+    uint64_t magic;     //!< The reciprocal of N.
+    q31_t *pState;      //!< The last N samples.
+} filter_boxcar_a63_t;
+
+
+/**
+ * \brief Defines a boxcar filter named name with a window of N samples.
+ */
+#define FILTER_BOXCAR_A63_DEFINE(name, N)                                           \
+    static q31_t name##_state[N];                                                   \
+    filter_boxcar_a63_t name = { 0, (N), 0, 0, 0, name##_state }
+
+
+/**
+ * \brief Initializes a boxcar filter.
+ *
+ * Works out the reciprocal and fills the window with y0, so the filter starts settled at
+ * y0 instead of winding up from zero.
+ *
+ * \param y0 The initial output value.
+ * \param param The filter's configuration and state data.
+ */
+void filter_boxcar_init_q31(q31_t y0, filter_boxcar_a63_t *param);
+
+
+/**
+ * \brief A process function for a boxcar filter.
+ *
+ * \param inx The new input sample.
+ * \param param The filter's configuration and state data.
+ * \return The average of the last N samples, rounded down.
+ */
+static inline q31_t filter_boxcar_q31(q31_t inx, filter_boxcar_a63_t *param) {
+    param->sum += (acc64_t)inx - param->pState[param->idx];
+    param->pState[param->idx] = inx;
+    if (++param->idx == param->N) {
+        param->idx = 0;
+    }
+    return filter_boxcar_div(param->sum, param->magic, param->l, param->N);
+}
+
+
+/**
+ * \brief A bank of boxcar filters with the same window length.
+ *
+ * The ring buffer is interleaved by time slot, the samples of all channels for one slot
+ * are next to each other.  Each update reads and writes one contiguous row, so a cache
+ * line holds 16 channels instead of 16 samples of one channel.  Channel i behaves exactly
+ * like a \ref filter_boxcar_a63_t.  Define it with \ref FILTER_BOXCAR_BANK_A63_DEFINE.
+ */
+typedef struct {
+    uint32_t n;         //!< The number of channels.
+    uint16_t N;         //!< The window length.
+    uint16_t idx;       //!< Slot of the oldest samples in pState.
+    uint16_t l;         //!< The reciprocal shift, 2^l >= N.
+    uint64_t magic;     //!< The reciprocal of N.
+    acc64_t *sum;       //!< The window sums, one per channel.
+    q31_t *pState;      //!< N slots of n samples, pState[slot * n + channel].
+} filter_boxcar_bank_a63_t;
+
+
+/**
+ * \brief Defines a boxcar bank named name with CH channels and a window of N samples.
+ */
+#define FILTER_BOXCAR_BANK_A63_DEFINE(name, CH, N)                                  \
+    static acc64_t name##_sum[CH] RT_DSP_ALIGNED(64);                               \
+    static q31_t name##_state[(CH) * (N)] RT_DSP_ALIGNED(64);                       \
+    filter_boxcar_bank_a63_t name = { (CH), (N), 0, 0, 0, name##_sum, name##_state }
+
+
+/**
+ * \brief Initializes a boxcar bank.
+ *
+ * \param S Pointer to the boxcar bank instance structure.
+ * \param y0 The initial output values, one per channel, or NULL for zero.
+ */
+void filter_boxcar_bank_init_q31(filter_boxcar_bank_a63_t *S, const q31_t *y0);
+
+
+/**
+ * \brief Filters one new sample on every channel of a boxcar bank.
+ *
+ * The output array may be the input array.
+ *
+ * \param S Pointer to the boxcar bank instance structure.
+ * \param in The new input samples, one per channel.
+ * \param out The averages, one per channel.
+ */
+void filter_boxcar_bank_q31(filter_boxcar_bank_a63_t *S, const q31_t *in, q31_t *out);
+
+
+/**
+ * \brief The longest window of the median and min/max filters.
+ */
+#define FILTER_RANK_MAX_N 64
+
+
+/**
+ * \brief Sliding window median filter data structure.
+ *
+ * The window is a ring buffer of N samples.  For N of 3 and 5 the median comes from
+ * \ref median3_q31 and \ref median5_q31 on the ring.  Longer windows keep the slots in two
+ * heaps, a max heap of the lower (N + 1) / 2 samples and a min heap of the rest, so the
+ * median is on top and replacing the oldest sample costs O(log N).  Define it with
+ * \ref FILTER_MEDIAN_Q31_DEFINE and set it up with \ref filter_median_init_q31.
+ */
+typedef struct {
+    uint16_t N;         //!< The window length, 1 to \ref FILTER_RANK_MAX_N.
+    uint16_t idx;       //!< Slot of the oldest sample.
+    q31_t *pState;      //!< The last N samples.
+    uint8_t *pHeap;     //!< Slots in heap order, [0, (N + 1) / 2) low heap, the rest high heap.
+    uint8_t *pPos;      //!< Position of each slot in pHeap.
+} filter_median_instance_q31;
+
+
+/**
+ * \brief Defines a median filter named name with a window of N samples.
+ */
+#define FILTER_MEDIAN_Q31_DEFINE(name, N)                                           \
+    static q31_t name##_state[N];                                                   \
+    static uint8_t name##_heap[N];                                                  \
+    static uint8_t name##_pos[N];                                                   \
+    filter_median_instance_q31 name = { (N), 0, name##_state, name##_heap, name##_pos }
+
+
+/**
+ * \brief Initializes a median filter with the window filled with y0.
+ *
+ * \param y0 The initial output value.
+ * \param param The filter's configuration and state data.
+ */
+void filter_median_init_q31(q31_t y0, filter_median_instance_q31 *param);
+
+
+/**
+ * \brief A process function for a median filter.
+ *
+ * \param inx The new input sample.
+ * \param param The filter's configuration and state data.
+ * \return The median of the last N samples.  For even N it is the mean of the two middle
+ * samples, rounded down.
+ */
+q31_t filter_median_q31(q31_t inx, filter_median_instance_q31 *param);
+
+
+/**
+ * \brief Median filters a block of samples.
+ *
+ * Same as calling \ref filter_median_q31 on each sample.  The output array may be the
+ * input array.
+ *
+ * \param param The filter's configuration and state data.
+ * \param in The input samples.
+ * \param out The filtered samples.
+ * \param n The number of samples.
+ */
+void filter_median_q31_block(filter_median_instance_q31 *param, const q31_t *in, q31_t *out,
+                             uint32_t n);
+
+
+/**
+ * \brief Sliding window minimum or maximum filter data structure.
+ *
+ * Keeps a monotonic deque of the samples that can still become the extremum, each with
+ * its arrival time.  A new sample drops the ones behind it that it beats, and the front
+ * drops out when it leaves the window, so each sample costs amortised O(1) whatever N is.
+ * The minimum filter runs the same code on ~x, which reverses the order of q31_t without
+ * overflow.  Define it with \ref FILTER_MINMAX_Q31_DEFINE and set it up with
+ * \ref filter_max_init_q31 or \ref filter_min_init_q31.
+ */
+typedef struct {
+    uint16_t N;         //!< The window length, 1 to 65535.
+    uint16_t head;      //!< Front of the deque in pVal.
+    uint16_t count;     //!< Number of samples in the deque.
+    q31_t mask;         //!< 0 for a maximum filter, -1 for a minimum filter.
+    uint32_t t;         //!< The sample counter.
+    q31_t *pVal;        //!< The deque samples, xor mask, as a ring of N.
+    uint32_t *pTime;    //!< Arrival time of each deque sample.
+} filter_minmax_instance_q31;
+
+
+/**
+ * \brief Defines a min/max filter named name with a window of N samples.
+ */
+#define FILTER_MINMAX_Q31_DEFINE(name, N)                                           \
+    static q31_t name##_val[N];                                                     \
+    static uint32_t name##_time[N];                                                 \
+    filter_minmax_instance_q31 name = { (N), 0, 0, 0, 0, name##_val, name##_time }
+
+
+/**
+ * \brief Initializes a sliding maximum filter with the window filled with y0.
+ *
+ * \param y0 The initial output value.
+ * \param param The filter's configuration and state data.
+ */
+void filter_max_init_q31(q31_t y0, filter_minmax_instance_q31 *param);
+
+
+/**
+ * \brief Initializes a sliding minimum filter with the window filled with y0.
+ *
+ * \param y0 The initial output value.
+ * \param param The filter's configuration and state data.
+ */
+void filter_min_init_q31(q31_t y0, filter_minmax_instance_q31 *param);
+
+
+/**
+ * \brief A process function for a sliding minimum or maximum filter.
+ *
+ * \param inx The new input sample.
+ * \param param The filter's configuration and state data.
+ * \return The minimum or maximum of the last N samples.
+ */
+static inline q31_t filter_minmax_q31(q31_t inx, filter_minmax_instance_q31 *param) {
+    const uint32_t N = param->N;
+    q31_t k = inx ^ param->mask;
+    uint32_t back;
+
+    // The front leaves the window before the new sample goes in, so at most N are kept.
+    if (param->count > 0 && param->t - param->pTime[param->head] >= N) {
+        param->head = (param->head + 1U == N) ? 0 : param->head + 1U;
+        param->count--;
+    }
+    back = param->head + param->count;
+    back = (back >= N) ? back - N : back;
+    while (param->count > 0) {
+        uint32_t last = (back == 0) ? N - 1U : back - 1U;
+        if (param->pVal[last] > k) {
+            break;
+        }
+        back = last;
+        param->count--;
+    }
+    param->pVal[back] = k;
+    param->pTime[back] = param->t++;
+    param->count++;
+    return param->pVal[param->head] ^ param->mask;
+}
+
+
+/**
+ * \brief Sliding minimum or maximum over a block of samples.
+ *
+ * Same as calling \ref filter_minmax_q31 on each sample.  The output array may be the
+ * input array.
+ *
+ * \param param The filter's configuration and state data.
+ * \param in The input samples.
+ * \param out The filtered samples.
+ * \param n The number of samples.
+ */
+void filter_minmax_q31_block(filter_minmax_instance_q31 *param, const q31_t *in, q31_t *out,
+                             uint32_t n);
+
+
+/**
+ * \brief Biquad (second order IIR) filter stage data structure.
+ *
+ * Direct form I with q31_t coefficients and a 64-bit accumulator.  The stage computes
+ *
+ *     y[n] = (b0*x[n] + b1*x[n-1] + b2*x[n-2] + a1*y[n-1] + a2*y[n-2]) * 2^sh
+ *
+ * so the feedback coefficients are stored negated, as in CMSIS.  Coefficients larger than
+ * 1.0 are scaled down by 2^sh, which is applied once to the accumulator as a post-shift.
+ * Zero the state to initialize.  Direct form I keeps the state as plain q31_t samples and
+ * has a single rounding point, so every form of the filter gives the same bits.
+ */
+typedef struct {
+    q31_t b0;       //!< The feed forward coefficients, scaled by 2^-sh.
+    q31_t b1;
+    q31_t b2;
+    q31_t a1;       //!< The negated feedback coefficients, scaled by 2^-sh.
+    q31_t a2;
+    uint16_t sh;    //!< The post-shift, 0 to 31.
+    q31_t state[4]; //!< x[n-1], x[n-2], y[n-1] and y[n-2].
+} filter_biquad_a63_t;
+
+
+/**
+ * \brief A process function for one biquad stage.
+ *
+ * The output is truncated and saturated.  The coefficients must be chosen so the five
+ * products don't overflow the accumulator, which is only possible with sh > 0.
+ *
+ * \param inx The new input sample.
+ * \param param The stage's configuration and state data.
+ * \return A new filtered output sample.
+ */
+static inline q31_t filter_biquad_q31(q31_t inx, filter_biquad_a63_t *param) {
+    acc64_t acc;
+    q31_t y;
+
+    // 1.31 * 1.31 => 2.62
+    acc = (acc64_t)param->b0 * inx;
+    acc += (acc64_t)param->b1 * param->state[0];
+    acc += (acc64_t)param->b2 * param->state[1];
+    acc += (acc64_t)param->a1 * param->state[2];
+    acc += (acc64_t)param->a2 * param->state[3];
+
+    // Back to 1.31 with the post-shift applied.
+    y = (q31_t)ssat_i64(acc >> (31 - param->sh), 32);
+
+    param->state[1] = param->state[0];
+    param->state[0] = inx;
+    param->state[3] = param->state[2];
+    param->state[2] = y;
+    return y;
+}
+
+
+/**
+ * \brief Biquad cascade data structure.
+ */
+typedef struct {
+    uint32_t numStages;          //!< The number of stages.
+    filter_biquad_a63_t *stages; //!< The stages, the input goes to stages[0].
+} filter_biquad_cas_a63_t;
+
+
+/**
+ * \brief A process function for a biquad cascade.
+ *
+ * \param inx The new input sample.
+ * \param param The cascade's configuration and state data.
+ * \return A new filtered output sample.
+ */
+static inline q31_t filter_biquad_cas_q31(q31_t inx, filter_biquad_cas_a63_t *param) {
+    for (uint32_t s = 0; s < param->numStages; s++) {
+        inx = filter_biquad_q31(inx, &param->stages[s]);
+    }
+    return inx;
+}
+
+
+/**
+ * \brief Filters a block of samples through a biquad cascade.
+ *
+ * Gives exactly the same outputs as calling \ref filter_biquad_cas_q31 once per sample.
+ * The block is run one stage at a time with that stage's state held in registers.  The
+ * output array may be the input array.
+ *
+ * \param param The cascade's configuration and state data.
+ * \param in The input samples.
+ * \param out The filtered output samples.
+ * \param n The number of samples.
+ */
+void filter_biquad_cas_q31_block(filter_biquad_cas_a63_t *param, const q31_t *in, q31_t *out,
+                                 uint32_t n);
+
+
+/**
+ * \brief A bank of biquad cascades stored as a structure of arrays.
+ *
+ * Every channel has the same number of stages.  The coefficient, shift and state arrays
+ * hold numStages * n values with stage s of channel i at index s * n + i, so the kernels
+ * can step neighbouring channels together.  Channel i behaves exactly like a
+ * \ref filter_biquad_cas_a63_t with the same coefficients and state.  The arrays are
+ * normally defined with \ref FILTER_BIQUAD_BANK_A63_DEFINE.
+ */
+typedef struct {
+    uint32_t n;         //!< The number of channels.
+    uint32_t numStages; //!< The number of stages per channel.
+    q31_t *b0;
+    q31_t *b1;
+    q31_t *b2;
+    q31_t *a1;
+    q31_t *a2;
+    uint16_t *sh;
+    q31_t *state[4];    //!< x[n-1], x[n-2], y[n-1] and y[n-2].
+} filter_biquad_bank_a63_t;
+
+
+/**
+ * \brief Defines a biquad bank instance named name with cache line aligned arrays for N
+ * channels of STAGES stages.
+ */
+#define FILTER_BIQUAD_BANK_A63_DEFINE(name, N, STAGES)                              \
+    static q31_t name##_b0[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    static q31_t name##_b1[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    static q31_t name##_b2[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    static q31_t name##_a1[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    static q31_t name##_a2[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    static uint16_t name##_sh[(N) * (STAGES)] RT_DSP_ALIGNED(64);                   \
+    static q31_t name##_x1[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    static q31_t name##_x2[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    static q31_t name##_y1[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    static q31_t name##_y2[(N) * (STAGES)] RT_DSP_ALIGNED(64);                      \
+    filter_biquad_bank_a63_t name = { (N), (STAGES), name##_b0, name##_b1, name##_b2, \
+                                      name##_a1, name##_a2, name##_sh,              \
+                                      { name##_x1, name##_x2, name##_y1, name##_y2 } }
+
+
+/**
+ * \brief Initializes a biquad bank instance structure.
+ *
+ * \param S Pointer to the biquad bank instance structure.
+ * \param resetStateFlag Set this to true to clear the state buffers.
+ */
+void filter_biquad_bank_init(filter_biquad_bank_a63_t *S, int32_t resetStateFlag);
+
+
+/**
+ * \brief Copies the coefficients and state of one stage into a biquad bank.
+ *
+ * \param S Pointer to the biquad bank instance structure.
+ * \param channel The channel.
+ * \param stage The stage of that channel.
+ * \param param The stage to copy from.
+ */
+void filter_biquad_bank_set(filter_biquad_bank_a63_t *S, uint32_t channel, uint32_t stage,
+                            const filter_biquad_a63_t *param);
+
+
+/**
+ * \brief Filters one new sample on every channel of a biquad bank.
+ *
+ * The output array may be the input array.
+ *
+ * \param S Pointer to the biquad bank instance structure.
+ * \param in The new input samples, one per channel.
+ * \param out The filtered output samples, one per channel.
+ */
+void filter_biquad_bank_q31(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out);
+
+
+/**
+ * \brief FIR decimator instance structure that uses q15_t data types.
+ *
+ * Keeps one output of every M inputs, so only those outputs are computed and the cost
+ * is numTaps / M multiplies per input sample, the same as a polyphase structure.  The
+ * state buffer is twice the filter length and every sample is written to both halves,
+ * so the last numTaps samples are always contiguous and no modulo arithmetic is needed
+ * in the dot product.  Define it with \ref FIR_DECIMATE_Q15_DEFINE and set it up with
+ * \ref fir_decimate_init_q15.
+ */
+typedef struct {
+    uint16_t numTaps;   //!< The filter length.
+    uint16_t M;         //!< The decimation factor.
+    uint16_t phase;     //!< Inputs since the last output.
+    uint16_t idx;       //!< Position of the newest sample in pState.
+    q15_t *pCoeffs;     //!< numTaps coefficients, h[0] first.
+    q15_t *pState;      //!< 2 * numTaps samples.
+} fir_decimate_instance_q15;
+
+
+/**
+ * \brief Defines an FIR decimator instance named name for N taps and a factor of M.
+ */
+#define FIR_DECIMATE_Q15_DEFINE(name, N, M)                                         \
+    static q15_t name##_coeffs[N] RT_DSP_ALIGNED(64);                               \
+    static q15_t name##_state[2 * (N)] RT_DSP_ALIGNED(64);                          \
+    fir_decimate_instance_q15 name = { (N), (M), 0, 0, name##_coeffs, name##_state }
+
+
+/**
+ * \brief Initializes an FIR decimator instance structure.
+ *
+ * Copies the coefficients and clears the state.
+ *
+ * \param S Pointer to the FIR decimator instance structure.
+ * \param h The numTaps filter coefficients, h[0] first.
+ */
+void fir_decimate_init_q15(fir_decimate_instance_q15 *S, const q15_t *h);
+
+
+/**
+ * \brief Filters and decimates a block of samples.
+ *
+ * The block length doesn't have to be a multiple of M, the phase carries over to the
+ * next call.  Each output is the 34.30 dot product (see \ref dot_q15_block) truncated
+ * and saturated to 1.15.  The output array may be the input array.
+ *
+ * \param S Pointer to the FIR decimator instance structure.
+ * \param in The input samples.
+ * \param out The output samples, room for n / M + 1 of them.
+ * \param n The number of input samples.
+ * \return The number of output samples written.
+ */
+uint32_t fir_decimate_q15(fir_decimate_instance_q15 *S, const q15_t *in, q15_t *out, uint32_t n);
+
+
+/**
+ * \brief Polyphase FIR interpolator instance structure that uses q15_t data types.
+ *
+ * Each input sample gives L outputs.  Output phase p only uses the taps h[p], h[p + L],
+ * ... so the init function stores the coefficients phase by phase, and each output is
+ * one contiguous dot product of phaseLength taps over a double length state buffer.
+ * The filter has a gain of 1/L unless the coefficients include it.  Define it with
+ * \ref FIR_INTERPOLATE_Q15_DEFINE and set it up with \ref fir_interpolate_init_q15.
+ */
+typedef struct {
+    uint16_t numTaps;     //!< The filter length.
+    uint16_t L;           //!< The interpolation factor.
+    uint16_t phaseLength; //!< Taps per phase, numTaps / L rounded up.
+    uint16_t idx;         //!< Position of the newest sample in pState.
+    q15_t *pCoeffs;       //!< L * phaseLength coefficients, phase by phase.
+    q15_t *pState;        //!< 2 * phaseLength samples.
+} fir_interpolate_instance_q15;
+
+
+/**
+ * \brief Defines an FIR interpolator instance named name for N taps and a factor of L.
+ */
+#define FIR_INTERPOLATE_Q15_DEFINE(name, N, L)                                      \
+    static q15_t name##_coeffs[(((N) + (L) - 1) / (L)) * (L)] RT_DSP_ALIGNED(64);    \
+    static q15_t name##_state[2 * (((N) + (L) - 1) / (L))] RT_DSP_ALIGNED(64);       \
+    fir_interpolate_instance_q15 name = { (N), (L), ((N) + (L) - 1) / (L), 0,          \
+                                            name##_coeffs, name##_state }
+
+
+/**
+ * \brief Initializes an FIR interpolator instance structure.
+ *
+ * Reorders the coefficients phase by phase, padding the last taps with zeros if numTaps
+ * is not a multiple of L, and clears the state.
+ *
+ * \param S Pointer to the FIR interpolator instance structure.
+ * \param h The numTaps filter coefficients, h[0] first.
+ */
+void fir_interpolate_init_q15(fir_interpolate_instance_q15 *S, const q15_t *h);
+
+
+/**
+ * \brief Filters and interpolates a block of samples.
+ *
+ * Each output is the 34.30 dot product (see \ref dot_q15_block) truncated and saturated
+ * to 1.15.  The output array must not overlap the input array.
+ *
+ * \param S Pointer to the FIR interpolator instance structure.
+ * \param in The input samples.
+ * \param out The output samples, n * L of them.
+ * \param n The number of input samples.
+ */
+void fir_interpolate_q15(fir_interpolate_instance_q15 *S, const q15_t *in, q15_t *out, uint32_t n);
+
+
+/**
+ * \brief Half-band FIR instance structure that uses q15_t data types.
+ *
+ * A half-band filter has numTaps = 4K + 3 and every other tap is zero except the centre
+ * tap h[2K + 1].  Decimating or interpolating by 2 splits it into a phase with the
+ * 2K + 2 even taps and a phase with only the centre tap, so it costs about a quarter of
+ * the multiplies of a plain FIR of the same length.  One instance is used either to
+ * decimate or to interpolate, not both.  Define it with \ref FIR_HALFBAND_Q15_DEFINE
+ * and set it up with \ref fir_halfband_init_q15.
+ */
+typedef struct {
+    uint16_t numTaps;   //!< The filter length, 4K + 3.
+    uint16_t phase;     //!< Decimator only, 1 if the next input gives an output.
+    uint16_t idxA;      //!< Position of the newest sample in pStateA.
+    uint16_t idxB;      //!< Position of the newest sample in pStateB.
+    q15_t center;       //!< The centre tap h[2K + 1].
+    q15_t *pCoeffs;     //!< The 2K + 2 even taps h[0], h[2], ...
+    q15_t *pStateA;     //!< 2 * (2K + 2) samples of the even tap phase.
+    q15_t *pStateB;     //!< 2 * (K + 1) samples of the centre tap phase, decimator only.
+} fir_halfband_instance_q15;
+
+
+/**
+ * \brief Defines a half-band FIR instance named name for N = 4K + 3 taps.
+ */
+#define FIR_HALFBAND_Q15_DEFINE(name, N)                                            \
+    static q15_t name##_coeffs[((N) + 1) / 2] RT_DSP_ALIGNED(64);                   \
+    static q15_t name##_stateA[(N) + 1] RT_DSP_ALIGNED(64);                         \
+    static q15_t name##_stateB[((N) + 1) / 2] RT_DSP_ALIGNED(64);                   \
+    fir_halfband_instance_q15 name = { (N), 0, 0, 0, 0, name##_coeffs,                 \
+                                         name##_stateA, name##_stateB }
+
+
+/**
+ * \brief Initializes a half-band FIR instance structure.
+ *
+ * Picks out the even taps and the centre tap, the other taps are taken to be zero.
+ * Clears the state.
+ *
+ * \param S Pointer to the half-band FIR instance structure.
+ * \param h The numTaps filter coefficients, h[0] first.
+ */
+void fir_halfband_init_q15(fir_halfband_instance_q15 *S, const q15_t *h);
+
+
+/**
+ * \brief Filters and decimates a block of samples by 2 with a half-band filter.
+ *
+ * Gives the same outputs as \ref fir_decimate_q15 with M = 2 and the full coefficients.
+ * The output array may be the input array.
+ *
+ * \param S Pointer to the half-band FIR instance structure.
+ * \param in The input samples.
+ * \param out The output samples, room for n / 2 + 1 of them.
+ * \param n The number of input samples.
+ * \return The number of output samples written.
+ */
+uint32_t fir_halfband_decimate_q15(fir_halfband_instance_q15 *S, const q15_t *in, q15_t *out,
+                                   uint32_t n);
+
+
+/**
+ * \brief Filters and interpolates a block of samples by 2 with a half-band filter.
+ *
+ * Gives the same outputs as \ref fir_interpolate_q15 with L = 2 and the full coefficients.
+ * The output array must not overlap the input array.
+ *
+ * \param S Pointer to the half-band FIR instance structure.
+ * \param in The input samples.
+ * \param out The output samples, 2 * n of them.
+ * \param n The number of input samples.
+ */
+void fir_halfband_interpolate_q15(fir_halfband_instance_q15 *S, const q15_t *in, q15_t *out,
+                                  uint32_t n);
+
+
+/**
+ * \brief FIR decimator instance structure that uses q31_t data types.
+ *
+ * Keeps one output of every M inputs, so only those outputs are computed and the cost
+ * is numTaps / M multiplies per input sample, the same as a polyphase structure.  The
+ * state buffer is twice the filter length and every sample is written to both halves,
+ * so the last numTaps samples are always contiguous and no modulo arithmetic is needed
+ * in the dot product.  Define it with \ref FIR_DECIMATE_Q31_DEFINE and set it up with
+ * \ref fir_decimate_init_q31.
+ */
+typedef struct {
+    uint16_t numTaps;   //!< The filter length.
+    uint16_t M;         //!< The decimation factor.
+    uint16_t phase;     //!< Inputs since the last output.
+    uint16_t idx;       //!< Position of the newest sample in pState.
+    q31_t *pCoeffs;     //!< numTaps coefficients, h[0] first.
+    q31_t *pState;      //!< 2 * numTaps samples.
+} fir_decimate_instance_q31;
+
+
+/**
+ * \brief Defines an FIR decimator instance named name for N taps and a factor of M.
+ */
+#define FIR_DECIMATE_Q31_DEFINE(name, N, M)                                         \
+    static q31_t name##_coeffs[N] RT_DSP_ALIGNED(64);                               \
+    static q31_t name##_state[2 * (N)] RT_DSP_ALIGNED(64);                          \
+    fir_decimate_instance_q31 name = { (N), (M), 0, 0, name##_coeffs, name##_state }
+
+
+/**
+ * \brief Initializes an FIR decimator instance structure.
+ *
+ * Copies the coefficients and clears the state.
+ *
+ * \param S Pointer to the FIR decimator instance structure.
+ * \param h The numTaps filter coefficients, h[0] first.
+ */
+void fir_decimate_init_q31(fir_decimate_instance_q31 *S, const q31_t *h);
+
+
+/**
+ * \brief Filters and decimates a block of samples.
+ *
+ * The block length doesn't have to be a multiple of M, the phase carries over to the
+ * next call.  Each output is the 2.62 dot product (see \ref dot_q31_block) truncated
+ * and saturated to 1.31.  The output array may be the input array.
+ *
+ * \param S Pointer to the FIR decimator instance structure.
+ * \param in The input samples.
+ * \param out The output samples, room for n / M + 1 of them.
+ * \param n The number of input samples.
+ * \return The number of output samples written.
+ */
+uint32_t fir_decimate_q31(fir_decimate_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Polyphase FIR interpolator instance structure that uses q31_t data types.
+ *
+ * Each input sample gives L outputs.  Output phase p only uses the taps h[p], h[p + L],
+ * ... so the init function stores the coefficients phase by phase, and each output is
+ * one contiguous dot product of phaseLength taps over a double length state buffer.
+ * The filter has a gain of 1/L unless the coefficients include it.  Define it with
+ * \ref FIR_INTERPOLATE_Q31_DEFINE and set it up with \ref fir_interpolate_init_q31.
+ */
+typedef struct {
+    uint16_t numTaps;     //!< The filter length.
+    uint16_t L;           //!< The interpolation factor.
+    uint16_t phaseLength; //!< Taps per phase, numTaps / L rounded up.
+    uint16_t idx;         //!< Position of the newest sample in pState.
+    q31_t *pCoeffs;       //!< L * phaseLength coefficients, phase by phase.
+    q31_t *pState;        //!< 2 * phaseLength samples.
+} fir_interpolate_instance_q31;
+
+
+/**
+ * \brief Defines an FIR interpolator instance named name for N taps and a factor of L.
+ */
+#define FIR_INTERPOLATE_Q31_DEFINE(name, N, L)                                      \
+    static q31_t name##_coeffs[(((N) + (L) - 1) / (L)) * (L)] RT_DSP_ALIGNED(64);    \
+    static q31_t name##_state[2 * (((N) + (L) - 1) / (L))] RT_DSP_ALIGNED(64);       \
+    fir_interpolate_instance_q31 name = { (N), (L), ((N) + (L) - 1) / (L), 0,          \
+                                            name##_coeffs, name##_state }
+
+
+/**
+ * \brief Initializes an FIR interpolator instance structure.
+ *
+ * Reorders the coefficients phase by phase, padding the last taps with zeros if numTaps
+ * is not a multiple of L, and clears the state.
+ *
+ * \param S Pointer to the FIR interpolator instance structure.
+ * \param h The numTaps filter coefficients, h[0] first.
+ */
+void fir_interpolate_init_q31(fir_interpolate_instance_q31 *S, const q31_t *h);
+
+
+/**
+ * \brief Filters and interpolates a block of samples.
+ *
+ * Each output is the 2.62 dot product (see \ref dot_q31_block) truncated and saturated
+ * to 1.31.  The output array must not overlap the input array.
+ *
+ * \param S Pointer to the FIR interpolator instance structure.
+ * \param in The input samples.
+ * \param out The output samples, n * L of them.
+ * \param n The number of input samples.
+ */
+void fir_interpolate_q31(fir_interpolate_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Half-band FIR instance structure that uses q31_t data types.
+ *
+ * A half-band filter has numTaps = 4K + 3 and every other tap is zero except the centre
+ * tap h[2K + 1].  Decimating or interpolating by 2 splits it into a phase with the
+ * 2K + 2 even taps and a phase with only the centre tap, so it costs about a quarter of
+ * the multiplies of a plain FIR of the same length.  One instance is used either to
+ * decimate or to interpolate, not both.  Define it with \ref FIR_HALFBAND_Q31_DEFINE
+ * and set it up with \ref fir_halfband_init_q31.
+ */
+typedef struct {
+    uint16_t numTaps;   //!< The filter length, 4K + 3.
+    uint16_t phase;     //!< Decimator only, 1 if the next input gives an output.
+    uint16_t idxA;      //!< Position of the newest sample in pStateA.
+    uint16_t idxB;      //!< Position of the newest sample in pStateB.
+    q31_t center;       //!< The centre tap h[2K + 1].
+    q31_t *pCoeffs;     //!< The 2K + 2 even taps h[0], h[2], ...
+    q31_t *pStateA;     //!< 2 * (2K + 2) samples of the even tap phase.
+    q31_t *pStateB;     //!< 2 * (K + 1) samples of the centre tap phase, decimator only.
+} fir_halfband_instance_q31;
+
+
+/**
+ * \brief Defines a half-band FIR instance named name for N = 4K + 3 taps.
+ */
+#define FIR_HALFBAND_Q31_DEFINE(name, N)                                            \
+    static q31_t name##_coeffs[((N) + 1) / 2] RT_DSP_ALIGNED(64);                   \
+    static q31_t name##_stateA[(N) + 1] RT_DSP_ALIGNED(64);                         \
+    static q31_t name##_stateB[((N) + 1) / 2] RT_DSP_ALIGNED(64);                   \
+    fir_halfband_instance_q31 name = { (N), 0, 0, 0, 0, name##_coeffs,                 \
+                                         name##_stateA, name##_stateB }
+
+
+/**
+ * \brief Initializes a half-band FIR instance structure.
+ *
+ * Picks out the even taps and the centre tap, the other taps are taken to be zero.
+ * Clears the state.
+ *
+ * \param S Pointer to the half-band FIR instance structure.
+ * \param h The numTaps filter coefficients, h[0] first.
+ */
+void fir_halfband_init_q31(fir_halfband_instance_q31 *S, const q31_t *h);
+
+
+/**
+ * \brief Filters and decimates a block of samples by 2 with a half-band filter.
+ *
+ * Gives the same outputs as \ref fir_decimate_q31 with M = 2 and the full coefficients.
+ * The output array may be the input array.
+ *
+ * \param S Pointer to the half-band FIR instance structure.
+ * \param in The input samples.
+ * \param out The output samples, room for n / 2 + 1 of them.
+ * \param n The number of input samples.
+ * \return The number of output samples written.
+ */
+uint32_t fir_halfband_decimate_q31(fir_halfband_instance_q31 *S, const q31_t *in, q31_t *out,
+                                   uint32_t n);
+
+
+/**
+ * \brief Filters and interpolates a block of samples by 2 with a half-band filter.
+ *
+ * Gives the same outputs as \ref fir_interpolate_q31 with L = 2 and the full coefficients.
+ * The output array must not overlap the input array.
+ *
+ * \param S Pointer to the half-band FIR instance structure.
+ * \param in The input samples.
+ * \param out The output samples, 2 * n of them.
+ * \param n The number of input samples.
+ */
+void fir_halfband_interpolate_q31(fir_halfband_instance_q31 *S, const q31_t *in, q31_t *out,
+                                  uint32_t n);
+
+
+//! The highest CIC filter order supported.
+#define CIC_MAX_ORDER 5
+
+/**
+ * \brief CIC (sinc^N) decimator instance structure for 1-bit sigma-delta bitstreams.
+ *
+ * The input is packed 64 samples to a uint64_t word, a 1 bit is +1 and a 0 bit is -1.
+ * The filter has N integrators at the input rate and N combs at the output rate, with a
+ * gain of R^N.  Whole bytes of input are integrated with one table lookup and a few
+ * multiply-adds, and an order 1 filter integrates whole words with a popcount, so the
+ * input doesn't have to be unpacked.  The integrators wrap, which is harmless because
+ * \ref cic_decimate_init keeps R^N below 2^62.
+ */
+typedef struct {
+    uint16_t order;                 //!< N, 1 to \ref CIC_MAX_ORDER.
+    uint16_t R;                     //!< The decimation factor, at least 1, R^N < 2^62.
+    uint16_t phase;                 //!< Input samples since the last output.
+    uint16_t bits;                  //!< The output full scale is 2^bits >= R^N.
+    uint16_t msbFirst;              //!< True if the first sample is bit 63 of each word.
+    uint64_t gain;                  //!< R^N.
+    uint64_t integ[CIC_MAX_ORDER];  //!< The integrators.
+    uint64_t comb[CIC_MAX_ORDER];   //!< The comb delays.
+} cic_decimate_instance;
+
+
+/**
+ * \brief Initializes a CIC decimator instance structure.
+ *
+ * Also clears the state.  This is not thread safe, it fills a shared table on first use.
+ *
+ * \param S Pointer to the CIC decimator instance structure.
+ * \param order The filter order N, 1 to \ref CIC_MAX_ORDER.  Values outside are clamped.
+ * \param R The decimation factor, at least 1.  0 is taken as 1, and a factor with R^N
+ * of 2^62 or more is lowered to the largest one below, 46340 for order 4 and 5404 for
+ * order 5.
+ * \param msbFirst True if the first sample of each word is bit 63, false if it is bit 0.
+ */
+void cic_decimate_init(cic_decimate_instance *S, uint16_t order, uint16_t R, int32_t msbFirst);
+
+
+/**
+ * \brief Filters and decimates a block of bitstream words to q31_t.
+ *
+ * The output is the filter output over 2^bits, so a stream of all ones gives 1.0
+ * (saturated to the largest q31_t) when R is a power of two, and slightly less otherwise.
+ * R doesn't have to divide 64, the phase carries over to the next call.
+ *
+ * \param S Pointer to the CIC decimator instance structure.
+ * \param in The input words.
+ * \param out The output samples, room for 64 * n / R + 1 of them.
+ * \param n The number of input words.
+ * \return The number of output samples written.
+ */
+uint32_t cic_decimate_q31(cic_decimate_instance *S, const uint64_t *in, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Filters and decimates a block of bitstream words to int16_t.
+ *
+ * Same as \ref cic_decimate_q31, scaled to a 16-bit signed ADC count.  The result can go
+ * straight into \ref adc_process_sample_i16_q31.
+ *
+ * \param S Pointer to the CIC decimator instance structure.
+ * \param in The input words.
+ * \param out The output samples, room for 64 * n / R + 1 of them.
+ * \param n The number of input words.
+ * \return The number of output samples written.
+ */
+uint32_t cic_decimate_i16(cic_decimate_instance *S, const uint64_t *in, int16_t *out, uint32_t n);
+
+
+
+/**
+ * \brief Goertzel filter bank data structure.
+ *
+ * Evaluates K single DFT bins on each of M channels over a block of samples, with q31_t
+ * state and the 2 cos(w) s[n - 1] product worked out in 64 bits.  The state for bin k of
+ * channel m is at [k * M + m], so the channels of one bin go through the vector kernels
+ * side by side.  The bin frequencies don't have to be on the DFT grid.
+ *
+ * The state sums wrap, so the input is shifted right by sh first.  A full scale input at
+ * frequency w grows the state to about L / sin(w) times full scale after L samples (L * L
+ * near DC and Nyquist), and sh has to leave room for that.  Define it with
+ * \ref GOERTZEL_BANK_Q31_DEFINE and set it up with \ref goertzel_bank_init_q31.
+ */
+typedef struct {
+    uint32_t M;         //!< The number of channels.
+    uint16_t K;         //!< The number of bins.
+    uint16_t sh;        //!< The input shift for headroom.
+    q31_t *pCos;        //!< cos(w) of each bin in Q30.
+    q31_t *pSin;        //!< sin(w) of each bin in Q30.
+    q31_t *pS1;         //!< s[n - 1], pS1[bin * M + channel].
+    q31_t *pS2;         //!< s[n - 2], pS2[bin * M + channel].
+} goertzel_bank_instance_q31;
+
+
+/**
+ * \brief Defines a Goertzel bank named name with CH channels, K bins and an input shift of SH.
+ */
+#define GOERTZEL_BANK_Q31_DEFINE(name, CH, K, SH)                                   \
+    static q31_t name##_cos[K];                                                     \
+    static q31_t name##_sin[K];                                                     \
+    static q31_t name##_s1[(K) * (CH)] RT_DSP_ALIGNED(64);                          \
+    static q31_t name##_s2[(K) * (CH)] RT_DSP_ALIGNED(64);                          \
+    goertzel_bank_instance_q31 name = { (CH), (K), (SH), name##_cos, name##_sin,   \
+                                        name##_s1, name##_s2 }
+
+
+/**
+ * \brief Initializes a Goertzel bank and clears its state.
+ *
+ * The frequency of each bin is given as a phase step, 2^32 per cycle, so bin k of an
+ * N point DFT is k * 2^32 / N and harmonic h of f0 is h * f0 / fs * 2^32.
+ *
+ * \param S Pointer to the Goertzel bank instance structure.
+ * \param phase The phase step of each bin.
+ */
+void goertzel_bank_init_q31(goertzel_bank_instance_q31 *S, const uint32_t *phase);
+
+
+/**
+ * \brief Runs a block of frames through a Goertzel bank.
+ *
+ * Can be called any number of times before \ref goertzel_bank_result_q31.
+ *
+ * \param S Pointer to the Goertzel bank instance structure.
+ * \param in nFrames frames of M samples, in[frame * M + channel].
+ * \param nFrames The number of frames.
+ */
+void goertzel_bank_q31(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+
+
+/**
+ * \brief Reads out the bins of a Goertzel bank and clears its state.
+ *
+ * Each result is the DFT sum of the samples since the last read out, divided by 2^sh, with
+ * the phase taken at the last sample.  A sine of amplitude A over L samples on a bin gives
+ * a magnitude of A * L / 2^(sh + 1).  The results saturate.
+ *
+ * \param S Pointer to the Goertzel bank instance structure.
+ * \param re The real parts, re[bin * M + channel].
+ * \param im The imaginary parts, im[bin * M + channel].
+ */
+void goertzel_bank_result_q31(goertzel_bank_instance_q31 *S, q31_t *re, q31_t *im);
+
+
+/**
+ * \brief Sliding DFT bank data structure.
+ *
+ * Keeps K bins of an N point DFT over the last N frames of M channels, updated every
+ * frame.  Rather than rotating the bins every sample, which lets the rounding errors
+ * build up, each bin holds the sum of x[n] * W^(-kn) with the twiddle index k * n mod N.
+ * The term a sample adds when it comes in is the same one it takes away N frames later,
+ * so the 64-bit sums stay exact for ever and the rotation is done once at read out.
+ * Define it with \ref SDFT_BANK_Q31_DEFINE and set it up with \ref sdft_bank_init_q31.
+ */
+typedef struct {
+    uint32_t M;         //!< The number of channels.
+    uint16_t N;         //!< The DFT length, 1 to 65535.
+    uint16_t K;         //!< The number of bins.
+    uint16_t idx;       //!< Slot of the oldest frame in pState, also the frame count mod N.
+    uint16_t l;         //!< Reciprocal shift of N, see \ref filter_boxcar_div.
+    uint64_t magic;     //!< Reciprocal of N.
+    uint16_t *pBin;     //!< The bin numbers, 0 to N - 1.
+    uint16_t *pPhase;   //!< Twiddle index of each bin for the next frame, bin * idx mod N.
+    q31_t *pCos;        //!< cos(2 pi i / N) in Q30, N entries.
+    q31_t *pSin;        //!< sin(2 pi i / N) in Q30, N entries.
+    q31_t *pState;      //!< N frames of M samples, pState[slot * M + channel].
+    acc64_t *pRe;       //!< Real parts of the sums, pRe[bin * M + channel].
+    acc64_t *pIm;       //!< Imaginary parts of the sums, pIm[bin * M + channel].
+} sdft_bank_instance_q31;
+
+
+/**
+ * \brief Defines a sliding DFT bank named name with CH channels, length N and K bins.
+ */
+#define SDFT_BANK_Q31_DEFINE(name, CH, N, K)                                        \
+    static uint16_t name##_bin[K];                                                  \
+    static uint16_t name##_phase[K];                                                \
+    static q31_t name##_cos[N];                                                     \
+    static q31_t name##_sin[N];                                                     \
+    static q31_t name##_state[(N) * (CH)] RT_DSP_ALIGNED(64);                       \
+    static acc64_t name##_re[(K) * (CH)] RT_DSP_ALIGNED(64);                        \
+    static acc64_t name##_im[(K) * (CH)] RT_DSP_ALIGNED(64);                        \
+    sdft_bank_instance_q31 name = { (CH), (N), (K), 0, 0, 0, name##_bin, name##_phase, \
+                                    name##_cos, name##_sin, name##_state, name##_re, name##_im }
+
+
+/**
+ * \brief Initializes a sliding DFT bank with an all zero window.
+ *
+ * \param S Pointer to the sliding DFT bank instance structure.
+ * \param bins The K bin numbers, 0 to N - 1.
+ */
+void sdft_bank_init_q31(sdft_bank_instance_q31 *S, const uint16_t *bins);
+
+
+/**
+ * \brief Slides a sliding DFT bank over a block of frames.
+ *
+ * \param S Pointer to the sliding DFT bank instance structure.
+ * \param in nFrames frames of M samples, in[frame * M + channel].
+ * \param nFrames The number of frames, any number.
+ */
+void sdft_bank_q31(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+
+
+/**
+ * \brief Reads out the bins of a sliding DFT bank.
+ *
+ * Each result is the DFT of the last N frames divided by N, with the oldest frame as
+ * sample 0.  A sine of amplitude A on a bin other than 0 or N / 2 gives a magnitude of A / 2.
+ *
+ * \param S Pointer to the sliding DFT bank instance structure.
+ * \param re The real parts, re[bin * M + channel].
+ * \param im The imaginary parts, im[bin * M + channel].
+ */
+void sdft_bank_result_q31(const sdft_bank_instance_q31 *S, q31_t *re, q31_t *im);
+
+
+
 
 #endif /* ARM_RT_DSP_FILTER_ */
\ No newline at end of file
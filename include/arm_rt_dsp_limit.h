@@ -231,6 +231,336 @@ static inline q31_t min_q31(q31_t x, q31_t y) {
     }
 }
 
+
+/**
+ * \brief Median of three for Q15 format.
+ *
+ * Written with min and max only so it compiles to compares and conditional moves,
+ * no branches.
+ *
+ * \param a First value.
+ * \param b Second value.
+ * \param c Third value.
+ * \return The median of a, b and c.
+ */
+static inline q15_t median3_q15(q15_t a, q15_t b, q15_t c) {
+    q15_t lo = (a < b) ? a : b;
+    q15_t hi = (a < b) ? b : a;
+    hi = (hi < c) ? hi : c;
+    return (lo > hi) ? lo : hi;
+}
+
+
+/**
+ * \brief Median of three for Q31 format.
+ *
+ * \param a First value.
+ * \param b Second value.
+ * \param c Third value.
+ * \return The median of a, b and c.
+ */
+static inline q31_t median3_q31(q31_t a, q31_t b, q31_t c) {
+    q31_t lo = (a < b) ? a : b;
+    q31_t hi = (a < b) ? b : a;
+    hi = (hi < c) ? hi : c;
+    return (lo > hi) ? lo : hi;
+}
+
+
+/**
+ * \brief Median of five for Q15 format.
+ *
+ * The larger of the two pair minimums and the smaller of the two pair maximums bracket
+ * the median of a to d, so the median of all five is the median of those two and e.
+ * Six compares, no branches.
+ *
+ * \param a First value.
+ * \param b Second value.
+ * \param c Third value.
+ * \param d Fourth value.
+ * \param e Fifth value.
+ * \return The median of the five values.
+ */
+static inline q15_t median5_q15(q15_t a, q15_t b, q15_t c, q15_t d, q15_t e) {
+    q15_t ab_lo = (a < b) ? a : b;
+    q15_t ab_hi = (a < b) ? b : a;
+    q15_t cd_lo = (c < d) ? c : d;
+    q15_t cd_hi = (c < d) ? d : c;
+    return median3_q15((ab_lo > cd_lo) ? ab_lo : cd_lo, (ab_hi < cd_hi) ? ab_hi : cd_hi, e);
+}
+
+
+/**
+ * \brief Median of five for Q31 format.
+ *
+ * \param a First value.
+ * \param b Second value.
+ * \param c Third value.
+ * \param d Fourth value.
+ * \param e Fifth value.
+ * \return The median of the five values.
+ */
+static inline q31_t median5_q31(q31_t a, q31_t b, q31_t c, q31_t d, q31_t e) {
+    q31_t ab_lo = (a < b) ? a : b;
+    q31_t ab_hi = (a < b) ? b : a;
+    q31_t cd_lo = (c < d) ? c : d;
+    q31_t cd_hi = (c < d) ? d : c;
+    return median3_q31((ab_lo > cd_lo) ? ab_lo : cd_lo, (ab_hi < cd_hi) ? ab_hi : cd_hi, e);
+}
+
+
+/**
+ * \brief Limits every element of an array to the supplied upper and lower limits.
+ *
+ * Each output is exactly \ref limit_q31 of its input.  The output array may be the
+ * input array.  The counts are worked out in the same pass from the compare masks.
+ *
+ * \param x Input values to be limited.
+ * \param llim Lower limit to be applied.
+ * \param ulim Upper limit to be applied.
+ * \param out Limited values.
+ * \param n Number of elements.
+ * \param nUpper If not NULL, receives the number of inputs above ulim.
+ * \param nLower If not NULL, receives the number of inputs, after the upper limit,
+ * below llim.
+ */
+void limit_q31_block(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n,
+                     uint32_t *nUpper, uint32_t *nLower);
+
+
+/**
+ * \brief Limits every element of an array to the supplied upper limit.
+ *
+ * Each output is exactly \ref upper_limit_q31 of its input, see \ref limit_q31_block.
+ *
+ * \param x Input values to be limited.
+ * \param ulim Upper limit to be applied.
+ * \param out Limited values.
+ * \param n Number of elements.
+ * \param nUpper If not NULL, receives the number of inputs above ulim.
+ */
+void upper_limit_q31_block(const q31_t *x, q31_t ulim, q31_t *out, uint32_t n, uint32_t *nUpper);
+
+
+/**
+ * \brief Limits every element of an array to the supplied lower limit.
+ *
+ * Each output is exactly \ref lower_limit_q31 of its input, see \ref limit_q31_block.
+ *
+ * \param x Input values to be limited.
+ * \param llim Lower limit to be applied.
+ * \param out Limited values.
+ * \param n Number of elements.
+ * \param nLower If not NULL, receives the number of inputs below llim.
+ */
+void lower_limit_q31_block(const q31_t *x, q31_t llim, q31_t *out, uint32_t n, uint32_t *nLower);
+
+
+/**
+ * \brief Limits every element of an array to the supplied upper and lower limits.
+ *
+ * Each output is exactly \ref limit_i16 of its input, see \ref limit_q31_block.
+ *
+ * \param x Input values to be limited.
+ * \param llim Lower limit to be applied.
+ * \param ulim Upper limit to be applied.
+ * \param out Limited values.
+ * \param n Number of elements.
+ * \param nUpper If not NULL, receives the number of inputs above ulim.
+ * \param nLower If not NULL, receives the number of inputs, after the upper limit,
+ * below llim.
+ */
+void limit_i16_block(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out, uint32_t n,
+                     uint32_t *nUpper, uint32_t *nLower);
+
+
+/**
+ * \brief Limits every element of an array to the supplied upper and lower limits.
+ *
+ * Each output is exactly \ref limit_u16 of its input, see \ref limit_q31_block.
+ *
+ * \param x Input values to be limited.
+ * \param llim Lower limit to be applied.
+ * \param ulim Upper limit to be applied.
+ * \param out Limited values.
+ * \param n Number of elements.
+ * \param nUpper If not NULL, receives the number of inputs above ulim.
+ * \param nLower If not NULL, receives the number of inputs, after the upper limit,
+ * below llim.
+ */
+void limit_u16_block(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out, uint32_t n,
+                     uint32_t *nUpper, uint32_t *nLower);
+
+
+/**
+ * \brief Limits every element of an array to the supplied upper and lower limits.
+ *
+ * Each output is exactly \ref limit_f32 of its input, see \ref limit_q31_block.  Like
+ * the scalar function a NaN input is passed through and not counted.
+ *
+ * \param x Input values to be limited.
+ * \param llim Lower limit to be applied.
+ * \param ulim Upper limit to be applied.
+ * \param out Limited values.
+ * \param n Number of elements.
+ * \param nUpper If not NULL, receives the number of inputs above ulim.
+ * \param nLower If not NULL, receives the number of inputs, after the upper limit,
+ * below llim.
+ */
+void limit_f32_block(const float *x, float llim, float ulim, float *out, uint32_t n,
+                     uint32_t *nUpper, uint32_t *nLower);
+
+
+/**
+ * \brief Result of a min and max search over an array.
+ *
+ * The values are widened to int32_t for every element type.  Ties report the first
+ * index.
+ */
+typedef struct {
+    int32_t min;        //!< The smallest element.
+    int32_t max;        //!< The largest element.
+    uint32_t argmin;    //!< Index of the first smallest element.
+    uint32_t argmax;    //!< Index of the first largest element.
+} minmax_result_t;
+
+
+/**
+ * \brief Finds the min and max of an array of Q31s and their indexes in one pass.
+ *
+ * The array is read once for all four results.  With n of 0 the min is INT32_MAX, the
+ * max INT32_MIN and both indexes 0.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \param r Receives the result.
+ */
+void minmax_q31_block(const q31_t *x, uint32_t n, minmax_result_t *r);
+
+
+/**
+ * \brief Finds the min and max of an array of Q15s, see \ref minmax_q31_block.
+ *
+ * With n of 0 the min is INT16_MAX, the max INT16_MIN and both indexes 0.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \param r Receives the result.
+ */
+void minmax_q15_block(const q15_t *x, uint32_t n, minmax_result_t *r);
+
+
+/**
+ * \brief Finds the min and max of an array of int16_t, see \ref minmax_q31_block.
+ *
+ * With n of 0 the min is INT16_MAX, the max INT16_MIN and both indexes 0.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \param r Receives the result.
+ */
+void minmax_i16_block(const int16_t *x, uint32_t n, minmax_result_t *r);
+
+
+/**
+ * \brief Finds the min and max of an array of uint16_t, see \ref minmax_q31_block.
+ *
+ * With n of 0 the min is UINT16_MAX, the max 0 and both indexes 0.
+ *
+ * \param x The input array.
+ * \param n The number of elements.
+ * \param r Receives the result.
+ */
+void minmax_u16_block(const uint16_t *x, uint32_t n, minmax_result_t *r);
+
+
+/**
+ * \brief Finds the smallest element of an array of Q31s, see \ref minmax_q31_block.
+ *
+ * \param x The input array, at least one element.
+ * \param n The number of elements.
+ * \param argmin If not NULL, receives the index of the first smallest element.
+ * \return The smallest element.
+ */
+q31_t min_q31_block(const q31_t *x, uint32_t n, uint32_t *argmin);
+
+
+/**
+ * \brief Finds the largest element of an array of Q31s, see \ref minmax_q31_block.
+ *
+ * \param x The input array, at least one element.
+ * \param n The number of elements.
+ * \param argmax If not NULL, receives the index of the first largest element.
+ * \return The largest element.
+ */
+q31_t max_q31_block(const q31_t *x, uint32_t n, uint32_t *argmax);
+
+
+/**
+ * \brief Finds the smallest element of an array of Q15s, see \ref minmax_q15_block.
+ *
+ * \param x The input array, at least one element.
+ * \param n The number of elements.
+ * \param argmin If not NULL, receives the index of the first smallest element.
+ * \return The smallest element.
+ */
+q15_t min_q15_block(const q15_t *x, uint32_t n, uint32_t *argmin);
+
+
+/**
+ * \brief Finds the largest element of an array of Q15s, see \ref minmax_q15_block.
+ *
+ * \param x The input array, at least one element.
+ * \param n The number of elements.
+ * \param argmax If not NULL, receives the index of the first largest element.
+ * \return The largest element.
+ */
+q15_t max_q15_block(const q15_t *x, uint32_t n, uint32_t *argmax);
+
+
+/**
+ * \brief Finds the smallest element of an array of int16_t, see \ref minmax_i16_block.
+ *
+ * \param x The input array, at least one element.
+ * \param n The number of elements.
+ * \param argmin If not NULL, receives the index of the first smallest element.
+ * \return The smallest element.
+ */
+int16_t min_i16_block(const int16_t *x, uint32_t n, uint32_t *argmin);
+
+
+/**
+ * \brief Finds the largest element of an array of int16_t, see \ref minmax_i16_block.
+ *
+ * \param x The input array, at least one element.
+ * \param n The number of elements.
+ * \param argmax If not NULL, receives the index of the first largest element.
+ * \return The largest element.
+ */
+int16_t max_i16_block(const int16_t *x, uint32_t n, uint32_t *argmax);
+
+
+/**
+ * \brief Finds the smallest element of an array of uint16_t, see \ref minmax_u16_block.
+ *
+ * \param x The input array, at least one element.
+ * \param n The number of elements.
+ * \param argmin If not NULL, receives the index of the first smallest element.
+ * \return The smallest element.
+ */
+uint16_t min_u16_block(const uint16_t *x, uint32_t n, uint32_t *argmin);
+
+
+/**
+ * \brief Finds the largest element of an array of uint16_t, see \ref minmax_u16_block.
+ *
+ * \param x The input array, at least one element.
+ * \param n The number of elements.
+ * \param argmax If not NULL, receives the index of the first largest element.
+ * \return The largest element.
+ */
+uint16_t max_u16_block(const uint16_t *x, uint32_t n, uint32_t *argmax);
+
 /**
  * @}
 */
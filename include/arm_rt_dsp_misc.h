@@ -91,6 +91,189 @@ static inline q31_t adc_process_sample_i16_q31(int16_t x, int16_t offset, q31_t
 }
 
 
+/**
+ * \brief Per channel ADC calibration table for the Q15 block conversion.
+ *
+ * Stored as a structure of arrays so the vector kernels can broadcast a channel's
+ * offset and slope.  Define it with \ref ADC_CAL_TABLE_Q15_DEFINE, or point the members
+ * at your own arrays.
+ */
+typedef struct {
+    uint32_t M;         //!< The number of channels in a scan.
+    int16_t *pOffset;   //!< Offset of each channel in counts.
+    q15_t *pSlope;      //!< Slope of each channel.
+} adc_cal_table_q15;
+
+
+/**
+ * \brief Per channel ADC calibration table for the Q31 block conversions.
+ *
+ * See \ref adc_cal_table_q15.  Define it with \ref ADC_CAL_TABLE_Q31_DEFINE.
+ */
+typedef struct {
+    uint32_t M;         //!< The number of channels in a scan.
+    int16_t *pOffset;   //!< Offset of each channel in counts.
+    q31_t *pSlope;      //!< Slope of each channel.
+} adc_cal_table_q31;
+
+
+/**
+ * \brief Defines a Q15 ADC calibration table named name with CH channels.
+ */
+#define ADC_CAL_TABLE_Q15_DEFINE(name, CH)                                          \
+    static int16_t name##_offset[CH] RT_DSP_ALIGNED(64);                            \
+    static q15_t name##_slope[CH] RT_DSP_ALIGNED(64);                               \
+    adc_cal_table_q15 name = { (CH), name##_offset, name##_slope }
+
+
+/**
+ * \brief Defines a Q31 ADC calibration table named name with CH channels.
+ */
+#define ADC_CAL_TABLE_Q31_DEFINE(name, CH)                                          \
+    static int16_t name##_offset[CH] RT_DSP_ALIGNED(64);                            \
+    static q31_t name##_slope[CH] RT_DSP_ALIGNED(64);                               \
+    adc_cal_table_q31 name = { (CH), name##_offset, name##_slope }
+
+
+/**
+ * \brief Converts a block of interleaved ADC scans to Q15, channel by channel.
+ *
+ * raw holds nScans scans of M channels as a DMA scan sequence writes them,
+ * raw[scan * M + channel].  The output is channel-major, out[channel * nScans + scan], and
+ * each output is exactly \ref adc_process_sample_q15 of its raw value with the channel's
+ * offset and slope.  Outputs that saturate are counted in the Q flag just the same.
+ *
+ * \param T Pointer to the calibration table.
+ * \param raw The interleaved raw values, right justified 12-bit.
+ * \param nScans The number of scans.
+ * \param out The converted values, M * nScans of them.
+ */
+void adc_process_block_q15(const adc_cal_table_q15 *T, const uint16_t *raw, uint32_t nScans,
+                           q15_t *out);
+
+
+/**
+ * \brief Converts a block of interleaved mid-rail ADC scans to Q31, channel by channel.
+ *
+ * Same layout as \ref adc_process_block_q15, each output is exactly
+ * \ref adc_process_sample_q31.
+ *
+ * \param T Pointer to the calibration table.
+ * \param raw The interleaved raw values, right justified 12-bit.
+ * \param nScans The number of scans.
+ * \param out The converted values, M * nScans of them.
+ */
+void adc_process_block_q31(const adc_cal_table_q31 *T, const uint16_t *raw, uint32_t nScans,
+                           q31_t *out);
+
+
+/**
+ * \brief Converts a block of interleaved 0V referenced ADC scans to Q31, channel by channel.
+ *
+ * Same layout as \ref adc_process_block_q15, each output is exactly
+ * \ref adc_process_sample_u_q31.
+ *
+ * \param T Pointer to the calibration table.
+ * \param raw The interleaved raw values, right justified 12-bit.
+ * \param nScans The number of scans.
+ * \param out The converted values, M * nScans of them.
+ */
+void adc_process_block_u_q31(const adc_cal_table_q31 *T, const uint16_t *raw, uint32_t nScans,
+                             q31_t *out);
+
+
+/**
+ * \brief Converts a block of interleaved signed ADC scans to Q31, channel by channel.
+ *
+ * Same layout as \ref adc_process_block_q15, each output is exactly
+ * \ref adc_process_sample_i16_q31.
+ *
+ * \param T Pointer to the calibration table.
+ * \param raw The interleaved raw values.
+ * \param nScans The number of scans.
+ * \param out The converted values, M * nScans of them.
+ */
+void adc_process_block_i16_q31(const adc_cal_table_q31 *T, const int16_t *raw, uint32_t nScans,
+                               q31_t *out);
+
+
+/**
+ * \brief Left shift that drops the unused low bits of a justified raw value.
+ *
+ * r is for right justified raw values, where nothing is dropped, and l for left justified
+ * ones, where the BITS bits of the result sit at the top of the 16-bit word.
+ */
+#define ADC_JUST_r(BITS) 0
+#define ADC_JUST_l(BITS) (16 - (BITS))
+
+
+/**
+ * \brief Offsets and scales a justified raw ADC value before the slope is applied.
+ *
+ * The unused low bits of the raw value are cleared, the offset in counts is moved up to
+ * line up with the raw value and the difference is shifted up by shift.  The arithmetic
+ * wraps, like the << of the 12-bit conversions.
+ *
+ * \param x The raw ADC value.
+ * \param offset The offset in counts.
+ * \param lj The justification shift, see \ref ADC_JUST_l.
+ * \param shift The remaining left shift.
+ * \return (x >> lj - offset) << (lj + shift), without the bits below lj.
+ */
+static inline q31_t adc_scale_raw(uint16_t x, int16_t offset, uint32_t lj, uint32_t shift) {
+    return (q31_t)(((x & (0xFFFFU << lj)) - ((uint32_t)(q31_t)offset << lj)) << shift);
+}
+
+
+/**
+ * \brief Generates the ADC conversions for a BITS-bit converter with justification J.
+ *
+ * J is r for right justified raw values and l for left justified ones.  For BITS = 12 and
+ * J = r it generates
+ *
+ * - adc_process_sample_q15_12r, adc_process_sample_q31_12r and
+ *   adc_process_sample_u_q31_12r, the scalar conversions with the arguments of
+ *   \ref adc_process_sample_q15 and the like,
+ * - adc_process_block_q15_12r, adc_process_block_q31_12r and adc_process_block_u_q31_12r,
+ *   the block conversions with the arguments of \ref adc_process_block_q15.
+ *
+ * All shifts are constants.  The 12r routines are bit-exact with the unsuffixed 12-bit
+ * ones.  The library defines 10, 12, 14 and 16 bits in both justifications, the block
+ * forms are in arm_rt_dsp_adc.c.
+ */
+#define ADC_CONVERSION_DEFINE(BITS, J)                                                      \
+    static inline q15_t adc_process_sample_q15_##BITS##J(uint16_t x, int16_t offset,      \
+                                                           q15_t slope) {                 \
+        return mulsat_q15((q15_t)adc_scale_raw(x, offset, ADC_JUST_##J(BITS),             \
+                                               16 - (BITS) - ADC_JUST_##J(BITS)), slope); \
+    }                                                                                     \
+    static inline q31_t adc_process_sample_q31_##BITS##J(uint16_t x, int16_t offset,      \
+                                                           q31_t slope) {                 \
+        return mulsat_q31(adc_scale_raw(x, offset, ADC_JUST_##J(BITS),                    \
+                                        32 - (BITS) - ADC_JUST_##J(BITS)), slope);        \
+    }                                                                                     \
+    static inline q31_t adc_process_sample_u_q31_##BITS##J(uint16_t x, int16_t offset,    \
+                                                             q31_t slope) {               \
+        return mulsat_q31(adc_scale_raw(x, offset, ADC_JUST_##J(BITS),                    \
+                                        31 - (BITS) - ADC_JUST_##J(BITS)), slope);        \
+    }                                                                                     \
+    void adc_process_block_q15_##BITS##J(const adc_cal_table_q15 *T, const uint16_t *raw,  \
+                                         uint32_t nScans, q15_t *out);                    \
+    void adc_process_block_q31_##BITS##J(const adc_cal_table_q31 *T, const uint16_t *raw,  \
+                                         uint32_t nScans, q31_t *out);                    \
+    void adc_process_block_u_q31_##BITS##J(const adc_cal_table_q31 *T, const uint16_t *raw,\
+                                           uint32_t nScans, q31_t *out)
+
+ADC_CONVERSION_DEFINE(10, r);
+ADC_CONVERSION_DEFINE(10, l);
+ADC_CONVERSION_DEFINE(12, r);
+ADC_CONVERSION_DEFINE(12, l);
+ADC_CONVERSION_DEFINE(14, r);
+ADC_CONVERSION_DEFINE(14, l);
+ADC_CONVERSION_DEFINE(16, r);
+ADC_CONVERSION_DEFINE(16, l);
+
+
 /**
  * \brief Converts a value from 1.31 fixed point format, q31_t, to an int16_t with an applied scaling factor and rounding.
  *
@@ -183,6 +366,97 @@ static inline int32_t convert_q31_to_i32(q31_t x, uint32_t scale) {
 }
 
 
+/**
+ * \brief Rounding of the block conversions from q31_t to integers.
+ */
+typedef enum {
+    CONVERT_TRUNC = 0,          //!< Drop the fraction, toward -inf like convert_q31_to_i16.
+    CONVERT_ROUND_HALF_UP,      //!< Half rounds toward +inf like convert_round_q31_to_i16.
+    CONVERT_ROUND_HALF_EVEN,    //!< Half rounds to the even integer.
+} convert_round_t;
+
+
+/**
+ * \brief Scales a q31_t to an integer with the given rounding, without narrowing.
+ *
+ * The result is in 33 bits for every x and scale, the block conversions saturate it.
+ *
+ * \param x Input value to be converted
+ * \param scale Scaling value to be applied.
+ * \param mode Rounding of the fraction.
+ * \return The scaled and rounded value.
+ */
+static inline int64_t convert_q31_scale(q31_t x, uint32_t scale, convert_round_t mode) {
+    q63_t p = (q63_t)x * scale;
+    if (mode == CONVERT_ROUND_HALF_UP) {
+        p += (q63_t)1 << 30;
+    } else if (mode == CONVERT_ROUND_HALF_EVEN) {
+        // One less than half, plus one when the integer part is odd.
+        p += ((q63_t)1 << 30) - 1 + ((p >> 31) & 1);
+    }
+    return p >> 31;
+}
+
+
+/**
+ * \brief Converts an array of q31_t to int16_t with per element scales, saturating.
+ *
+ * With CONVERT_TRUNC and CONVERT_ROUND_HALF_UP every in range result is the same as
+ * \ref convert_q31_to_i16 and \ref convert_round_q31_to_i16.
+ *
+ * \param x Input values.
+ * \param scale Scaling value of each element.
+ * \param mode Rounding of the fraction.
+ * \param out Converted values.
+ * \param n Number of elements.
+ */
+void convert_q31_to_i16_block(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                              int16_t *out, uint32_t n);
+
+
+/**
+ * \brief Converts an array of q31_t to uint16_t with per element scales, saturating.
+ *
+ * Negative results give 0.
+ *
+ * \param x Input values.
+ * \param scale Scaling value of each element.
+ * \param mode Rounding of the fraction.
+ * \param out Converted values.
+ * \param n Number of elements.
+ */
+void convert_q31_to_u16_block(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                              uint16_t *out, uint32_t n);
+
+
+/**
+ * \brief Converts an array of q31_t to uint32_t with per element scales, saturating.
+ *
+ * Negative results give 0.
+ *
+ * \param x Input values.
+ * \param scale Scaling value of each element.
+ * \param mode Rounding of the fraction.
+ * \param out Converted values.
+ * \param n Number of elements.
+ */
+void convert_q31_to_u32_block(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                              uint32_t *out, uint32_t n);
+
+
+/**
+ * \brief Converts an array of q31_t to int32_t with per element scales, saturating.
+ *
+ * \param x Input values.
+ * \param scale Scaling value of each element.
+ * \param mode Rounding of the fraction.
+ * \param out Converted values, may be the same array as x.
+ * \param n Number of elements.
+ */
+void convert_q31_to_i32_block(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                              int32_t *out, uint32_t n);
+
+
 /**
   \brief Convert a uint16_t to a q31_t.
   \param x Value to convert.
@@ -222,6 +496,127 @@ static inline q31_t convert_i32_to_q31(int32_t x, int32_t scale) {
 }
 
 
+/**
+ * \brief Precomputed reciprocal of a scale for the convert_*_to_q31 functions.
+ *
+ * Built once per scale by \ref convert_recip_init.  The conversions with it are a few
+ * 32x32->64 multiplies and one correction step instead of a 64-bit division, and match
+ * the division exactly.
+ */
+typedef struct {
+    uint32_t recHi;     //!< High word of floor(2^63 / |scale|).
+    uint32_t recLo;     //!< Low word of floor(2^63 / |scale|).
+    uint32_t d;         //!< |scale|.
+    uint32_t neg;       //!< 1 if the scale is negative.
+} convert_recip_t;
+
+
+/**
+ * \brief Builds the reciprocal of a scale.
+ *
+ * \param scale The scale the conversions divide by, not 0.
+ * \param R The reciprocal.
+ */
+void convert_recip_init(int32_t scale, convert_recip_t *R);
+
+
+/**
+ * \brief floor(ax * 2^31 / |scale|) from the reciprocal.
+ *
+ * The estimate (ax * rec) >> 32 is low by at most one because ax < 2^32, so one
+ * compare of the remainder fixes it.  The remainder is below 2 * |scale|, so it comes
+ * out exact even though the products wrap.
+ *
+ * \param ax The magnitude of the value to convert.
+ * \param R The reciprocal.
+ * \return The quotient.
+ */
+static inline uint64_t convert_recip_div(uint32_t ax, const convert_recip_t *R) {
+    uint64_t q = (uint64_t)ax * R->recHi + (((uint64_t)ax * R->recLo) >> 32);
+    uint64_t r = ((uint64_t)ax << 31) - q * R->d;
+    return q + (r >= R->d);
+}
+
+
+/**
+ * \brief Converts a uint16_t to a q31_t with a precomputed scale.
+ *
+ * Same result as \ref convert_u16_to_q31, which gives 0 for every negative scale.
+ *
+ * \param x Value to convert.
+ * \param R Reciprocal of the scale.
+ * \return Converted value.
+ */
+static inline q31_t convert_u16_to_q31_recip(uint16_t x, const convert_recip_t *R) {
+    return R->neg ? 0 : (q31_t)(uint32_t)convert_recip_div(x, R);
+}
+
+
+/**
+ * \brief Converts an int16_t to a q31_t with a precomputed scale.
+ *
+ * Same result as \ref convert_i16_to_q31.
+ *
+ * \param x Value to convert.
+ * \param R Reciprocal of the scale.
+ * \return Converted value.
+ */
+static inline q31_t convert_i16_to_q31_recip(int16_t x, const convert_recip_t *R) {
+    uint32_t q = (uint32_t)convert_recip_div((x < 0) ? (uint32_t)-x : (uint32_t)x, R);
+    return (q31_t)(((x < 0) ^ R->neg) ? 0U - q : q);
+}
+
+
+/**
+ * \brief Converts an int32_t to a q31_t with a precomputed scale.
+ *
+ * Same result as \ref convert_i32_to_q31, including the wrap when |x| > |scale|.
+ *
+ * \param x Value to convert.
+ * \param R Reciprocal of the scale.
+ * \return Converted value.
+ */
+static inline q31_t convert_i32_to_q31_recip(int32_t x, const convert_recip_t *R) {
+    uint32_t q = (uint32_t)convert_recip_div((x < 0) ? 0U - (uint32_t)x : (uint32_t)x, R);
+    return (q31_t)((((uint32_t)x >> 31) ^ R->neg) ? 0U - q : q);
+}
+
+
+/**
+ * \brief Converts an array of uint16_t to q31_t, see \ref convert_u16_to_q31_recip.
+ *
+ * \param x Values to convert.
+ * \param R Reciprocal of the scale.
+ * \param out Converted values.
+ * \param n Number of elements.
+ */
+void convert_u16_to_q31_block(const uint16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Converts an array of int16_t to q31_t, see \ref convert_i16_to_q31_recip.
+ *
+ * \param x Values to convert.
+ * \param R Reciprocal of the scale.
+ * \param out Converted values.
+ * \param n Number of elements.
+ */
+void convert_i16_to_q31_block(const int16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Converts an array of int32_t to q31_t, see \ref convert_i32_to_q31_recip.
+ *
+ * The output array may be the same as the input array.
+ *
+ * \param x Values to convert.
+ * \param R Reciprocal of the scale.
+ * \param out Converted values.
+ * \param n Number of elements.
+ */
+void convert_i32_to_q31_block(const int32_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+
+
 
 
 /**
@@ -302,6 +697,107 @@ static inline int32_t hysteresis_threshold_i16(int16_t val, hysteresis_thresh_i1
 }
 
 
+/**
+ * \brief Bank of q31_t hysteresis thresholds stored as a structure of arrays.
+ *
+ * Channel i works like a \ref hysteresis_thresh_t with thresholds hyst_on[i] and
+ * hyst_off[i], its output is bit i % 64 of state[i / 64].  The arrays are supplied by
+ * the caller, \ref HYSTERESIS_BANK_DEFINE declares aligned ones.  To initialize, set
+ * the thresholds and call \ref hysteresis_bank_init.
+ */
+typedef struct {
+    uint32_t n;           //!< The number of channels.
+    q31_t *hyst_on;       //!< Upper thresholds.
+    q31_t *hyst_off;      //!< Lower thresholds.
+    uint64_t *state;      //!< The outputs, one bit per channel.
+} hysteresis_bank_t;
+
+
+/**
+ * \brief Defines a hysteresis bank named name with aligned arrays for N channels.
+ */
+#define HYSTERESIS_BANK_DEFINE(name, N)                                             \
+    static q31_t name##_on[N] RT_DSP_ALIGNED(64);                                   \
+    static q31_t name##_off[N] RT_DSP_ALIGNED(64);                                  \
+    static uint64_t name##_state[((N) + 63) / 64] RT_DSP_ALIGNED(64);               \
+    hysteresis_bank_t name = { (N), name##_on, name##_off, name##_state }
+
+
+/**
+ * \brief Bank of int16_t hysteresis thresholds, see \ref hysteresis_bank_t.
+ */
+typedef struct {
+    uint32_t n;           //!< The number of channels.
+    int16_t *hyst_on;     //!< Upper thresholds.
+    int16_t *hyst_off;    //!< Lower thresholds.
+    uint64_t *state;      //!< The outputs, one bit per channel.
+} hysteresis_bank_i16_t;
+
+
+/**
+ * \brief Defines an int16_t hysteresis bank named name with aligned arrays for N channels.
+ */
+#define HYSTERESIS_BANK_I16_DEFINE(name, N)                                         \
+    static int16_t name##_on[N] RT_DSP_ALIGNED(64);                                 \
+    static int16_t name##_off[N] RT_DSP_ALIGNED(64);                                \
+    static uint64_t name##_state[((N) + 63) / 64] RT_DSP_ALIGNED(64);               \
+    hysteresis_bank_i16_t name = { (N), name##_on, name##_off, name##_state }
+
+
+/**
+ * \brief Initialize a hysteresis bank, every output starts at 0.
+ *
+ * \param H Hysteresis bank.
+ */
+void hysteresis_bank_init(hysteresis_bank_t *H);
+
+
+/**
+ * \brief Initialize an int16_t hysteresis bank, every output starts at 0.
+ *
+ * \param H Hysteresis bank.
+ */
+void hysteresis_bank_init_i16(hysteresis_bank_i16_t *H);
+
+
+/**
+ * \brief Applies every threshold of a hysteresis bank to its input value.
+ *
+ * Channel i gives the same output as \ref hysteresis_threshold with val[i].  The bits
+ * of the channels whose output changed are set in changed, which has one word per 64
+ * channels like the state.  The bits past the last channel stay 0 in both.
+ *
+ * \param H Hysteresis bank.
+ * \param val Input values, one per channel.
+ * \param changed Bitset of the channels whose output changed.
+ * \return The number of channels whose output changed.
+ */
+uint32_t hysteresis_bank(hysteresis_bank_t *H, const q31_t *val, uint64_t *changed);
+
+
+/**
+ * \brief Applies every threshold of an int16_t hysteresis bank, see \ref hysteresis_bank.
+ *
+ * \param H Hysteresis bank.
+ * \param val Input values, one per channel.
+ * \param changed Bitset of the channels whose output changed.
+ * \return The number of channels whose output changed.
+ */
+uint32_t hysteresis_bank_i16(hysteresis_bank_i16_t *H, const int16_t *val, uint64_t *changed);
+
+
+/**
+ * \brief The output of one channel of a hysteresis bank.
+ *
+ * \param state The state bitset of the bank.
+ * \param i Channel number.
+ * \return True or false.
+ */
+static inline int32_t hysteresis_bank_state(const uint64_t *state, uint32_t i) {
+    return (int32_t)((state[i / 64] >> (i % 64)) & 1);
+}
+
+
 /**
  * \brief Checks if a value is within some delta of a nominal value.
  *
@@ -337,4 +833,83 @@ static inline int32_t check_delta_f32(float32_t value, float32_t nominal, float3
 
 
 
+/**
+ * \brief Right shift of the squares summed by \ref rms_bank_q31.
+ *
+ * Each square is at most 2^46 after the shift, so 65536 of them fit in the 64-bit sum.
+ */
+#define RMS_BANK_SQ_SHIFT 16
+
+
+/**
+ * \brief Streaming RMS, mean and peak detector bank data structure.
+ *
+ * Accumulates the sum, the sum of squares and the largest magnitude of each of M channels
+ * and closes a window either on a rising zero crossing, the first sample >= 0 after one
+ * < 0, or when it reaches maxLen samples.  With zeroCross off every window is exactly
+ * maxLen samples.  Windows shorter than minLen don't close on a crossing, which keeps
+ * noise around zero from splitting a cycle.  The state and results are stored as
+ * structures of arrays so the vector kernels square and accumulate several channels in
+ * one pass over the input.  Define it with \ref RMS_BANK_Q31_DEFINE.
+ */
+typedef struct {
+    uint32_t M;         //!< The number of channels.
+    uint32_t minLen;    //!< Shortest window a zero crossing closes.
+    uint32_t maxLen;    //!< Longest window, 1 to 65536.
+    int32_t zeroCross;  //!< Close windows on rising zero crossings.
+    acc64_t *pSumSq;    //!< Sum of x * x >> \ref RMS_BANK_SQ_SHIFT of the open window.
+    acc64_t *pSum;      //!< Sum of x of the open window.
+    uint32_t *pMax;     //!< Largest |x| of the open window.
+    uint32_t *pCount;   //!< Samples in the open window.
+    q31_t *pLast;       //!< The previous sample.
+    q31_t *pRms;        //!< RMS of the last closed window.
+    q31_t *pMean;       //!< Mean of the last closed window, rounded toward zero.
+    q31_t *pPeak;       //!< Peak magnitude of the last closed window, saturated.
+    uint32_t *pLen;     //!< Length of the last closed window.
+    uint32_t *pSeq;     //!< Number of windows closed so far.
+} rms_bank_instance_q31;
+
+
+/**
+ * \brief Defines an RMS bank named name with CH channels.
+ */
+#define RMS_BANK_Q31_DEFINE(name, CH, MINLEN, MAXLEN, ZC)                            \
+    static acc64_t name##_sumsq[CH] RT_DSP_ALIGNED(64);                             \
+    static acc64_t name##_sum[CH] RT_DSP_ALIGNED(64);                               \
+    static uint32_t name##_max[CH] RT_DSP_ALIGNED(64);                              \
+    static uint32_t name##_count[CH] RT_DSP_ALIGNED(64);                            \
+    static q31_t name##_last[CH] RT_DSP_ALIGNED(64);                                \
+    static q31_t name##_rms[CH];                                                    \
+    static q31_t name##_mean[CH];                                                   \
+    static q31_t name##_peak[CH];                                                   \
+    static uint32_t name##_len[CH];                                                 \
+    static uint32_t name##_seq[CH];                                                 \
+    rms_bank_instance_q31 name = { (CH), (MINLEN), (MAXLEN), (ZC), name##_sumsq, name##_sum, \
+                                   name##_max, name##_count, name##_last, name##_rms,      \
+                                   name##_mean, name##_peak, name##_len, name##_seq }
+
+
+/**
+ * \brief Clears the open windows and the results of an RMS bank.
+ *
+ * \param S Pointer to the RMS bank instance structure.
+ */
+void rms_bank_init_q31(rms_bank_instance_q31 *S);
+
+
+/**
+ * \brief Runs a block of frames through an RMS bank.
+ *
+ * The results of a channel are updated each time one of its windows closes, pSeq tells
+ * which ones did.  The sample that makes a zero crossing starts the next window.
+ *
+ * \param S Pointer to the RMS bank instance structure.
+ * \param in nFrames frames of M samples, in[frame * M + channel].
+ * \param nFrames The number of frames.
+ * \return The number of windows closed over all channels.
+ */
+uint32_t rms_bank_q31(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+
+
+
 #endif /*ARM_RT_DSP_MISC_*/
\ No newline at end of file
@@ -0,0 +1,203 @@
+/**
+ * \file arm_rt_dsp_q15x2.h
+ * \brief Packed dual Q15 arithmetic.
+ *
+*/
+
+#ifndef ARM_RT_DSP_Q15X2_
+#define ARM_RT_DSP_Q15X2_
+
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp_core.h"
+
+
+/**
+ * \defgroup q15x2_group Packed Dual Q15 Functions
+ *
+ * A \ref q15x2_t holds two q15_t lanes in one 32-bit word, lane 0 in the low half and
+ * lane 1 in the high half.  The functions map onto the ARM 16-bit SIMD instructions
+ * (QADD16, QSUB16, SMUAD, SMLAD, ...) so two channels are processed for the cost of one.
+ * On a host the mock intrinsics in \ref arm_rt_dsp_core.h give the same results.
+ *
+ * @{
+*/
+
+/**
+ * \brief Two q15_t values packed into one 32-bit word.
+ *
+ * Lane 0 is in bits 0..15 and lane 1 in bits 16..31.  This matches the operand
+ * format of the ARM 16-bit SIMD instructions and of CMSIS read_q15x2().
+ */
+typedef uint32_t q15x2_t;
+
+
+/**
+ * \brief Packs two q15_t values.
+ *
+ * \param lo The lane 0 value.
+ * \param hi The lane 1 value.
+ * \return The packed value.
+ */
+static inline q15x2_t q15x2_pack(q15_t lo, q15_t hi) {
+    return ((uint32_t)(uint16_t)hi << 16) | (uint16_t)lo;
+}
+
+
+/**
+ * \brief Extracts lane 0.
+ *
+ * \param x The packed value.
+ * \return The lane 0 value.
+ */
+static inline q15_t q15x2_lo(q15x2_t x) {
+    return (q15_t)(x & 0xFFFFU);
+}
+
+
+/**
+ * \brief Extracts lane 1.
+ *
+ * \param x The packed value.
+ * \return The lane 1 value.
+ */
+static inline q15_t q15x2_hi(q15x2_t x) {
+    return (q15_t)(x >> 16);
+}
+
+
+/**
+ * \brief Adds both lanes with saturation (QADD16).
+ *
+ * \param x The first addend.
+ * \param y The second addend.
+ * \return The saturated sums.
+ */
+static inline q15x2_t add_q15x2(q15x2_t x, q15x2_t y) {
+    return __QADD16(x, y);
+}
+
+
+/**
+ * \brief Subtracts both lanes with saturation (QSUB16).
+ *
+ * \param x The minuend.
+ * \param y The subtrahend.
+ * \return The saturated differences.
+ */
+static inline q15x2_t sub_q15x2(q15x2_t x, q15x2_t y) {
+    return __QSUB16(x, y);
+}
+
+
+/**
+ * \brief Maximum of each lane.
+ *
+ * \param x First value.
+ * \param y Second value.
+ * \return The maximum of x and y in each lane.
+ */
+static inline q15x2_t max_q15x2(q15x2_t x, q15x2_t y) {
+#ifdef MOCK_ARM_MATH
+    q15_t lo = (q15x2_lo(x) > q15x2_lo(y)) ? q15x2_lo(x) : q15x2_lo(y);
+    q15_t hi = (q15x2_hi(x) > q15x2_hi(y)) ? q15x2_hi(x) : q15x2_hi(y);
+    return q15x2_pack(lo, hi);
+#else
+    // SSUB16 sets the GE bits of the lanes where x >= y and SEL picks those lanes from x.
+    (void)__SSUB16(x, y);
+    return __SEL(x, y);
+#endif
+}
+
+
+/**
+ * \brief Minimum of each lane.
+ *
+ * \param x First value.
+ * \param y Second value.
+ * \return The minimum of x and y in each lane.
+ */
+static inline q15x2_t min_q15x2(q15x2_t x, q15x2_t y) {
+#ifdef MOCK_ARM_MATH
+    q15_t lo = (q15x2_lo(x) > q15x2_lo(y)) ? q15x2_lo(y) : q15x2_lo(x);
+    q15_t hi = (q15x2_hi(x) > q15x2_hi(y)) ? q15x2_hi(y) : q15x2_hi(x);
+    return q15x2_pack(lo, hi);
+#else
+    (void)__SSUB16(x, y);
+    return __SEL(y, x);
+#endif
+}
+
+
+/**
+ * \brief Multiplies both lanes, bit-identical to \ref mul_q15 on each lane.
+ *
+ * \param x The first multiplicands.
+ * \param y The second multiplicands.
+ * \return The products.
+ */
+static inline q15x2_t mul_q15x2(q15x2_t x, q15x2_t y) {
+    return q15x2_pack(mul_q15(q15x2_lo(x), q15x2_lo(y)), mul_q15(q15x2_hi(x), q15x2_hi(y)));
+}
+
+
+/**
+ * \brief Multiplies both lanes with saturation, bit-identical to \ref mulsat_q15 on each lane.
+ *
+ * \param x The first multiplicands.
+ * \param y The second multiplicands.
+ * \return The saturated products.
+ */
+static inline q15x2_t mulsat_q15x2(q15x2_t x, q15x2_t y) {
+    return q15x2_pack(mulsat_q15(q15x2_lo(x), q15x2_lo(y)), mulsat_q15(q15x2_hi(x), q15x2_hi(y)));
+}
+
+
+/**
+ * \brief Dual multiply and add of the products (SMUAD).
+ *
+ * x.lo * y.lo + x.hi * y.hi.  The result is in 2.30 format and only overflows
+ * when both products are 1.0.
+ *
+ * \param x The first multiplicands.
+ * \param y The second multiplicands.
+ * \return The sum of the products in 2.30 format.
+ */
+static inline int32_t dot_q15x2(q15x2_t x, q15x2_t y) {
+    return (int32_t)__SMUAD(x, y);
+}
+
+
+/**
+ * \brief Dual multiply and accumulate (SMLAD).
+ *
+ * acc + x.lo * y.lo + x.hi * y.hi.  Wraps on overflow and sets the Q flag.
+ *
+ * \param x The first multiplicands.
+ * \param y The second multiplicands.
+ * \param acc The accumulator.
+ * \return The new accumulator value.
+ */
+static inline int32_t mac_q15x2(q15x2_t x, q15x2_t y, int32_t acc) {
+    return (int32_t)__SMLAD(x, y, (uint32_t)acc);
+}
+
+
+/**
+ * \brief Dual multiply and accumulate into 64 bits (SMLALD).
+ *
+ * \param x The first multiplicands.
+ * \param y The second multiplicands.
+ * \param acc The 64-bit accumulator.
+ * \return The new accumulator value.
+ */
+static inline int64_t mac64_q15x2(q15x2_t x, q15x2_t y, int64_t acc) {
+    return (int64_t)__SMLALD(x, y, (uint64_t)acc);
+}
+
+/**
+ * @}
+*/
+
+
+#endif // ARM_RT_DSP_Q15X2_
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "arm_rt_dsp_core.h"
+#include "arm_rt_dsp_q15x2.h"
 
 
 /**
@@ -36,6 +37,19 @@ typedef struct {
 } ramp_limit_q15_t;
 
 
+/**
+ * \brief Dual channel q15_t ramp limiter data structure.
+ *
+ * Every member holds lane 0 in the low half and lane 1 in the high half.
+ */
+typedef struct {
+    q15x2_t llim;
+    q15x2_t ulim;
+    q15x2_t inc;
+    q15x2_t y;
+} ramp_limit_q15x2_t;
+
+
 /**
  * \brief Signed q31_t ramp data structure.
  *
@@ -46,6 +60,22 @@ typedef struct {
 } ramp_q31_t;
 
 
+/**
+ * \brief Signed q31_t S-curve ramp data structure.
+ *
+ * The ramp limits both the rate, vmax per sample, and the acceleration, amax per
+ * sample per sample.  Set vmax and amax, both positive, and call
+ * \ref ramp_scurve_init_q31.
+ */
+typedef struct {
+    q31_t vmax;
+    q31_t amax;
+    q31_t y;
+    q31_t v;       // The current rate.
+    int64_t dmax;  // Derived, the distance needed to stop from vmax.
+} ramp_scurve_q31_t;
+
+
 // Linear ramp from one number to another with upper limit and lower limit.
 // I am still playing with the concept here.  Does it want limits?  Or should I just use saturated addition.
 // Should it be inlined?
@@ -88,6 +118,28 @@ void ramp_limit_init_q15(q15_t y0, ramp_limit_q15_t *r);
 q15_t ramp_limit_q15(q15_t x, ramp_limit_q15_t *r);
 
 
+/**
+ * \brief Initialize the dual linear ramp data structure with initial output values.
+ *
+ * \param y0 Packed initial output values.
+ * \param r Ramp data structure.
+ */
+void ramp_limit_init_q15x2(q15x2_t y0, ramp_limit_q15x2_t *r);
+
+
+/**
+ * \brief Dual channel linear ramp with upper limit and lower limit applied.
+ *
+ * Each lane gives exactly the same result as \ref ramp_limit_q15 when the limits are
+ * in order and the increment is not negative.
+ *
+ * \param x Packed input values are the new or current ramp targets.
+ * \param r Ramp data structure.
+ * \return The packed ramped values.
+ */
+q15x2_t ramp_limit_q15x2(q15x2_t x, ramp_limit_q15x2_t *r);
+
+
 /**
  * \brief Initialize the linear ramp data structure with an initial output value.
  *
@@ -107,4 +159,200 @@ void ramp_init_q31(q31_t y0, ramp_q31_t *r);
 q31_t ramp_q31(q31_t x, ramp_q31_t *r);
 
 
+/**
+ * \brief Linear ramp over a block of samples with a constant target.
+ *
+ * Gives exactly the same outputs as calling \ref ramp_q31 once per sample with the
+ * same x.  The sample where the ramp reaches x is worked out up front, so the moving
+ * part is written as an arithmetic progression and the rest as a constant, both
+ * vectorized.  A negative inc takes the per-sample path.
+ *
+ * \param x Ramp target for the whole block.
+ * \param r Ramp data structure.
+ * \param out Ramped output values.
+ * \param n Number of samples.
+ */
+void ramp_q31_block(q31_t x, ramp_q31_t *r, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief Linear ramp with limits over a block of samples with a constant target.
+ *
+ * Gives exactly the same outputs as calling \ref ramp_limit_q15 once per sample with
+ * the same x, see \ref ramp_q31_block.  The closed form needs llim <= y <= ulim and
+ * inc >= 0, anything else takes the per-sample path.
+ *
+ * \param x Ramp target for the whole block.
+ * \param r Ramp data structure.
+ * \param out Ramped output values.
+ * \param n Number of samples.
+ */
+void ramp_limit_q15_block(q15_t x, ramp_limit_q15_t *r, q15_t *out, uint32_t n);
+
+
+/**
+ * \brief Linear ramp with limits over a block of samples with a constant target.
+ *
+ * Gives exactly the same outputs as calling \ref ramp_limit_i16 once per sample with
+ * the same x, see \ref ramp_limit_q15_block.
+ *
+ * \param x Ramp target for the whole block.
+ * \param r Ramp data structure.
+ * \param out Ramped output values.
+ * \param n Number of samples.
+ */
+void ramp_limit_i16_block(int16_t x, ramp_limit_i16_t *r, int16_t *out, uint32_t n);
+
+
+/**
+ * \brief Initialize the S-curve ramp data structure with an initial output value.
+ *
+ * The ramp starts at rest.  Call this again after changing vmax or amax.
+ *
+ * \param y0 Initial output value.
+ * \param r Ramp data structure.
+ */
+void ramp_scurve_init_q31(q31_t y0, ramp_scurve_q31_t *r);
+
+
+/**
+ * \brief S-curve ramp from one number to another.
+ *
+ * Each sample the rate moves by at most amax towards the largest rate, up to vmax,
+ * from which the ramp can still stop at x by slowing down amax per sample.  Starting
+ * from rest the output never overshoots, it lands exactly on x and the rate is then
+ * zero.  When x moves closer than the stopping distance the ramp overshoots and
+ * comes back, the limits always hold.
+ *
+ * \param x Input value is new or current ramp target.
+ * \param r Ramp data structure.
+ * \return The ramped value output approaches the current target.
+ */
+q31_t ramp_scurve_q31(q31_t x, ramp_scurve_q31_t *r);
+
+
+/**
+ * \brief S-curve ramp over a block of samples with a constant target.
+ *
+ * Gives exactly the same outputs as calling \ref ramp_scurve_q31 once per sample with
+ * the same x.
+ *
+ * \param x Ramp target for the whole block.
+ * \param r Ramp data structure.
+ * \param out Ramped output values.
+ * \param n Number of samples.
+ */
+void ramp_scurve_q31_block(q31_t x, ramp_scurve_q31_t *r, q31_t *out, uint32_t n);
+
+
+/**
+ * \brief The remaining sample count of a ramp bank channel that never settles.
+ */
+#define RAMP_BANK_NEVER UINT32_MAX
+
+/**
+ * \brief Bank of q15_t ramp limiters stored as a structure of arrays.
+ *
+ * Channel i is a \ref ramp_limit_q15_t with its own limits, increment, output y[i]
+ * and target x[i].  Channels that have reached their target have their bit cleared in
+ * the active bitmap and cost nothing in \ref ramp_limit_bank_q15, so the time per
+ * step follows the number of moving channels.  The arrays are supplied by the caller,
+ * \ref RAMP_LIMIT_BANK_Q15_DEFINE declares aligned ones.  To initialize, set the
+ * limits and increments and call \ref ramp_limit_bank_init_q15.
+ */
+typedef struct {
+    uint32_t n;           // The number of channels.
+    uint32_t nActive;     // The number of channels still moving.
+    q15_t *llim;
+    q15_t *ulim;
+    q15_t *inc;
+    q15_t *y;             // The outputs.
+    q15_t *x;             // The targets.
+    uint32_t *remaining;  // Samples until each channel settles.
+    uint64_t *active;     // One bit per channel, set while it is moving.
+} ramp_limit_bank_q15_t;
+
+
+/**
+ * \brief Defines a ramp bank named name with aligned arrays for N channels.
+ */
+#define RAMP_LIMIT_BANK_Q15_DEFINE(name, N)                                         \
+    static q15_t name##_llim[N] RT_DSP_ALIGNED(64);                                 \
+    static q15_t name##_ulim[N] RT_DSP_ALIGNED(64);                                 \
+    static q15_t name##_inc[N] RT_DSP_ALIGNED(64);                                  \
+    static q15_t name##_y[N] RT_DSP_ALIGNED(64);                                    \
+    static q15_t name##_x[N] RT_DSP_ALIGNED(64);                                    \
+    static uint32_t name##_remaining[N] RT_DSP_ALIGNED(64);                         \
+    static uint64_t name##_active[((N) + 63) / 64] RT_DSP_ALIGNED(64);              \
+    ramp_limit_bank_q15_t name = { (N), 0, name##_llim, name##_ulim, name##_inc,    \
+                                   name##_y, name##_x, name##_remaining,            \
+                                   name##_active }
+
+
+/**
+ * \brief Initialize a ramp bank with initial output values.
+ *
+ * The outputs are clamped to the limits like \ref ramp_limit_init_q15, the targets are
+ * set to the outputs and every channel starts settled.
+ *
+ * \param S Ramp bank.
+ * \param y0 Initial output values, one per channel, or NULL for all zero.
+ */
+void ramp_limit_bank_init_q15(ramp_limit_bank_q15_t *S, const q15_t *y0);
+
+
+/**
+ * \brief Sets the target of one channel of a ramp bank.
+ *
+ * The channel is re-armed if the target changed.  Call this also after changing the
+ * limits or the increment of a channel, with its current target.
+ *
+ * \param S Ramp bank.
+ * \param i Channel number.
+ * \param x New target.
+ */
+void ramp_limit_bank_target_q15(ramp_limit_bank_q15_t *S, uint32_t i, q15_t x);
+
+
+/**
+ * \brief Sets the targets of all channels of a ramp bank.
+ *
+ * Only the channels whose target changed are re-armed.
+ *
+ * \param S Ramp bank.
+ * \param x New targets, one per channel.
+ */
+void ramp_limit_bank_targets_q15(ramp_limit_bank_q15_t *S, const q15_t *x);
+
+
+/**
+ * \brief Steps every moving channel of a ramp bank once.
+ *
+ * Channel i gives exactly the same output y[i] as \ref ramp_limit_q15 with target
+ * x[i] on a ramp with the same limits and state.  Settled channels are skipped, their
+ * outputs would not change.
+ *
+ * \param S Ramp bank.
+ * \return The number of channels still moving.
+ */
+uint32_t ramp_limit_bank_q15(ramp_limit_bank_q15_t *S);
+
+
+/**
+ * \brief The number of steps until a channel of a ramp bank settles.
+ *
+ * \param S Ramp bank.
+ * \param i Channel number.
+ * \return 0 if the channel is settled, RAMP_BANK_NEVER if it is stepped for ever (a
+ * negative increment or limits out of order), else the exact number of calls to
+ * \ref ramp_limit_bank_q15 after which y[i] stops changing.  That is at its target,
+ * except with a zero increment, where a channel outside its limits settles after the
+ * one step that clamps it.
+ */
+static inline uint32_t ramp_limit_bank_remaining_q15(const ramp_limit_bank_q15_t *S, uint32_t i)
+{
+    return S->remaining[i];
+}
+
+
 #endif // _ARM_RT_DSP_RAMP_H_
\ No newline at end of file
@@ -6,6 +6,79 @@
 #include "arm_rt_dsp.h"
 
 
+#ifdef MOCK_ARM_MATH
+// The emulated Q flag, see arm_rt_dsp_core.h.
+RT_DSP_THREAD_LOCAL uint32_t dsp_q_count = 0;
+#endif
+
+
+// atan(2^-i) with 2^56 per cycle, for the CORDIC below.
+static const int64_t sincos_cordic_atan[40] = {
+    0x20000000000000LL, 0x12E4051D9DF308LL, 0x09FB385B5EE39ELL, 0x051111D41DDD9ALL,
+    0x028B0D430E589BLL, 0x0145D7E1590462LL, 0x00A2F61E5C2826LL, 0x00517C5511D443LL,
+    0x0028BE5346D0C3LL, 0x00145F2EBB30ABLL, 0x000A2F980091BALL, 0x000517CC14A80DLL,
+    0x00028BE60CDFECLL, 0x000145F306C173LL, 0x0000A2F9836AE9LL, 0x0000517CC1B6BALL,
+    0x000028BE60DB86LL, 0x0000145F306DC8LL, 0x00000A2F9836E5LL, 0x00000517CC1B72LL,
+    0x0000028BE60DB9LL, 0x00000145F306DDLL, 0x000000A2F9836ELL, 0x000000517CC1B7LL,
+    0x00000028BE60DCLL, 0x000000145F306ELL, 0x0000000A2F9837LL, 0x0000000517CC1BLL,
+    0x000000028BE60ELL, 0x0000000145F307LL, 0x00000000A2F983LL, 0x00000000517CC2LL,
+    0x0000000028BE61LL, 0x00000000145F30LL, 0x000000000A2F98LL, 0x000000000517CCLL,
+    0x00000000028BE6LL, 0x000000000145F3LL, 0x0000000000A2FALL, 0x0000000000517DLL,
+};
+
+// 1 / CORDIC gain in Q40.
+#define SINCOS_CORDIC_X0 667681663043LL
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+cos and sin of phase * 2 pi / 2^32 in Q30, within one LSB, without libm.  The
+CORDIC runs in the first quadrant in Q40 and the quadrant is put back after.
+The results are clamped to 1 - 2^-30 so a Q30 product with any q31_t still fits
+in a q31_t after the shift.
+-----------------------------------------------------------------------------*/
+void sincos_q30(uint32_t phase, q31_t *c, q31_t *s)
+{
+  const int64_t lim = (1 << 30) - 1;
+  int64_t x = SINCOS_CORDIC_X0;
+  int64_t y = 0;
+  int64_t z = (int64_t)(phase & 0x3FFFFFFFU) << 24;
+  int64_t cx, sy;
+
+  for (uint32_t i = 0; i < 40; i++)
+  {
+    int64_t xs = x >> i;
+    int64_t ys = y >> i;
+    if (z >= 0)
+    {
+      x -= ys;
+      y += xs;
+      z -= sincos_cordic_atan[i];
+    }
+    else
+    {
+      x += ys;
+      y -= xs;
+      z += sincos_cordic_atan[i];
+    }
+  }
+  x = (x + (1 << 9)) >> 10;
+  y = (y + (1 << 9)) >> 10;
+
+  switch (phase >> 30)
+  {
+    case 0:  cx = x;  sy = y;  break;
+    case 1:  cx = -y; sy = x;  break;
+    case 2:  cx = -x; sy = -y; break;
+    default: cx = y;  sy = -x; break;
+  }
+  *c = (q31_t)((cx > lim) ? lim : (cx < -lim) ? -lim : cx);
+  *s = (q31_t)((sy > lim) ? lim : (sy < -lim) ? -lim : sy);
+}
+
+
 /*-----------------------------------------------------------------------------
 History:
 
@@ -106,6 +179,43 @@ q15_t ramp_limit_q15(q15_t x, ramp_limit_q15_t *r) {
 }
 
 
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void ramp_limit_init_q15x2(q15x2_t y0, ramp_limit_q15x2_t *r) {
+    // Sets the starting values to between the lower limits and the upper limits.
+    r->y = min_q15x2(max_q15x2(y0, r->llim), r->ulim);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The difference saturates to 16 bits, that doesn't matter since it is clamped
+to inc right after.  y + delta always lies between y and x so the add can't
+saturate either.
+-----------------------------------------------------------------------------*/
+q15x2_t ramp_limit_q15x2(q15x2_t x, ramp_limit_q15x2_t *r) {
+    q15x2_t delta;
+
+    delta = __QSUB16(x, r->y);
+
+    // inc is the limit of speed of movement from one number to the next.
+    delta = max_q15x2(min_q15x2(delta, r->inc), __QSUB16(0, r->inc));
+
+    r->y = __QADD16(r->y, delta);
+
+    // Sets the return values to between the lower limits and the upper limits.
+    r->y = min_q15x2(max_q15x2(r->y, r->llim), r->ulim);
+
+    return r->y;
+}
+
+
 /*-----------------------------------------------------------------------------
 History:
 
@@ -155,6 +265,27 @@ q31_t ramp_q31(q31_t x, ramp_q31_t *r) {
 }
 
 
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The one 64-bit division per scale.  |INT32_MIN| is 2^31, which still fits.
+-----------------------------------------------------------------------------*/
+void convert_recip_init(int32_t scale, convert_recip_t *R)
+{
+  uint64_t rec = 0;
+
+  R->neg = scale < 0;
+  R->d = (scale < 0) ? 0U - (uint32_t)scale : (uint32_t)scale;
+  if (R->d != 0)
+  {
+    rec = (UINT64_C(1) << 63) / R->d;
+  }
+  R->recHi = (uint32_t)(rec >> 32);
+  R->recLo = (uint32_t)rec;
+}
+
+
 /*-----------------------------------------------------------------------------
 History:
 
@@ -181,6 +312,32 @@ void hysteresis_init_i16(int16_t l_thresh, int16_t h_thresh, hysteresis_thresh_i
 }
 
 
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void hysteresis_bank_init(hysteresis_bank_t *H) {
+    for (uint32_t w = 0; w < (H->n + 63U) / 64U; w++) {
+        H->state[w] = 0;
+    }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void hysteresis_bank_init_i16(hysteresis_bank_i16_t *H) {
+    for (uint32_t w = 0; w < (H->n + 63U) / 64U; w++) {
+        H->state[w] = 0;
+    }
+}
+
+
 
 /*-----------------------------------------------------------------------------
 History:
@@ -206,6 +363,33 @@ void iir_pi_init_q15(iir_pi_instance_q15 * S, int32_t resetStateFlag) {
 }
 
 
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The per channel coefficient words are arranged once here so the process
+function can feed them straight to SMLAD.
+-----------------------------------------------------------------------------*/
+void iir_pi_init_q15x2(iir_pi_instance_q15x2 * S, int32_t resetStateFlag) {
+  q15x2_t A0;
+  q15x2_t A1;
+
+  // Derived coefficients for both lanes at once.
+  A0 = __QADD16(S->Kp, S->Ki);
+  A1 = __QSUB16(0, S->Kp);
+
+  S->A[0] = __PKHBT(A0, A1, 16);
+  S->A[1] = __PKHTB(A1, A0, 16);
+
+  // Check whether state needs reset or not
+  if (resetStateFlag)
+  {
+    memset(S->state, 0, PI_Q15_STATE_BUFFER_SIZE * sizeof(q15x2_t));
+  }
+
+}
+
+
 /*-----------------------------------------------------------------------------
 History:
 
@@ -336,3 +520,55 @@ void iir_pid_init_v2_q31( iir_pid_instance_v2_q31 *S, int32_t resetStateFlag)
   S->mask_count = 0;
 
 }
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Kr * cos(w0) is rounded down like the controller arithmetic.
+-----------------------------------------------------------------------------*/
+void iir_pr_init_q31(iir_pr_instance_q31 *S, int32_t resetStateFlag)
+{
+  q31_t c, s;
+
+  sincos_q30(S->phase, &c, &s);
+
+  /* Derived coefficients A0, A1 and C */
+  S->A0 = S->Kr;
+  S->A1 = (acc32_t)(-(((int64_t)S->Kr * c) >> 30));
+  S->C = c;
+
+  /* Check whether state needs reset or not */
+  if (resetStateFlag)
+  {
+    memset(S->state, 0, PR_Q31_STATE_BUFFER_SIZE * sizeof(q31_t));
+  }
+
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void iir_notch_init_q31(iir_notch_instance_q31 *S, int32_t resetStateFlag)
+{
+  q31_t c, s;
+
+  sincos_q30(S->phase, &c, &s);
+
+  /* Derived coefficients, the zeros and then the poles */
+  S->A1 = c;
+  S->B1 = (q31_t)(((int64_t)S->r * c) >> 31);
+  S->B2 = (q31_t)(((int64_t)S->r * S->r) >> 32);
+
+  /* Check whether state needs reset or not */
+  if (resetStateFlag)
+  {
+    memset(S->state, 0, NOTCH_Q31_STATE_BUFFER_SIZE * sizeof(q31_t));
+  }
+
+}
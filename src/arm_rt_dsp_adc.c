@@ -0,0 +1,507 @@
+/**
+ * \file arm_rt_dsp_adc.c
+ * \brief Block ADC conversion of interleaved DMA scan buffers.
+*/
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernels.  These are the reference for every other kernel.
+
+Notes:
+The kernels walk one channel at a time, raw and out already point at the
+channel, so a channel's samples are M apart in raw and contiguous in out.
+lj and shift are the justification and the remaining shift of
+adc_scale_raw, the conversions of every width and justification differ only
+in those.  The kernels of each level are always inlined helpers, which
+ADC_KERNEL_TABLE_DEFINE below instantiates once per format with literal
+shifts, so every shift is an immediate and the justification mask goes away
+for right justified formats.
+-----------------------------------------------------------------------------*/
+static inline RT_DSP_ALWAYS_INLINE void adc_q15_step(const uint16_t *raw, uint32_t M, int16_t offset,
+                                                     q15_t slope, uint32_t lj, uint32_t shift, uint32_t s,
+                                                     uint32_t nScans, q15_t *out)
+{
+    for (; s < nScans; s++) {
+        out[s] = mulsat_q15((q15_t)adc_scale_raw(raw[s * M], offset, lj, shift), slope);
+    }
+}
+
+static inline RT_DSP_ALWAYS_INLINE void adc_q31_step(const uint16_t *raw, uint32_t M, int16_t offset,
+                                                     q31_t slope, uint32_t lj, uint32_t shift, uint32_t s,
+                                                     uint32_t nScans, q31_t *out)
+{
+    for (; s < nScans; s++) {
+        out[s] = mulsat_q31(adc_scale_raw(raw[s * M], offset, lj, shift), slope);
+    }
+}
+
+static inline RT_DSP_ALWAYS_INLINE void adc_q15_scalar(const uint16_t *raw, uint32_t M, const int16_t *offset,
+                                                       const q15_t *slope, uint32_t lj, uint32_t shift,
+                                                       uint32_t nScans, q15_t *out) {
+    for (uint32_t c = 0; c < M; c++) {
+        adc_q15_step(&raw[c], M, offset[c], slope[c], lj, shift, 0, nScans, &out[c * nScans]);
+    }
+}
+
+static inline RT_DSP_ALWAYS_INLINE void adc_q31_scalar(const uint16_t *raw, uint32_t M, const int16_t *offset,
+                                                       const q31_t *slope, uint32_t lj, uint32_t shift,
+                                                       uint32_t nScans, q31_t *out) {
+    for (uint32_t c = 0; c < M; c++) {
+        adc_q31_step(&raw[c], M, offset[c], slope[c], lj, shift, 0, nScans, &out[c * nScans]);
+    }
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+A channel is deinterleaved with a 32-bit gather at a 16-bit scale, the low
+half of each lane is the sample.  The AND that drops the other half also
+clears the bits below lj, and the offset is moved up once per channel.  The
+gather reads one sample past the last one, so the vector loop stops before
+the last scan and the scalar step does the rest.  mulsat_q15 only saturates for -1.0 * -1.0, where (x*y) >> 16 is
+16384, so it is MULHW, a min with 16383 and a shift left, and the lanes the
+min clamps are counted in the Q flag.  The Q31 version is the same on the high
+half of the 64-bit product.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+static inline RT_DSP_ALWAYS_INLINE void adc_q15_avx2(const uint16_t *raw, uint32_t M, const int16_t *offset,
+                                                     const q15_t *slope, uint32_t lj, uint32_t shift,
+                                                     uint32_t nScans, q15_t *out) {
+    const __m256i mask = _mm256_set1_epi32((int32_t)((0xFFFFU << lj) & 0xFFFF));
+    const __m256i smax = _mm256_set1_epi16(16383);
+    const __m256i step = _mm256_set1_epi32((int32_t)(16 * M));
+    const __m256i half = _mm256_set1_epi32((int32_t)(8 * M));
+    const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                             _mm256_set1_epi32((int32_t)M));
+
+    for (uint32_t c = 0; c < M; c++) {
+        const int *base = (const int *)&raw[c];
+        const __m256i off = _mm256_set1_epi16((int16_t)((uint32_t)offset[c] << lj));
+        const __m256i sl = _mm256_set1_epi16(slope[c]);
+        q15_t *o = &out[c * nScans];
+        __m256i vi = lanes;
+        uint32_t sat = 0;
+        uint32_t s = 0;
+
+        for (; s + 16 < nScans; s += 16) {
+            __m256i v0 = _mm256_and_si256(_mm256_i32gather_epi32(base, vi, 2), mask);
+            __m256i v1 = _mm256_and_si256(_mm256_i32gather_epi32(base, _mm256_add_epi32(vi, half), 2), mask);
+            __m256i v = _mm256_permute4x64_epi64(_mm256_packus_epi32(v0, v1), 0xD8);
+            __m256i a = _mm256_slli_epi16(_mm256_sub_epi16(v, off), (int)shift);
+            __m256i r = _mm256_mulhi_epi16(a, sl);
+            sat += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi16(r, smax)));
+            r = _mm256_min_epi16(r, smax);
+            _mm256_storeu_si256((__m256i *)&o[s], _mm256_slli_epi16(r, 1));
+            vi = _mm256_add_epi32(vi, step);
+        }
+        dsp_q_count += sat / 2;
+        adc_q15_step(&raw[c], M, offset[c], slope[c], lj, shift, s, nScans, o);
+    }
+}
+
+RT_DSP_TARGET_AVX2
+static inline RT_DSP_ALWAYS_INLINE void adc_q31_avx2(const uint16_t *raw, uint32_t M, const int16_t *offset,
+                                                     const q31_t *slope, uint32_t lj, uint32_t shift,
+                                                     uint32_t nScans, q31_t *out) {
+    const __m256i mask = _mm256_set1_epi32((int32_t)((0xFFFFU << lj) & 0xFFFF));
+    const __m256i smax = _mm256_set1_epi32(0x3FFFFFFF);
+    const __m256i step = _mm256_set1_epi32((int32_t)(8 * M));
+    const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                             _mm256_set1_epi32((int32_t)M));
+
+    for (uint32_t c = 0; c < M; c++) {
+        const int *base = (const int *)&raw[c];
+        const __m256i off = _mm256_set1_epi32((int32_t)((uint32_t)offset[c] << lj));
+        const __m256i sl = _mm256_set1_epi32(slope[c]);
+        q31_t *o = &out[c * nScans];
+        __m256i vi = lanes;
+        uint32_t sat = 0;
+        uint32_t s = 0;
+
+        for (; s + 8 < nScans; s += 8) {
+            __m256i v = _mm256_and_si256(_mm256_i32gather_epi32(base, vi, 2), mask);
+            __m256i a = _mm256_slli_epi32(_mm256_sub_epi32(v, off), (int)shift);
+            __m256i p02 = _mm256_mul_epi32(a, sl);
+            __m256i p13 = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), sl);
+            __m256i r = _mm256_blend_epi32(_mm256_srli_epi64(p02, 32), p13, 0xAA);
+            sat += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(r, smax))));
+            r = _mm256_min_epi32(r, smax);
+            _mm256_storeu_si256((__m256i *)&o[s], _mm256_slli_epi32(r, 1));
+            vi = _mm256_add_epi32(vi, step);
+        }
+        dsp_q_count += sat;
+        adc_q31_step(&raw[c], M, offset[c], slope[c], lj, shift, s, nScans, o);
+    }
+}
+
+RT_DSP_TARGET_AVX512
+static inline RT_DSP_ALWAYS_INLINE void adc_q15_avx512(const uint16_t *raw, uint32_t M, const int16_t *offset,
+                                                       const q15_t *slope, uint32_t lj, uint32_t shift,
+                                                       uint32_t nScans, q15_t *out) {
+    const __m512i mask = _mm512_set1_epi16((int16_t)(0xFFFFU << lj));
+    const __m512i smax = _mm512_set1_epi16(16383);
+    const __m512i step = _mm512_set1_epi32((int32_t)(32 * M));
+    const __m512i half = _mm512_set1_epi32((int32_t)(16 * M));
+    const __m512i lanes = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+                                                               11, 12, 13, 14, 15),
+                                             _mm512_set1_epi32((int32_t)M));
+
+    for (uint32_t c = 0; c < M; c++) {
+        const void *base = &raw[c];
+        const __m512i off = _mm512_set1_epi16((int16_t)((uint32_t)offset[c] << lj));
+        const __m512i sl = _mm512_set1_epi16(slope[c]);
+        q15_t *o = &out[c * nScans];
+        __m512i vi = lanes;
+        uint32_t sat = 0;
+        uint32_t s = 0;
+
+        for (; s + 32 < nScans; s += 32) {
+            __m256i v0 = _mm512_cvtepi32_epi16(_mm512_i32gather_epi32(vi, base, 2));
+            __m256i v1 = _mm512_cvtepi32_epi16(_mm512_i32gather_epi32(_mm512_add_epi32(vi, half), base, 2));
+            __m512i v = _mm512_inserti64x4(_mm512_castsi256_si512(v0), v1, 1);
+            if (lj != 0) {
+                v = _mm512_and_si512(v, mask);
+            }
+            __m512i a = _mm512_slli_epi16(_mm512_sub_epi16(v, off), (unsigned int)shift);
+            __m512i r = _mm512_mulhi_epi16(a, sl);
+            sat += (uint32_t)__builtin_popcount(_mm512_cmpgt_epi16_mask(r, smax));
+            r = _mm512_min_epi16(r, smax);
+            _mm512_storeu_si512((void *)&o[s], _mm512_slli_epi16(r, 1));
+            vi = _mm512_add_epi32(vi, step);
+        }
+        dsp_q_count += sat;
+        adc_q15_step(&raw[c], M, offset[c], slope[c], lj, shift, s, nScans, o);
+    }
+}
+
+RT_DSP_TARGET_AVX512
+static inline RT_DSP_ALWAYS_INLINE void adc_q31_avx512(const uint16_t *raw, uint32_t M, const int16_t *offset,
+                                                       const q31_t *slope, uint32_t lj, uint32_t shift,
+                                                       uint32_t nScans, q31_t *out) {
+    const __m512i mask = _mm512_set1_epi32((int32_t)((0xFFFFU << lj) & 0xFFFF));
+    const __m512i smax = _mm512_set1_epi32(0x3FFFFFFF);
+    const __m512i step = _mm512_set1_epi32((int32_t)(16 * M));
+    const __m512i lanes = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+                                                               11, 12, 13, 14, 15),
+                                             _mm512_set1_epi32((int32_t)M));
+
+    for (uint32_t c = 0; c < M; c++) {
+        const void *base = &raw[c];
+        const __m512i off = _mm512_set1_epi32((int32_t)((uint32_t)offset[c] << lj));
+        const __m512i sl = _mm512_set1_epi32(slope[c]);
+        q31_t *o = &out[c * nScans];
+        __m512i vi = lanes;
+        uint32_t sat = 0;
+        uint32_t s = 0;
+
+        for (; s + 16 < nScans; s += 16) {
+            __m512i v = _mm512_and_si512(_mm512_i32gather_epi32(vi, base, 2), mask);
+            __m512i a = _mm512_slli_epi32(_mm512_sub_epi32(v, off), (unsigned int)shift);
+            __m512i p02 = _mm512_mul_epi32(a, sl);
+            __m512i p13 = _mm512_mul_epi32(_mm512_srli_epi64(a, 32), sl);
+            __m512i r = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(p02, 32), p13);
+            sat += (uint32_t)__builtin_popcount(_mm512_cmpgt_epi32_mask(r, smax));
+            r = _mm512_min_epi32(r, smax);
+            _mm512_storeu_si512((void *)&o[s], _mm512_slli_epi32(r, 1));
+            vi = _mm512_add_epi32(vi, step);
+        }
+        dsp_q_count += sat;
+        adc_q31_step(&raw[c], M, offset[c], slope[c], lj, shift, s, nScans, o);
+    }
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+VLD2 to VLD4 deinterleave up to four channels as they load, more channels
+use the scalar kernel.  SQDMULH gives (2*x*y) >> 32 saturated, clearing its
+low bit gives ((x*y) >> 32) << 1 and the saturated -1.0 * -1.0 is the same
+0x7FFFFFFE as mulsat_q31, likewise for Q15.  That is the only saturation, the
+lanes where both sides are -1.0 are counted in the Q flag.
+-----------------------------------------------------------------------------*/
+// SHL takes its count as an immediate, so the counts of the formats are spelled
+// out, one case is left once inlined.  ADC_KERNELS_DEFINE checks at compile time
+// that every format's count is one of them.
+static inline RT_DSP_ALWAYS_INLINE int16x8_t adc_shl_s16(int16x8_t a, uint32_t shift) {
+    switch (shift) {
+    case 0: return a;
+    case 2: return vshlq_n_s16(a, 2);
+    case 4: return vshlq_n_s16(a, 4);
+    case 6: return vshlq_n_s16(a, 6);
+    default: __builtin_unreachable();
+    }
+}
+
+static inline RT_DSP_ALWAYS_INLINE int32x4_t adc_shl_s32(int32x4_t a, uint32_t shift) {
+    switch (shift) {
+    case 15: return vshlq_n_s32(a, 15);
+    case 16: return vshlq_n_s32(a, 16);
+    case 17: return vshlq_n_s32(a, 17);
+    case 18: return vshlq_n_s32(a, 18);
+    case 19: return vshlq_n_s32(a, 19);
+    case 20: return vshlq_n_s32(a, 20);
+    case 21: return vshlq_n_s32(a, 21);
+    case 22: return vshlq_n_s32(a, 22);
+    default: __builtin_unreachable();
+    }
+}
+
+static inline RT_DSP_ALWAYS_INLINE void adc_q15_neon8(uint16x8_t v, uint32_t lj, int16x8_t off, int16x8_t sl,
+                                                      uint32_t shift, q15_t *o, uint32x4_t *sat) {
+    const int16x8_t vmin = vdupq_n_s16(INT16_MIN);
+    if (lj != 0) {
+        v = vandq_u16(v, vdupq_n_u16((uint16_t)(0xFFFFU << lj)));
+    }
+    int16x8_t a = adc_shl_s16(vsubq_s16(vreinterpretq_s16_u16(v), off), shift);
+    uint16x8_t m = vandq_u16(vceqq_s16(a, vmin), vceqq_s16(sl, vmin));
+    *sat = vpadalq_u16(*sat, vshrq_n_u16(m, 15));
+    vst1q_s16(o, vbicq_s16(vqdmulhq_s16(a, sl), vdupq_n_s16(1)));
+}
+
+static inline RT_DSP_ALWAYS_INLINE void adc_q31_neon8(uint16x8_t v, uint32_t lj, int32x4_t off, int32x4_t sl,
+                                                      uint32_t shift, q31_t *o, uint32x4_t *sat) {
+    const int32x4_t vmin = vdupq_n_s32(INT32_MIN);
+    if (lj != 0) {
+        v = vandq_u16(v, vdupq_n_u16((uint16_t)(0xFFFFU << lj)));
+    }
+    int32x4_t a0 = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(v)));
+    int32x4_t a1 = vreinterpretq_s32_u32(vmovl_high_u16(v));
+    a0 = adc_shl_s32(vsubq_s32(a0, off), shift);
+    a1 = adc_shl_s32(vsubq_s32(a1, off), shift);
+    uint32x4_t slmin = vceqq_s32(sl, vmin);
+    *sat = vsubq_u32(*sat, vandq_u32(vceqq_s32(a0, vmin), slmin));
+    *sat = vsubq_u32(*sat, vandq_u32(vceqq_s32(a1, vmin), slmin));
+    vst1q_s32(o, vbicq_s32(vqdmulhq_s32(a0, sl), vdupq_n_s32(1)));
+    vst1q_s32(o + 4, vbicq_s32(vqdmulhq_s32(a1, sl), vdupq_n_s32(1)));
+}
+
+static inline RT_DSP_ALWAYS_INLINE void adc_q15_neon(const uint16_t *raw, uint32_t M, const int16_t *offset,
+                                                     const q15_t *slope, uint32_t lj, uint32_t shift,
+                                                     uint32_t nScans, q15_t *out) {
+    int16x8_t off[4], sl[4];
+    uint32x4_t sat = vdupq_n_u32(0);
+    uint32_t s = 0;
+
+    if (M == 0 || M > 4) {
+        adc_q15_scalar(raw, M, offset, slope, lj, shift, nScans, out);
+        return;
+    }
+    for (uint32_t c = 0; c < M; c++) {
+        off[c] = vdupq_n_s16((int16_t)((uint32_t)offset[c] << lj));
+        sl[c] = vdupq_n_s16(slope[c]);
+    }
+    for (; s + 8 <= nScans; s += 8) {
+        const uint16_t *p = &raw[s * M];
+        if (M == 1) {
+            adc_q15_neon8(vld1q_u16(p), lj, off[0], sl[0], shift, &out[s], &sat);
+        } else if (M == 2) {
+            uint16x8x2_t v = vld2q_u16(p);
+            adc_q15_neon8(v.val[0], lj, off[0], sl[0], shift, &out[s], &sat);
+            adc_q15_neon8(v.val[1], lj, off[1], sl[1], shift, &out[nScans + s], &sat);
+        } else if (M == 3) {
+            uint16x8x3_t v = vld3q_u16(p);
+            adc_q15_neon8(v.val[0], lj, off[0], sl[0], shift, &out[s], &sat);
+            adc_q15_neon8(v.val[1], lj, off[1], sl[1], shift, &out[nScans + s], &sat);
+            adc_q15_neon8(v.val[2], lj, off[2], sl[2], shift, &out[2 * nScans + s], &sat);
+        } else {
+            uint16x8x4_t v = vld4q_u16(p);
+            adc_q15_neon8(v.val[0], lj, off[0], sl[0], shift, &out[s], &sat);
+            adc_q15_neon8(v.val[1], lj, off[1], sl[1], shift, &out[nScans + s], &sat);
+            adc_q15_neon8(v.val[2], lj, off[2], sl[2], shift, &out[2 * nScans + s], &sat);
+            adc_q15_neon8(v.val[3], lj, off[3], sl[3], shift, &out[3 * nScans + s], &sat);
+        }
+    }
+    dsp_q_count += vaddvq_u32(sat);
+    for (uint32_t c = 0; c < M; c++) {
+        adc_q15_step(&raw[c], M, offset[c], slope[c], lj, shift, s, nScans, &out[c * nScans]);
+    }
+}
+
+static inline RT_DSP_ALWAYS_INLINE void adc_q31_neon(const uint16_t *raw, uint32_t M, const int16_t *offset,
+                                                     const q31_t *slope, uint32_t lj, uint32_t shift,
+                                                     uint32_t nScans, q31_t *out) {
+    int32x4_t off[4], sl[4];
+    uint32x4_t sat = vdupq_n_u32(0);
+    uint32_t s = 0;
+
+    if (M == 0 || M > 4) {
+        adc_q31_scalar(raw, M, offset, slope, lj, shift, nScans, out);
+        return;
+    }
+    for (uint32_t c = 0; c < M; c++) {
+        off[c] = vdupq_n_s32((int32_t)((uint32_t)offset[c] << lj));
+        sl[c] = vdupq_n_s32(slope[c]);
+    }
+    for (; s + 8 <= nScans; s += 8) {
+        const uint16_t *p = &raw[s * M];
+        if (M == 1) {
+            adc_q31_neon8(vld1q_u16(p), lj, off[0], sl[0], shift, &out[s], &sat);
+        } else if (M == 2) {
+            uint16x8x2_t v = vld2q_u16(p);
+            adc_q31_neon8(v.val[0], lj, off[0], sl[0], shift, &out[s], &sat);
+            adc_q31_neon8(v.val[1], lj, off[1], sl[1], shift, &out[nScans + s], &sat);
+        } else if (M == 3) {
+            uint16x8x3_t v = vld3q_u16(p);
+            adc_q31_neon8(v.val[0], lj, off[0], sl[0], shift, &out[s], &sat);
+            adc_q31_neon8(v.val[1], lj, off[1], sl[1], shift, &out[nScans + s], &sat);
+            adc_q31_neon8(v.val[2], lj, off[2], sl[2], shift, &out[2 * nScans + s], &sat);
+        } else {
+            uint16x8x4_t v = vld4q_u16(p);
+            adc_q31_neon8(v.val[0], lj, off[0], sl[0], shift, &out[s], &sat);
+            adc_q31_neon8(v.val[1], lj, off[1], sl[1], shift, &out[nScans + s], &sat);
+            adc_q31_neon8(v.val[2], lj, off[2], sl[2], shift, &out[2 * nScans + s], &sat);
+            adc_q31_neon8(v.val[3], lj, off[3], sl[3], shift, &out[3 * nScans + s], &sat);
+        }
+    }
+    dsp_q_count += vaddvq_u32(sat);
+    for (uint32_t c = 0; c < M; c++) {
+        adc_q31_step(&raw[c], M, offset[c], slope[c], lj, shift, s, nScans, &out[c * nScans]);
+    }
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+Kernel tables.
+
+Notes:
+One kernel per format and level, each calls the inlined kernel of its level
+with the literal shifts of the format, the same ones as ADC_CONVERSION_DEFINE.
+The shifts must be cases of adc_shl_s16 and adc_shl_s32, or NEON would have
+no immediate for them.
+-----------------------------------------------------------------------------*/
+#define ADC_SHIFT_Q15_OK(S) ((S) == 0 || (S) == 2 || (S) == 4 || (S) == 6)
+#define ADC_SHIFT_Q31_OK(S) ((S) >= 15 && (S) <= 22)
+
+#define ADC_KERNELS_DEFINE(ISA, TARGET, BITS, J)                                                \
+    _Static_assert(ADC_SHIFT_Q15_OK(16 - (BITS) - ADC_JUST_##J(BITS)) &&                        \
+                   ADC_SHIFT_Q31_OK(32 - (BITS) - ADC_JUST_##J(BITS)) &&                        \
+                   ADC_SHIFT_Q31_OK(31 - (BITS) - ADC_JUST_##J(BITS)),                          \
+                   "ADC format shift without an immediate shift case");                         \
+    TARGET static void adc_block_q15_##BITS##J##_##ISA(const uint16_t *raw, uint32_t M,        \
+                                                       const int16_t *offset, const q15_t *slope, \
+                                                       uint32_t nScans, q15_t *out) {          \
+        adc_q15_##ISA(raw, M, offset, slope, ADC_JUST_##J(BITS),                                \
+                      16 - (BITS) - ADC_JUST_##J(BITS), nScans, out);                           \
+    }                                                                                           \
+    TARGET static void adc_block_q31_##BITS##J##_##ISA(const uint16_t *raw, uint32_t M,        \
+                                                       const int16_t *offset, const q31_t *slope, \
+                                                       uint32_t nScans, q31_t *out) {          \
+        adc_q31_##ISA(raw, M, offset, slope, ADC_JUST_##J(BITS),                                \
+                      32 - (BITS) - ADC_JUST_##J(BITS), nScans, out);                           \
+    }                                                                                           \
+    TARGET static void adc_block_u_q31_##BITS##J##_##ISA(const uint16_t *raw, uint32_t M,      \
+                                                         const int16_t *offset, const q31_t *slope, \
+                                                         uint32_t nScans, q31_t *out) {        \
+        adc_q31_##ISA(raw, M, offset, slope, ADC_JUST_##J(BITS),                                \
+                      31 - (BITS) - ADC_JUST_##J(BITS), nScans, out);                           \
+    }
+
+#define ADC_KERNEL_LIST(KIND, ISA)                                                              \
+    { [ADC_FORMAT_10r] = adc_block_##KIND##_10r_##ISA, [ADC_FORMAT_10l] = adc_block_##KIND##_10l_##ISA, \
+      [ADC_FORMAT_12r] = adc_block_##KIND##_12r_##ISA, [ADC_FORMAT_12l] = adc_block_##KIND##_12l_##ISA, \
+      [ADC_FORMAT_14r] = adc_block_##KIND##_14r_##ISA, [ADC_FORMAT_14l] = adc_block_##KIND##_14l_##ISA, \
+      [ADC_FORMAT_16r] = adc_block_##KIND##_16r_##ISA, [ADC_FORMAT_16l] = adc_block_##KIND##_16l_##ISA }
+
+#define ADC_KERNEL_TABLE_DEFINE(ISA, TARGET)                                                    \
+    ADC_KERNELS_DEFINE(ISA, TARGET, 10, r)                                                      \
+    ADC_KERNELS_DEFINE(ISA, TARGET, 10, l)                                                      \
+    ADC_KERNELS_DEFINE(ISA, TARGET, 12, r)                                                      \
+    ADC_KERNELS_DEFINE(ISA, TARGET, 12, l)                                                      \
+    ADC_KERNELS_DEFINE(ISA, TARGET, 14, r)                                                      \
+    ADC_KERNELS_DEFINE(ISA, TARGET, 14, l)                                                      \
+    ADC_KERNELS_DEFINE(ISA, TARGET, 16, r)                                                      \
+    ADC_KERNELS_DEFINE(ISA, TARGET, 16, l)                                                      \
+    const adc_block_kernels_t adc_block_kernels_##ISA = {                                       \
+        ADC_KERNEL_LIST(q15, ISA), ADC_KERNEL_LIST(q31, ISA), ADC_KERNEL_LIST(u_q31, ISA)       \
+    };
+
+ADC_KERNEL_TABLE_DEFINE(scalar, )
+#ifdef RT_DSP_HAVE_X86
+ADC_KERNEL_TABLE_DEFINE(avx2, RT_DSP_TARGET_AVX2)
+ADC_KERNEL_TABLE_DEFINE(avx512, RT_DSP_TARGET_AVX512)
+#endif
+#ifdef RT_DSP_HAVE_NEON
+ADC_KERNEL_TABLE_DEFINE(neon, )
+#endif
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.  The
+unsuffixed conversions are the 12-bit right justified format.
+-----------------------------------------------------------------------------*/
+void adc_process_block_q15(const adc_cal_table_q15 *T, const uint16_t *raw, uint32_t nScans,
+                           q15_t *out) {
+    dsp_kernels.adc_block->q15[ADC_FORMAT_12r](raw, T->M, T->pOffset, T->pSlope, nScans, out);
+}
+
+void adc_process_block_q31(const adc_cal_table_q31 *T, const uint16_t *raw, uint32_t nScans,
+                           q31_t *out) {
+    dsp_kernels.adc_block->q31[ADC_FORMAT_12r](raw, T->M, T->pOffset, T->pSlope, nScans, out);
+}
+
+void adc_process_block_u_q31(const adc_cal_table_q31 *T, const uint16_t *raw, uint32_t nScans,
+                             q31_t *out) {
+    dsp_kernels.adc_block->u_q31[ADC_FORMAT_12r](raw, T->M, T->pOffset, T->pSlope, nScans, out);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Read as uint16_t a negative sample is 65536 too big, which the << 16 pushes
+out of the 32 bits, so the 16-bit right justified Q31 kernel gives the signed
+result.
+-----------------------------------------------------------------------------*/
+void adc_process_block_i16_q31(const adc_cal_table_q31 *T, const int16_t *raw, uint32_t nScans,
+                               q31_t *out) {
+    dsp_kernels.adc_block->q31[ADC_FORMAT_16r]((const uint16_t *)raw, T->M, T->pOffset, T->pSlope,
+                                               nScans, out);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The block forms of ADC_CONVERSION_DEFINE, each calls its format's kernel.
+-----------------------------------------------------------------------------*/
+#define ADC_BLOCK_CONVERSION_DEFINE(BITS, J)                                                    \
+    void adc_process_block_q15_##BITS##J(const adc_cal_table_q15 *T, const uint16_t *raw,    \
+                                         uint32_t nScans, q15_t *out) {                       \
+        dsp_kernels.adc_block->q15[ADC_FORMAT_##BITS##J](raw, T->M, T->pOffset, T->pSlope,     \
+                                                         nScans, out);                        \
+    }                                                                                         \
+    void adc_process_block_q31_##BITS##J(const adc_cal_table_q31 *T, const uint16_t *raw,    \
+                                         uint32_t nScans, q31_t *out) {                       \
+        dsp_kernels.adc_block->q31[ADC_FORMAT_##BITS##J](raw, T->M, T->pOffset, T->pSlope,     \
+                                                         nScans, out);                        \
+    }                                                                                         \
+    void adc_process_block_u_q31_##BITS##J(const adc_cal_table_q31 *T, const uint16_t *raw,  \
+                                           uint32_t nScans, q31_t *out) {                     \
+        dsp_kernels.adc_block->u_q31[ADC_FORMAT_##BITS##J](raw, T->M, T->pOffset, T->pSlope,   \
+                                                           nScans, out);                      \
+    }
+
+ADC_BLOCK_CONVERSION_DEFINE(10, r)
+ADC_BLOCK_CONVERSION_DEFINE(10, l)
+ADC_BLOCK_CONVERSION_DEFINE(12, r)
+ADC_BLOCK_CONVERSION_DEFINE(12, l)
+ADC_BLOCK_CONVERSION_DEFINE(14, r)
+ADC_BLOCK_CONVERSION_DEFINE(14, l)
+ADC_BLOCK_CONVERSION_DEFINE(16, r)
+ADC_BLOCK_CONVERSION_DEFINE(16, l)
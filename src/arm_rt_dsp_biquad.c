@@ -0,0 +1,316 @@
+/**
+ * \file arm_rt_dsp_biquad.c
+ * \brief Biquad cascades, in block form and as banks stored as structures of arrays.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Stage by stage over the whole block, so the coefficients and state of one stage
+stay in registers.  Same arithmetic as filter_biquad_q31.
+-----------------------------------------------------------------------------*/
+void filter_biquad_cas_q31_block(filter_biquad_cas_a63_t *param, const q31_t *in, q31_t *out,
+                                 uint32_t n)
+{
+  const q31_t *src = in;
+
+  if (param->numStages == 0 && out != in)
+  {
+    memmove(out, in, n * sizeof(q31_t));
+  }
+
+  for (uint32_t s = 0; s < param->numStages; s++)
+  {
+    filter_biquad_a63_t *st = &param->stages[s];
+    const acc64_t b0 = st->b0;
+    const acc64_t b1 = st->b1;
+    const acc64_t b2 = st->b2;
+    const acc64_t a1 = st->a1;
+    const acc64_t a2 = st->a2;
+    const uint32_t rsh = 31U - st->sh;
+    q31_t x1 = st->state[0];
+    q31_t x2 = st->state[1];
+    q31_t y1 = st->state[2];
+    q31_t y2 = st->state[3];
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+      q31_t x = src[i];
+      acc64_t acc = b0 * x;
+      acc += b1 * x1;
+      acc += b2 * x2;
+      acc += a1 * y1;
+      acc += a2 * y2;
+      q31_t y = (q31_t)ssat_i64(acc >> rsh, 32);
+
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      out[i] = y;
+    }
+
+    st->state[0] = x1;
+    st->state[1] = x2;
+    st->state[2] = y1;
+    st->state[3] = y2;
+    src = out;
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+There are no derived coefficients, so this only clears the state.
+-----------------------------------------------------------------------------*/
+void filter_biquad_bank_init(filter_biquad_bank_a63_t *S, int32_t resetStateFlag)
+{
+  if (resetStateFlag)
+  {
+    for (int k = 0; k < 4; k++)
+    {
+      memset(S->state[k], 0, S->n * S->numStages * sizeof(q31_t));
+    }
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void filter_biquad_bank_set(filter_biquad_bank_a63_t *S, uint32_t channel, uint32_t stage,
+                            const filter_biquad_a63_t *param)
+{
+  uint32_t k = stage * S->n + channel;
+
+  S->b0[k] = param->b0;
+  S->b1[k] = param->b1;
+  S->b2[k] = param->b2;
+  S->a1[k] = param->a1;
+  S->a2[k] = param->a2;
+  S->sh[k] = param->sh;
+  for (int j = 0; j < 4; j++)
+  {
+    S->state[j][k] = param->state[j];
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernel.  Stage s of channel i is stepped exactly like filter_biquad_q31.
+The kernels run one stage of every channel before the next stage, stage 0
+reads in[] and the later stages read the previous stage's out[].
+-----------------------------------------------------------------------------*/
+static inline void filter_biquad_bank_step_q31(filter_biquad_bank_a63_t *S, uint32_t s,
+                                               const q31_t *in, q31_t *out,
+                                               uint32_t i, uint32_t n)
+{
+    for (; i < n; i++) {
+        uint32_t k = s * S->n + i;
+        filter_biquad_a63_t f = { S->b0[k], S->b1[k], S->b2[k], S->a1[k], S->a2[k], S->sh[k],
+                                  { S->state[0][k], S->state[1][k], S->state[2][k], S->state[3][k] } };
+        out[i] = filter_biquad_q31(in[i], &f);
+        for (int j = 0; j < 4; j++) {
+            S->state[j][k] = f.state[j];
+        }
+    }
+}
+
+void filter_biquad_bank_q31_scalar(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    if (S->numStages == 0 && out != in) {
+        memmove(out, in, S->n * sizeof(q31_t));
+    }
+    for (uint32_t s = 0; s < S->numStages; s++) {
+        filter_biquad_bank_step_q31(S, s, s ? out : in, out, 0, S->n);
+    }
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+AVX2 does the arithmetic shift by 31 - sh as ((acc ^ m) >> cnt) ^ m with a
+variable logical shift, where m is the sign of acc, and then saturates with
+two compares against the q31_t range.  AVX-512 has VPSRAVQ and VPMOVSQD.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+void filter_biquad_bank_q31_avx2(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256i vmax = _mm256_set1_epi64x(INT32_MAX);
+    const __m256i vmin = _mm256_set1_epi64x(INT32_MIN);
+    const __m256i c31 = _mm256_set1_epi64x(31);
+    const uint32_t n = S->n;
+
+    if (S->numStages == 0 && out != in) {
+        memmove(out, in, n * sizeof(q31_t));
+    }
+    for (uint32_t s = 0; s < S->numStages; s++) {
+        const q31_t *src = s ? out : in;
+        uint32_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+            uint32_t k = s * n + i;
+            __m128i xin = _mm_loadu_si128((const __m128i *)&src[i]);
+            __m128i x1 = _mm_loadu_si128((const __m128i *)&S->state[0][k]);
+            __m128i y1 = _mm_loadu_si128((const __m128i *)&S->state[2][k]);
+            __m256i x2 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->state[1][k]));
+            __m256i y2 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->state[3][k]));
+            __m256i b0 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->b0[k]));
+            __m256i b1 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->b1[k]));
+            __m256i b2 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->b2[k]));
+            __m256i a1 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->a1[k]));
+            __m256i a2 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->a2[k]));
+
+            // 1.31 * 1.31 => 2.62
+            __m256i acc = _mm256_mul_epi32(b0, _mm256_cvtepi32_epi64(xin));
+            acc = _mm256_add_epi64(acc, _mm256_mul_epi32(b1, _mm256_cvtepi32_epi64(x1)));
+            acc = _mm256_add_epi64(acc, _mm256_mul_epi32(b2, x2));
+            acc = _mm256_add_epi64(acc, _mm256_mul_epi32(a1, _mm256_cvtepi32_epi64(y1)));
+            acc = _mm256_add_epi64(acc, _mm256_mul_epi32(a2, y2));
+
+            __m128i sh = _mm_loadl_epi64((const __m128i *)&S->sh[k]);
+            __m256i cnt = _mm256_sub_epi64(c31, _mm256_cvtepu16_epi64(sh));
+            __m256i m = _mm256_cmpgt_epi64(zero, acc);
+            __m256i y = _mm256_xor_si256(_mm256_srlv_epi64(_mm256_xor_si256(acc, m), cnt), m);
+            y = _mm256_blendv_epi8(y, vmax, _mm256_cmpgt_epi64(y, vmax));
+            y = _mm256_blendv_epi8(y, vmin, _mm256_cmpgt_epi64(vmin, y));
+            __m128i r = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(y, even));
+
+            _mm_storeu_si128((__m128i *)&S->state[1][k], x1);
+            _mm_storeu_si128((__m128i *)&S->state[0][k], xin);
+            _mm_storeu_si128((__m128i *)&S->state[3][k], y1);
+            _mm_storeu_si128((__m128i *)&S->state[2][k], r);
+            _mm_storeu_si128((__m128i *)&out[i], r);
+        }
+        filter_biquad_bank_step_q31(S, s, src, out, i, n);
+    }
+}
+
+RT_DSP_TARGET_AVX512
+void filter_biquad_bank_q31_avx512(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    const __m512i c31 = _mm512_set1_epi64(31);
+    const uint32_t n = S->n;
+
+    if (S->numStages == 0 && out != in) {
+        memmove(out, in, n * sizeof(q31_t));
+    }
+    for (uint32_t s = 0; s < S->numStages; s++) {
+        const q31_t *src = s ? out : in;
+        uint32_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+            uint32_t k = s * n + i;
+            __m256i xin = _mm256_loadu_si256((const __m256i *)&src[i]);
+            __m256i x1 = _mm256_loadu_si256((const __m256i *)&S->state[0][k]);
+            __m256i y1 = _mm256_loadu_si256((const __m256i *)&S->state[2][k]);
+            __m512i x2 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->state[1][k]));
+            __m512i y2 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->state[3][k]));
+            __m512i b0 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->b0[k]));
+            __m512i b1 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->b1[k]));
+            __m512i b2 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->b2[k]));
+            __m512i a1 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->a1[k]));
+            __m512i a2 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->a2[k]));
+
+            __m512i acc = _mm512_mul_epi32(b0, _mm512_cvtepi32_epi64(xin));
+            acc = _mm512_add_epi64(acc, _mm512_mul_epi32(b1, _mm512_cvtepi32_epi64(x1)));
+            acc = _mm512_add_epi64(acc, _mm512_mul_epi32(b2, x2));
+            acc = _mm512_add_epi64(acc, _mm512_mul_epi32(a1, _mm512_cvtepi32_epi64(y1)));
+            acc = _mm512_add_epi64(acc, _mm512_mul_epi32(a2, y2));
+
+            __m128i sh = _mm_loadu_si128((const __m128i *)&S->sh[k]);
+            __m512i cnt = _mm512_sub_epi64(c31, _mm512_cvtepu16_epi64(sh));
+            __m256i r = _mm512_cvtsepi64_epi32(_mm512_srav_epi64(acc, cnt));
+
+            _mm256_storeu_si256((__m256i *)&S->state[1][k], x1);
+            _mm256_storeu_si256((__m256i *)&S->state[0][k], xin);
+            _mm256_storeu_si256((__m256i *)&S->state[3][k], y1);
+            _mm256_storeu_si256((__m256i *)&S->state[2][k], r);
+            _mm256_storeu_si256((__m256i *)&out[i], r);
+        }
+        filter_biquad_bank_step_q31(S, s, src, out, i, n);
+    }
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+SSHL by sh - 31 is the arithmetic right shift and SQXTN the saturation.
+-----------------------------------------------------------------------------*/
+void filter_biquad_bank_q31_neon(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    const int32x4_t c31 = vdupq_n_s32(31);
+    const uint32_t n = S->n;
+
+    if (S->numStages == 0 && out != in) {
+        memmove(out, in, n * sizeof(q31_t));
+    }
+    for (uint32_t s = 0; s < S->numStages; s++) {
+        const q31_t *src = s ? out : in;
+        uint32_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+            uint32_t k = s * n + i;
+            int32x4_t x = vld1q_s32(&src[i]);
+            int32x4_t x1 = vld1q_s32(&S->state[0][k]);
+            int32x4_t x2 = vld1q_s32(&S->state[1][k]);
+            int32x4_t y1 = vld1q_s32(&S->state[2][k]);
+            int32x4_t y2 = vld1q_s32(&S->state[3][k]);
+            int32x4_t b0 = vld1q_s32(&S->b0[k]);
+            int32x4_t b1 = vld1q_s32(&S->b1[k]);
+            int32x4_t b2 = vld1q_s32(&S->b2[k]);
+            int32x4_t a1 = vld1q_s32(&S->a1[k]);
+            int32x4_t a2 = vld1q_s32(&S->a2[k]);
+
+            int64x2_t al = vmull_s32(vget_low_s32(b0), vget_low_s32(x));
+            int64x2_t ah = vmull_high_s32(b0, x);
+            al = vmlal_s32(al, vget_low_s32(b1), vget_low_s32(x1));
+            ah = vmlal_high_s32(ah, b1, x1);
+            al = vmlal_s32(al, vget_low_s32(b2), vget_low_s32(x2));
+            ah = vmlal_high_s32(ah, b2, x2);
+            al = vmlal_s32(al, vget_low_s32(a1), vget_low_s32(y1));
+            ah = vmlal_high_s32(ah, a1, y1);
+            al = vmlal_s32(al, vget_low_s32(a2), vget_low_s32(y2));
+            ah = vmlal_high_s32(ah, a2, y2);
+
+            int32x4_t cnt = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vld1_u16(&S->sh[k]))), c31);
+            int32x4_t r = vcombine_s32(vqmovn_s64(vshlq_s64(al, vmovl_s32(vget_low_s32(cnt)))),
+                                       vqmovn_s64(vshlq_s64(ah, vmovl_high_s32(cnt))));
+
+            vst1q_s32(&S->state[1][k], x1);
+            vst1q_s32(&S->state[0][k], x);
+            vst1q_s32(&S->state[3][k], y1);
+            vst1q_s32(&S->state[2][k], r);
+            vst1q_s32(&out[i], r);
+        }
+        filter_biquad_bank_step_q31(S, s, src, out, i, n);
+    }
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void filter_biquad_bank_q31(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    dsp_kernels.filter_biquad_bank_q31(S, in, out);
+}
@@ -0,0 +1,582 @@
+/**
+ * \file arm_rt_dsp_block.c
+ * \brief Block (array) versions of the core multiply and absolute value functions.
+*/
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernels.  These are the reference for every other kernel.
+-----------------------------------------------------------------------------*/
+void mul_q15_block_scalar(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = mul_q15(x[i], y[i]);
+    }
+}
+
+void mul_q31_block_scalar(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = mul_q31(x[i], y[i]);
+    }
+}
+
+void mulsat_q15_block_scalar(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = mulsat_q15(x[i], y[i]);
+    }
+}
+
+void mulsat_q31_block_scalar(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = mulsat_q31(x[i], y[i]);
+    }
+}
+
+// Only -1.0 saturates, it is counted in the Q flag like an SSAT would count it.
+void abs_sat_q15_block_scalar(const q15_t *x, q15_t *out, uint32_t n) {
+    uint32_t sat = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sat += (x[i] == INT16_MIN);
+        out[i] = abs_sat_q15(x[i]);
+    }
+    dsp_q_count += sat;
+}
+
+void abs_sat_q31_block_scalar(const q31_t *x, q31_t *out, uint32_t n) {
+    uint32_t sat = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sat += (x[i] == INT32_MIN);
+        out[i] = abs_sat_q31(x[i]);
+    }
+    dsp_q_count += sat;
+}
+
+// The dot products sum in unsigned arithmetic so a wrap is defined, like the vector adds.
+int64_t dot_q15_block_scalar(const q15_t *x, const q15_t *y, uint32_t n) {
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (uint64_t)((int32_t)x[i] * y[i]);
+    }
+    return (int64_t)acc;
+}
+
+int64_t dot_q31_block_scalar(const q31_t *x, const q31_t *y, uint32_t n) {
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (uint64_t)((int64_t)x[i] * y[i]);
+    }
+    return (int64_t)acc;
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+SSE4.1 kernels.
+
+Notes:
+The Q15 product (x*y) >> 15 is rebuilt from the high and low halves of the
+32-bit product, (hi << 1) | (lo >> 15), so it wraps exactly like mul_q15.
+Only the low 32 bits of (x*y) >> 31 are kept by mul_q31, so a logical 64-bit
+shift gives the same result as the arithmetic one.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_SSE41
+void mul_q15_block_sse41(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&x[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&y[i]);
+        __m128i lo = _mm_mullo_epi16(a, b);
+        __m128i hi = _mm_mulhi_epi16(a, b);
+        __m128i r = _mm_or_si128(_mm_slli_epi16(hi, 1), _mm_srli_epi16(lo, 15));
+        _mm_storeu_si128((__m128i *)&out[i], r);
+    }
+    mul_q15_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_SSE41
+void mul_q31_block_sse41(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&x[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&y[i]);
+        __m128i p02 = _mm_mul_epi32(a, b);
+        __m128i p13 = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        __m128i r = _mm_blend_epi16(_mm_srli_epi64(p02, 31), _mm_slli_epi64(p13, 1), 0xCC);
+        _mm_storeu_si128((__m128i *)&out[i], r);
+    }
+    mul_q31_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_SSE41
+void mulsat_q15_block_sse41(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    const __m128i vmax = _mm_set1_epi16(0x3FFF);
+    const __m128i vmin = _mm_set1_epi16(-0x4000);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&x[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&y[i]);
+        __m128i r = _mm_mulhi_epi16(a, b);
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi16(r, vmax)));
+        r = _mm_max_epi16(_mm_min_epi16(r, vmax), vmin);
+        _mm_storeu_si128((__m128i *)&out[i], _mm_slli_epi16(r, 1));
+    }
+    dsp_q_count += sat / 2;
+    mulsat_q15_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_SSE41
+void mulsat_q31_block_sse41(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    const __m128i vmax = _mm_set1_epi32(0x3FFFFFFF);
+    const __m128i vmin = _mm_set1_epi32(-0x40000000);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&x[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&y[i]);
+        __m128i p02 = _mm_mul_epi32(a, b);
+        __m128i p13 = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        __m128i r = _mm_blend_epi16(_mm_srli_epi64(p02, 32), p13, 0xCC);
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(r, vmax))));
+        r = _mm_max_epi32(_mm_min_epi32(r, vmax), vmin);
+        _mm_storeu_si128((__m128i *)&out[i], _mm_slli_epi32(r, 1));
+    }
+    dsp_q_count += sat;
+    mulsat_q31_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_SSE41
+void abs_sat_q15_block_sse41(const q15_t *x, q15_t *out, uint32_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i vmin = _mm_set1_epi16(INT16_MIN);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&x[i]);
+        __m128i r = _mm_max_epi16(a, _mm_subs_epi16(zero, a));
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(a, vmin)));
+        _mm_storeu_si128((__m128i *)&out[i], r);
+    }
+    dsp_q_count += sat / 2;
+    abs_sat_q15_block_scalar(&x[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_SSE41
+void abs_sat_q31_block_sse41(const q31_t *x, q31_t *out, uint32_t n) {
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i r = _mm_abs_epi32(_mm_loadu_si128((const __m128i *)&x[i]));
+        // abs(0x80000000) is 0x80000000, count it and knock it down to 0x7FFFFFFF.
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm_movemask_ps(_mm_castsi128_ps(r)));
+        r = _mm_sub_epi32(r, _mm_srli_epi32(r, 31));
+        _mm_storeu_si128((__m128i *)&out[i], r);
+    }
+    dsp_q_count += sat;
+    abs_sat_q31_block_scalar(&x[i], &out[i], n - i);
+}
+
+
+/*-----------------------------------------------------------------------------
+AVX2 kernels.  Same arithmetic as the SSE4.1 kernels on 256-bit vectors.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+void mul_q15_block_avx2(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&y[i]);
+        __m256i lo = _mm256_mullo_epi16(a, b);
+        __m256i hi = _mm256_mulhi_epi16(a, b);
+        __m256i r = _mm256_or_si256(_mm256_slli_epi16(hi, 1), _mm256_srli_epi16(lo, 15));
+        _mm256_storeu_si256((__m256i *)&out[i], r);
+    }
+    mul_q15_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void mul_q31_block_avx2(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&y[i]);
+        __m256i p02 = _mm256_mul_epi32(a, b);
+        __m256i p13 = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i r = _mm256_blend_epi16(_mm256_srli_epi64(p02, 31), _mm256_slli_epi64(p13, 1), 0xCC);
+        _mm256_storeu_si256((__m256i *)&out[i], r);
+    }
+    mul_q31_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void mulsat_q15_block_avx2(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    const __m256i vmax = _mm256_set1_epi16(0x3FFF);
+    const __m256i vmin = _mm256_set1_epi16(-0x4000);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&y[i]);
+        __m256i r = _mm256_mulhi_epi16(a, b);
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi16(r, vmax)));
+        r = _mm256_max_epi16(_mm256_min_epi16(r, vmax), vmin);
+        _mm256_storeu_si256((__m256i *)&out[i], _mm256_slli_epi16(r, 1));
+    }
+    dsp_q_count += sat / 2;
+    mulsat_q15_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void mulsat_q31_block_avx2(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    const __m256i vmax = _mm256_set1_epi32(0x3FFFFFFF);
+    const __m256i vmin = _mm256_set1_epi32(-0x40000000);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&y[i]);
+        __m256i p02 = _mm256_mul_epi32(a, b);
+        __m256i p13 = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i r = _mm256_blend_epi16(_mm256_srli_epi64(p02, 32), p13, 0xCC);
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(r, vmax))));
+        r = _mm256_max_epi32(_mm256_min_epi32(r, vmax), vmin);
+        _mm256_storeu_si256((__m256i *)&out[i], _mm256_slli_epi32(r, 1));
+    }
+    dsp_q_count += sat;
+    mulsat_q31_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void abs_sat_q15_block_avx2(const q15_t *x, q15_t *out, uint32_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i vmin = _mm256_set1_epi16(INT16_MIN);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i r = _mm256_max_epi16(a, _mm256_subs_epi16(zero, a));
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, vmin)));
+        _mm256_storeu_si256((__m256i *)&out[i], r);
+    }
+    dsp_q_count += sat / 2;
+    abs_sat_q15_block_scalar(&x[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void abs_sat_q31_block_avx2(const q31_t *x, q31_t *out, uint32_t n) {
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i r = _mm256_abs_epi32(_mm256_loadu_si256((const __m256i *)&x[i]));
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(r)));
+        r = _mm256_sub_epi32(r, _mm256_srli_epi32(r, 31));
+        _mm256_storeu_si256((__m256i *)&out[i], r);
+    }
+    dsp_q_count += sat;
+    abs_sat_q31_block_scalar(&x[i], &out[i], n - i);
+}
+
+// Sums the four 64-bit lanes.
+RT_DSP_TARGET_AVX2
+static inline uint64_t hsum_epi64_avx2(__m256i acc) {
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    return (uint64_t)_mm_cvtsi128_si64(s) + (uint64_t)_mm_extract_epi64(s, 1);
+}
+
+// PMADDWD wraps only for (-1.0 * -1.0) * 2 = 2^31, and a pair sum can never be
+// -2^31, so (int64_t)(pair - 1) + 1 sign extends the pair sums exactly.
+RT_DSP_TARGET_AVX2
+int64_t dot_q15_block_avx2(const q15_t *x, const q15_t *y, uint32_t n) {
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&y[i]);
+        __m256i m = _mm256_sub_epi32(_mm256_madd_epi16(a, b), one);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(m)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(m, 1)));
+    }
+    // Put back the 8 subtracted per iteration.
+    uint64_t sum = hsum_epi64_avx2(acc) + (uint64_t)i / 2;
+    return (int64_t)(sum + (uint64_t)dot_q15_block_scalar(&x[i], &y[i], n - i));
+}
+
+RT_DSP_TARGET_AVX2
+int64_t dot_q31_block_avx2(const q31_t *x, const q31_t *y, uint32_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&y[i]);
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(a, b));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)));
+    }
+    uint64_t sum = hsum_epi64_avx2(acc);
+    return (int64_t)(sum + (uint64_t)dot_q31_block_scalar(&x[i], &y[i], n - i));
+}
+
+/*-----------------------------------------------------------------------------
+AVX-512 kernels.  Same arithmetic as the SSE4.1 kernels on 512-bit vectors.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX512
+void mul_q15_block_avx512(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i a = _mm512_loadu_si512((const void *)&x[i]);
+        __m512i b = _mm512_loadu_si512((const void *)&y[i]);
+        __m512i lo = _mm512_mullo_epi16(a, b);
+        __m512i hi = _mm512_mulhi_epi16(a, b);
+        __m512i r = _mm512_or_si512(_mm512_slli_epi16(hi, 1), _mm512_srli_epi16(lo, 15));
+        _mm512_storeu_si512((void *)&out[i], r);
+    }
+    mul_q15_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void mul_q31_block_avx512(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i a = _mm512_loadu_si512((const void *)&x[i]);
+        __m512i b = _mm512_loadu_si512((const void *)&y[i]);
+        __m512i p02 = _mm512_mul_epi32(a, b);
+        __m512i p13 = _mm512_mul_epi32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+        __m512i r = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(p02, 31), _mm512_slli_epi64(p13, 1));
+        _mm512_storeu_si512((void *)&out[i], r);
+    }
+    mul_q31_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void mulsat_q15_block_avx512(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    const __m512i vmax = _mm512_set1_epi16(0x3FFF);
+    const __m512i vmin = _mm512_set1_epi16(-0x4000);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i a = _mm512_loadu_si512((const void *)&x[i]);
+        __m512i b = _mm512_loadu_si512((const void *)&y[i]);
+        __m512i r = _mm512_mulhi_epi16(a, b);
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm512_cmpgt_epi16_mask(r, vmax));
+        r = _mm512_max_epi16(_mm512_min_epi16(r, vmax), vmin);
+        _mm512_storeu_si512((void *)&out[i], _mm512_slli_epi16(r, 1));
+    }
+    dsp_q_count += sat;
+    mulsat_q15_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void mulsat_q31_block_avx512(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    const __m512i vmax = _mm512_set1_epi32(0x3FFFFFFF);
+    const __m512i vmin = _mm512_set1_epi32(-0x40000000);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i a = _mm512_loadu_si512((const void *)&x[i]);
+        __m512i b = _mm512_loadu_si512((const void *)&y[i]);
+        __m512i p02 = _mm512_mul_epi32(a, b);
+        __m512i p13 = _mm512_mul_epi32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+        __m512i r = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(p02, 32), p13);
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm512_cmpgt_epi32_mask(r, vmax));
+        r = _mm512_max_epi32(_mm512_min_epi32(r, vmax), vmin);
+        _mm512_storeu_si512((void *)&out[i], _mm512_slli_epi32(r, 1));
+    }
+    dsp_q_count += sat;
+    mulsat_q31_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void abs_sat_q15_block_avx512(const q15_t *x, q15_t *out, uint32_t n) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i vmin = _mm512_set1_epi16(INT16_MIN);
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i a = _mm512_loadu_si512((const void *)&x[i]);
+        __m512i r = _mm512_max_epi16(a, _mm512_subs_epi16(zero, a));
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm512_cmpeq_epi16_mask(a, vmin));
+        _mm512_storeu_si512((void *)&out[i], r);
+    }
+    dsp_q_count += sat;
+    abs_sat_q15_block_scalar(&x[i], &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void abs_sat_q31_block_avx512(const q31_t *x, q31_t *out, uint32_t n) {
+    uint32_t sat = 0;
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i r = _mm512_abs_epi32(_mm512_loadu_si512((const void *)&x[i]));
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm512_cmplt_epi32_mask(r, _mm512_setzero_si512()));
+        r = _mm512_sub_epi32(r, _mm512_srli_epi32(r, 31));
+        _mm512_storeu_si512((void *)&out[i], r);
+    }
+    dsp_q_count += sat;
+    abs_sat_q31_block_scalar(&x[i], &out[i], n - i);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels for AArch64.
+
+Notes:
+The narrowing shifts truncate, which matches the casts in the scalar functions.
+-----------------------------------------------------------------------------*/
+void mul_q15_block_neon(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t a = vld1q_s16(&x[i]);
+        int16x8_t b = vld1q_s16(&y[i]);
+        int32x4_t pl = vmull_s16(vget_low_s16(a), vget_low_s16(b));
+        int32x4_t ph = vmull_high_s16(a, b);
+        vst1q_s16(&out[i], vcombine_s16(vshrn_n_s32(pl, 15), vshrn_n_s32(ph, 15)));
+    }
+    mul_q15_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+void mul_q31_block_neon(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t a = vld1q_s32(&x[i]);
+        int32x4_t b = vld1q_s32(&y[i]);
+        int64x2_t pl = vmull_s32(vget_low_s32(a), vget_low_s32(b));
+        int64x2_t ph = vmull_high_s32(a, b);
+        vst1q_s32(&out[i], vcombine_s32(vshrn_n_s64(pl, 31), vshrn_n_s64(ph, 31)));
+    }
+    mul_q31_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+void mulsat_q15_block_neon(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    const int16x8_t vmax = vdupq_n_s16(0x3FFF);
+    const int16x8_t vmin = vdupq_n_s16(-0x4000);
+    uint32x4_t sat = vdupq_n_u32(0);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t a = vld1q_s16(&x[i]);
+        int16x8_t b = vld1q_s16(&y[i]);
+        int32x4_t pl = vmull_s16(vget_low_s16(a), vget_low_s16(b));
+        int32x4_t ph = vmull_high_s16(a, b);
+        int16x8_t r = vcombine_s16(vshrn_n_s32(pl, 16), vshrn_n_s32(ph, 16));
+        sat = vpadalq_u16(sat, vshrq_n_u16(vcgtq_s16(r, vmax), 15));
+        r = vmaxq_s16(vminq_s16(r, vmax), vmin);
+        vst1q_s16(&out[i], vshlq_n_s16(r, 1));
+    }
+    dsp_q_count += vaddvq_u32(sat);
+    mulsat_q15_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+void mulsat_q31_block_neon(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    const int32x4_t vmax = vdupq_n_s32(0x3FFFFFFF);
+    const int32x4_t vmin = vdupq_n_s32(-0x40000000);
+    uint32x4_t sat = vdupq_n_u32(0);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t a = vld1q_s32(&x[i]);
+        int32x4_t b = vld1q_s32(&y[i]);
+        int64x2_t pl = vmull_s32(vget_low_s32(a), vget_low_s32(b));
+        int64x2_t ph = vmull_high_s32(a, b);
+        int32x4_t r = vcombine_s32(vshrn_n_s64(pl, 32), vshrn_n_s64(ph, 32));
+        sat = vsubq_u32(sat, vcgtq_s32(r, vmax));
+        r = vmaxq_s32(vminq_s32(r, vmax), vmin);
+        vst1q_s32(&out[i], vshlq_n_s32(r, 1));
+    }
+    dsp_q_count += vaddvq_u32(sat);
+    mulsat_q31_block_scalar(&x[i], &y[i], &out[i], n - i);
+}
+
+void abs_sat_q15_block_neon(const q15_t *x, q15_t *out, uint32_t n) {
+    const int16x8_t vmin = vdupq_n_s16(INT16_MIN);
+    uint32x4_t sat = vdupq_n_u32(0);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t a = vld1q_s16(&x[i]);
+        sat = vpadalq_u16(sat, vshrq_n_u16(vceqq_s16(a, vmin), 15));
+        vst1q_s16(&out[i], vqabsq_s16(a));
+    }
+    dsp_q_count += vaddvq_u32(sat);
+    abs_sat_q15_block_scalar(&x[i], &out[i], n - i);
+}
+
+void abs_sat_q31_block_neon(const q31_t *x, q31_t *out, uint32_t n) {
+    const int32x4_t vmin = vdupq_n_s32(INT32_MIN);
+    uint32x4_t sat = vdupq_n_u32(0);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t a = vld1q_s32(&x[i]);
+        sat = vsubq_u32(sat, vceqq_s32(a, vmin));
+        vst1q_s32(&out[i], vqabsq_s32(a));
+    }
+    dsp_q_count += vaddvq_u32(sat);
+    abs_sat_q31_block_scalar(&x[i], &out[i], n - i);
+}
+
+int64_t dot_q15_block_neon(const q15_t *x, const q15_t *y, uint32_t n) {
+    int64x2_t acc = vdupq_n_s64(0);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t a = vld1q_s16(&x[i]);
+        int16x8_t b = vld1q_s16(&y[i]);
+        acc = vpadalq_s32(acc, vmull_s16(vget_low_s16(a), vget_low_s16(b)));
+        acc = vpadalq_s32(acc, vmull_high_s16(a, b));
+    }
+    uint64_t sum = (uint64_t)vaddvq_s64(acc);
+    return (int64_t)(sum + (uint64_t)dot_q15_block_scalar(&x[i], &y[i], n - i));
+}
+
+int64_t dot_q31_block_neon(const q31_t *x, const q31_t *y, uint32_t n) {
+    int64x2_t accl = vdupq_n_s64(0);
+    int64x2_t acch = vdupq_n_s64(0);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t a = vld1q_s32(&x[i]);
+        int32x4_t b = vld1q_s32(&y[i]);
+        accl = vmlal_s32(accl, vget_low_s32(a), vget_low_s32(b));
+        acch = vmlal_high_s32(acch, a, b);
+    }
+    uint64_t sum = (uint64_t)vaddvq_s64(vaddq_s64(accl, acch));
+    return (int64_t)(sum + (uint64_t)dot_q31_block_scalar(&x[i], &y[i], n - i));
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void mul_q15_block(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    dsp_kernels.mul_q15_block(x, y, out, n);
+}
+
+void mul_q31_block(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    dsp_kernels.mul_q31_block(x, y, out, n);
+}
+
+void mulsat_q15_block(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n) {
+    dsp_kernels.mulsat_q15_block(x, y, out, n);
+}
+
+void mulsat_q31_block(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n) {
+    dsp_kernels.mulsat_q31_block(x, y, out, n);
+}
+
+void abs_sat_q15_block(const q15_t *x, q15_t *out, uint32_t n) {
+    dsp_kernels.abs_sat_q15_block(x, out, n);
+}
+
+void abs_sat_q31_block(const q31_t *x, q31_t *out, uint32_t n) {
+    dsp_kernels.abs_sat_q31_block(x, out, n);
+}
+
+int64_t dot_q15_block(const q15_t *x, const q15_t *y, uint32_t n) {
+    return dsp_kernels.dot_q15_block(x, y, n);
+}
+
+int64_t dot_q31_block(const q31_t *x, const q31_t *y, uint32_t n) {
+    return dsp_kernels.dot_q31_block(x, y, n);
+}
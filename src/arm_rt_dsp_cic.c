@@ -0,0 +1,254 @@
+/**
+ * \file arm_rt_dsp_cic.c
+ * \brief CIC decimators for 1-bit sigma-delta bitstreams.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+
+
+// cic_byte_table[n][b] is what byte b adds to integrator n when integrated from zero
+// state, with the first sample in bit 0.  The largest entry is C(12, 5) = 792.
+static uint16_t cic_byte_table[CIC_MAX_ORDER][256];
+static uint8_t cic_bit_reverse[256];
+static int cic_tables_ready = 0;
+
+// Eight steps of integrator m add C(7 + k, k) times its old value to integrator m + k.
+static const uint32_t cic_byte_carry[CIC_MAX_ORDER] = { 1, 8, 36, 120, 330 };
+
+// The largest R of each order N with R^N below 2^62, so the wrap of the integrators
+// is harmless and 2 * y - R^N fits an int64_t.
+static const uint16_t cic_max_rate[CIC_MAX_ORDER] = { 65535, 65535, 65535, 46340, 5404 };
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The tables are filled by running the integrators one bit at a time.
+-----------------------------------------------------------------------------*/
+static void cic_tables_init(void)
+{
+  for (uint32_t b = 0; b < 256; b++)
+  {
+    uint32_t integ[CIC_MAX_ORDER] = { 0 };
+    uint32_t r = 0;
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+      uint32_t acc = (b >> i) & 1U;
+      for (uint32_t k = 0; k < CIC_MAX_ORDER; k++)
+      {
+        integ[k] += acc;
+        acc = integ[k];
+      }
+      r |= ((b >> i) & 1U) << (7U - i);
+    }
+    for (uint32_t k = 0; k < CIC_MAX_ORDER; k++)
+    {
+      cic_byte_table[k][b] = (uint16_t)integ[k];
+    }
+    cic_bit_reverse[b] = (uint8_t)r;
+  }
+  cic_tables_ready = 1;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+order and R are clamped to what the decimator can run: an order of 0 would
+have no integrator to read, R = 0 would never finish a word, and R^N must stay
+below 2^62, see cic_max_rate.
+-----------------------------------------------------------------------------*/
+void cic_decimate_init(cic_decimate_instance *S, uint16_t order, uint16_t R, int32_t msbFirst)
+{
+  if (!cic_tables_ready)
+  {
+    cic_tables_init();
+  }
+  if (order < 1)
+  {
+    order = 1;
+  }
+  else if (order > CIC_MAX_ORDER)
+  {
+    order = CIC_MAX_ORDER;
+  }
+  if (R < 1)
+  {
+    R = 1;
+  }
+  else if (R > cic_max_rate[order - 1U])
+  {
+    R = cic_max_rate[order - 1U];
+  }
+
+  S->order = order;
+  S->R = R;
+  S->phase = 0;
+  S->msbFirst = (msbFirst != 0);
+
+  S->gain = 1;
+  for (uint32_t k = 0; k < order; k++)
+  {
+    S->gain *= R;
+  }
+  S->bits = (S->gain > 1) ? (uint16_t)(64 - __builtin_clzll(S->gain - 1U)) : 0;
+
+  memset(S->integ, 0, sizeof(S->integ));
+  memset(S->comb, 0, sizeof(S->comb));
+}
+
+
+// One input sample through the integrators.
+static inline void cic_step_bit(cic_decimate_instance *S, uint32_t b)
+{
+  uint64_t acc = b;
+  for (uint32_t k = 0; k < S->order; k++)
+  {
+    S->integ[k] += acc;
+    acc = S->integ[k];
+  }
+}
+
+// Eight input samples through the integrators.  The highest integrator is updated
+// first because it needs the old values of the lower ones.
+static inline void cic_step_byte(cic_decimate_instance *S, uint32_t b)
+{
+  for (uint32_t k = S->order; k-- > 0;)
+  {
+    uint64_t v = S->integ[k] + cic_byte_table[k][b];
+    for (uint32_t m = 0; m < k; m++)
+    {
+      v += (uint64_t)cic_byte_carry[k - m] * S->integ[m];
+    }
+    S->integ[k] = v;
+  }
+}
+
+// The combs, giving the bipolar output in [-R^N, R^N].  The integrators may have
+// wrapped but the difference is exact.
+static inline int64_t cic_comb(cic_decimate_instance *S)
+{
+  uint64_t y = S->integ[S->order - 1U];
+  for (uint32_t k = 0; k < S->order; k++)
+  {
+    uint64_t t = y - S->comb[k];
+    S->comb[k] = y;
+    y = t;
+  }
+  return 2 * (int64_t)y - (int64_t)S->gain;
+}
+
+static inline int64_t cic_scale(int64_t v, uint32_t bits, uint32_t outBits)
+{
+  if (bits <= outBits)
+  {
+    return v * ((int64_t)1 << (outBits - bits));
+  }
+  return v >> (bits - outBits);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Each word is taken apart in the largest pieces that don't cross an output:
+popcounts of whole runs for order 1, whole bytes through the table otherwise,
+and single bits to get back onto a byte boundary.  Exactly one of out31 and
+out16 is used.
+-----------------------------------------------------------------------------*/
+static inline uint32_t cic_decimate_run(cic_decimate_instance *S, const uint64_t *in,
+                                        q31_t *out31, int16_t *out16, uint32_t n)
+{
+  uint32_t m = 0;
+
+  for (uint32_t w = 0; w < n; w++)
+  {
+    uint64_t x = in[w];
+    uint32_t pos = 0;
+
+    if (S->msbFirst)
+    {
+      x = __builtin_bswap64(x);
+      uint64_t r = 0;
+      for (uint32_t b = 0; b < 64; b += 8)
+      {
+        r |= (uint64_t)cic_bit_reverse[(x >> b) & 0xFFU] << b;
+      }
+      x = r;
+    }
+
+    while (pos < 64)
+    {
+      uint32_t left = (uint32_t)S->R - S->phase;
+      uint32_t len;
+
+      if (S->order == 1)
+      {
+        len = (64U - pos < left) ? 64U - pos : left;
+        uint64_t bits = x >> pos;
+        if (len < 64)
+        {
+          bits &= ((uint64_t)1 << len) - 1U;
+        }
+        S->integ[0] += (uint64_t)__builtin_popcountll(bits);
+      }
+      else if ((pos & 7U) == 0 && left >= 8)
+      {
+        len = 8;
+        cic_step_byte(S, (uint32_t)(x >> pos) & 0xFFU);
+      }
+      else
+      {
+        len = 1;
+        cic_step_bit(S, (uint32_t)(x >> pos) & 1U);
+      }
+      pos += len;
+      S->phase = (uint16_t)(S->phase + len);
+
+      if (S->phase == S->R)
+      {
+        int64_t v = cic_comb(S);
+        S->phase = 0;
+        if (out31)
+        {
+          out31[m++] = (q31_t)ssat_i64(cic_scale(v, S->bits, 31), 32);
+        }
+        else
+        {
+          out16[m++] = (int16_t)ssat_i64(cic_scale(v, S->bits, 15), 16);
+        }
+      }
+    }
+  }
+
+  return m;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+uint32_t cic_decimate_q31(cic_decimate_instance *S, const uint64_t *in, q31_t *out, uint32_t n)
+{
+  return cic_decimate_run(S, in, out, NULL, n);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+uint32_t cic_decimate_i16(cic_decimate_instance *S, const uint64_t *in, int16_t *out, uint32_t n)
+{
+  return cic_decimate_run(S, in, NULL, out, n);
+}
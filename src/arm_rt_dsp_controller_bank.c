@@ -0,0 +1,344 @@
+/**
+ * \file arm_rt_dsp_controller_bank.c
+ * \brief Banks of controllers stored as structures of arrays.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same derived gains as iir_pi_init_q31, one controller at a time.
+-----------------------------------------------------------------------------*/
+void iir_pi_bank_init_q31(iir_pi_bank_instance_q31 *S, int32_t resetStateFlag)
+{
+  for (uint32_t i = 0; i < S->n; i++)
+  {
+    S->A0[i] = __QADD(S->Kp[i], S->Ki[i]);
+    S->A1[i] = 0 - S->Kp[i];
+  }
+
+  if (resetStateFlag)
+  {
+    memset(S->state[0], 0, S->n * sizeof(q31_t));
+    memset(S->state[1], 0, S->n * sizeof(q31_t));
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same derived gains as iir_pi_init_q15, one controller at a time.
+-----------------------------------------------------------------------------*/
+void iir_pi_bank_init_q15(iir_pi_bank_instance_q15 *S, int32_t resetStateFlag)
+{
+  for (uint32_t i = 0; i < S->n; i++)
+  {
+    S->A0[i] = __QADD16(S->Kp[i], S->Ki[i]);
+    S->A1[i] = __QSUB16(0, S->Kp[i]);
+  }
+
+  if (resetStateFlag)
+  {
+    memset(S->state[0], 0, S->n * sizeof(q15_t));
+    memset(S->state[1], 0, S->n * sizeof(q15_t));
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernels.  Controller i is stepped exactly like iir_pi_q31/iir_pi_q15.
+
+Notes:
+iir_pi_q31 saturates with ssat_i64, which doesn't touch the Q flag, so the Q31
+step counts the outputs that differ from the unsaturated sum itself.  The Q15
+step saturates with __SSAT, which counts.
+-----------------------------------------------------------------------------*/
+static inline void iir_pi_bank_step_q31(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out,
+                                        uint32_t i, uint32_t n)
+{
+    uint32_t sat = 0;
+    for (; i < n; i++) {
+        iir_pi_instance_q31 pi = { 0, 0, S->A0[i], S->A1[i], { S->state[0][i], S->state[1][i] } };
+        int64_t acc = ((int64_t)pi.A0 * in[i] + (int64_t)pi.A1 * pi.state[0]
+                       + (int64_t)pi.state[1] * 32768) >> 15;
+        out[i] = iir_pi_q31(&pi, in[i]);
+        sat += (out[i] != acc);
+        S->state[0][i] = pi.state[0];
+        S->state[1][i] = pi.state[1];
+    }
+    dsp_q_count += sat;
+}
+
+static inline void iir_pi_bank_step_q15(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out,
+                                        uint32_t i, uint32_t n)
+{
+    for (; i < n; i++) {
+        iir_pi_instance_q15 pi = { S->A0[i], S->A1[i], { S->state[0][i], S->state[1][i] }, 0, 0 };
+        out[i] = iir_pi_q15(&pi, in[i]);
+        S->state[0][i] = pi.state[0];
+        S->state[1][i] = pi.state[1];
+    }
+}
+
+void iir_pi_bank_q31_scalar(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out) {
+    iir_pi_bank_step_q31(S, in, out, 0, S->n);
+}
+
+void iir_pi_bank_q15_scalar(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out) {
+    iir_pi_bank_step_q15(S, in, out, 0, S->n);
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+Q31: the 64-bit accumulator is clamped to the range whose >> 15 fits in 32
+bits.  After that the low 32 bits of a logical shift are the saturated output,
+which stands in for the missing 64-bit arithmetic shift in AVX2.
+Q15: PMADDWD of (A0, A1) with (x[n], x[n-1]) is the same dual multiply-add as
+SMLAD, and PACKSSDW is the final 16-bit __SSAT.  The lanes that saturate are
+counted in the Q flag like the scalar kernels count them.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+void iir_pi_bank_q31_avx2(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out) {
+    const __m256i vmax = _mm256_set1_epi64x(((int64_t)INT32_MAX << 15) | 0x7FFF);
+    const __m256i vmin = _mm256_set1_epi64x((int64_t)INT32_MIN * 32768);
+    const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    q31_t *x1 = S->state[0];
+    q31_t *y1 = S->state[1];
+    uint32_t sat = 0;
+    uint32_t i = 0;
+
+    for (; i + 4 <= S->n; i += 4) {
+        __m128i xin = _mm_loadu_si128((const __m128i *)&in[i]);
+        __m256i x = _mm256_cvtepi32_epi64(xin);
+        __m256i a0 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->A0[i]));
+        __m256i a1 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&S->A1[i]));
+        __m256i xp = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&x1[i]));
+        __m256i yp = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&y1[i]));
+
+        // 17.15 * 1.31 => 18.46
+        __m256i acc = _mm256_add_epi64(_mm256_mul_epi32(a0, x), _mm256_mul_epi32(a1, xp));
+        acc = _mm256_add_epi64(acc, _mm256_slli_epi64(yp, 15));
+
+        __m256i hi = _mm256_cmpgt_epi64(acc, vmax);
+        __m256i lo = _mm256_cmpgt_epi64(vmin, acc);
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_or_si256(hi, lo))));
+        acc = _mm256_blendv_epi8(acc, vmax, hi);
+        acc = _mm256_blendv_epi8(acc, vmin, lo);
+        acc = _mm256_srli_epi64(acc, 15);
+        __m128i r = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(acc, even));
+
+        _mm_storeu_si128((__m128i *)&out[i], r);
+        _mm_storeu_si128((__m128i *)&x1[i], xin);
+        _mm_storeu_si128((__m128i *)&y1[i], r);
+    }
+    dsp_q_count += sat;
+    iir_pi_bank_step_q31(S, in, out, i, S->n);
+}
+
+RT_DSP_TARGET_AVX512
+void iir_pi_bank_q31_avx512(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out) {
+    q31_t *x1 = S->state[0];
+    q31_t *y1 = S->state[1];
+    uint32_t sat = 0;
+    uint32_t i = 0;
+
+    for (; i + 8 <= S->n; i += 8) {
+        __m256i xin = _mm256_loadu_si256((const __m256i *)&in[i]);
+        __m512i x = _mm512_cvtepi32_epi64(xin);
+        __m512i a0 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->A0[i]));
+        __m512i a1 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&S->A1[i]));
+        __m512i xp = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&x1[i]));
+        __m512i yp = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&y1[i]));
+
+        __m512i acc = _mm512_add_epi64(_mm512_mul_epi32(a0, x), _mm512_mul_epi32(a1, xp));
+        acc = _mm512_add_epi64(acc, _mm512_slli_epi64(yp, 15));
+
+        // VPMOVSQD is exactly ssat_i64(acc, 32), the lanes it clamped no longer sign extend back.
+        acc = _mm512_srai_epi64(acc, 15);
+        __m256i r = _mm512_cvtsepi64_epi32(acc);
+        sat += (uint32_t)__builtin_popcount(_mm512_cmpneq_epi64_mask(acc, _mm512_cvtepi32_epi64(r)));
+
+        _mm256_storeu_si256((__m256i *)&out[i], r);
+        _mm256_storeu_si256((__m256i *)&x1[i], xin);
+        _mm256_storeu_si256((__m256i *)&y1[i], r);
+    }
+    dsp_q_count += sat;
+    iir_pi_bank_step_q31(S, in, out, i, S->n);
+}
+
+RT_DSP_TARGET_SSE41
+void iir_pi_bank_q15_sse41(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rnd = _mm_set1_epi32(1 << 6);
+    const __m128i vmax = _mm_set1_epi32(INT16_MAX);
+    const __m128i vmin = _mm_set1_epi32(INT16_MIN);
+    q15_t *x1 = S->state[0];
+    q15_t *y1 = S->state[1];
+    uint32_t sat = 0;
+    uint32_t i = 0;
+
+    for (; i + 8 <= S->n; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i *)&in[i]);
+        __m128i a0 = _mm_loadu_si128((const __m128i *)&S->A0[i]);
+        __m128i a1 = _mm_loadu_si128((const __m128i *)&S->A1[i]);
+        __m128i xp = _mm_loadu_si128((const __m128i *)&x1[i]);
+        __m128i yp = _mm_loadu_si128((const __m128i *)&y1[i]);
+
+        // 9.7 * 1.15 => 10.22, y[n-1] << 7 comes from (y[n-1] << 16) >> 9.
+        __m128i tlo = _mm_madd_epi16(_mm_unpacklo_epi16(a0, a1), _mm_unpacklo_epi16(x, xp));
+        __m128i thi = _mm_madd_epi16(_mm_unpackhi_epi16(a0, a1), _mm_unpackhi_epi16(x, xp));
+        tlo = _mm_add_epi32(tlo, _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(zero, yp), 9), rnd));
+        thi = _mm_add_epi32(thi, _mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(zero, yp), 9), rnd));
+        tlo = _mm_srai_epi32(tlo, 7);
+        thi = _mm_srai_epi32(thi, 7);
+        __m128i r = _mm_packs_epi32(tlo, thi);
+        __m128i slo = _mm_or_si128(_mm_cmpgt_epi32(tlo, vmax), _mm_cmpgt_epi32(vmin, tlo));
+        __m128i shi = _mm_or_si128(_mm_cmpgt_epi32(thi, vmax), _mm_cmpgt_epi32(vmin, thi));
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm_movemask_epi8(_mm_packs_epi32(slo, shi)));
+
+        _mm_storeu_si128((__m128i *)&out[i], r);
+        _mm_storeu_si128((__m128i *)&x1[i], x);
+        _mm_storeu_si128((__m128i *)&y1[i], r);
+    }
+    dsp_q_count += sat / 2;
+    iir_pi_bank_step_q15(S, in, out, i, S->n);
+}
+
+RT_DSP_TARGET_AVX2
+void iir_pi_bank_q15_avx2(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rnd = _mm256_set1_epi32(1 << 6);
+    const __m256i vmax = _mm256_set1_epi32(INT16_MAX);
+    const __m256i vmin = _mm256_set1_epi32(INT16_MIN);
+    q15_t *x1 = S->state[0];
+    q15_t *y1 = S->state[1];
+    uint32_t sat = 0;
+    uint32_t i = 0;
+
+    // The unpacks and the pack both work within 128-bit lanes so the order comes back out.
+    for (; i + 16 <= S->n; i += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)&in[i]);
+        __m256i a0 = _mm256_loadu_si256((const __m256i *)&S->A0[i]);
+        __m256i a1 = _mm256_loadu_si256((const __m256i *)&S->A1[i]);
+        __m256i xp = _mm256_loadu_si256((const __m256i *)&x1[i]);
+        __m256i yp = _mm256_loadu_si256((const __m256i *)&y1[i]);
+
+        __m256i tlo = _mm256_madd_epi16(_mm256_unpacklo_epi16(a0, a1), _mm256_unpacklo_epi16(x, xp));
+        __m256i thi = _mm256_madd_epi16(_mm256_unpackhi_epi16(a0, a1), _mm256_unpackhi_epi16(x, xp));
+        tlo = _mm256_add_epi32(tlo, _mm256_add_epi32(_mm256_srai_epi32(_mm256_unpacklo_epi16(zero, yp), 9), rnd));
+        thi = _mm256_add_epi32(thi, _mm256_add_epi32(_mm256_srai_epi32(_mm256_unpackhi_epi16(zero, yp), 9), rnd));
+        tlo = _mm256_srai_epi32(tlo, 7);
+        thi = _mm256_srai_epi32(thi, 7);
+        __m256i r = _mm256_packs_epi32(tlo, thi);
+        __m256i slo = _mm256_or_si256(_mm256_cmpgt_epi32(tlo, vmax), _mm256_cmpgt_epi32(vmin, tlo));
+        __m256i shi = _mm256_or_si256(_mm256_cmpgt_epi32(thi, vmax), _mm256_cmpgt_epi32(vmin, thi));
+        sat += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(_mm256_packs_epi32(slo, shi)));
+
+        _mm256_storeu_si256((__m256i *)&out[i], r);
+        _mm256_storeu_si256((__m256i *)&x1[i], x);
+        _mm256_storeu_si256((__m256i *)&y1[i], r);
+    }
+    dsp_q_count += sat / 2;
+    iir_pi_bank_step_q15(S, in, out, i, S->n);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+The saturating narrowing shifts (SQSHRN) do the shift and the __SSAT in one.
+A lane saturated when it differs from the plain shift, the lanes that match
+are counted and the rest go to the Q flag.
+-----------------------------------------------------------------------------*/
+void iir_pi_bank_q31_neon(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out) {
+    q31_t *x1 = S->state[0];
+    q31_t *y1 = S->state[1];
+    uint64x2_t same = vdupq_n_u64(0);
+    uint32_t i = 0;
+
+    for (; i + 4 <= S->n; i += 4) {
+        int32x4_t x = vld1q_s32(&in[i]);
+        int32x4_t a0 = vld1q_s32(&S->A0[i]);
+        int32x4_t a1 = vld1q_s32(&S->A1[i]);
+        int32x4_t xp = vld1q_s32(&x1[i]);
+        int32x4_t yp = vld1q_s32(&y1[i]);
+
+        int64x2_t accl = vshll_n_s32(vget_low_s32(yp), 15);
+        int64x2_t acch = vshll_high_n_s32(yp, 15);
+        accl = vmlal_s32(accl, vget_low_s32(a0), vget_low_s32(x));
+        acch = vmlal_high_s32(acch, a0, x);
+        accl = vmlal_s32(accl, vget_low_s32(a1), vget_low_s32(xp));
+        acch = vmlal_high_s32(acch, a1, xp);
+        int32x4_t r = vcombine_s32(vqshrn_n_s64(accl, 15), vqshrn_n_s64(acch, 15));
+        same = vsubq_u64(same, vceqq_s64(vshrq_n_s64(accl, 15), vmovl_s32(vget_low_s32(r))));
+        same = vsubq_u64(same, vceqq_s64(vshrq_n_s64(acch, 15), vmovl_high_s32(r)));
+
+        vst1q_s32(&out[i], r);
+        vst1q_s32(&x1[i], x);
+        vst1q_s32(&y1[i], r);
+    }
+    dsp_q_count += i - (uint32_t)vaddvq_u64(same);
+    iir_pi_bank_step_q31(S, in, out, i, S->n);
+}
+
+void iir_pi_bank_q15_neon(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out) {
+    const int32x4_t rnd = vdupq_n_s32(1 << 6);
+    q15_t *x1 = S->state[0];
+    q15_t *y1 = S->state[1];
+    uint32x4_t same = vdupq_n_u32(0);
+    uint32_t i = 0;
+
+    for (; i + 8 <= S->n; i += 8) {
+        int16x8_t x = vld1q_s16(&in[i]);
+        int16x8_t a0 = vld1q_s16(&S->A0[i]);
+        int16x8_t a1 = vld1q_s16(&S->A1[i]);
+        int16x8_t xp = vld1q_s16(&x1[i]);
+        int16x8_t yp = vld1q_s16(&y1[i]);
+
+        int32x4_t tl = vaddq_s32(vshll_n_s16(vget_low_s16(yp), 7), rnd);
+        int32x4_t th = vaddq_s32(vshll_high_n_s16(yp, 7), rnd);
+        tl = vmlal_s16(tl, vget_low_s16(a0), vget_low_s16(x));
+        th = vmlal_high_s16(th, a0, x);
+        tl = vmlal_s16(tl, vget_low_s16(a1), vget_low_s16(xp));
+        th = vmlal_high_s16(th, a1, xp);
+        int16x8_t r = vcombine_s16(vqshrn_n_s32(tl, 7), vqshrn_n_s32(th, 7));
+        same = vsubq_u32(same, vceqq_s32(vshrq_n_s32(tl, 7), vmovl_s16(vget_low_s16(r))));
+        same = vsubq_u32(same, vceqq_s32(vshrq_n_s32(th, 7), vmovl_high_s16(r)));
+
+        vst1q_s16(&out[i], r);
+        vst1q_s16(&x1[i], x);
+        vst1q_s16(&y1[i], r);
+    }
+    dsp_q_count += i - vaddvq_u32(same);
+    iir_pi_bank_step_q15(S, in, out, i, S->n);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void iir_pi_bank_q31(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out) {
+    dsp_kernels.iir_pi_bank_q31(S, in, out);
+}
+
+void iir_pi_bank_q15(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out) {
+    dsp_kernels.iir_pi_bank_q15(S, in, out);
+}
@@ -0,0 +1,168 @@
+/**
+ * \file arm_rt_dsp_controller_run.c
+ * \brief Controllers run over a block of samples.
+*/
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same arithmetic as iir_pi_q15.  The state is kept in locals so the compiler
+does not have to reload it through S after every store to out.
+-----------------------------------------------------------------------------*/
+void iir_pi_q15_run(iir_pi_instance_q15 * S, const q15_t *in, q15_t *out, uint32_t n)
+{
+  const int32_t A0 = S->A0;
+  const int32_t A1 = S->A1;
+  q15_t x1 = S->state[0];
+  q15_t y1 = S->state[1];
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    q15_t x = in[i];
+    int32_t temp = A0 * (int32_t)x;
+    temp += A1 * (int32_t)x1;
+    temp += ((int32_t)y1)<<7;
+    temp += (1<<6);
+    temp = temp >> 7;
+    y1 = (q15_t)(__SSAT(temp, 16));
+    x1 = x;
+    out[i] = y1;
+  }
+
+  S->state[0] = x1;
+  S->state[1] = y1;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same arithmetic as iir_pi_q31, state kept in locals.
+-----------------------------------------------------------------------------*/
+void iir_pi_q31_run(iir_pi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n)
+{
+  const int64_t A0 = S->A0;
+  const int64_t A1 = S->A1;
+  q31_t x1 = S->state[0];
+  q31_t y1 = S->state[1];
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    q31_t x = in[i];
+    int64_t acc = A0 * (int64_t)x;
+    acc += A1 * (int64_t)x1;
+    acc += ((int64_t)y1)<<15;
+    acc = acc >> 15;
+    y1 = ssat_i64(acc, 32);
+    x1 = x;
+    out[i] = y1;
+  }
+
+  S->state[0] = x1;
+  S->state[1] = y1;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same arithmetic as iir_pid_q31, state and derivative filter kept in locals.
+-----------------------------------------------------------------------------*/
+void iir_pid_q31_run(iir_pid_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n)
+{
+  const int64_t A0 = S->A0;
+  const int64_t A1 = S->A1;
+  const int64_t A0d = S->A0d;
+  const int64_t A1d = S->A1d;
+  const int64_t A2d = S->A2d;
+  q31_t x1 = S->state[0];
+  q31_t x2 = S->state[1];
+  q31_t y1 = S->state[2];
+  q31_t dstate = S->dstate;
+  q31_t fdstate = S->fdstate;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    q31_t x = in[i];
+    int64_t acc = A0 * (int64_t)x;
+    acc += A1 * (int64_t)x1;
+    int64_t acc_d = A0d * (int64_t)x;
+    acc_d += A1d * (int64_t)x1;
+    acc_d += A2d * (int64_t)x2;
+
+    acc += ((int64_t)y1) << 15;
+    acc = acc >> 15;
+    acc_d = acc_d >> 15;
+
+    dstate = ssat_i64(acc_d, 32);
+    fdstate = (dstate >> 2) + fdstate - (fdstate >> 2);
+    y1 = ssat_i64(acc, 32);
+    y1 += fdstate;
+
+    x2 = x1;
+    x1 = x;
+    out[i] = y1;
+  }
+
+  S->state[0] = x1;
+  S->state[1] = x2;
+  S->state[2] = y1;
+  S->dstate = dstate;
+  S->fdstate = fdstate;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same arithmetic as iir_pid_v2_q31.  The gain set is picked once for the block
+and the masked samples at the start are handled before the main loop, so the
+loop itself has no branches.
+-----------------------------------------------------------------------------*/
+void iir_pid_v2_q31_run(iir_pid_instance_v2_q31 *S, const q31_t *in, q31_t *out, uint32_t n,
+                        int32_t b_select)
+{
+  const int64_t G0 = b_select ? S->B0 : S->A0;
+  const int64_t G1 = b_select ? S->B1 : S->A1;
+  const int64_t G2 = b_select ? S->B2 : S->A2;
+  q31_t x1 = S->state[0];
+  q31_t x2 = S->state[1];
+  q31_t y1 = S->state[2];
+  uint32_t i = 0;
+
+  // While masked the output holds and only the input history moves.
+  while (i < n && S->mask_count > 0)
+  {
+    S->mask_count--;
+    x2 = x1;
+    x1 = in[i];
+    out[i] = y1;
+    i++;
+  }
+
+  for (; i < n; i++)
+  {
+    q31_t x = in[i];
+    int64_t acc = G0 * (int64_t)x;
+    acc += G1 * (int64_t)x1;
+    acc += G2 * (int64_t)x2;
+    acc += ((int64_t)y1)<<(15+PID_SH);
+    acc = acc >> (15+PID_SH);
+    y1 = ssat_i64(acc, 32);
+
+    x2 = x1;
+    x1 = x;
+    out[i] = y1;
+  }
+
+  S->state[0] = x1;
+  S->state[1] = x2;
+  S->state[2] = y1;
+}
@@ -0,0 +1,526 @@
+/**
+ * \file arm_rt_dsp_convert.c
+ * \brief Block versions of the conversions between integers and Q31.
+*/
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernels.  These are the reference for every other kernel.
+-----------------------------------------------------------------------------*/
+void convert_u16_to_q31_block_scalar(const uint16_t *x, const convert_recip_t *R, q31_t *out,
+                                     uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = convert_u16_to_q31_recip(x[i], R);
+    }
+}
+
+void convert_i16_to_q31_block_scalar(const int16_t *x, const convert_recip_t *R, q31_t *out,
+                                     uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = convert_i16_to_q31_recip(x[i], R);
+    }
+}
+
+void convert_i32_to_q31_block_scalar(const int32_t *x, const convert_recip_t *R, q31_t *out,
+                                     uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = convert_i32_to_q31_recip(x[i], R);
+    }
+}
+
+static inline int64_t convert_usat(int64_t v, int64_t max) {
+    return (v < 0) ? 0 : ((v > max) ? max : v);
+}
+
+void convert_q31_to_i16_block_scalar(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                     int16_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = (int16_t)ssat_i64(convert_q31_scale(x[i], scale[i], mode), 16);
+    }
+}
+
+void convert_q31_to_u16_block_scalar(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                     uint16_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = (uint16_t)convert_usat(convert_q31_scale(x[i], scale[i], mode), UINT16_MAX);
+    }
+}
+
+void convert_q31_to_u32_block_scalar(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                     uint32_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = (uint32_t)convert_usat(convert_q31_scale(x[i], scale[i], mode), UINT32_MAX);
+    }
+}
+
+void convert_q31_to_i32_block_scalar(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                     int32_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = (int32_t)ssat_i64(convert_q31_scale(x[i], scale[i], mode), 32);
+    }
+}
+
+// The rounding of convert_q31_scale as an addend of the product, bias plus
+// bit 31 of the product masked by odd.
+typedef struct {
+    int64_t bias;
+    int64_t odd;
+} convert_round_bias_t;
+
+static inline convert_round_bias_t convert_round_bias(convert_round_t mode) {
+    convert_round_bias_t b = {0, 0};
+    if (mode == CONVERT_ROUND_HALF_UP) {
+        b.bias = (int64_t)1 << 30;
+    } else if (mode == CONVERT_ROUND_HALF_EVEN) {
+        b.bias = ((int64_t)1 << 30) - 1;
+        b.odd = 1;
+    }
+    return b;
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+convert_recip_div on 64-bit lanes, PMULUDQ does every 32x32->64 product.
+The even and odd elements go through separately so the low words of the
+quotients can be blended back in place without a shuffle.  The remainder is
+below 2^33, so the signed 64-bit compare is fine.  The sign is applied to
+the 32-bit quotient with (q ^ s) - s.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+static inline __m256i convert_recip_avx2(__m256i a, const convert_recip_t *R) {
+    const __m256i rhi = _mm256_set1_epi64x(R->recHi);
+    const __m256i rlo = _mm256_set1_epi64x(R->recLo);
+    const __m256i d = _mm256_set1_epi64x(R->d);
+    __m256i q = _mm256_add_epi64(_mm256_mul_epu32(a, rhi), _mm256_srli_epi64(_mm256_mul_epu32(a, rlo), 32));
+    __m256i qd = _mm256_add_epi64(_mm256_mul_epu32(q, d),
+                                  _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(q, 32), d), 32));
+    __m256i r = _mm256_sub_epi64(_mm256_slli_epi64(a, 31), qd);
+    return _mm256_sub_epi64(q, _mm256_cmpgt_epi64(r, _mm256_sub_epi64(d, _mm256_set1_epi64x(1))));
+}
+
+// The quotients of the eight unsigned 32-bit lanes of ax.
+RT_DSP_TARGET_AVX2
+static inline __m256i convert_recip8_avx2(__m256i ax, const convert_recip_t *R) {
+    __m256i qe = convert_recip_avx2(_mm256_and_si256(ax, _mm256_set1_epi64x(0xFFFFFFFF)), R);
+    __m256i qo = convert_recip_avx2(_mm256_srli_epi64(ax, 32), R);
+    return _mm256_blend_epi32(qe, _mm256_slli_epi64(qo, 32), 0xAA);
+}
+
+RT_DSP_TARGET_AVX2
+static inline __m256i convert_signed8_avx2(__m256i v, const convert_recip_t *R) {
+    __m256i s = _mm256_xor_si256(_mm256_srai_epi32(v, 31), _mm256_set1_epi32(-(int32_t)R->neg));
+    __m256i q = convert_recip8_avx2(_mm256_abs_epi32(v), R);
+    return _mm256_sub_epi32(_mm256_xor_si256(q, s), s);
+}
+
+RT_DSP_TARGET_AVX2
+void convert_u16_to_q31_block_avx2(const uint16_t *x, const convert_recip_t *R, q31_t *out,
+                                   uint32_t n) {
+    const __m256i keep = _mm256_set1_epi32(R->neg ? 0 : -1);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)&x[i]));
+        _mm256_storeu_si256((__m256i *)&out[i], _mm256_and_si256(convert_recip8_avx2(v, R), keep));
+    }
+    convert_u16_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void convert_i16_to_q31_block_avx2(const int16_t *x, const convert_recip_t *R, q31_t *out,
+                                   uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)&x[i]));
+        _mm256_storeu_si256((__m256i *)&out[i], convert_signed8_avx2(v, R));
+    }
+    convert_i16_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void convert_i32_to_q31_block_avx2(const int32_t *x, const convert_recip_t *R, q31_t *out,
+                                   uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        _mm256_storeu_si256((__m256i *)&out[i], convert_signed8_avx2(v, R));
+    }
+    convert_i32_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+static inline __m512i convert_recip_avx512(__m512i a, const convert_recip_t *R) {
+    const __m512i rhi = _mm512_set1_epi64(R->recHi);
+    const __m512i rlo = _mm512_set1_epi64(R->recLo);
+    const __m512i d = _mm512_set1_epi64(R->d);
+    __m512i q = _mm512_add_epi64(_mm512_mul_epu32(a, rhi), _mm512_srli_epi64(_mm512_mul_epu32(a, rlo), 32));
+    __m512i qd = _mm512_add_epi64(_mm512_mul_epu32(q, d),
+                                  _mm512_slli_epi64(_mm512_mul_epu32(_mm512_srli_epi64(q, 32), d), 32));
+    __m512i r = _mm512_sub_epi64(_mm512_slli_epi64(a, 31), qd);
+    return _mm512_mask_add_epi64(q, _mm512_cmpge_epu64_mask(r, d), q, _mm512_set1_epi64(1));
+}
+
+RT_DSP_TARGET_AVX512
+static inline __m512i convert_recip16_avx512(__m512i ax, const convert_recip_t *R) {
+    __m512i qe = convert_recip_avx512(_mm512_and_si512(ax, _mm512_set1_epi64(0xFFFFFFFF)), R);
+    __m512i qo = convert_recip_avx512(_mm512_srli_epi64(ax, 32), R);
+    return _mm512_mask_blend_epi32(0xAAAA, qe, _mm512_slli_epi64(qo, 32));
+}
+
+RT_DSP_TARGET_AVX512
+static inline __m512i convert_signed16_avx512(__m512i v, const convert_recip_t *R) {
+    __m512i s = _mm512_xor_si512(_mm512_srai_epi32(v, 31), _mm512_set1_epi32(-(int32_t)R->neg));
+    __m512i q = convert_recip16_avx512(_mm512_abs_epi32(v), R);
+    return _mm512_sub_epi32(_mm512_xor_si512(q, s), s);
+}
+
+RT_DSP_TARGET_AVX512
+void convert_u16_to_q31_block_avx512(const uint16_t *x, const convert_recip_t *R, q31_t *out,
+                                     uint32_t n) {
+    const __m512i keep = _mm512_set1_epi32(R->neg ? 0 : -1);
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)&x[i]));
+        _mm512_storeu_si512((void *)&out[i], _mm512_and_si512(convert_recip16_avx512(v, R), keep));
+    }
+    convert_u16_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void convert_i16_to_q31_block_avx512(const int16_t *x, const convert_recip_t *R, q31_t *out,
+                                     uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *)&x[i]));
+        _mm512_storeu_si512((void *)&out[i], convert_signed16_avx512(v, R));
+    }
+    convert_i16_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void convert_i32_to_q31_block_avx512(const int32_t *x, const convert_recip_t *R, q31_t *out,
+                                     uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        _mm512_storeu_si512((void *)&out[i], convert_signed16_avx512(v, R));
+    }
+    convert_i32_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+/*
+The q31 to integer kernels work on the rounded 64-bit products.  PMULDQ
+takes the scale as signed, so x << 32 is added back where the scale has its
+top bit set.  The product is clamped to [lo << 31, (hi << 31) + 2^31 - 1]
+and the result is then bits 31..62, which a logical shift gets for the even
+elements and a left shift by one puts in place for the odd ones.
+*/
+RT_DSP_TARGET_AVX2
+static inline __m256i convert_q31_scale_avx2(__m256i x, __m256i s, convert_round_bias_t b,
+                                             int64_t lo, int64_t hi) {
+    const __m256i pmin = _mm256_set1_epi64x(lo * ((int64_t)1 << 31));
+    const __m256i pmax = _mm256_set1_epi64x(hi * ((int64_t)1 << 31) + 0x7FFFFFFF);
+    __m256i p = _mm256_add_epi64(_mm256_mul_epi32(x, s),
+                                 _mm256_slli_epi64(_mm256_and_si256(x, _mm256_srai_epi32(s, 31)), 32));
+    __m256i r = _mm256_and_si256(_mm256_srli_epi64(p, 31), _mm256_set1_epi64x(b.odd));
+    p = _mm256_add_epi64(p, _mm256_add_epi64(r, _mm256_set1_epi64x(b.bias)));
+    p = _mm256_blendv_epi8(p, pmax, _mm256_cmpgt_epi64(p, pmax));
+    return _mm256_blendv_epi8(p, pmin, _mm256_cmpgt_epi64(pmin, p));
+}
+
+// Eight saturated results as 32-bit lanes.
+RT_DSP_TARGET_AVX2
+static inline __m256i convert_q31_scale8_avx2(const q31_t *x, const uint32_t *scale, convert_round_bias_t b,
+                                              int64_t lo, int64_t hi) {
+    __m256i vx = _mm256_loadu_si256((const __m256i *)x);
+    __m256i vs = _mm256_loadu_si256((const __m256i *)scale);
+    __m256i pe = convert_q31_scale_avx2(vx, vs, b, lo, hi);
+    __m256i po = convert_q31_scale_avx2(_mm256_srli_epi64(vx, 32), _mm256_srli_epi64(vs, 32), b, lo, hi);
+    return _mm256_blend_epi32(_mm256_srli_epi64(pe, 31), _mm256_slli_epi64(po, 1), 0xAA);
+}
+
+RT_DSP_TARGET_AVX2
+void convert_q31_to_i16_block_avx2(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                   int16_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = convert_q31_scale8_avx2(&x[i], &scale[i], b, INT16_MIN, INT16_MAX);
+        _mm_storeu_si128((__m128i *)&out[i],
+                         _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+    }
+    convert_q31_to_i16_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void convert_q31_to_u16_block_avx2(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                   uint16_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = convert_q31_scale8_avx2(&x[i], &scale[i], b, 0, UINT16_MAX);
+        _mm_storeu_si128((__m128i *)&out[i],
+                         _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+    }
+    convert_q31_to_u16_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void convert_q31_to_u32_block_avx2(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                   uint32_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_si256((__m256i *)&out[i], convert_q31_scale8_avx2(&x[i], &scale[i], b, 0, UINT32_MAX));
+    }
+    convert_q31_to_u32_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+void convert_q31_to_i32_block_avx2(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                   int32_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_si256((__m256i *)&out[i], convert_q31_scale8_avx2(&x[i], &scale[i], b, INT32_MIN, INT32_MAX));
+    }
+    convert_q31_to_i32_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+static inline __m512i convert_q31_scale_avx512(__m512i x, __m512i s, convert_round_bias_t b,
+                                               int64_t lo, int64_t hi) {
+    __m512i p = _mm512_add_epi64(_mm512_mul_epi32(x, s),
+                                 _mm512_slli_epi64(_mm512_and_si512(x, _mm512_srai_epi32(s, 31)), 32));
+    __m512i r = _mm512_and_si512(_mm512_srli_epi64(p, 31), _mm512_set1_epi64(b.odd));
+    p = _mm512_add_epi64(p, _mm512_add_epi64(r, _mm512_set1_epi64(b.bias)));
+    p = _mm512_max_epi64(p, _mm512_set1_epi64(lo * ((int64_t)1 << 31)));
+    return _mm512_min_epi64(p, _mm512_set1_epi64(hi * ((int64_t)1 << 31) + 0x7FFFFFFF));
+}
+
+RT_DSP_TARGET_AVX512
+static inline __m512i convert_q31_scale16_avx512(const q31_t *x, const uint32_t *scale, convert_round_bias_t b,
+                                                 int64_t lo, int64_t hi) {
+    __m512i vx = _mm512_loadu_si512((const void *)x);
+    __m512i vs = _mm512_loadu_si512((const void *)scale);
+    __m512i pe = convert_q31_scale_avx512(vx, vs, b, lo, hi);
+    __m512i po = convert_q31_scale_avx512(_mm512_srli_epi64(vx, 32), _mm512_srli_epi64(vs, 32), b, lo, hi);
+    return _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(pe, 31), _mm512_slli_epi64(po, 1));
+}
+
+RT_DSP_TARGET_AVX512
+void convert_q31_to_i16_block_avx512(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                     int16_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = convert_q31_scale16_avx512(&x[i], &scale[i], b, INT16_MIN, INT16_MAX);
+        _mm256_storeu_si256((__m256i *)&out[i], _mm512_cvtepi32_epi16(v));
+    }
+    convert_q31_to_i16_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void convert_q31_to_u16_block_avx512(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                     uint16_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = convert_q31_scale16_avx512(&x[i], &scale[i], b, 0, UINT16_MAX);
+        _mm256_storeu_si256((__m256i *)&out[i], _mm512_cvtepi32_epi16(v));
+    }
+    convert_q31_to_u16_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void convert_q31_to_u32_block_avx512(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                     uint32_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_si512((void *)&out[i], convert_q31_scale16_avx512(&x[i], &scale[i], b, 0, UINT32_MAX));
+    }
+    convert_q31_to_u32_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+void convert_q31_to_i32_block_avx512(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                     int32_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_si512((void *)&out[i],
+                            convert_q31_scale16_avx512(&x[i], &scale[i], b, INT32_MIN, INT32_MAX));
+    }
+    convert_q31_to_i32_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+Same arithmetic as the x86 kernels, UMULL does the products two lanes at a
+time.  A true compare lane is all ones, so subtracting it adds one.
+-----------------------------------------------------------------------------*/
+static inline uint32x2_t convert_recip_neon(uint32x2_t a, const convert_recip_t *R) {
+    const uint32x2_t d = vdup_n_u32(R->d);
+    uint64x2_t q = vaddq_u64(vmull_u32(a, vdup_n_u32(R->recHi)),
+                             vshrq_n_u64(vmull_u32(a, vdup_n_u32(R->recLo)), 32));
+    uint64x2_t qd = vaddq_u64(vmull_u32(vmovn_u64(q), d), vshlq_n_u64(vmull_u32(vshrn_n_u64(q, 32), d), 32));
+    uint64x2_t r = vsubq_u64(vshlq_n_u64(vmovl_u32(a), 31), qd);
+    return vmovn_u64(vsubq_u64(q, vcgeq_u64(r, vmovl_u32(d))));
+}
+
+static inline uint32x4_t convert_recip4_neon(uint32x4_t ax, const convert_recip_t *R) {
+    return vcombine_u32(convert_recip_neon(vget_low_u32(ax), R), convert_recip_neon(vget_high_u32(ax), R));
+}
+
+static inline int32x4_t convert_signed4_neon(int32x4_t v, const convert_recip_t *R) {
+    int32x4_t s = veorq_s32(vshrq_n_s32(v, 31), vdupq_n_s32(-(int32_t)R->neg));
+    int32x4_t q = vreinterpretq_s32_u32(convert_recip4_neon(vreinterpretq_u32_s32(vabsq_s32(v)), R));
+    return vsubq_s32(veorq_s32(q, s), s);
+}
+
+void convert_u16_to_q31_block_neon(const uint16_t *x, const convert_recip_t *R, q31_t *out,
+                                   uint32_t n) {
+    const uint32x4_t keep = vdupq_n_u32(R->neg ? 0 : 0xFFFFFFFF);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t v = vmovl_u16(vld1_u16(&x[i]));
+        vst1q_s32(&out[i], vreinterpretq_s32_u32(vandq_u32(convert_recip4_neon(v, R), keep)));
+    }
+    convert_u16_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+void convert_i16_to_q31_block_neon(const int16_t *x, const convert_recip_t *R, q31_t *out,
+                                   uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_s32(&out[i], convert_signed4_neon(vmovl_s16(vld1_s16(&x[i])), R));
+    }
+    convert_i16_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+void convert_i32_to_q31_block_neon(const int32_t *x, const convert_recip_t *R, q31_t *out,
+                                   uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_s32(&out[i], convert_signed4_neon(vld1q_s32(&x[i]), R));
+    }
+    convert_i32_to_q31_block_scalar(&x[i], R, &out[i], n - i);
+}
+
+/*
+The q31 to integer kernels take the product as unsigned and subtract
+scale << 32 where x is negative.  The saturating narrowing shifts do the
+shift by 31 and the clamp together.
+*/
+static inline int64x2_t convert_q31_scale_neon(int32x2_t x, uint32x2_t s, convert_round_bias_t b) {
+    int64x2_t p = vreinterpretq_s64_u64(vmull_u32(vreinterpret_u32_s32(x), s));
+    uint32x2_t sx = vand_u32(vreinterpret_u32_s32(vshr_n_s32(x, 31)), s);
+    p = vsubq_s64(p, vreinterpretq_s64_u64(vshll_n_u32(sx, 32)));
+    int64x2_t r = vandq_s64(vshrq_n_s64(p, 31), vdupq_n_s64(b.odd));
+    return vaddq_s64(p, vaddq_s64(r, vdupq_n_s64(b.bias)));
+}
+
+// Four results saturated to int32.
+static inline int32x4_t convert_q31_scale4_neon(const q31_t *x, const uint32_t *scale, convert_round_bias_t b) {
+    int32x4_t vx = vld1q_s32(x);
+    uint32x4_t vs = vld1q_u32(scale);
+    int64x2_t lo = convert_q31_scale_neon(vget_low_s32(vx), vget_low_u32(vs), b);
+    int64x2_t hi = convert_q31_scale_neon(vget_high_s32(vx), vget_high_u32(vs), b);
+    return vcombine_s32(vqshrn_n_s64(lo, 31), vqshrn_n_s64(hi, 31));
+}
+
+void convert_q31_to_i16_block_neon(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                   int16_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1_s16(&out[i], vqmovn_s32(convert_q31_scale4_neon(&x[i], &scale[i], b)));
+    }
+    convert_q31_to_i16_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+void convert_q31_to_u16_block_neon(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                   uint16_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1_u16(&out[i], vqmovun_s32(convert_q31_scale4_neon(&x[i], &scale[i], b)));
+    }
+    convert_q31_to_u16_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+void convert_q31_to_u32_block_neon(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                   uint32_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t vx = vld1q_s32(&x[i]);
+        uint32x4_t vs = vld1q_u32(&scale[i]);
+        int64x2_t lo = convert_q31_scale_neon(vget_low_s32(vx), vget_low_u32(vs), b);
+        int64x2_t hi = convert_q31_scale_neon(vget_high_s32(vx), vget_high_u32(vs), b);
+        vst1q_u32(&out[i], vcombine_u32(vqshrun_n_s64(lo, 31), vqshrun_n_s64(hi, 31)));
+    }
+    convert_q31_to_u32_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+
+void convert_q31_to_i32_block_neon(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                                   int32_t *out, uint32_t n) {
+    convert_round_bias_t b = convert_round_bias(mode);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_s32(&out[i], convert_q31_scale4_neon(&x[i], &scale[i], b));
+    }
+    convert_q31_to_i32_block_scalar(&x[i], &scale[i], mode, &out[i], n - i);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void convert_u16_to_q31_block(const uint16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n) {
+    dsp_kernels.convert_u16_to_q31_block(x, R, out, n);
+}
+
+void convert_i16_to_q31_block(const int16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n) {
+    dsp_kernels.convert_i16_to_q31_block(x, R, out, n);
+}
+
+void convert_i32_to_q31_block(const int32_t *x, const convert_recip_t *R, q31_t *out, uint32_t n) {
+    dsp_kernels.convert_i32_to_q31_block(x, R, out, n);
+}
+
+void convert_q31_to_i16_block(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                              int16_t *out, uint32_t n) {
+    dsp_kernels.convert_q31_to_i16_block(x, scale, mode, out, n);
+}
+
+void convert_q31_to_u16_block(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                              uint16_t *out, uint32_t n) {
+    dsp_kernels.convert_q31_to_u16_block(x, scale, mode, out, n);
+}
+
+void convert_q31_to_u32_block(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                              uint32_t *out, uint32_t n) {
+    dsp_kernels.convert_q31_to_u32_block(x, scale, mode, out, n);
+}
+
+void convert_q31_to_i32_block(const q31_t *x, const uint32_t *scale, convert_round_t mode,
+                              int32_t *out, uint32_t n) {
+    dsp_kernels.convert_q31_to_i32_block(x, scale, mode, out, n);
+}
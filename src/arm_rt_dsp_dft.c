@@ -0,0 +1,431 @@
+/**
+ * \file arm_rt_dsp_dft.c
+ * \brief Goertzel and sliding DFT banks for harmonic monitoring.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void goertzel_bank_init_q31(goertzel_bank_instance_q31 *S, const uint32_t *phase)
+{
+  for (uint32_t k = 0; k < S->K; k++)
+  {
+    sincos_q30(phase[k], &S->pCos[k], &S->pSin[k]);
+  }
+  memset(S->pS1, 0, (uint32_t)S->K * S->M * sizeof(q31_t));
+  memset(S->pS2, 0, (uint32_t)S->K * S->M * sizeof(q31_t));
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+y = s[n - 1] - exp(-jw) s[n - 2], worked out in 64 bits and saturated.
+-----------------------------------------------------------------------------*/
+void goertzel_bank_result_q31(goertzel_bank_instance_q31 *S, q31_t *re, q31_t *im)
+{
+  for (uint32_t k = 0; k < S->K; k++)
+  {
+    const int64_t c = S->pCos[k];
+    const int64_t s = S->pSin[k];
+    for (uint32_t m = 0; m < S->M; m++)
+    {
+      uint32_t i = k * S->M + m;
+      int64_t s1 = S->pS1[i];
+      int64_t s2 = S->pS2[i];
+      re[i] = (q31_t)ssat_i64(s1 - ((c * s2) >> 30), 32);
+      im[i] = (q31_t)ssat_i64((s * s2) >> 30, 32);
+      S->pS1[i] = 0;
+      S->pS2[i] = 0;
+    }
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+Goertzel scalar kernel.
+
+Notes:
+s[n] = (x[n] >> sh) + 2 cos(w) s[n - 1] - s[n - 2], with 2 cos(w) s[n - 1] as
+(cos * s1) >> 29 taken to 32 bits and the sums wrapping.  Only the low 32 bits
+of the product shift are used, which is what lets the vector kernels use
+logical shifts.  Bin by bin and channel by channel over the whole block, so the
+state of one channel stays in registers.
+-----------------------------------------------------------------------------*/
+static inline void goertzel_bank_step_q31(goertzel_bank_instance_q31 *S, const q31_t *in,
+                                          uint32_t nFrames, uint32_t m)
+{
+    const uint32_t M = S->M;
+
+    for (uint32_t k = 0; k < S->K; k++) {
+        const int64_t c = S->pCos[k];
+        for (uint32_t j = m; j < M; j++) {
+            uint32_t s1 = (uint32_t)S->pS1[k * M + j];
+            uint32_t s2 = (uint32_t)S->pS2[k * M + j];
+            for (uint32_t t = 0; t < nFrames; t++) {
+                uint32_t p = (uint32_t)((c * (q31_t)s1) >> 29);
+                uint32_t s0 = (uint32_t)(in[t * M + j] >> S->sh) + p - s2;
+                s2 = s1;
+                s1 = s0;
+            }
+            S->pS1[k * M + j] = (q31_t)s1;
+            S->pS2[k * M + j] = (q31_t)s2;
+        }
+    }
+}
+
+void goertzel_bank_q31_scalar(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    goertzel_bank_step_q31(S, in, nFrames, 0);
+}
+
+
+/*-----------------------------------------------------------------------------
+Sliding DFT scalar kernel.
+
+Notes:
+At most N - idx frames, so the old frames are the ring rows idx onwards and
+none of them is overwritten yet.  The caller copies the frames into the ring and
+moves the phases on.  The product rounding only has to be the same going in and
+coming out, so the twiddle terms are floor(x * tw / 2^30) both ways.
+-----------------------------------------------------------------------------*/
+static inline void sdft_bank_step_q31(sdft_bank_instance_q31 *S, const q31_t *in,
+                                      uint32_t nFrames, uint32_t m)
+{
+    const uint32_t M = S->M;
+    const uint32_t N = S->N;
+    const q31_t *old = &S->pState[(uint32_t)S->idx * M];
+
+    for (uint32_t k = 0; k < S->K; k++) {
+        for (uint32_t j = m; j < M; j++) {
+            acc64_t re = S->pRe[k * M + j];
+            acc64_t im = S->pIm[k * M + j];
+            uint32_t ph = S->pPhase[k];
+            for (uint32_t t = 0; t < nFrames; t++) {
+                const int64_t c = S->pCos[ph];
+                const int64_t s = S->pSin[ph];
+                const int64_t xn = in[t * M + j];
+                const int64_t xo = old[t * M + j];
+                re += ((xn * c) >> 30) - ((xo * c) >> 30);
+                im -= ((xn * s) >> 30) - ((xo * s) >> 30);
+                ph += S->pBin[k];
+                ph = (ph >= N) ? ph - N : ph;
+            }
+            S->pRe[k * M + j] = re;
+            S->pIm[k * M + j] = im;
+        }
+    }
+}
+
+void sdft_bank_q31_scalar(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    sdft_bank_step_q31(S, in, nFrames, 0);
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+Goertzel: PMULDQ gives the products of the even lanes, the odd lanes are moved
+down first.  A logical 64-bit shift right by 29 leaves the wanted 32 bits in the
+low half of an even product, a shift left by 3 puts them in the high half of an
+odd product, and one blend interleaves them again.
+
+Sliding DFT: AVX2 has no 64-bit arithmetic shift, so the low halves come from
+the logical shift and the high halves from a 32-bit arithmetic shift.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+void goertzel_bank_q31_avx2(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const __m128i sh = _mm_cvtsi32_si128(S->sh);
+    uint32_t m = 0;
+
+    for (; m + 8 <= M; m += 8) {
+        for (uint32_t k = 0; k < S->K; k++) {
+            const __m256i c = _mm256_set1_epi32(S->pCos[k]);
+            __m256i s1 = _mm256_loadu_si256((const __m256i *)&S->pS1[k * M + m]);
+            __m256i s2 = _mm256_loadu_si256((const __m256i *)&S->pS2[k * M + m]);
+            for (uint32_t t = 0; t < nFrames; t++) {
+                __m256i x = _mm256_sra_epi32(_mm256_loadu_si256((const __m256i *)&in[t * M + m]), sh);
+                __m256i pe = _mm256_srli_epi64(_mm256_mul_epi32(s1, c), 29);
+                __m256i po = _mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(s1, 32), c), 3);
+                __m256i p = _mm256_blend_epi32(pe, po, 0xAA);
+                __m256i s0 = _mm256_sub_epi32(_mm256_add_epi32(x, p), s2);
+                s2 = s1;
+                s1 = s0;
+            }
+            _mm256_storeu_si256((__m256i *)&S->pS1[k * M + m], s1);
+            _mm256_storeu_si256((__m256i *)&S->pS2[k * M + m], s2);
+        }
+    }
+    goertzel_bank_step_q31(S, in, nFrames, m);
+}
+
+RT_DSP_TARGET_AVX512
+void goertzel_bank_q31_avx512(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const __m128i sh = _mm_cvtsi32_si128(S->sh);
+    uint32_t m = 0;
+
+    for (; m + 16 <= M; m += 16) {
+        for (uint32_t k = 0; k < S->K; k++) {
+            const __m512i c = _mm512_set1_epi32(S->pCos[k]);
+            __m512i s1 = _mm512_loadu_si512((const void *)&S->pS1[k * M + m]);
+            __m512i s2 = _mm512_loadu_si512((const void *)&S->pS2[k * M + m]);
+            for (uint32_t t = 0; t < nFrames; t++) {
+                __m512i x = _mm512_sra_epi32(_mm512_loadu_si512((const void *)&in[t * M + m]), sh);
+                __m512i pe = _mm512_srli_epi64(_mm512_mul_epi32(s1, c), 29);
+                __m512i po = _mm512_slli_epi64(_mm512_mul_epi32(_mm512_srli_epi64(s1, 32), c), 3);
+                __m512i p = _mm512_mask_blend_epi32(0xAAAA, pe, po);
+                __m512i s0 = _mm512_sub_epi32(_mm512_add_epi32(x, p), s2);
+                s2 = s1;
+                s1 = s0;
+            }
+            _mm512_storeu_si512((void *)&S->pS1[k * M + m], s1);
+            _mm512_storeu_si512((void *)&S->pS2[k * M + m], s2);
+        }
+    }
+    goertzel_bank_step_q31(S, in, nFrames, m);
+}
+
+// floor(x * c / 2^30) on four sign extended channels.
+RT_DSP_TARGET_AVX2
+static inline __m256i sdft_term_avx2(__m256i x, __m256i c) {
+    __m256i p = _mm256_mul_epi32(x, c);
+    return _mm256_blend_epi32(_mm256_srli_epi64(p, 30), _mm256_srai_epi32(p, 30), 0xAA);
+}
+
+RT_DSP_TARGET_AVX2
+void sdft_bank_q31_avx2(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const uint32_t N = S->N;
+    const q31_t *old = &S->pState[(uint32_t)S->idx * M];
+    uint32_t m = 0;
+
+    for (; m + 4 <= M; m += 4) {
+        for (uint32_t k = 0; k < S->K; k++) {
+            __m256i re = _mm256_loadu_si256((const __m256i *)&S->pRe[k * M + m]);
+            __m256i im = _mm256_loadu_si256((const __m256i *)&S->pIm[k * M + m]);
+            uint32_t ph = S->pPhase[k];
+            for (uint32_t t = 0; t < nFrames; t++) {
+                const __m256i c = _mm256_set1_epi64x(S->pCos[ph]);
+                const __m256i s = _mm256_set1_epi64x(S->pSin[ph]);
+                __m256i xn = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&in[t * M + m]));
+                __m256i xo = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&old[t * M + m]));
+                re = _mm256_add_epi64(re, _mm256_sub_epi64(sdft_term_avx2(xn, c), sdft_term_avx2(xo, c)));
+                im = _mm256_sub_epi64(im, _mm256_sub_epi64(sdft_term_avx2(xn, s), sdft_term_avx2(xo, s)));
+                ph += S->pBin[k];
+                ph = (ph >= N) ? ph - N : ph;
+            }
+            _mm256_storeu_si256((__m256i *)&S->pRe[k * M + m], re);
+            _mm256_storeu_si256((__m256i *)&S->pIm[k * M + m], im);
+        }
+    }
+    sdft_bank_step_q31(S, in, nFrames, m);
+}
+
+RT_DSP_TARGET_AVX512
+void sdft_bank_q31_avx512(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const uint32_t N = S->N;
+    const q31_t *old = &S->pState[(uint32_t)S->idx * M];
+    uint32_t m = 0;
+
+    for (; m + 8 <= M; m += 8) {
+        for (uint32_t k = 0; k < S->K; k++) {
+            __m512i re = _mm512_loadu_si512((const void *)&S->pRe[k * M + m]);
+            __m512i im = _mm512_loadu_si512((const void *)&S->pIm[k * M + m]);
+            uint32_t ph = S->pPhase[k];
+            for (uint32_t t = 0; t < nFrames; t++) {
+                const __m512i c = _mm512_set1_epi64(S->pCos[ph]);
+                const __m512i s = _mm512_set1_epi64(S->pSin[ph]);
+                __m512i xn = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&in[t * M + m]));
+                __m512i xo = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&old[t * M + m]));
+                __m512i dc = _mm512_sub_epi64(_mm512_srai_epi64(_mm512_mul_epi32(xn, c), 30),
+                                              _mm512_srai_epi64(_mm512_mul_epi32(xo, c), 30));
+                __m512i ds = _mm512_sub_epi64(_mm512_srai_epi64(_mm512_mul_epi32(xn, s), 30),
+                                              _mm512_srai_epi64(_mm512_mul_epi32(xo, s), 30));
+                re = _mm512_add_epi64(re, dc);
+                im = _mm512_sub_epi64(im, ds);
+                ph += S->pBin[k];
+                ph = (ph >= N) ? ph - N : ph;
+            }
+            _mm512_storeu_si512((void *)&S->pRe[k * M + m], re);
+            _mm512_storeu_si512((void *)&S->pIm[k * M + m], im);
+        }
+    }
+    sdft_bank_step_q31(S, in, nFrames, m);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+SHRN keeps the low 32 bits of the shifted product like the scalar kernel, and
+SSHR on the 64-bit products is the floor.
+-----------------------------------------------------------------------------*/
+void goertzel_bank_q31_neon(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const int32x4_t sh = vdupq_n_s32(-(int32_t)S->sh);
+    uint32_t m = 0;
+
+    for (; m + 4 <= M; m += 4) {
+        for (uint32_t k = 0; k < S->K; k++) {
+            const int32x4_t c = vdupq_n_s32(S->pCos[k]);
+            int32x4_t s1 = vld1q_s32(&S->pS1[k * M + m]);
+            int32x4_t s2 = vld1q_s32(&S->pS2[k * M + m]);
+            for (uint32_t t = 0; t < nFrames; t++) {
+                int32x4_t x = vshlq_s32(vld1q_s32(&in[t * M + m]), sh);
+                int32x4_t p = vcombine_s32(vshrn_n_s64(vmull_s32(vget_low_s32(s1), vget_low_s32(c)), 29),
+                                           vshrn_n_s64(vmull_high_s32(s1, c), 29));
+                int32x4_t s0 = vsubq_s32(vaddq_s32(x, p), s2);
+                s2 = s1;
+                s1 = s0;
+            }
+            vst1q_s32(&S->pS1[k * M + m], s1);
+            vst1q_s32(&S->pS2[k * M + m], s2);
+        }
+    }
+    goertzel_bank_step_q31(S, in, nFrames, m);
+}
+
+void sdft_bank_q31_neon(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const uint32_t N = S->N;
+    const q31_t *old = &S->pState[(uint32_t)S->idx * M];
+    uint32_t m = 0;
+
+    for (; m + 4 <= M; m += 4) {
+        for (uint32_t k = 0; k < S->K; k++) {
+            int64x2_t rel = vld1q_s64(&S->pRe[k * M + m]);
+            int64x2_t reh = vld1q_s64(&S->pRe[k * M + m + 2]);
+            int64x2_t iml = vld1q_s64(&S->pIm[k * M + m]);
+            int64x2_t imh = vld1q_s64(&S->pIm[k * M + m + 2]);
+            uint32_t ph = S->pPhase[k];
+            for (uint32_t t = 0; t < nFrames; t++) {
+                const int32x4_t c = vdupq_n_s32(S->pCos[ph]);
+                const int32x4_t s = vdupq_n_s32(S->pSin[ph]);
+                int32x4_t xn = vld1q_s32(&in[t * M + m]);
+                int32x4_t xo = vld1q_s32(&old[t * M + m]);
+                rel = vaddq_s64(rel, vsubq_s64(vshrq_n_s64(vmull_s32(vget_low_s32(xn), vget_low_s32(c)), 30),
+                                               vshrq_n_s64(vmull_s32(vget_low_s32(xo), vget_low_s32(c)), 30)));
+                reh = vaddq_s64(reh, vsubq_s64(vshrq_n_s64(vmull_high_s32(xn, c), 30),
+                                               vshrq_n_s64(vmull_high_s32(xo, c), 30)));
+                iml = vsubq_s64(iml, vsubq_s64(vshrq_n_s64(vmull_s32(vget_low_s32(xn), vget_low_s32(s)), 30),
+                                               vshrq_n_s64(vmull_s32(vget_low_s32(xo), vget_low_s32(s)), 30)));
+                imh = vsubq_s64(imh, vsubq_s64(vshrq_n_s64(vmull_high_s32(xn, s), 30),
+                                               vshrq_n_s64(vmull_high_s32(xo, s), 30)));
+                ph += S->pBin[k];
+                ph = (ph >= N) ? ph - N : ph;
+            }
+            vst1q_s64(&S->pRe[k * M + m], rel);
+            vst1q_s64(&S->pRe[k * M + m + 2], reh);
+            vst1q_s64(&S->pIm[k * M + m], iml);
+            vst1q_s64(&S->pIm[k * M + m + 2], imh);
+        }
+    }
+    sdft_bank_step_q31(S, in, nFrames, m);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void goertzel_bank_q31(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    dsp_kernels.goertzel_bank_q31(S, in, nFrames);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The twiddle table is on the 2^32 per cycle phase grid rounded to the nearest
+step, so it is within a couple of LSBs of cos(2 pi i / N) for any N.
+-----------------------------------------------------------------------------*/
+void sdft_bank_init_q31(sdft_bank_instance_q31 *S, const uint16_t *bins)
+{
+  filter_boxcar_reciprocal(S->N, &S->l, &S->magic);
+  for (uint32_t i = 0; i < S->N; i++)
+  {
+    uint32_t phase = (uint32_t)((((uint64_t)i << 32) + S->N / 2U) / S->N);
+    sincos_q30(phase, &S->pCos[i], &S->pSin[i]);
+  }
+  for (uint32_t k = 0; k < S->K; k++)
+  {
+    S->pBin[k] = bins[k];
+    S->pPhase[k] = 0;
+  }
+  S->idx = 0;
+  memset(S->pState, 0, (uint32_t)S->N * S->M * sizeof(q31_t));
+  memset(S->pRe, 0, (uint32_t)S->K * S->M * sizeof(acc64_t));
+  memset(S->pIm, 0, (uint32_t)S->K * S->M * sizeof(acc64_t));
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The block is cut where the ring wraps, so each kernel call sees its old frames
+as one run of rows.
+-----------------------------------------------------------------------------*/
+void sdft_bank_q31(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames)
+{
+  while (nFrames > 0)
+  {
+    uint32_t L = (uint32_t)S->N - S->idx;
+    L = (nFrames < L) ? nFrames : L;
+
+    dsp_kernels.sdft_bank_q31(S, in, L);
+    memcpy(&S->pState[(uint32_t)S->idx * S->M], in, L * S->M * sizeof(q31_t));
+    for (uint32_t k = 0; k < S->K; k++)
+    {
+      S->pPhase[k] = (uint16_t)((S->pPhase[k] + (uint64_t)S->pBin[k] * L) % S->N);
+    }
+    S->idx = (uint16_t)((S->idx + L == S->N) ? 0 : S->idx + L);
+    in += L * S->M;
+    nFrames -= L;
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The sums are divided by N first with filter_boxcar_div, then rotated by
+W^(k * idx) so the oldest frame is sample 0.
+-----------------------------------------------------------------------------*/
+void sdft_bank_result_q31(const sdft_bank_instance_q31 *S, q31_t *re, q31_t *im)
+{
+  for (uint32_t k = 0; k < S->K; k++)
+  {
+    const int64_t c = S->pCos[S->pPhase[k]];
+    const int64_t s = S->pSin[S->pPhase[k]];
+    for (uint32_t m = 0; m < S->M; m++)
+    {
+      uint32_t i = k * S->M + m;
+      int64_t a = filter_boxcar_div(S->pRe[i], S->magic, S->l, S->N);
+      int64_t b = filter_boxcar_div(S->pIm[i], S->magic, S->l, S->N);
+      re[i] = (q31_t)ssat_i64((a * c - b * s) >> 30, 32);
+      im[i] = (q31_t)ssat_i64((a * s + b * c) >> 30, 32);
+    }
+  }
+}
@@ -0,0 +1,399 @@
+/**
+ * \file arm_rt_dsp_dispatch.c
+ * \brief Runtime selection of the block kernels.
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+#if defined(RT_DSP_HAVE_NEON) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+
+static const char *const dsp_isa_names[DSP_ISA_COUNT] = {
+    "scalar", "sse4.1", "avx2", "avx512", "neon"
+};
+
+
+// Starts out on the scalar kernels so the table is usable before dsp_dispatch_init().
+dsp_dispatch_t dsp_kernels = {
+    .isa = DSP_ISA_SCALAR,
+    .mul_q15_block = mul_q15_block_scalar,
+    .mul_q31_block = mul_q31_block_scalar,
+    .mulsat_q15_block = mulsat_q15_block_scalar,
+    .mulsat_q31_block = mulsat_q31_block_scalar,
+    .abs_sat_q15_block = abs_sat_q15_block_scalar,
+    .abs_sat_q31_block = abs_sat_q31_block_scalar,
+    .dot_q15_block = dot_q15_block_scalar,
+    .dot_q31_block = dot_q31_block_scalar,
+    .iir_pi_bank_q31 = iir_pi_bank_q31_scalar,
+    .iir_pi_bank_q15 = iir_pi_bank_q15_scalar,
+    .filter_pma_bank_q31 = filter_pma_bank_q31_scalar,
+    .filter_biquad_bank_q31 = filter_biquad_bank_q31_scalar,
+    .goertzel_bank_q31 = goertzel_bank_q31_scalar,
+    .sdft_bank_q31 = sdft_bank_q31_scalar,
+    .rms_bank_q31 = rms_bank_q31_scalar,
+    .iir_pr_multi_q31_run = iir_pr_multi_q31_run_scalar,
+    .ramp_fill_q31 = ramp_fill_q31_scalar,
+    .ramp_fill_i16 = ramp_fill_i16_scalar,
+    .limit_q31_block = limit_q31_block_scalar,
+    .limit_i16_block = limit_i16_block_scalar,
+    .limit_u16_block = limit_u16_block_scalar,
+    .limit_f32_block = limit_f32_block_scalar,
+    .minmax_q31_block = minmax_q31_block_scalar,
+    .minmax_i16_block = minmax_i16_block_scalar,
+    .minmax_u16_block = minmax_u16_block_scalar,
+    .sum64_q31_block = sum64_q31_block_scalar,
+    .sum64_i16_block = sum64_i16_block_scalar,
+    .sum64_u16_block = sum64_u16_block_scalar,
+    .sumsq_q31_block = sumsq_q31_block_scalar,
+    .sumsq_i16_block = sumsq_i16_block_scalar,
+    .sumsq_u16_block = sumsq_u16_block_scalar,
+    .adc_block = &adc_block_kernels_scalar,
+    .convert_u16_to_q31_block = convert_u16_to_q31_block_scalar,
+    .convert_i16_to_q31_block = convert_i16_to_q31_block_scalar,
+    .convert_i32_to_q31_block = convert_i32_to_q31_block_scalar,
+    .convert_q31_to_i16_block = convert_q31_to_i16_block_scalar,
+    .convert_q31_to_u16_block = convert_q31_to_u16_block_scalar,
+    .convert_q31_to_u32_block = convert_q31_to_u32_block_scalar,
+    .convert_q31_to_i32_block = convert_q31_to_i32_block_scalar,
+    .hyst_bank_q31 = hyst_bank_q31_scalar,
+    .hyst_bank_i16 = hyst_bank_i16_scalar,
+};
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Each level starts from the level below it and overrides the kernels it has, so
+a kernel without a version for a level falls back to the best one below it.
+-----------------------------------------------------------------------------*/
+static void dsp_bind_scalar(dsp_dispatch_t *d) {
+    d->mul_q15_block = mul_q15_block_scalar;
+    d->mul_q31_block = mul_q31_block_scalar;
+    d->mulsat_q15_block = mulsat_q15_block_scalar;
+    d->mulsat_q31_block = mulsat_q31_block_scalar;
+    d->abs_sat_q15_block = abs_sat_q15_block_scalar;
+    d->abs_sat_q31_block = abs_sat_q31_block_scalar;
+    d->dot_q15_block = dot_q15_block_scalar;
+    d->dot_q31_block = dot_q31_block_scalar;
+    d->iir_pi_bank_q31 = iir_pi_bank_q31_scalar;
+    d->iir_pi_bank_q15 = iir_pi_bank_q15_scalar;
+    d->filter_pma_bank_q31 = filter_pma_bank_q31_scalar;
+    d->filter_biquad_bank_q31 = filter_biquad_bank_q31_scalar;
+    d->goertzel_bank_q31 = goertzel_bank_q31_scalar;
+    d->sdft_bank_q31 = sdft_bank_q31_scalar;
+    d->rms_bank_q31 = rms_bank_q31_scalar;
+    d->iir_pr_multi_q31_run = iir_pr_multi_q31_run_scalar;
+    d->ramp_fill_q31 = ramp_fill_q31_scalar;
+    d->ramp_fill_i16 = ramp_fill_i16_scalar;
+    d->limit_q31_block = limit_q31_block_scalar;
+    d->limit_i16_block = limit_i16_block_scalar;
+    d->limit_u16_block = limit_u16_block_scalar;
+    d->limit_f32_block = limit_f32_block_scalar;
+    d->minmax_q31_block = minmax_q31_block_scalar;
+    d->minmax_i16_block = minmax_i16_block_scalar;
+    d->minmax_u16_block = minmax_u16_block_scalar;
+    d->sum64_q31_block = sum64_q31_block_scalar;
+    d->sum64_i16_block = sum64_i16_block_scalar;
+    d->sum64_u16_block = sum64_u16_block_scalar;
+    d->sumsq_q31_block = sumsq_q31_block_scalar;
+    d->sumsq_i16_block = sumsq_i16_block_scalar;
+    d->sumsq_u16_block = sumsq_u16_block_scalar;
+    d->adc_block = &adc_block_kernels_scalar;
+    d->convert_u16_to_q31_block = convert_u16_to_q31_block_scalar;
+    d->convert_i16_to_q31_block = convert_i16_to_q31_block_scalar;
+    d->convert_i32_to_q31_block = convert_i32_to_q31_block_scalar;
+    d->convert_q31_to_i16_block = convert_q31_to_i16_block_scalar;
+    d->convert_q31_to_u16_block = convert_q31_to_u16_block_scalar;
+    d->convert_q31_to_u32_block = convert_q31_to_u32_block_scalar;
+    d->convert_q31_to_i32_block = convert_q31_to_i32_block_scalar;
+    d->hyst_bank_q31 = hyst_bank_q31_scalar;
+    d->hyst_bank_i16 = hyst_bank_i16_scalar;
+}
+
+#ifdef RT_DSP_HAVE_X86
+static void dsp_bind_sse41(dsp_dispatch_t *d) {
+    dsp_bind_scalar(d);
+    d->mul_q15_block = mul_q15_block_sse41;
+    d->mul_q31_block = mul_q31_block_sse41;
+    d->mulsat_q15_block = mulsat_q15_block_sse41;
+    d->mulsat_q31_block = mulsat_q31_block_sse41;
+    d->abs_sat_q15_block = abs_sat_q15_block_sse41;
+    d->abs_sat_q31_block = abs_sat_q31_block_sse41;
+    d->iir_pi_bank_q15 = iir_pi_bank_q15_sse41;
+}
+
+static void dsp_bind_avx2(dsp_dispatch_t *d) {
+    dsp_bind_sse41(d);
+    d->mul_q15_block = mul_q15_block_avx2;
+    d->mul_q31_block = mul_q31_block_avx2;
+    d->mulsat_q15_block = mulsat_q15_block_avx2;
+    d->mulsat_q31_block = mulsat_q31_block_avx2;
+    d->abs_sat_q15_block = abs_sat_q15_block_avx2;
+    d->abs_sat_q31_block = abs_sat_q31_block_avx2;
+    d->dot_q15_block = dot_q15_block_avx2;
+    d->dot_q31_block = dot_q31_block_avx2;
+    d->iir_pi_bank_q31 = iir_pi_bank_q31_avx2;
+    d->iir_pi_bank_q15 = iir_pi_bank_q15_avx2;
+    d->filter_pma_bank_q31 = filter_pma_bank_q31_avx2;
+    d->filter_biquad_bank_q31 = filter_biquad_bank_q31_avx2;
+    d->goertzel_bank_q31 = goertzel_bank_q31_avx2;
+    d->sdft_bank_q31 = sdft_bank_q31_avx2;
+    d->rms_bank_q31 = rms_bank_q31_avx2;
+    d->iir_pr_multi_q31_run = iir_pr_multi_q31_run_avx2;
+    d->ramp_fill_q31 = ramp_fill_q31_avx2;
+    d->ramp_fill_i16 = ramp_fill_i16_avx2;
+    d->limit_q31_block = limit_q31_block_avx2;
+    d->limit_i16_block = limit_i16_block_avx2;
+    d->limit_u16_block = limit_u16_block_avx2;
+    d->limit_f32_block = limit_f32_block_avx2;
+    d->minmax_q31_block = minmax_q31_block_avx2;
+    d->minmax_i16_block = minmax_i16_block_avx2;
+    d->minmax_u16_block = minmax_u16_block_avx2;
+    d->sum64_q31_block = sum64_q31_block_avx2;
+    d->sum64_i16_block = sum64_i16_block_avx2;
+    d->sum64_u16_block = sum64_u16_block_avx2;
+    d->sumsq_q31_block = sumsq_q31_block_avx2;
+    d->sumsq_i16_block = sumsq_i16_block_avx2;
+    d->sumsq_u16_block = sumsq_u16_block_avx2;
+    d->adc_block = &adc_block_kernels_avx2;
+    d->convert_u16_to_q31_block = convert_u16_to_q31_block_avx2;
+    d->convert_i16_to_q31_block = convert_i16_to_q31_block_avx2;
+    d->convert_i32_to_q31_block = convert_i32_to_q31_block_avx2;
+    d->convert_q31_to_i16_block = convert_q31_to_i16_block_avx2;
+    d->convert_q31_to_u16_block = convert_q31_to_u16_block_avx2;
+    d->convert_q31_to_u32_block = convert_q31_to_u32_block_avx2;
+    d->convert_q31_to_i32_block = convert_q31_to_i32_block_avx2;
+    d->hyst_bank_q31 = hyst_bank_q31_avx2;
+    d->hyst_bank_i16 = hyst_bank_i16_avx2;
+}
+
+static void dsp_bind_avx512(dsp_dispatch_t *d) {
+    dsp_bind_avx2(d);
+    d->mul_q15_block = mul_q15_block_avx512;
+    d->mul_q31_block = mul_q31_block_avx512;
+    d->mulsat_q15_block = mulsat_q15_block_avx512;
+    d->mulsat_q31_block = mulsat_q31_block_avx512;
+    d->abs_sat_q15_block = abs_sat_q15_block_avx512;
+    d->abs_sat_q31_block = abs_sat_q31_block_avx512;
+    d->iir_pi_bank_q31 = iir_pi_bank_q31_avx512;
+    d->filter_pma_bank_q31 = filter_pma_bank_q31_avx512;
+    d->filter_biquad_bank_q31 = filter_biquad_bank_q31_avx512;
+    d->goertzel_bank_q31 = goertzel_bank_q31_avx512;
+    d->sdft_bank_q31 = sdft_bank_q31_avx512;
+    d->rms_bank_q31 = rms_bank_q31_avx512;
+    d->iir_pr_multi_q31_run = iir_pr_multi_q31_run_avx512;
+    d->ramp_fill_q31 = ramp_fill_q31_avx512;
+    d->ramp_fill_i16 = ramp_fill_i16_avx512;
+    d->limit_q31_block = limit_q31_block_avx512;
+    d->limit_i16_block = limit_i16_block_avx512;
+    d->limit_u16_block = limit_u16_block_avx512;
+    d->limit_f32_block = limit_f32_block_avx512;
+    d->minmax_q31_block = minmax_q31_block_avx512;
+    d->minmax_i16_block = minmax_i16_block_avx512;
+    d->minmax_u16_block = minmax_u16_block_avx512;
+    d->sum64_q31_block = sum64_q31_block_avx512;
+    d->sum64_i16_block = sum64_i16_block_avx512;
+    d->sum64_u16_block = sum64_u16_block_avx512;
+    d->sumsq_q31_block = sumsq_q31_block_avx512;
+    d->sumsq_i16_block = sumsq_i16_block_avx512;
+    d->sumsq_u16_block = sumsq_u16_block_avx512;
+    d->adc_block = &adc_block_kernels_avx512;
+    d->convert_u16_to_q31_block = convert_u16_to_q31_block_avx512;
+    d->convert_i16_to_q31_block = convert_i16_to_q31_block_avx512;
+    d->convert_i32_to_q31_block = convert_i32_to_q31_block_avx512;
+    d->convert_q31_to_i16_block = convert_q31_to_i16_block_avx512;
+    d->convert_q31_to_u16_block = convert_q31_to_u16_block_avx512;
+    d->convert_q31_to_u32_block = convert_q31_to_u32_block_avx512;
+    d->convert_q31_to_i32_block = convert_q31_to_i32_block_avx512;
+    d->hyst_bank_q31 = hyst_bank_q31_avx512;
+    d->hyst_bank_i16 = hyst_bank_i16_avx512;
+}
+#endif
+
+#ifdef RT_DSP_HAVE_NEON
+static void dsp_bind_neon(dsp_dispatch_t *d) {
+    dsp_bind_scalar(d);
+    d->mul_q15_block = mul_q15_block_neon;
+    d->mul_q31_block = mul_q31_block_neon;
+    d->mulsat_q15_block = mulsat_q15_block_neon;
+    d->mulsat_q31_block = mulsat_q31_block_neon;
+    d->abs_sat_q15_block = abs_sat_q15_block_neon;
+    d->abs_sat_q31_block = abs_sat_q31_block_neon;
+    d->dot_q15_block = dot_q15_block_neon;
+    d->dot_q31_block = dot_q31_block_neon;
+    d->iir_pi_bank_q31 = iir_pi_bank_q31_neon;
+    d->iir_pi_bank_q15 = iir_pi_bank_q15_neon;
+    d->filter_pma_bank_q31 = filter_pma_bank_q31_neon;
+    d->filter_biquad_bank_q31 = filter_biquad_bank_q31_neon;
+    d->goertzel_bank_q31 = goertzel_bank_q31_neon;
+    d->sdft_bank_q31 = sdft_bank_q31_neon;
+    d->rms_bank_q31 = rms_bank_q31_neon;
+    d->iir_pr_multi_q31_run = iir_pr_multi_q31_run_neon;
+    d->ramp_fill_q31 = ramp_fill_q31_neon;
+    d->ramp_fill_i16 = ramp_fill_i16_neon;
+    d->limit_q31_block = limit_q31_block_neon;
+    d->limit_i16_block = limit_i16_block_neon;
+    d->limit_u16_block = limit_u16_block_neon;
+    d->limit_f32_block = limit_f32_block_neon;
+    d->minmax_q31_block = minmax_q31_block_neon;
+    d->minmax_i16_block = minmax_i16_block_neon;
+    d->minmax_u16_block = minmax_u16_block_neon;
+    d->sum64_q31_block = sum64_q31_block_neon;
+    d->sum64_i16_block = sum64_i16_block_neon;
+    d->sum64_u16_block = sum64_u16_block_neon;
+    d->sumsq_q31_block = sumsq_q31_block_neon;
+    d->sumsq_i16_block = sumsq_i16_block_neon;
+    d->sumsq_u16_block = sumsq_u16_block_neon;
+    d->adc_block = &adc_block_kernels_neon;
+    d->convert_u16_to_q31_block = convert_u16_to_q31_block_neon;
+    d->convert_i16_to_q31_block = convert_i16_to_q31_block_neon;
+    d->convert_i32_to_q31_block = convert_i32_to_q31_block_neon;
+    d->convert_q31_to_i16_block = convert_q31_to_i16_block_neon;
+    d->convert_q31_to_u16_block = convert_q31_to_u16_block_neon;
+    d->convert_q31_to_u32_block = convert_q31_to_u32_block_neon;
+    d->convert_q31_to_i32_block = convert_q31_to_i32_block_neon;
+    d->hyst_bank_q31 = hyst_bank_q31_neon;
+    d->hyst_bank_i16 = hyst_bank_i16_neon;
+}
+#endif
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+int32_t dsp_isa_supported(dsp_isa_t isa) {
+    switch (isa) {
+    case DSP_ISA_SCALAR:
+        return 1;
+#ifdef RT_DSP_HAVE_X86
+    case DSP_ISA_SSE41:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.1") != 0;
+    case DSP_ISA_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    case DSP_ISA_AVX512:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+#ifdef RT_DSP_HAVE_NEON
+    case DSP_ISA_NEON:
+#if defined(__linux__) && defined(HWCAP_ASIMD)
+        return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+        // Advanced SIMD is mandatory on AArch64.
+        return 1;
+#endif
+#endif
+    default:
+        return 0;
+    }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Walks down from the requested level to the first one the CPU supports.  NEON
+sits above the x86 levels, so asking for it on x86 gives the best x86 level.
+-----------------------------------------------------------------------------*/
+dsp_isa_t dsp_dispatch_set_isa(dsp_isa_t isa) {
+    if (isa >= DSP_ISA_COUNT) {
+        isa = DSP_ISA_COUNT - 1;
+    }
+    while (isa != DSP_ISA_SCALAR && !dsp_isa_supported(isa)) {
+        isa = (isa == DSP_ISA_NEON) ? DSP_ISA_AVX512 : (dsp_isa_t)(isa - 1);
+    }
+
+    switch (isa) {
+#ifdef RT_DSP_HAVE_X86
+    case DSP_ISA_SSE41:
+        dsp_bind_sse41(&dsp_kernels);
+        break;
+    case DSP_ISA_AVX2:
+        dsp_bind_avx2(&dsp_kernels);
+        break;
+    case DSP_ISA_AVX512:
+        dsp_bind_avx512(&dsp_kernels);
+        break;
+#endif
+#ifdef RT_DSP_HAVE_NEON
+    case DSP_ISA_NEON:
+        dsp_bind_neon(&dsp_kernels);
+        break;
+#endif
+    default:
+        isa = DSP_ISA_SCALAR;
+        dsp_bind_scalar(&dsp_kernels);
+        break;
+    }
+    dsp_kernels.isa = isa;
+    return isa;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+An unknown ARM_RT_DSP_ISA value is ignored rather than treated as an error.
+-----------------------------------------------------------------------------*/
+dsp_isa_t dsp_dispatch_init(void) {
+    dsp_isa_t isa = DSP_ISA_COUNT;
+    const char *env = getenv("ARM_RT_DSP_ISA");
+
+    if (env != NULL) {
+        isa = dsp_isa_from_name(env);
+    }
+    return dsp_dispatch_set_isa(isa);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+const char *dsp_isa_name(dsp_isa_t isa) {
+    if (isa >= DSP_ISA_COUNT) {
+        return "unknown";
+    }
+    return dsp_isa_names[isa];
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+dsp_isa_t dsp_isa_from_name(const char *name) {
+    for (int32_t i = 0; i < DSP_ISA_COUNT; i++) {
+        if (strcmp(name, dsp_isa_names[i]) == 0) {
+            return (dsp_isa_t)i;
+        }
+    }
+    return DSP_ISA_COUNT;
+}
+
+
+#if defined(RT_DSP_HAVE_X86) || defined(RT_DSP_HAVE_NEON)
+// Bind the best kernels when the library is loaded so callers don't have to.
+__attribute__((constructor))
+static void dsp_dispatch_auto_init(void) {
+    dsp_dispatch_init();
+}
+#endif
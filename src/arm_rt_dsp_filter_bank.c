@@ -0,0 +1,268 @@
+/**
+ * \file arm_rt_dsp_filter_bank.c
+ * \brief Banks of filters stored as structures of arrays.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+sh_common lets the block kernels use one shift count for the whole bank.
+-----------------------------------------------------------------------------*/
+void filter_pma_bank_init(filter_pma_bank_a63_t *S, int32_t resetStateFlag)
+{
+  S->sh_common = (S->n > 0) ? S->sh[0] : -1;
+  for (uint32_t i = 1; i < S->n; i++)
+  {
+    if (S->sh[i] != S->sh[0])
+    {
+      S->sh_common = -1;
+      break;
+    }
+  }
+
+  if (resetStateFlag)
+  {
+    memset(S->acc, 0, S->n * sizeof(acc64_t));
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void filter_pma_bank_precharge_q31(filter_pma_bank_a63_t *S, const q31_t *y0)
+{
+  for (uint32_t i = 0; i < S->n; i++)
+  {
+    filter_pma_a63_t f = { 0, S->sh[i] };
+    filter_pma_precharge_q31(&f, y0[i]);
+    S->acc[i] = f.acc;
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+magic = ceil(2^(32 + 2l) / N), worked out as (2^k - 1) / N + 1 so the
+numerator fits in 64 bits when l = 16.
+-----------------------------------------------------------------------------*/
+void filter_boxcar_reciprocal(uint32_t N, uint16_t *l, uint64_t *magic)
+{
+  uint32_t k;
+
+  *l = 0;
+  while ((1UL << *l) < N)
+  {
+    (*l)++;
+  }
+  k = 32U + 2U * *l;
+  *magic = ((k == 64U) ? UINT64_MAX : ((uint64_t)1 << k) - 1U) / N + 1U;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void filter_boxcar_init_q31(q31_t y0, filter_boxcar_a63_t *param)
+{
+  filter_boxcar_reciprocal(param->N, &param->l, &param->magic);
+  for (uint32_t i = 0; i < param->N; i++)
+  {
+    param->pState[i] = y0;
+  }
+  param->sum = (acc64_t)y0 * param->N;
+  param->idx = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void filter_boxcar_bank_init_q31(filter_boxcar_bank_a63_t *S, const q31_t *y0)
+{
+  filter_boxcar_reciprocal(S->N, &S->l, &S->magic);
+  for (uint32_t i = 0; i < S->n; i++)
+  {
+    q31_t y = (y0 != NULL) ? y0[i] : 0;
+    for (uint32_t k = 0; k < S->N; k++)
+    {
+      S->pState[k * S->n + i] = y;
+    }
+    S->sum[i] = (acc64_t)y * S->N;
+  }
+  S->idx = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+One pass over the oldest row: the sum update vectorizes, the division is the
+same inline as the single channel filter.
+-----------------------------------------------------------------------------*/
+void filter_boxcar_bank_q31(filter_boxcar_bank_a63_t *S, const q31_t *in, q31_t *out)
+{
+  q31_t *row = &S->pState[(uint32_t)S->idx * S->n];
+
+  for (uint32_t i = 0; i < S->n; i++)
+  {
+    q31_t x = in[i];
+    S->sum[i] += (acc64_t)x - row[i];
+    row[i] = x;
+    out[i] = filter_boxcar_div(S->sum[i], S->magic, S->l, S->N);
+  }
+  if (++S->idx == S->N)
+  {
+    S->idx = 0;
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernel.  Channel i is filtered exactly like filter_pma_q31.
+-----------------------------------------------------------------------------*/
+static inline void filter_pma_bank_step_q31(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out,
+                                            uint32_t i, uint32_t n)
+{
+    for (; i < n; i++) {
+        filter_pma_a63_t f = { S->acc[i], S->sh[i] };
+        out[i] = filter_pma_q31(in[i], &f);
+        S->acc[i] = f.acc;
+    }
+}
+
+void filter_pma_bank_q31_scalar(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    filter_pma_bank_step_q31(S, in, out, 0, S->n);
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+AVX2 has no 64-bit arithmetic shift, so acc >> sh is done as
+((acc ^ m) >> sh) ^ m with a logical shift, where m is the sign of acc.
+The output is the low 32 bits of the shift, as in the scalar assignment to
+q31_t, and the dissipation subtracts that output sign extended back to 64 bits.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+void filter_pma_bank_q31_avx2(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m128i shc = _mm_cvtsi32_si128(S->sh_common);
+    acc64_t *acc = S->acc;
+    uint32_t i = 0;
+
+    for (; i + 4 <= S->n; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&acc[i]);
+        a = _mm256_add_epi64(a, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&in[i])));
+
+        __m256i m = _mm256_cmpgt_epi64(zero, a);
+        __m256i y = _mm256_xor_si256(a, m);
+        if (S->sh_common >= 0) {
+            y = _mm256_srl_epi64(y, shc);
+        } else {
+            __m128i sh = _mm_loadl_epi64((const __m128i *)&S->sh[i]);
+            y = _mm256_srlv_epi64(y, _mm256_cvtepu16_epi64(sh));
+        }
+        y = _mm256_xor_si256(y, m);
+        __m128i r = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(y, even));
+
+        a = _mm256_sub_epi64(a, _mm256_cvtepi32_epi64(r));
+        _mm256_storeu_si256((__m256i *)&acc[i], a);
+        _mm_storeu_si128((__m128i *)&out[i], r);
+    }
+    filter_pma_bank_step_q31(S, in, out, i, S->n);
+}
+
+RT_DSP_TARGET_AVX512
+void filter_pma_bank_q31_avx512(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    const __m128i shc = _mm_cvtsi32_si128(S->sh_common);
+    acc64_t *acc = S->acc;
+    uint32_t i = 0;
+
+    for (; i + 8 <= S->n; i += 8) {
+        __m512i a = _mm512_loadu_si512((const void *)&acc[i]);
+        a = _mm512_add_epi64(a, _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)&in[i])));
+
+        __m512i y;
+        if (S->sh_common >= 0) {
+            y = _mm512_sra_epi64(a, shc);
+        } else {
+            __m128i sh = _mm_loadu_si128((const __m128i *)&S->sh[i]);
+            y = _mm512_srav_epi64(a, _mm512_cvtepu16_epi64(sh));
+        }
+        __m256i r = _mm512_cvtepi64_epi32(y);
+
+        a = _mm512_sub_epi64(a, _mm512_cvtepi32_epi64(r));
+        _mm512_storeu_si512((void *)&acc[i], a);
+        _mm256_storeu_si256((__m256i *)&out[i], r);
+    }
+    filter_pma_bank_step_q31(S, in, out, i, S->n);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+SSHL by a negative count is the arithmetic right shift, XTN keeps the low
+32 bits like the scalar assignment to q31_t.
+-----------------------------------------------------------------------------*/
+void filter_pma_bank_q31_neon(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    int64x2_t shl = vdupq_n_s64(-(int64_t)S->sh_common);
+    int64x2_t shh = shl;
+    acc64_t *acc = S->acc;
+    uint32_t i = 0;
+
+    for (; i + 4 <= S->n; i += 4) {
+        int32x4_t x = vld1q_s32(&in[i]);
+        int64x2_t al = vaddw_s32(vld1q_s64(&acc[i]), vget_low_s32(x));
+        int64x2_t ah = vaddw_high_s32(vld1q_s64(&acc[i + 2]), x);
+
+        if (S->sh_common < 0) {
+            uint32x4_t sh = vmovl_u16(vld1_u16(&S->sh[i]));
+            shl = vnegq_s64(vreinterpretq_s64_u64(vmovl_u32(vget_low_u32(sh))));
+            shh = vnegq_s64(vreinterpretq_s64_u64(vmovl_high_u32(sh)));
+        }
+        int32x4_t r = vcombine_s32(vmovn_s64(vshlq_s64(al, shl)), vmovn_s64(vshlq_s64(ah, shh)));
+
+        vst1q_s64(&acc[i], vsubw_s32(al, vget_low_s32(r)));
+        vst1q_s64(&acc[i + 2], vsubw_high_s32(ah, r));
+        vst1q_s32(&out[i], r);
+    }
+    filter_pma_bank_step_q31(S, in, out, i, S->n);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void filter_pma_bank_q31(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out) {
+    dsp_kernels.filter_pma_bank_q31(S, in, out);
+}
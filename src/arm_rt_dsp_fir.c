@@ -0,0 +1,401 @@
+/**
+ * \file arm_rt_dsp_fir.c
+ * \brief FIR decimators and interpolators.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+
+
+// The dot products are 34.30 and 2.62, the outputs are truncated and saturated.
+static inline q15_t fir_output_q15(int64_t acc) {
+    return (q15_t)ssat_i64(acc >> 15, 16);
+}
+
+static inline q31_t fir_output_q31(int64_t acc) {
+    return (q31_t)ssat_i64(acc >> 31, 32);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void fir_decimate_init_q15(fir_decimate_instance_q15 *S, const q15_t *h)
+{
+  memcpy(S->pCoeffs, h, S->numTaps * sizeof(q15_t));
+  memset(S->pState, 0, 2U * S->numTaps * sizeof(q15_t));
+  S->phase = 0;
+  S->idx = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The newest sample is at pState[idx] and at pState[idx + numTaps], so
+pState[idx + k] is x[n - k] for k < numTaps and the dot product with h[k] is
+contiguous.  idx counts down.
+-----------------------------------------------------------------------------*/
+uint32_t fir_decimate_q15(fir_decimate_instance_q15 *S, const q15_t *in, q15_t *out, uint32_t n)
+{
+  const uint32_t N = S->numTaps;
+  uint32_t idx = S->idx;
+  uint32_t phase = S->phase;
+  uint32_t m = 0;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    idx = (idx == 0) ? N - 1 : idx - 1;
+    S->pState[idx] = in[i];
+    S->pState[idx + N] = in[i];
+
+    if (++phase == S->M)
+    {
+      phase = 0;
+      out[m++] = fir_output_q15(dot_q15_block(S->pCoeffs, &S->pState[idx], N));
+    }
+  }
+
+  S->idx = (uint16_t)idx;
+  S->phase = (uint16_t)phase;
+  return m;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+pCoeffs[p * phaseLength + j] = h[j * L + p].
+-----------------------------------------------------------------------------*/
+void fir_interpolate_init_q15(fir_interpolate_instance_q15 *S, const q15_t *h)
+{
+  for (uint32_t p = 0; p < S->L; p++)
+  {
+    for (uint32_t j = 0; j < S->phaseLength; j++)
+    {
+      uint32_t k = j * S->L + p;
+      S->pCoeffs[p * S->phaseLength + j] = (k < S->numTaps) ? h[k] : 0;
+    }
+  }
+  memset(S->pState, 0, 2U * S->phaseLength * sizeof(q15_t));
+  S->idx = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same double length state buffer as fir_decimate_q15, holding the inputs.
+-----------------------------------------------------------------------------*/
+void fir_interpolate_q15(fir_interpolate_instance_q15 *S, const q15_t *in, q15_t *out, uint32_t n)
+{
+  const uint32_t Q = S->phaseLength;
+  uint32_t idx = S->idx;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    idx = (idx == 0) ? Q - 1 : idx - 1;
+    S->pState[idx] = in[i];
+    S->pState[idx + Q] = in[i];
+
+    for (uint32_t p = 0; p < S->L; p++)
+    {
+      *out++ = fir_output_q15(dot_q15_block(&S->pCoeffs[p * Q], &S->pState[idx], Q));
+    }
+  }
+
+  S->idx = (uint16_t)idx;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void fir_halfband_init_q15(fir_halfband_instance_q15 *S, const q15_t *h)
+{
+  const uint32_t NA = (S->numTaps + 1U) / 2U;
+
+  for (uint32_t j = 0; j < NA; j++)
+  {
+    S->pCoeffs[j] = h[2U * j];
+  }
+  S->center = h[S->numTaps / 2U];
+  memset(S->pStateA, 0, 2U * NA * sizeof(q15_t));
+  memset(S->pStateB, 0, NA * sizeof(q15_t));
+  S->phase = 0;
+  S->idxA = 0;
+  S->idxB = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Of each pair of inputs the first goes to the centre tap phase B and the second
+to the even tap phase A and gives an output.  With c = 2K + 1 the centre tap
+sees x[n - c], which is K samples back in phase B.
+-----------------------------------------------------------------------------*/
+uint32_t fir_halfband_decimate_q15(fir_halfband_instance_q15 *S, const q15_t *in, q15_t *out,
+                                   uint32_t n)
+{
+  const uint32_t NA = (S->numTaps + 1U) / 2U;
+  const uint32_t NB = NA / 2U;
+  uint32_t idxA = S->idxA;
+  uint32_t idxB = S->idxB;
+  uint32_t phase = S->phase;
+  uint32_t m = 0;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    if (phase == 0)
+    {
+      idxB = (idxB == 0) ? NB - 1 : idxB - 1;
+      S->pStateB[idxB] = in[i];
+      S->pStateB[idxB + NB] = in[i];
+      phase = 1;
+    }
+    else
+    {
+      idxA = (idxA == 0) ? NA - 1 : idxA - 1;
+      S->pStateA[idxA] = in[i];
+      S->pStateA[idxA + NA] = in[i];
+      uint64_t acc = (uint64_t)dot_q15_block(S->pCoeffs, &S->pStateA[idxA], NA);
+      acc += (uint64_t)((int64_t)S->center * S->pStateB[idxB + NB - 1U]);
+      out[m++] = fir_output_q15((int64_t)acc);
+      phase = 0;
+    }
+  }
+
+  S->idxA = (uint16_t)idxA;
+  S->idxB = (uint16_t)idxB;
+  S->phase = (uint16_t)phase;
+  return m;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The odd outputs only see the centre tap, at x[n - K].
+-----------------------------------------------------------------------------*/
+void fir_halfband_interpolate_q15(fir_halfband_instance_q15 *S, const q15_t *in, q15_t *out,
+                                  uint32_t n)
+{
+  const uint32_t NA = (S->numTaps + 1U) / 2U;
+  const uint32_t K = NA / 2U - 1U;
+  uint32_t idxA = S->idxA;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    idxA = (idxA == 0) ? NA - 1 : idxA - 1;
+    S->pStateA[idxA] = in[i];
+    S->pStateA[idxA + NA] = in[i];
+    *out++ = fir_output_q15(dot_q15_block(S->pCoeffs, &S->pStateA[idxA], NA));
+    *out++ = fir_output_q15((int64_t)S->center * S->pStateA[idxA + K]);
+  }
+
+  S->idxA = (uint16_t)idxA;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void fir_decimate_init_q31(fir_decimate_instance_q31 *S, const q31_t *h)
+{
+  memcpy(S->pCoeffs, h, S->numTaps * sizeof(q31_t));
+  memset(S->pState, 0, 2U * S->numTaps * sizeof(q31_t));
+  S->phase = 0;
+  S->idx = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The newest sample is at pState[idx] and at pState[idx + numTaps], so
+pState[idx + k] is x[n - k] for k < numTaps and the dot product with h[k] is
+contiguous.  idx counts down.
+-----------------------------------------------------------------------------*/
+uint32_t fir_decimate_q31(fir_decimate_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n)
+{
+  const uint32_t N = S->numTaps;
+  uint32_t idx = S->idx;
+  uint32_t phase = S->phase;
+  uint32_t m = 0;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    idx = (idx == 0) ? N - 1 : idx - 1;
+    S->pState[idx] = in[i];
+    S->pState[idx + N] = in[i];
+
+    if (++phase == S->M)
+    {
+      phase = 0;
+      out[m++] = fir_output_q31(dot_q31_block(S->pCoeffs, &S->pState[idx], N));
+    }
+  }
+
+  S->idx = (uint16_t)idx;
+  S->phase = (uint16_t)phase;
+  return m;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+pCoeffs[p * phaseLength + j] = h[j * L + p].
+-----------------------------------------------------------------------------*/
+void fir_interpolate_init_q31(fir_interpolate_instance_q31 *S, const q31_t *h)
+{
+  for (uint32_t p = 0; p < S->L; p++)
+  {
+    for (uint32_t j = 0; j < S->phaseLength; j++)
+    {
+      uint32_t k = j * S->L + p;
+      S->pCoeffs[p * S->phaseLength + j] = (k < S->numTaps) ? h[k] : 0;
+    }
+  }
+  memset(S->pState, 0, 2U * S->phaseLength * sizeof(q31_t));
+  S->idx = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same double length state buffer as fir_decimate_q31, holding the inputs.
+-----------------------------------------------------------------------------*/
+void fir_interpolate_q31(fir_interpolate_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n)
+{
+  const uint32_t Q = S->phaseLength;
+  uint32_t idx = S->idx;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    idx = (idx == 0) ? Q - 1 : idx - 1;
+    S->pState[idx] = in[i];
+    S->pState[idx + Q] = in[i];
+
+    for (uint32_t p = 0; p < S->L; p++)
+    {
+      *out++ = fir_output_q31(dot_q31_block(&S->pCoeffs[p * Q], &S->pState[idx], Q));
+    }
+  }
+
+  S->idx = (uint16_t)idx;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void fir_halfband_init_q31(fir_halfband_instance_q31 *S, const q31_t *h)
+{
+  const uint32_t NA = (S->numTaps + 1U) / 2U;
+
+  for (uint32_t j = 0; j < NA; j++)
+  {
+    S->pCoeffs[j] = h[2U * j];
+  }
+  S->center = h[S->numTaps / 2U];
+  memset(S->pStateA, 0, 2U * NA * sizeof(q31_t));
+  memset(S->pStateB, 0, NA * sizeof(q31_t));
+  S->phase = 0;
+  S->idxA = 0;
+  S->idxB = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Of each pair of inputs the first goes to the centre tap phase B and the second
+to the even tap phase A and gives an output.  With c = 2K + 1 the centre tap
+sees x[n - c], which is K samples back in phase B.
+-----------------------------------------------------------------------------*/
+uint32_t fir_halfband_decimate_q31(fir_halfband_instance_q31 *S, const q31_t *in, q31_t *out,
+                                   uint32_t n)
+{
+  const uint32_t NA = (S->numTaps + 1U) / 2U;
+  const uint32_t NB = NA / 2U;
+  uint32_t idxA = S->idxA;
+  uint32_t idxB = S->idxB;
+  uint32_t phase = S->phase;
+  uint32_t m = 0;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    if (phase == 0)
+    {
+      idxB = (idxB == 0) ? NB - 1 : idxB - 1;
+      S->pStateB[idxB] = in[i];
+      S->pStateB[idxB + NB] = in[i];
+      phase = 1;
+    }
+    else
+    {
+      idxA = (idxA == 0) ? NA - 1 : idxA - 1;
+      S->pStateA[idxA] = in[i];
+      S->pStateA[idxA + NA] = in[i];
+      uint64_t acc = (uint64_t)dot_q31_block(S->pCoeffs, &S->pStateA[idxA], NA);
+      acc += (uint64_t)((int64_t)S->center * S->pStateB[idxB + NB - 1U]);
+      out[m++] = fir_output_q31((int64_t)acc);
+      phase = 0;
+    }
+  }
+
+  S->idxA = (uint16_t)idxA;
+  S->idxB = (uint16_t)idxB;
+  S->phase = (uint16_t)phase;
+  return m;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The odd outputs only see the centre tap, at x[n - K].
+-----------------------------------------------------------------------------*/
+void fir_halfband_interpolate_q31(fir_halfband_instance_q31 *S, const q31_t *in, q31_t *out,
+                                  uint32_t n)
+{
+  const uint32_t NA = (S->numTaps + 1U) / 2U;
+  const uint32_t K = NA / 2U - 1U;
+  uint32_t idxA = S->idxA;
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    idxA = (idxA == 0) ? NA - 1 : idxA - 1;
+    S->pStateA[idxA] = in[i];
+    S->pStateA[idxA + NA] = in[i];
+    *out++ = fir_output_q31(dot_q31_block(S->pCoeffs, &S->pStateA[idxA], NA));
+    *out++ = fir_output_q31((int64_t)S->center * S->pStateA[idxA + K]);
+  }
+
+  S->idxA = (uint16_t)idxA;
+}
@@ -0,0 +1,202 @@
+/**
+ * \file arm_rt_dsp_hysteresis.c
+ * \brief Hysteresis threshold banks with bit packed outputs.
+*/
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernels.  These are the reference for every other kernel.
+
+Notes:
+The kernels build two bitsets per 64 channels, above hyst_on and below
+hyst_off, and update the state word with one and-or.  Above wins, like the
+if in hysteresis_threshold.  Every kernel does its last partial word with the
+scalar kernel, so the bits past the last channel are never set.
+-----------------------------------------------------------------------------*/
+static inline uint32_t hyst_bank_word(uint64_t *state, uint64_t *changed, uint64_t above, uint64_t below) {
+    uint64_t old = *state;
+    *state = above | (old & ~below);
+    *changed = *state ^ old;
+    return (uint32_t)__builtin_popcountll(*changed);
+}
+
+uint32_t hyst_bank_q31_scalar(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state,
+                              uint64_t *changed, uint32_t n) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; i += 64) {
+        uint32_t m = (n - i < 64) ? n - i : 64;
+        uint64_t above = 0, below = 0;
+        for (uint32_t j = 0; j < m; j++) {
+            above |= (uint64_t)(val[i + j] > on[i + j]) << j;
+            below |= (uint64_t)(val[i + j] < off[i + j]) << j;
+        }
+        count += hyst_bank_word(&state[i / 64], &changed[i / 64], above, below);
+    }
+    return count;
+}
+
+uint32_t hyst_bank_i16_scalar(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state,
+                              uint64_t *changed, uint32_t n) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; i += 64) {
+        uint32_t m = (n - i < 64) ? n - i : 64;
+        uint64_t above = 0, below = 0;
+        for (uint32_t j = 0; j < m; j++) {
+            above |= (uint64_t)(val[i + j] > on[i + j]) << j;
+            below |= (uint64_t)(val[i + j] < off[i + j]) << j;
+        }
+        count += hyst_bank_word(&state[i / 64], &changed[i / 64], above, below);
+    }
+    return count;
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+The compare masks go straight to bits, MOVMSKPS for AVX2 q31 and the mask
+registers for AVX-512.  AVX2 has no 16-bit movemask, so two compares are
+packed to bytes first, and the lane crossing of the pack is undone with a
+permute.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+uint32_t hyst_bank_q31_avx2(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state,
+                            uint64_t *changed, uint32_t n) {
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t above = 0, below = 0;
+        for (uint32_t k = 0; k < 64; k += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)&val[i + k]);
+            __m256i a = _mm256_cmpgt_epi32(v, _mm256_loadu_si256((const __m256i *)&on[i + k]));
+            __m256i b = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)&off[i + k]), v);
+            above |= (uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(a)) << k;
+            below |= (uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(b)) << k;
+        }
+        count += hyst_bank_word(&state[i / 64], &changed[i / 64], above, below);
+    }
+    return count + hyst_bank_q31_scalar(&val[i], &on[i], &off[i], &state[i / 64], &changed[i / 64], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+uint32_t hyst_bank_i16_avx2(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state,
+                            uint64_t *changed, uint32_t n) {
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t above = 0, below = 0;
+        for (uint32_t k = 0; k < 64; k += 32) {
+            __m256i v0 = _mm256_loadu_si256((const __m256i *)&val[i + k]);
+            __m256i v1 = _mm256_loadu_si256((const __m256i *)&val[i + k + 16]);
+            __m256i a = _mm256_packs_epi16(_mm256_cmpgt_epi16(v0, _mm256_loadu_si256((const __m256i *)&on[i + k])),
+                                           _mm256_cmpgt_epi16(v1, _mm256_loadu_si256((const __m256i *)&on[i + k + 16])));
+            __m256i b = _mm256_packs_epi16(_mm256_cmpgt_epi16(_mm256_loadu_si256((const __m256i *)&off[i + k]), v0),
+                                           _mm256_cmpgt_epi16(_mm256_loadu_si256((const __m256i *)&off[i + k + 16]), v1));
+            above |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_permute4x64_epi64(a, 0xD8)) << k;
+            below |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_permute4x64_epi64(b, 0xD8)) << k;
+        }
+        count += hyst_bank_word(&state[i / 64], &changed[i / 64], above, below);
+    }
+    return count + hyst_bank_i16_scalar(&val[i], &on[i], &off[i], &state[i / 64], &changed[i / 64], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+uint32_t hyst_bank_q31_avx512(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state,
+                              uint64_t *changed, uint32_t n) {
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t above = 0, below = 0;
+        for (uint32_t k = 0; k < 64; k += 16) {
+            __m512i v = _mm512_loadu_si512((const void *)&val[i + k]);
+            above |= (uint64_t)_mm512_cmpgt_epi32_mask(v, _mm512_loadu_si512((const void *)&on[i + k])) << k;
+            below |= (uint64_t)_mm512_cmplt_epi32_mask(v, _mm512_loadu_si512((const void *)&off[i + k])) << k;
+        }
+        count += hyst_bank_word(&state[i / 64], &changed[i / 64], above, below);
+    }
+    return count + hyst_bank_q31_scalar(&val[i], &on[i], &off[i], &state[i / 64], &changed[i / 64], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+uint32_t hyst_bank_i16_avx512(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state,
+                              uint64_t *changed, uint32_t n) {
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t above = 0, below = 0;
+        for (uint32_t k = 0; k < 64; k += 32) {
+            __m512i v = _mm512_loadu_si512((const void *)&val[i + k]);
+            above |= (uint64_t)_mm512_cmpgt_epi16_mask(v, _mm512_loadu_si512((const void *)&on[i + k])) << k;
+            below |= (uint64_t)_mm512_cmplt_epi16_mask(v, _mm512_loadu_si512((const void *)&off[i + k])) << k;
+        }
+        count += hyst_bank_word(&state[i / 64], &changed[i / 64], above, below);
+    }
+    return count + hyst_bank_i16_scalar(&val[i], &on[i], &off[i], &state[i / 64], &changed[i / 64], n - i);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+A compare lane is all ones, anded with the lane's bit and added across the
+vector it gives the bits of the vector.
+-----------------------------------------------------------------------------*/
+uint32_t hyst_bank_q31_neon(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state,
+                            uint64_t *changed, uint32_t n) {
+    static const uint32_t lane_bits[4] = {1, 2, 4, 8};
+    const uint32x4_t bits = vld1q_u32(lane_bits);
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t above = 0, below = 0;
+        for (uint32_t k = 0; k < 64; k += 4) {
+            int32x4_t v = vld1q_s32(&val[i + k]);
+            above |= (uint64_t)vaddvq_u32(vandq_u32(vcgtq_s32(v, vld1q_s32(&on[i + k])), bits)) << k;
+            below |= (uint64_t)vaddvq_u32(vandq_u32(vcltq_s32(v, vld1q_s32(&off[i + k])), bits)) << k;
+        }
+        count += hyst_bank_word(&state[i / 64], &changed[i / 64], above, below);
+    }
+    return count + hyst_bank_q31_scalar(&val[i], &on[i], &off[i], &state[i / 64], &changed[i / 64], n - i);
+}
+
+uint32_t hyst_bank_i16_neon(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state,
+                            uint64_t *changed, uint32_t n) {
+    static const uint16_t lane_bits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    const uint16x8_t bits = vld1q_u16(lane_bits);
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t above = 0, below = 0;
+        for (uint32_t k = 0; k < 64; k += 8) {
+            int16x8_t v = vld1q_s16(&val[i + k]);
+            above |= (uint64_t)vaddvq_u16(vandq_u16(vcgtq_s16(v, vld1q_s16(&on[i + k])), bits)) << k;
+            below |= (uint64_t)vaddvq_u16(vandq_u16(vcltq_s16(v, vld1q_s16(&off[i + k])), bits)) << k;
+        }
+        count += hyst_bank_word(&state[i / 64], &changed[i / 64], above, below);
+    }
+    return count + hyst_bank_i16_scalar(&val[i], &on[i], &off[i], &state[i / 64], &changed[i / 64], n - i);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+uint32_t hysteresis_bank(hysteresis_bank_t *H, const q31_t *val, uint64_t *changed) {
+    return dsp_kernels.hyst_bank_q31(val, H->hyst_on, H->hyst_off, H->state, changed, H->n);
+}
+
+uint32_t hysteresis_bank_i16(hysteresis_bank_i16_t *H, const int16_t *val, uint64_t *changed) {
+    return dsp_kernels.hyst_bank_i16(val, H->hyst_on, H->hyst_off, H->state, changed, H->n);
+}
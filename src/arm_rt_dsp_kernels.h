@@ -0,0 +1,248 @@
+/**
+ * \file arm_rt_dsp_kernels.h
+ * \brief Private declarations of the instruction set specific block kernels.
+ *
+ * Every block function has a portable scalar kernel that is the reference for the
+ * results.  The vector kernels must match it bit for bit and count the same
+ * saturation events in the emulated Q flag.  The x86 kernels are compiled with
+ * function target attributes so the library itself is still built for the
+ * baseline instruction set.
+*/
+
+#ifndef ARM_RT_DSP_KERNELS_
+#define ARM_RT_DSP_KERNELS_
+
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RT_DSP_HAVE_X86 1
+#include <immintrin.h>
+#define RT_DSP_TARGET_SSE41  __attribute__((target("sse4.1")))
+#define RT_DSP_TARGET_AVX2   __attribute__((target("avx2")))
+#define RT_DSP_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define RT_DSP_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// For helpers whose arguments must fold to constants in every caller, so their
+// shifts come out as immediates.
+#if defined(__GNUC__)
+#define RT_DSP_ALWAYS_INLINE __attribute__((always_inline))
+#else
+#define RT_DSP_ALWAYS_INLINE
+#endif
+
+
+// Multiply kernels, arm_rt_dsp_block.c
+void mul_q15_block_scalar(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mul_q31_block_scalar(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void mulsat_q15_block_scalar(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mulsat_q31_block_scalar(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void abs_sat_q15_block_scalar(const q15_t *x, q15_t *out, uint32_t n);
+void abs_sat_q31_block_scalar(const q31_t *x, q31_t *out, uint32_t n);
+int64_t dot_q15_block_scalar(const q15_t *x, const q15_t *y, uint32_t n);
+int64_t dot_q31_block_scalar(const q31_t *x, const q31_t *y, uint32_t n);
+
+// Controller bank kernels, arm_rt_dsp_controller_bank.c
+void iir_pi_bank_q31_scalar(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out);
+void iir_pi_bank_q15_scalar(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out);
+
+// Filter bank kernels, arm_rt_dsp_filter_bank.c
+void filter_pma_bank_q31_scalar(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out);
+
+// Biquad bank kernels, arm_rt_dsp_biquad.c
+void filter_biquad_bank_q31_scalar(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out);
+
+// Goertzel and sliding DFT kernels, arm_rt_dsp_dft.c
+void goertzel_bank_q31_scalar(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+void sdft_bank_q31_scalar(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+
+// RMS bank kernels, arm_rt_dsp_rms.c
+uint32_t rms_bank_q31_scalar(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+
+// Resonant controllers, arm_rt_dsp_resonant.c
+void iir_pr_multi_q31_run_scalar(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+
+// Ramp kernels, arm_rt_dsp_ramp.c
+void ramp_fill_q31_scalar(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n);
+void ramp_fill_i16_scalar(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out, uint32_t n);
+
+// Limit kernels, arm_rt_dsp_limit.c
+void limit_q31_block_scalar(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n, uint32_t *count);
+void limit_i16_block_scalar(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out, uint32_t n, uint32_t *count);
+void limit_u16_block_scalar(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out, uint32_t n, uint32_t *count);
+void limit_f32_block_scalar(const float *x, float llim, float ulim, float *out, uint32_t n, uint32_t *count);
+
+// Reduction kernels, arm_rt_dsp_reduce.c
+void minmax_q31_block_scalar(const q31_t *x, uint32_t n, minmax_result_t *r);
+void minmax_i16_block_scalar(const int16_t *x, uint32_t n, minmax_result_t *r);
+void minmax_u16_block_scalar(const uint16_t *x, uint32_t n, minmax_result_t *r);
+int64_t sum64_q31_block_scalar(const q31_t *x, uint32_t n);
+int64_t sum64_i16_block_scalar(const int16_t *x, uint32_t n);
+int64_t sum64_u16_block_scalar(const uint16_t *x, uint32_t n);
+uint64_t sumsq_q31_block_scalar(const q31_t *x, uint32_t n);
+uint64_t sumsq_i16_block_scalar(const int16_t *x, uint32_t n);
+uint64_t sumsq_u16_block_scalar(const uint16_t *x, uint32_t n);
+
+// ADC kernels, arm_rt_dsp_adc.c
+extern const adc_block_kernels_t adc_block_kernels_scalar;
+
+// Convert kernels, arm_rt_dsp_convert.c
+void convert_u16_to_q31_block_scalar(const uint16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_i16_to_q31_block_scalar(const int16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_i32_to_q31_block_scalar(const int32_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_q31_to_i16_block_scalar(const q31_t *x, const uint32_t *scale, convert_round_t mode, int16_t *out, uint32_t n);
+void convert_q31_to_u16_block_scalar(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint16_t *out, uint32_t n);
+void convert_q31_to_u32_block_scalar(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint32_t *out, uint32_t n);
+void convert_q31_to_i32_block_scalar(const q31_t *x, const uint32_t *scale, convert_round_t mode, int32_t *out, uint32_t n);
+
+// Hysteresis kernels, arm_rt_dsp_hysteresis.c
+uint32_t hyst_bank_q31_scalar(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+uint32_t hyst_bank_i16_scalar(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+
+#ifdef RT_DSP_HAVE_X86
+void mul_q15_block_sse41(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mul_q31_block_sse41(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void mulsat_q15_block_sse41(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mulsat_q31_block_sse41(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void abs_sat_q15_block_sse41(const q15_t *x, q15_t *out, uint32_t n);
+void abs_sat_q31_block_sse41(const q31_t *x, q31_t *out, uint32_t n);
+
+void mul_q15_block_avx2(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mul_q31_block_avx2(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void mulsat_q15_block_avx2(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mulsat_q31_block_avx2(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void abs_sat_q15_block_avx2(const q15_t *x, q15_t *out, uint32_t n);
+void abs_sat_q31_block_avx2(const q31_t *x, q31_t *out, uint32_t n);
+int64_t dot_q15_block_avx2(const q15_t *x, const q15_t *y, uint32_t n);
+int64_t dot_q31_block_avx2(const q31_t *x, const q31_t *y, uint32_t n);
+
+void mul_q15_block_avx512(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mul_q31_block_avx512(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void mulsat_q15_block_avx512(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mulsat_q31_block_avx512(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void abs_sat_q15_block_avx512(const q15_t *x, q15_t *out, uint32_t n);
+void abs_sat_q31_block_avx512(const q31_t *x, q31_t *out, uint32_t n);
+
+void iir_pi_bank_q15_sse41(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out);
+void iir_pi_bank_q31_avx2(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out);
+void iir_pi_bank_q15_avx2(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out);
+void iir_pi_bank_q31_avx512(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out);
+
+void filter_pma_bank_q31_avx2(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out);
+void filter_pma_bank_q31_avx512(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out);
+void filter_biquad_bank_q31_avx2(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out);
+void filter_biquad_bank_q31_avx512(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out);
+void goertzel_bank_q31_avx2(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+void goertzel_bank_q31_avx512(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+void sdft_bank_q31_avx2(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+void sdft_bank_q31_avx512(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+uint32_t rms_bank_q31_avx2(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+uint32_t rms_bank_q31_avx512(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+void iir_pr_multi_q31_run_avx2(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+void iir_pr_multi_q31_run_avx512(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+void ramp_fill_q31_avx2(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n);
+void ramp_fill_q31_avx512(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n);
+void ramp_fill_i16_avx2(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out, uint32_t n);
+void ramp_fill_i16_avx512(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out, uint32_t n);
+void limit_q31_block_avx2(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n, uint32_t *count);
+void limit_q31_block_avx512(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n, uint32_t *count);
+void limit_i16_block_avx2(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out, uint32_t n, uint32_t *count);
+void limit_i16_block_avx512(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out, uint32_t n, uint32_t *count);
+void limit_u16_block_avx2(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out, uint32_t n, uint32_t *count);
+void limit_u16_block_avx512(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out, uint32_t n, uint32_t *count);
+void limit_f32_block_avx2(const float *x, float llim, float ulim, float *out, uint32_t n, uint32_t *count);
+void limit_f32_block_avx512(const float *x, float llim, float ulim, float *out, uint32_t n, uint32_t *count);
+void minmax_q31_block_avx2(const q31_t *x, uint32_t n, minmax_result_t *r);
+void minmax_q31_block_avx512(const q31_t *x, uint32_t n, minmax_result_t *r);
+void minmax_i16_block_avx2(const int16_t *x, uint32_t n, minmax_result_t *r);
+void minmax_i16_block_avx512(const int16_t *x, uint32_t n, minmax_result_t *r);
+void minmax_u16_block_avx2(const uint16_t *x, uint32_t n, minmax_result_t *r);
+void minmax_u16_block_avx512(const uint16_t *x, uint32_t n, minmax_result_t *r);
+int64_t sum64_q31_block_avx2(const q31_t *x, uint32_t n);
+int64_t sum64_q31_block_avx512(const q31_t *x, uint32_t n);
+int64_t sum64_i16_block_avx2(const int16_t *x, uint32_t n);
+int64_t sum64_i16_block_avx512(const int16_t *x, uint32_t n);
+int64_t sum64_u16_block_avx2(const uint16_t *x, uint32_t n);
+int64_t sum64_u16_block_avx512(const uint16_t *x, uint32_t n);
+uint64_t sumsq_q31_block_avx2(const q31_t *x, uint32_t n);
+uint64_t sumsq_q31_block_avx512(const q31_t *x, uint32_t n);
+uint64_t sumsq_i16_block_avx2(const int16_t *x, uint32_t n);
+uint64_t sumsq_i16_block_avx512(const int16_t *x, uint32_t n);
+uint64_t sumsq_u16_block_avx2(const uint16_t *x, uint32_t n);
+uint64_t sumsq_u16_block_avx512(const uint16_t *x, uint32_t n);
+extern const adc_block_kernels_t adc_block_kernels_avx2;
+extern const adc_block_kernels_t adc_block_kernels_avx512;
+void convert_u16_to_q31_block_avx2(const uint16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_u16_to_q31_block_avx512(const uint16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_i16_to_q31_block_avx2(const int16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_i16_to_q31_block_avx512(const int16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_i32_to_q31_block_avx2(const int32_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_i32_to_q31_block_avx512(const int32_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_q31_to_i16_block_avx2(const q31_t *x, const uint32_t *scale, convert_round_t mode, int16_t *out, uint32_t n);
+void convert_q31_to_i16_block_avx512(const q31_t *x, const uint32_t *scale, convert_round_t mode, int16_t *out, uint32_t n);
+void convert_q31_to_u16_block_avx2(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint16_t *out, uint32_t n);
+void convert_q31_to_u16_block_avx512(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint16_t *out, uint32_t n);
+void convert_q31_to_u32_block_avx2(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint32_t *out, uint32_t n);
+void convert_q31_to_u32_block_avx512(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint32_t *out, uint32_t n);
+void convert_q31_to_i32_block_avx2(const q31_t *x, const uint32_t *scale, convert_round_t mode, int32_t *out, uint32_t n);
+void convert_q31_to_i32_block_avx512(const q31_t *x, const uint32_t *scale, convert_round_t mode, int32_t *out, uint32_t n);
+uint32_t hyst_bank_q31_avx2(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+uint32_t hyst_bank_q31_avx512(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+uint32_t hyst_bank_i16_avx2(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+uint32_t hyst_bank_i16_avx512(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+#endif
+
+#ifdef RT_DSP_HAVE_NEON
+void mul_q15_block_neon(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mul_q31_block_neon(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void mulsat_q15_block_neon(const q15_t *x, const q15_t *y, q15_t *out, uint32_t n);
+void mulsat_q31_block_neon(const q31_t *x, const q31_t *y, q31_t *out, uint32_t n);
+void abs_sat_q15_block_neon(const q15_t *x, q15_t *out, uint32_t n);
+void abs_sat_q31_block_neon(const q31_t *x, q31_t *out, uint32_t n);
+int64_t dot_q15_block_neon(const q15_t *x, const q15_t *y, uint32_t n);
+int64_t dot_q31_block_neon(const q31_t *x, const q31_t *y, uint32_t n);
+
+void iir_pi_bank_q31_neon(iir_pi_bank_instance_q31 *S, const q31_t *in, q31_t *out);
+void iir_pi_bank_q15_neon(iir_pi_bank_instance_q15 *S, const q15_t *in, q15_t *out);
+
+void filter_pma_bank_q31_neon(filter_pma_bank_a63_t *S, const q31_t *in, q31_t *out);
+void filter_biquad_bank_q31_neon(filter_biquad_bank_a63_t *S, const q31_t *in, q31_t *out);
+void goertzel_bank_q31_neon(goertzel_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+void sdft_bank_q31_neon(sdft_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+uint32_t rms_bank_q31_neon(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames);
+void iir_pr_multi_q31_run_neon(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n);
+void ramp_fill_q31_neon(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n);
+void ramp_fill_i16_neon(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out, uint32_t n);
+void limit_q31_block_neon(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n, uint32_t *count);
+void limit_i16_block_neon(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out, uint32_t n, uint32_t *count);
+void limit_u16_block_neon(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out, uint32_t n, uint32_t *count);
+void limit_f32_block_neon(const float *x, float llim, float ulim, float *out, uint32_t n, uint32_t *count);
+void minmax_q31_block_neon(const q31_t *x, uint32_t n, minmax_result_t *r);
+void minmax_i16_block_neon(const int16_t *x, uint32_t n, minmax_result_t *r);
+void minmax_u16_block_neon(const uint16_t *x, uint32_t n, minmax_result_t *r);
+int64_t sum64_q31_block_neon(const q31_t *x, uint32_t n);
+int64_t sum64_i16_block_neon(const int16_t *x, uint32_t n);
+int64_t sum64_u16_block_neon(const uint16_t *x, uint32_t n);
+uint64_t sumsq_q31_block_neon(const q31_t *x, uint32_t n);
+uint64_t sumsq_i16_block_neon(const int16_t *x, uint32_t n);
+uint64_t sumsq_u16_block_neon(const uint16_t *x, uint32_t n);
+extern const adc_block_kernels_t adc_block_kernels_neon;
+void convert_u16_to_q31_block_neon(const uint16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_i16_to_q31_block_neon(const int16_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_i32_to_q31_block_neon(const int32_t *x, const convert_recip_t *R, q31_t *out, uint32_t n);
+void convert_q31_to_i16_block_neon(const q31_t *x, const uint32_t *scale, convert_round_t mode, int16_t *out, uint32_t n);
+void convert_q31_to_u16_block_neon(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint16_t *out, uint32_t n);
+void convert_q31_to_u32_block_neon(const q31_t *x, const uint32_t *scale, convert_round_t mode, uint32_t *out, uint32_t n);
+void convert_q31_to_i32_block_neon(const q31_t *x, const uint32_t *scale, convert_round_t mode, int32_t *out, uint32_t n);
+uint32_t hyst_bank_q31_neon(const q31_t *val, const q31_t *on, const q31_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+uint32_t hyst_bank_i16_neon(const int16_t *val, const int16_t *on, const int16_t *off, uint64_t *state, uint64_t *changed, uint32_t n);
+#endif
+
+
+#endif // ARM_RT_DSP_KERNELS_
@@ -0,0 +1,437 @@
+/**
+ * \file arm_rt_dsp_limit.c
+ * \brief Block versions of the limit functions with limit hit counts.
+*/
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernels.  These are the reference for every other kernel.  count[0] is
+the number of inputs above ulim and count[1] the number of inputs below llim
+after the upper limit, the two branches of the scalar limit functions.  The
+input is read before the output is written so the arrays may be the same.
+-----------------------------------------------------------------------------*/
+static inline void limit_q31_step(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out,
+                                  uint32_t i, uint32_t n, uint32_t *count)
+{
+    for (; i < n; i++) {
+        q31_t v = x[i];
+        count[0] += v > ulim;
+        v = upper_limit_q31(v, ulim);
+        count[1] += v < llim;
+        out[i] = lower_limit_q31(v, llim);
+    }
+}
+
+static inline void limit_i16_step(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out,
+                                  uint32_t i, uint32_t n, uint32_t *count)
+{
+    for (; i < n; i++) {
+        int16_t v = x[i];
+        count[0] += v > ulim;
+        count[1] += ((v > ulim) ? ulim : v) < llim;
+        out[i] = limit_i16(v, llim, ulim);
+    }
+}
+
+static inline void limit_u16_step(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out,
+                                  uint32_t i, uint32_t n, uint32_t *count)
+{
+    for (; i < n; i++) {
+        uint16_t v = x[i];
+        count[0] += v > ulim;
+        count[1] += ((v > ulim) ? ulim : v) < llim;
+        out[i] = limit_u16(v, llim, ulim);
+    }
+}
+
+static inline void limit_f32_step(const float *x, float llim, float ulim, float *out,
+                                  uint32_t i, uint32_t n, uint32_t *count)
+{
+    for (; i < n; i++) {
+        float v = x[i];
+        count[0] += v > ulim;
+        count[1] += ((v > ulim) ? ulim : v) < llim;
+        out[i] = limit_f32(v, llim, ulim);
+    }
+}
+
+void limit_q31_block_scalar(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n,
+                            uint32_t *count) {
+    limit_q31_step(x, llim, ulim, out, 0, n, count);
+}
+
+void limit_i16_block_scalar(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out,
+                            uint32_t n, uint32_t *count) {
+    limit_i16_step(x, llim, ulim, out, 0, n, count);
+}
+
+void limit_u16_block_scalar(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out,
+                            uint32_t n, uint32_t *count) {
+    limit_u16_step(x, llim, ulim, out, 0, n, count);
+}
+
+void limit_f32_block_scalar(const float *x, float llim, float ulim, float *out, uint32_t n,
+                            uint32_t *count) {
+    limit_f32_step(x, llim, ulim, out, 0, n, count);
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+Integer limits are min then max, which is exactly the pair of branches.  The
+float limits use ordered compares and blends instead of MINPS/MAXPS so a NaN
+input stays NaN like in limit_f32.  The counts are popcounts of the compare
+masks, MOVEMASK gives two bits per 16-bit lane on AVX2.  AVX2 has no unsigned
+16-bit compare, v > u is min(v, u) != v there.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+void limit_q31_block_avx2(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n,
+                          uint32_t *count) {
+    const __m256i vl = _mm256_set1_epi32(llim);
+    const __m256i vu = _mm256_set1_epi32(ulim);
+    uint32_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i mu = _mm256_cmpgt_epi32(v, vu);
+        v = _mm256_min_epi32(v, vu);
+        __m256i ml = _mm256_cmpgt_epi32(vl, v);
+        _mm256_storeu_si256((__m256i *)&out[i], _mm256_max_epi32(v, vl));
+        count[0] += (uint32_t)__builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mu)));
+        count[1] += (uint32_t)__builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(ml)));
+    }
+    limit_q31_step(x, llim, ulim, out, i, n, count);
+}
+
+RT_DSP_TARGET_AVX2
+void limit_i16_block_avx2(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out,
+                          uint32_t n, uint32_t *count) {
+    const __m256i vl = _mm256_set1_epi16(llim);
+    const __m256i vu = _mm256_set1_epi16(ulim);
+    uint32_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i mu = _mm256_cmpgt_epi16(v, vu);
+        v = _mm256_min_epi16(v, vu);
+        __m256i ml = _mm256_cmpgt_epi16(vl, v);
+        _mm256_storeu_si256((__m256i *)&out[i], _mm256_max_epi16(v, vl));
+        count[0] += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(mu)) / 2U;
+        count[1] += (uint32_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(ml)) / 2U;
+    }
+    limit_i16_step(x, llim, ulim, out, i, n, count);
+}
+
+RT_DSP_TARGET_AVX2
+void limit_u16_block_avx2(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out,
+                          uint32_t n, uint32_t *count) {
+    const __m256i vl = _mm256_set1_epi16((int16_t)llim);
+    const __m256i vu = _mm256_set1_epi16((int16_t)ulim);
+    uint32_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i t = _mm256_min_epu16(v, vu);
+        __m256i r = _mm256_max_epu16(t, vl);
+        _mm256_storeu_si256((__m256i *)&out[i], r);
+        // The masks are set where nothing was limited.
+        uint32_t ku = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(t, v));
+        uint32_t kl = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(r, t));
+        count[0] += 16U - (uint32_t)__builtin_popcount(ku) / 2U;
+        count[1] += 16U - (uint32_t)__builtin_popcount(kl) / 2U;
+    }
+    limit_u16_step(x, llim, ulim, out, i, n, count);
+}
+
+RT_DSP_TARGET_AVX2
+void limit_f32_block_avx2(const float *x, float llim, float ulim, float *out, uint32_t n,
+                          uint32_t *count) {
+    const __m256 vl = _mm256_set1_ps(llim);
+    const __m256 vu = _mm256_set1_ps(ulim);
+    uint32_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(&x[i]);
+        __m256 mu = _mm256_cmp_ps(v, vu, _CMP_GT_OQ);
+        v = _mm256_blendv_ps(v, vu, mu);
+        __m256 ml = _mm256_cmp_ps(v, vl, _CMP_LT_OQ);
+        _mm256_storeu_ps(&out[i], _mm256_blendv_ps(v, vl, ml));
+        count[0] += (uint32_t)__builtin_popcount(_mm256_movemask_ps(mu));
+        count[1] += (uint32_t)__builtin_popcount(_mm256_movemask_ps(ml));
+    }
+    limit_f32_step(x, llim, ulim, out, i, n, count);
+}
+
+RT_DSP_TARGET_AVX512
+void limit_q31_block_avx512(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n,
+                            uint32_t *count) {
+    const __m512i vl = _mm512_set1_epi32(llim);
+    const __m512i vu = _mm512_set1_epi32(ulim);
+    uint32_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        __mmask16 mu = _mm512_cmpgt_epi32_mask(v, vu);
+        v = _mm512_min_epi32(v, vu);
+        __mmask16 ml = _mm512_cmpgt_epi32_mask(vl, v);
+        _mm512_storeu_si512((void *)&out[i], _mm512_max_epi32(v, vl));
+        count[0] += (uint32_t)__builtin_popcount(mu);
+        count[1] += (uint32_t)__builtin_popcount(ml);
+    }
+    limit_q31_step(x, llim, ulim, out, i, n, count);
+}
+
+RT_DSP_TARGET_AVX512
+void limit_i16_block_avx512(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out,
+                            uint32_t n, uint32_t *count) {
+    const __m512i vl = _mm512_set1_epi16(llim);
+    const __m512i vu = _mm512_set1_epi16(ulim);
+    uint32_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        __mmask32 mu = _mm512_cmpgt_epi16_mask(v, vu);
+        v = _mm512_min_epi16(v, vu);
+        __mmask32 ml = _mm512_cmpgt_epi16_mask(vl, v);
+        _mm512_storeu_si512((void *)&out[i], _mm512_max_epi16(v, vl));
+        count[0] += (uint32_t)__builtin_popcount(mu);
+        count[1] += (uint32_t)__builtin_popcount(ml);
+    }
+    limit_i16_step(x, llim, ulim, out, i, n, count);
+}
+
+RT_DSP_TARGET_AVX512
+void limit_u16_block_avx512(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out,
+                            uint32_t n, uint32_t *count) {
+    const __m512i vl = _mm512_set1_epi16((int16_t)llim);
+    const __m512i vu = _mm512_set1_epi16((int16_t)ulim);
+    uint32_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        __mmask32 mu = _mm512_cmpgt_epu16_mask(v, vu);
+        v = _mm512_min_epu16(v, vu);
+        __mmask32 ml = _mm512_cmpgt_epu16_mask(vl, v);
+        _mm512_storeu_si512((void *)&out[i], _mm512_max_epu16(v, vl));
+        count[0] += (uint32_t)__builtin_popcount(mu);
+        count[1] += (uint32_t)__builtin_popcount(ml);
+    }
+    limit_u16_step(x, llim, ulim, out, i, n, count);
+}
+
+RT_DSP_TARGET_AVX512
+void limit_f32_block_avx512(const float *x, float llim, float ulim, float *out, uint32_t n,
+                            uint32_t *count) {
+    const __m512 vl = _mm512_set1_ps(llim);
+    const __m512 vu = _mm512_set1_ps(ulim);
+    uint32_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_loadu_ps(&x[i]);
+        __mmask16 mu = _mm512_cmp_ps_mask(v, vu, _CMP_GT_OQ);
+        v = _mm512_mask_blend_ps(mu, v, vu);
+        __mmask16 ml = _mm512_cmp_ps_mask(v, vl, _CMP_LT_OQ);
+        _mm512_storeu_ps(&out[i], _mm512_mask_blend_ps(ml, v, vl));
+        count[0] += (uint32_t)__builtin_popcount(mu);
+        count[1] += (uint32_t)__builtin_popcount(ml);
+    }
+    limit_f32_step(x, llim, ulim, out, i, n, count);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+A true compare lane is all ones, so subtracting the mask counts it.  The lane
+counts are summed once at the end, each lane sees at most n / 4 hits.  The
+16-bit kernels widen the counts every vector so they can not wrap.
+-----------------------------------------------------------------------------*/
+void limit_q31_block_neon(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n,
+                          uint32_t *count) {
+    const int32x4_t vl = vdupq_n_s32(llim);
+    const int32x4_t vu = vdupq_n_s32(ulim);
+    uint32x4_t cu = vdupq_n_u32(0), cl = vdupq_n_u32(0);
+    uint32_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t v = vld1q_s32(&x[i]);
+        cu = vsubq_u32(cu, vcgtq_s32(v, vu));
+        v = vminq_s32(v, vu);
+        cl = vsubq_u32(cl, vcltq_s32(v, vl));
+        vst1q_s32(&out[i], vmaxq_s32(v, vl));
+    }
+    count[0] += vaddvq_u32(cu);
+    count[1] += vaddvq_u32(cl);
+    limit_q31_step(x, llim, ulim, out, i, n, count);
+}
+
+void limit_i16_block_neon(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out,
+                          uint32_t n, uint32_t *count) {
+    const int16x8_t vl = vdupq_n_s16(llim);
+    const int16x8_t vu = vdupq_n_s16(ulim);
+    uint32x4_t cu = vdupq_n_u32(0), cl = vdupq_n_u32(0);
+    uint32_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t v = vld1q_s16(&x[i]);
+        cu = vpadalq_u16(cu, vshrq_n_u16(vcgtq_s16(v, vu), 15));
+        v = vminq_s16(v, vu);
+        cl = vpadalq_u16(cl, vshrq_n_u16(vcltq_s16(v, vl), 15));
+        vst1q_s16(&out[i], vmaxq_s16(v, vl));
+    }
+    count[0] += vaddvq_u32(cu);
+    count[1] += vaddvq_u32(cl);
+    limit_i16_step(x, llim, ulim, out, i, n, count);
+}
+
+void limit_u16_block_neon(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out,
+                          uint32_t n, uint32_t *count) {
+    const uint16x8_t vl = vdupq_n_u16(llim);
+    const uint16x8_t vu = vdupq_n_u16(ulim);
+    uint32x4_t cu = vdupq_n_u32(0), cl = vdupq_n_u32(0);
+    uint32_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vld1q_u16(&x[i]);
+        cu = vpadalq_u16(cu, vshrq_n_u16(vcgtq_u16(v, vu), 15));
+        v = vminq_u16(v, vu);
+        cl = vpadalq_u16(cl, vshrq_n_u16(vcltq_u16(v, vl), 15));
+        vst1q_u16(&out[i], vmaxq_u16(v, vl));
+    }
+    count[0] += vaddvq_u32(cu);
+    count[1] += vaddvq_u32(cl);
+    limit_u16_step(x, llim, ulim, out, i, n, count);
+}
+
+void limit_f32_block_neon(const float *x, float llim, float ulim, float *out, uint32_t n,
+                          uint32_t *count) {
+    const float32x4_t vl = vdupq_n_f32(llim);
+    const float32x4_t vu = vdupq_n_f32(ulim);
+    uint32x4_t cu = vdupq_n_u32(0), cl = vdupq_n_u32(0);
+    uint32_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vld1q_f32(&x[i]);
+        uint32x4_t mu = vcgtq_f32(v, vu);
+        v = vbslq_f32(mu, vu, v);
+        uint32x4_t ml = vcltq_f32(v, vl);
+        vst1q_f32(&out[i], vbslq_f32(ml, vl, v));
+        cu = vsubq_u32(cu, mu);
+        cl = vsubq_u32(cl, ml);
+    }
+    count[0] += vaddvq_u32(cu);
+    count[1] += vaddvq_u32(cl);
+    limit_f32_step(x, llim, ulim, out, i, n, count);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void limit_q31_block(const q31_t *x, q31_t llim, q31_t ulim, q31_t *out, uint32_t n,
+                     uint32_t *nUpper, uint32_t *nLower) {
+    uint32_t count[2] = { 0, 0 };
+
+    dsp_kernels.limit_q31_block(x, llim, ulim, out, n, count);
+    if (nUpper != NULL) {
+        *nUpper = count[0];
+    }
+    if (nLower != NULL) {
+        *nLower = count[1];
+    }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+A lower limit of INT32_MIN never applies, so this is limit_q31_block.
+-----------------------------------------------------------------------------*/
+void upper_limit_q31_block(const q31_t *x, q31_t ulim, q31_t *out, uint32_t n, uint32_t *nUpper) {
+    limit_q31_block(x, INT32_MIN, ulim, out, n, nUpper, NULL);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+An upper limit of INT32_MAX never applies, so this is limit_q31_block.
+-----------------------------------------------------------------------------*/
+void lower_limit_q31_block(const q31_t *x, q31_t llim, q31_t *out, uint32_t n, uint32_t *nLower) {
+    limit_q31_block(x, llim, INT32_MAX, out, n, NULL, nLower);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void limit_i16_block(const int16_t *x, int16_t llim, int16_t ulim, int16_t *out, uint32_t n,
+                     uint32_t *nUpper, uint32_t *nLower) {
+    uint32_t count[2] = { 0, 0 };
+
+    dsp_kernels.limit_i16_block(x, llim, ulim, out, n, count);
+    if (nUpper != NULL) {
+        *nUpper = count[0];
+    }
+    if (nLower != NULL) {
+        *nLower = count[1];
+    }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void limit_u16_block(const uint16_t *x, uint16_t llim, uint16_t ulim, uint16_t *out, uint32_t n,
+                     uint32_t *nUpper, uint32_t *nLower) {
+    uint32_t count[2] = { 0, 0 };
+
+    dsp_kernels.limit_u16_block(x, llim, ulim, out, n, count);
+    if (nUpper != NULL) {
+        *nUpper = count[0];
+    }
+    if (nLower != NULL) {
+        *nLower = count[1];
+    }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void limit_f32_block(const float *x, float llim, float ulim, float *out, uint32_t n,
+                     uint32_t *nUpper, uint32_t *nLower) {
+    uint32_t count[2] = { 0, 0 };
+
+    dsp_kernels.limit_f32_block(x, llim, ulim, out, n, count);
+    if (nUpper != NULL) {
+        *nUpper = count[0];
+    }
+    if (nLower != NULL) {
+        *nLower = count[1];
+    }
+}
@@ -0,0 +1,577 @@
+/**
+ * \file arm_rt_dsp_ramp.c
+ * \brief Block and bank versions of the ramp functions and the S-curve ramp.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernels.  out[k] = y + (k + 1) * step for k < m and t after that.  The
+progression is done in unsigned arithmetic, the callers only ask for values
+between y and t so it never actually wraps.
+-----------------------------------------------------------------------------*/
+static inline void ramp_fill_step_q31(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out,
+                                      uint32_t k, uint32_t n)
+{
+    for (; k < m; k++) {
+        out[k] = (q31_t)((uint32_t)y + (k + 1U) * (uint32_t)step);
+    }
+    for (; k < n; k++) {
+        out[k] = t;
+    }
+}
+
+static inline void ramp_fill_step_i16(int16_t y, int16_t step, uint32_t m, int16_t t,
+                                      int16_t *out, uint32_t k, uint32_t n)
+{
+    for (; k < m; k++) {
+        out[k] = (int16_t)(uint16_t)((uint32_t)y + (k + 1U) * (uint32_t)step);
+    }
+    for (; k < n; k++) {
+        out[k] = t;
+    }
+}
+
+void ramp_fill_q31_scalar(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n) {
+    ramp_fill_step_q31(y, step, m, t, out, 0, n);
+}
+
+void ramp_fill_i16_scalar(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out,
+                          uint32_t n) {
+    ramp_fill_step_i16(y, step, m, t, out, 0, n);
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+The progression starts as y + step * (1, 2, ...) and every vector adds
+step times the lane count, wrapping like the scalar unsigned arithmetic.  The
+tails of both parts run on the scalar step.
+-----------------------------------------------------------------------------*/
+static const int16_t ramp_fill_seq_i16[32] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+    17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32
+};
+
+RT_DSP_TARGET_AVX2
+void ramp_fill_q31_avx2(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n) {
+    const __m256i vs = _mm256_set1_epi32(step);
+    const __m256i vd = _mm256_slli_epi32(vs, 3);
+    const __m256i vt = _mm256_set1_epi32(t);
+    __m256i v = _mm256_add_epi32(_mm256_set1_epi32(y),
+                                 _mm256_mullo_epi32(vs, _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8)));
+    uint32_t k = 0;
+
+    for (; k + 8 <= m; k += 8) {
+        _mm256_storeu_si256((__m256i *)&out[k], v);
+        v = _mm256_add_epi32(v, vd);
+    }
+    ramp_fill_step_q31(y, step, m, t, out, k, m);
+    for (k = m; k + 8 <= n; k += 8) {
+        _mm256_storeu_si256((__m256i *)&out[k], vt);
+    }
+    ramp_fill_step_q31(y, step, m, t, out, k, n);
+}
+
+RT_DSP_TARGET_AVX2
+void ramp_fill_i16_avx2(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out,
+                        uint32_t n) {
+    const __m256i vs = _mm256_set1_epi16(step);
+    const __m256i vd = _mm256_slli_epi16(vs, 4);
+    const __m256i vt = _mm256_set1_epi16(t);
+    const __m256i seq = _mm256_loadu_si256((const __m256i *)ramp_fill_seq_i16);
+    __m256i v = _mm256_add_epi16(_mm256_set1_epi16(y), _mm256_mullo_epi16(vs, seq));
+    uint32_t k = 0;
+
+    for (; k + 16 <= m; k += 16) {
+        _mm256_storeu_si256((__m256i *)&out[k], v);
+        v = _mm256_add_epi16(v, vd);
+    }
+    ramp_fill_step_i16(y, step, m, t, out, k, m);
+    for (k = m; k + 16 <= n; k += 16) {
+        _mm256_storeu_si256((__m256i *)&out[k], vt);
+    }
+    ramp_fill_step_i16(y, step, m, t, out, k, n);
+}
+
+RT_DSP_TARGET_AVX512
+void ramp_fill_q31_avx512(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n) {
+    const __m512i vs = _mm512_set1_epi32(step);
+    const __m512i vd = _mm512_slli_epi32(vs, 4);
+    const __m512i vt = _mm512_set1_epi32(t);
+    __m512i v = _mm512_add_epi32(_mm512_set1_epi32(y),
+                                 _mm512_mullo_epi32(vs, _mm512_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8,
+                                                                          9, 10, 11, 12, 13, 14,
+                                                                          15, 16)));
+    uint32_t k = 0;
+
+    for (; k + 16 <= m; k += 16) {
+        _mm512_storeu_si512((void *)&out[k], v);
+        v = _mm512_add_epi32(v, vd);
+    }
+    ramp_fill_step_q31(y, step, m, t, out, k, m);
+    for (k = m; k + 16 <= n; k += 16) {
+        _mm512_storeu_si512((void *)&out[k], vt);
+    }
+    ramp_fill_step_q31(y, step, m, t, out, k, n);
+}
+
+RT_DSP_TARGET_AVX512
+void ramp_fill_i16_avx512(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out,
+                          uint32_t n) {
+    const __m512i vs = _mm512_set1_epi16(step);
+    const __m512i vd = _mm512_slli_epi16(vs, 5);
+    const __m512i vt = _mm512_set1_epi16(t);
+    const __m512i seq = _mm512_loadu_si512((const void *)ramp_fill_seq_i16);
+    __m512i v = _mm512_add_epi16(_mm512_set1_epi16(y), _mm512_mullo_epi16(vs, seq));
+    uint32_t k = 0;
+
+    for (; k + 32 <= m; k += 32) {
+        _mm512_storeu_si512((void *)&out[k], v);
+        v = _mm512_add_epi16(v, vd);
+    }
+    ramp_fill_step_i16(y, step, m, t, out, k, m);
+    for (k = m; k + 32 <= n; k += 32) {
+        _mm512_storeu_si512((void *)&out[k], vt);
+    }
+    ramp_fill_step_i16(y, step, m, t, out, k, n);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+-----------------------------------------------------------------------------*/
+void ramp_fill_q31_neon(q31_t y, q31_t step, uint32_t m, q31_t t, q31_t *out, uint32_t n) {
+    static const int32_t seq[4] = { 1, 2, 3, 4 };
+    const int32x4_t vd = vdupq_n_s32((int32_t)((uint32_t)step * 4U));
+    const int32x4_t vt = vdupq_n_s32(t);
+    int32x4_t v = vmlaq_n_s32(vdupq_n_s32(y), vld1q_s32(seq), step);
+    uint32_t k = 0;
+
+    for (; k + 4 <= m; k += 4) {
+        vst1q_s32(&out[k], v);
+        v = vaddq_s32(v, vd);
+    }
+    ramp_fill_step_q31(y, step, m, t, out, k, m);
+    for (k = m; k + 4 <= n; k += 4) {
+        vst1q_s32(&out[k], vt);
+    }
+    ramp_fill_step_q31(y, step, m, t, out, k, n);
+}
+
+void ramp_fill_i16_neon(int16_t y, int16_t step, uint32_t m, int16_t t, int16_t *out,
+                        uint32_t n) {
+    static const int16_t seq[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const int16x8_t vd = vdupq_n_s16((int16_t)(uint16_t)((uint32_t)step * 8U));
+    const int16x8_t vt = vdupq_n_s16(t);
+    int16x8_t v = vmlaq_n_s16(vdupq_n_s16(y), vld1q_s16(seq), step);
+    uint32_t k = 0;
+
+    for (; k + 8 <= m; k += 8) {
+        vst1q_s16(&out[k], v);
+        v = vaddq_s16(v, vd);
+    }
+    ramp_fill_step_i16(y, step, m, t, out, k, m);
+    for (k = m; k + 8 <= n; k += 8) {
+        vst1q_s16(&out[k], vt);
+    }
+    ramp_fill_step_i16(y, step, m, t, out, k, n);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+With inc > 0 the ramp moves by exactly inc until it is within inc of x, so the
+output after k samples is y + k * inc while that is short of x, and x from
+sample ceil(|x - y| / inc) on.  __QADD never saturates on the way, the ramp only
+goes past x where the result is replaced by x anyway.  With inc = 0 the output
+stays at y.
+-----------------------------------------------------------------------------*/
+void ramp_q31_block(q31_t x, ramp_q31_t *r, q31_t *out, uint32_t n)
+{
+  uint32_t d, m;
+
+  if (n == 0)
+  {
+    return;
+  }
+  if (r->inc < 0)
+  {
+    for (uint32_t k = 0; k < n; k++)
+    {
+      out[k] = ramp_q31(x, r);
+    }
+    return;
+  }
+
+  d = (x > r->y) ? (uint32_t)x - (uint32_t)r->y : (uint32_t)r->y - (uint32_t)x;
+  if (d == 0)
+  {
+    m = 0;
+  }
+  else if (r->inc == 0)
+  {
+    m = n;
+  }
+  else
+  {
+    m = (d - 1U) / (uint32_t)r->inc;
+    m = (m < n) ? m : n;
+  }
+
+  dsp_kernels.ramp_fill_q31(r->y, (x > r->y) ? r->inc : -r->inc, m, x, out, n);
+  r->y = out[n - 1];
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Common to the two 16-bit limited ramps, which only differ in name.  With the
+output inside the limits the ramp heads for the target clamped to the limits,
+and once it gets there it stays.  The kernel is picked by the dispatch table,
+see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+static void ramp_limit_block_i16(int16_t x, int16_t llim, int16_t ulim, int16_t inc, int16_t *y,
+                                 int16_t *out, uint32_t n)
+{
+  int16_t t = (x < llim) ? llim : (x > ulim) ? ulim : x;
+  uint32_t d = (uint32_t)((t > *y) ? t - *y : *y - t);
+  uint32_t m;
+
+  if (d == 0)
+  {
+    m = 0;
+  }
+  else if (inc == 0)
+  {
+    m = n;
+  }
+  else
+  {
+    m = (d - 1U) / (uint32_t)inc;
+    m = (m < n) ? m : n;
+  }
+
+  dsp_kernels.ramp_fill_i16(*y, (t > *y) ? inc : (int16_t)-inc, m, t, out, n);
+  *y = out[n - 1];
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void ramp_limit_q15_block(q15_t x, ramp_limit_q15_t *r, q15_t *out, uint32_t n)
+{
+  if (n == 0)
+  {
+    return;
+  }
+  if (r->inc < 0 || r->llim > r->ulim || r->y < r->llim || r->y > r->ulim)
+  {
+    for (uint32_t k = 0; k < n; k++)
+    {
+      out[k] = ramp_limit_q15(x, r);
+    }
+    return;
+  }
+  ramp_limit_block_i16(x, r->llim, r->ulim, r->inc, &r->y, out, n);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void ramp_limit_i16_block(int16_t x, ramp_limit_i16_t *r, int16_t *out, uint32_t n)
+{
+  if (n == 0)
+  {
+    return;
+  }
+  if (r->inc < 0 || r->llim > r->ulim || r->y < r->llim || r->y > r->ulim)
+  {
+    for (uint32_t k = 0; k < n; k++)
+    {
+      out[k] = ramp_limit_i16(x, r);
+    }
+    return;
+  }
+  ramp_limit_block_i16(x, r->llim, r->ulim, r->inc, &r->y, out, n);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The distance covered while stopping from rate u >= 0 when the rate drops by a
+every sample: u + (u - a) + (u - 2a) + ... over the positive terms, which is
+(m + 1) * u - a * m * (m + 1) / 2 with m = u / a.
+-----------------------------------------------------------------------------*/
+static int64_t ramp_scurve_stop(int64_t u, int64_t a)
+{
+  int64_t m = u / a;
+
+  return (m + 1) * u - a * m * (m + 1) / 2;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The largest rate u with ramp_scurve_stop(u) <= D.  With m whole steps of a
+that is u = (D + a * m * (m + 1) / 2) / (m + 1), kept below (m + 1) * a so it
+really does stop in m + 1 samples, where m is the largest count with
+a * m * (m + 1) / 2 <= D.  The square root gives m to within one.
+-----------------------------------------------------------------------------*/
+static int64_t ramp_scurve_vstop(int64_t D, int64_t a)
+{
+  int64_t m = ((int64_t)sqrt_u64((uint64_t)(8 * (D / a) + 1)) - 1) / 2;
+  int64_t u;
+
+  while (a * (m + 1) * (m + 2) / 2 <= D)
+  {
+    m++;
+  }
+  while (m > 0 && a * m * (m + 1) / 2 > D)
+  {
+    m--;
+  }
+  u = (D + a * m * (m + 1) / 2) / (m + 1);
+  return (u < (m + 1) * a) ? u : (m + 1) * a - 1;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void ramp_scurve_init_q31(q31_t y0, ramp_scurve_q31_t *r)
+{
+  r->y = y0;
+  r->v = 0;
+  r->dmax = ramp_scurve_stop(r->vmax, r->amax);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Works with the distance D = |x - y| and the rate u towards x.  The stopping
+rate only needs the square root once D is inside the stopping distance from
+vmax, before that the ramp just heads for vmax.  Starting from rest the new
+rate u' always satisfies stop(u') <= D, so stop(u' - a) <= D - u' and the next
+sample can slow down enough as well.  That is what keeps it from overshooting.
+-----------------------------------------------------------------------------*/
+q31_t ramp_scurve_q31(q31_t x, ramp_scurve_q31_t *r)
+{
+  int64_t e = (int64_t)x - r->y;
+  int64_t D = (e < 0) ? -e : e;
+  int64_t u = (e < 0) ? -(int64_t)r->v : r->v;
+  int64_t a = r->amax;
+  int64_t ud;
+
+  ud = (D >= r->dmax) ? r->vmax : ramp_scurve_vstop(D, a);
+  if (ud > r->vmax)
+  {
+    ud = r->vmax;
+  }
+
+  // The acceleration limit.
+  if (ud > u + a)
+  {
+    ud = u + a;
+  }
+  else if (ud < u - a)
+  {
+    ud = u - a;
+  }
+
+  r->v = (q31_t)((e < 0) ? -ud : ud);
+  r->y = (q31_t)ssat_i64((int64_t)r->y + r->v, 32);
+  return r->y;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void ramp_scurve_q31_block(q31_t x, ramp_scurve_q31_t *r, q31_t *out, uint32_t n)
+{
+  for (uint32_t k = 0; k < n; k++)
+  {
+    out[k] = ramp_scurve_q31(x, r);
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Works out how long channel i has to go, see ramp_limit_q15_block for the
+closed form, and sets its bit in the active bitmap to match.  A channel that
+starts outside its limits is clamped back inside by its first step, after that
+the closed form holds.  A zero increment channel only has that first step to
+take, it leaves the active set after it.  Limits out of order or a negative
+increment don't follow it at all, those channels are stepped for ever.
+-----------------------------------------------------------------------------*/
+static void ramp_limit_bank_arm(ramp_limit_bank_q15_t *S, uint32_t i)
+{
+  const uint64_t bit = (uint64_t)1 << (i % 64);
+  const uint64_t was = S->active[i / 64] & bit;
+  q15_t llim = S->llim[i], ulim = S->ulim[i], inc = S->inc[i];
+  q15_t y = S->y[i];
+  q15_t t = (S->x[i] < llim) ? llim : (S->x[i] > ulim) ? ulim : S->x[i];
+  uint32_t first = 0, d, n;
+
+  if (inc < 0 || llim > ulim)
+  {
+    n = RAMP_BANK_NEVER;
+  }
+  else
+  {
+    if (y < llim || y > ulim)
+    {
+      ramp_limit_q15_t r = { llim, ulim, inc, y };
+      y = ramp_limit_q15(S->x[i], &r);
+      first = 1;
+    }
+    d = (uint32_t)((t > y) ? t - y : y - t);
+    if (d == 0)
+    {
+      n = first;
+    }
+    else if (inc == 0)
+    {
+      // Stuck short of the target, it only needs stepping to get inside the limits.
+      n = first;
+    }
+    else
+    {
+      n = first + (d + (uint32_t)inc - 1U) / (uint32_t)inc;
+    }
+  }
+
+  S->remaining[i] = n;
+  if (n == 0)
+  {
+    S->active[i / 64] &= ~bit;
+    S->nActive -= (was != 0);
+  }
+  else
+  {
+    S->active[i / 64] |= bit;
+    S->nActive += (was == 0);
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void ramp_limit_bank_init_q15(ramp_limit_bank_q15_t *S, const q15_t *y0)
+{
+  memset(S->active, 0, ((S->n + 63U) / 64U) * sizeof(uint64_t));
+  S->nActive = 0;
+  for (uint32_t i = 0; i < S->n; i++)
+  {
+    ramp_limit_q15_t r = { S->llim[i], S->ulim[i], S->inc[i], 0 };
+    ramp_limit_init_q15((y0 != NULL) ? y0[i] : 0, &r);
+    S->y[i] = S->x[i] = r.y;
+    S->remaining[i] = 0;
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void ramp_limit_bank_target_q15(ramp_limit_bank_q15_t *S, uint32_t i, q15_t x)
+{
+  S->x[i] = x;
+  ramp_limit_bank_arm(S, i);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The compare runs over the whole bank, the re-arm only where a target moved.
+-----------------------------------------------------------------------------*/
+void ramp_limit_bank_targets_q15(ramp_limit_bank_q15_t *S, const q15_t *x)
+{
+  for (uint32_t i = 0; i < S->n; i++)
+  {
+    if (x[i] != S->x[i])
+    {
+      S->x[i] = x[i];
+      ramp_limit_bank_arm(S, i);
+    }
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Walks the set bits of the active bitmap with count trailing zeros, so the
+settled channels are never touched.
+-----------------------------------------------------------------------------*/
+uint32_t ramp_limit_bank_q15(ramp_limit_bank_q15_t *S)
+{
+  const uint32_t words = (S->n + 63U) / 64U;
+
+  for (uint32_t w = 0; w < words && S->nActive > 0; w++)
+  {
+    uint64_t bits = S->active[w];
+
+    while (bits != 0)
+    {
+      uint32_t i = w * 64U + (uint32_t)__builtin_ctzll(bits);
+      ramp_limit_q15_t r = { S->llim[i], S->ulim[i], S->inc[i], S->y[i] };
+
+      bits &= bits - 1U;
+      S->y[i] = ramp_limit_q15(S->x[i], &r);
+      if (S->remaining[i] != RAMP_BANK_NEVER && --S->remaining[i] == 0)
+      {
+        S->active[w] &= ~((uint64_t)1 << (i % 64U));
+        S->nActive--;
+      }
+    }
+  }
+  return S->nActive;
+}
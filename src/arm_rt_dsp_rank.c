@@ -0,0 +1,214 @@
+/**
+ * \file arm_rt_dsp_rank.c
+ * \brief Sliding window median and min/max filters.
+*/
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+
+
+/*-----------------------------------------------------------------------------
+Heap helpers for the median filter.
+
+Notes:
+The low heap is pHeap[0, nlo) and the high heap pHeap[nlo, N).  Both are kept as
+max heaps on the key pState[slot] ^ mask, with mask 0 for the low heap and -1 for
+the high heap, so the high heap is a min heap on the samples.
+-----------------------------------------------------------------------------*/
+static inline q31_t median_key(const filter_median_instance_q31 *S, uint32_t base, uint32_t p,
+                               q31_t mask)
+{
+  return S->pState[S->pHeap[base + p]] ^ mask;
+}
+
+static inline void median_swap(filter_median_instance_q31 *S, uint32_t a, uint32_t b)
+{
+  uint8_t t = S->pHeap[a];
+  S->pHeap[a] = S->pHeap[b];
+  S->pHeap[b] = t;
+  S->pPos[S->pHeap[a]] = (uint8_t)a;
+  S->pPos[S->pHeap[b]] = (uint8_t)b;
+}
+
+// Moves the slot at local position p of one heap up or down to where it belongs.
+static void median_sift(filter_median_instance_q31 *S, uint32_t base, uint32_t size, q31_t mask,
+                        uint32_t p)
+{
+  while (p > 0)
+  {
+    uint32_t parent = (p - 1U) / 2U;
+    if (median_key(S, base, parent, mask) >= median_key(S, base, p, mask))
+    {
+      break;
+    }
+    median_swap(S, base + parent, base + p);
+    p = parent;
+  }
+
+  for (;;)
+  {
+    uint32_t c = 2U * p + 1U;
+    if (c >= size)
+    {
+      break;
+    }
+    if (c + 1U < size && median_key(S, base, c + 1U, mask) > median_key(S, base, c, mask))
+    {
+      c++;
+    }
+    if (median_key(S, base, p, mask) >= median_key(S, base, c, mask))
+    {
+      break;
+    }
+    median_swap(S, base + p, base + c);
+    p = c;
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+All samples are equal, so any order is a valid pair of heaps.
+-----------------------------------------------------------------------------*/
+void filter_median_init_q31(q31_t y0, filter_median_instance_q31 *param)
+{
+  for (uint32_t i = 0; i < param->N; i++)
+  {
+    param->pState[i] = y0;
+    param->pHeap[i] = (uint8_t)i;
+    param->pPos[i] = (uint8_t)i;
+  }
+  param->idx = 0;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The new sample replaces the oldest in its heap slot, so the heap sizes never
+change.  After sifting it inside its own heap it can only break the order
+between the two heaps by ending up on top, and one swap of the two tops puts
+that right.
+-----------------------------------------------------------------------------*/
+q31_t filter_median_q31(q31_t inx, filter_median_instance_q31 *param)
+{
+  const uint32_t N = param->N;
+  const uint32_t nlo = (N + 1U) / 2U;
+  const q31_t *x = param->pState;
+  uint32_t slot = param->idx;
+
+  param->pState[slot] = inx;
+  param->idx = (slot + 1U == N) ? 0 : (uint16_t)(slot + 1U);
+
+  if (N == 3)
+  {
+    return median3_q31(x[0], x[1], x[2]);
+  }
+  if (N == 5)
+  {
+    return median5_q31(x[0], x[1], x[2], x[3], x[4]);
+  }
+
+  uint32_t p = param->pPos[slot];
+  if (p < nlo)
+  {
+    median_sift(param, 0, nlo, 0, p);
+  }
+  else
+  {
+    median_sift(param, nlo, N - nlo, -1, p - nlo);
+  }
+
+  if (N == 1)
+  {
+    return inx;
+  }
+  if (x[param->pHeap[0]] > x[param->pHeap[nlo]])
+  {
+    median_swap(param, 0, nlo);
+    median_sift(param, 0, nlo, 0, 0);
+    median_sift(param, nlo, N - nlo, -1, 0);
+  }
+
+  if (N & 1U)
+  {
+    return x[param->pHeap[0]];
+  }
+  return (q31_t)(((int64_t)x[param->pHeap[0]] + x[param->pHeap[nlo]]) >> 1);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void filter_median_q31_block(filter_median_instance_q31 *param, const q31_t *in, q31_t *out,
+                             uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+  {
+    out[i] = filter_median_q31(in[i], param);
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The window starts as a single deque entry that arrived just before t = 0, so it
+expires after N samples like the samples it stands for.
+-----------------------------------------------------------------------------*/
+static void filter_minmax_init(q31_t y0, q31_t mask, filter_minmax_instance_q31 *param)
+{
+  param->mask = mask;
+  param->t = 0;
+  param->head = 0;
+  param->count = 1;
+  param->pVal[0] = y0 ^ mask;
+  param->pTime[0] = (uint32_t)-1;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void filter_max_init_q31(q31_t y0, filter_minmax_instance_q31 *param)
+{
+  filter_minmax_init(y0, 0, param);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void filter_min_init_q31(q31_t y0, filter_minmax_instance_q31 *param)
+{
+  filter_minmax_init(y0, -1, param);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void filter_minmax_q31_block(filter_minmax_instance_q31 *param, const q31_t *in, q31_t *out,
+                             uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+  {
+    out[i] = filter_minmax_q31(in[i], param);
+  }
+}
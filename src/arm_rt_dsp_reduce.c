@@ -0,0 +1,830 @@
+/**
+ * \file arm_rt_dsp_reduce.c
+ * \brief Array reductions: min and max with their indexes, sums and sums of squares.
+*/
+#include <stdint.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/**
+ * Number of vectors the 16-bit kernels run before the per lane counters and sums are
+ * widened.  A lane gains at most 2^16 per vector, so 16384 vectors stay below 2^31.
+ */
+#define REDUCE_CHUNK 16384U
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernels.  These are the reference for every other kernel.
+
+Notes:
+The min and max start at the far end of the range with index 0.  Only a
+smaller (larger) value moves them, so ties keep the first index, and an array
+that is all at the far end correctly reports index 0.  The vector kernels keep
+one candidate per lane and merge them with reduce_merge, where a tie goes to
+the smaller index, then finish the tail with the scalar step.
+-----------------------------------------------------------------------------*/
+static inline void reduce_init(minmax_result_t *r, int32_t lo, int32_t hi)
+{
+    r->min = hi;
+    r->max = lo;
+    r->argmin = 0;
+    r->argmax = 0;
+}
+
+static inline void reduce_merge(minmax_result_t *r, int32_t vmin, uint32_t kmin,
+                                int32_t vmax, uint32_t kmax)
+{
+    if (vmin < r->min || (vmin == r->min && kmin < r->argmin)) {
+        r->min = vmin;
+        r->argmin = kmin;
+    }
+    if (vmax > r->max || (vmax == r->max && kmax < r->argmax)) {
+        r->max = vmax;
+        r->argmax = kmax;
+    }
+}
+
+static inline void minmax_q31_step(const q31_t *x, uint32_t i, uint32_t n, minmax_result_t *r)
+{
+    for (; i < n; i++) {
+        if (x[i] < r->min) {
+            r->min = x[i];
+            r->argmin = i;
+        }
+        if (x[i] > r->max) {
+            r->max = x[i];
+            r->argmax = i;
+        }
+    }
+}
+
+static inline void minmax_i16_step(const int16_t *x, uint32_t i, uint32_t n, minmax_result_t *r)
+{
+    for (; i < n; i++) {
+        if (x[i] < r->min) {
+            r->min = x[i];
+            r->argmin = i;
+        }
+        if (x[i] > r->max) {
+            r->max = x[i];
+            r->argmax = i;
+        }
+    }
+}
+
+static inline void minmax_u16_step(const uint16_t *x, uint32_t i, uint32_t n, minmax_result_t *r)
+{
+    for (; i < n; i++) {
+        if (x[i] < r->min) {
+            r->min = x[i];
+            r->argmin = i;
+        }
+        if (x[i] > r->max) {
+            r->max = x[i];
+            r->argmax = i;
+        }
+    }
+}
+
+// Merges the lanes of a 16-bit kernel.  The values are biased by 0x8000 for
+// uint16_t so the signed compares order them, the index of lane l is
+// i + j[l] * L + l where j counts the vectors of the chunk.
+static inline void reduce_merge16(minmax_result_t *r, const int16_t *bmin, const uint16_t *jmin,
+                                  const int16_t *bmax, const uint16_t *jmax, uint32_t L,
+                                  uint32_t i, int16_t bias)
+{
+    for (uint32_t l = 0; l < L; l++) {
+        int32_t vmin = bias ? (int32_t)(uint16_t)(bmin[l] ^ bias) : bmin[l];
+        int32_t vmax = bias ? (int32_t)(uint16_t)(bmax[l] ^ bias) : bmax[l];
+        reduce_merge(r, vmin, i + jmin[l] * L + l, vmax, i + jmax[l] * L + l);
+    }
+}
+
+void minmax_q31_block_scalar(const q31_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, INT32_MIN, INT32_MAX);
+    minmax_q31_step(x, 0, n, r);
+}
+
+void minmax_i16_block_scalar(const int16_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, INT16_MIN, INT16_MAX);
+    minmax_i16_step(x, 0, n, r);
+}
+
+void minmax_u16_block_scalar(const uint16_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, 0, UINT16_MAX);
+    minmax_u16_step(x, 0, n, r);
+}
+
+int64_t sum64_q31_block_scalar(const q31_t *x, uint32_t n) {
+    int64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += x[i];
+    }
+    return acc;
+}
+
+int64_t sum64_i16_block_scalar(const int16_t *x, uint32_t n) {
+    int64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += x[i];
+    }
+    return acc;
+}
+
+int64_t sum64_u16_block_scalar(const uint16_t *x, uint32_t n) {
+    int64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += x[i];
+    }
+    return acc;
+}
+
+uint64_t sumsq_q31_block_scalar(const q31_t *x, uint32_t n) {
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (uint64_t)(((int64_t)x[i] * x[i]) >> 31);
+    }
+    return acc;
+}
+
+uint64_t sumsq_i16_block_scalar(const int16_t *x, uint32_t n) {
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (uint32_t)((int32_t)x[i] * x[i]);
+    }
+    return acc;
+}
+
+uint64_t sumsq_u16_block_scalar(const uint16_t *x, uint32_t n) {
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (uint32_t)x[i] * x[i];
+    }
+    return acc;
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+The min and max kernels keep a best value and the index it was seen at per
+lane, the index is only replaced on a strict compare so each lane keeps its
+first hit.  The 16-bit kernels count vectors in 16-bit lanes and merge every
+65536 vectors.  uint16_t runs through the signed kernels with the sign bit
+flipped, and its sums add back 0x8000 per element.  PMADDWD with ones sums
+16-bit pairs, with itself it gives pairs of squares of at most 2^31, which
+are read as unsigned.  The Q31 squares are non-negative, so a logical shift
+gives the >> 31.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+static inline uint64_t reduce_hsum_epi64_avx2(__m256i acc) {
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    return (uint64_t)_mm_cvtsi128_si64(s) + (uint64_t)_mm_extract_epi64(s, 1);
+}
+
+// Adds the two unsigned 32-bit halves of each 64-bit lane of p to acc.
+RT_DSP_TARGET_AVX2
+static inline __m256i reduce_add_u32_avx2(__m256i acc, __m256i p) {
+    const __m256i lo = _mm256_set1_epi64x(0xFFFFFFFF);
+    acc = _mm256_add_epi64(acc, _mm256_and_si256(p, lo));
+    return _mm256_add_epi64(acc, _mm256_srli_epi64(p, 32));
+}
+
+RT_DSP_TARGET_AVX512
+static inline __m512i reduce_add_u32_avx512(__m512i acc, __m512i p) {
+    const __m512i lo = _mm512_set1_epi64(0xFFFFFFFF);
+    acc = _mm512_add_epi64(acc, _mm512_and_si512(p, lo));
+    return _mm512_add_epi64(acc, _mm512_srli_epi64(p, 32));
+}
+
+RT_DSP_TARGET_AVX2
+static uint32_t minmax_16_avx2(const int16_t *x, uint32_t n, minmax_result_t *r, int16_t bias) {
+    const __m256i vb = _mm256_set1_epi16(bias);
+    const __m256i one = _mm256_set1_epi16(1);
+    int16_t bmin[16], bmax[16];
+    uint16_t jmin[16], jmax[16];
+    uint32_t i = 0;
+
+    while (i + 16 <= n) {
+        uint32_t m = (n - i) / 16;
+        if (m > 65536) {
+            m = 65536;
+        }
+        __m256i vmin = _mm256_set1_epi16(INT16_MAX), vmax = _mm256_set1_epi16(INT16_MIN);
+        __m256i kmin = _mm256_setzero_si256(), kmax = kmin, vj = kmin;
+        for (uint32_t j = 0; j < m; j++) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&x[i + j * 16]), vb);
+            kmin = _mm256_blendv_epi8(kmin, vj, _mm256_cmpgt_epi16(vmin, v));
+            kmax = _mm256_blendv_epi8(kmax, vj, _mm256_cmpgt_epi16(v, vmax));
+            vmin = _mm256_min_epi16(vmin, v);
+            vmax = _mm256_max_epi16(vmax, v);
+            vj = _mm256_add_epi16(vj, one);
+        }
+        _mm256_storeu_si256((__m256i *)bmin, vmin);
+        _mm256_storeu_si256((__m256i *)bmax, vmax);
+        _mm256_storeu_si256((__m256i *)jmin, kmin);
+        _mm256_storeu_si256((__m256i *)jmax, kmax);
+        reduce_merge16(r, bmin, jmin, bmax, jmax, 16, i, bias);
+        i += m * 16;
+    }
+    return i;
+}
+
+RT_DSP_TARGET_AVX2
+static int64_t sum64_16_avx2(const int16_t *x, uint32_t n, uint32_t *done, int16_t bias) {
+    const __m256i vb = _mm256_set1_epi16(bias);
+    const __m256i one = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+
+    while (i + 16 <= n) {
+        uint32_t m = (n - i) / 16;
+        if (m > REDUCE_CHUNK) {
+            m = REDUCE_CHUNK;
+        }
+        __m256i s = _mm256_setzero_si256();
+        for (uint32_t j = 0; j < m; j++) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&x[i + j * 16]), vb);
+            s = _mm256_add_epi32(s, _mm256_madd_epi16(v, one));
+        }
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(s)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(s, 1)));
+        i += m * 16;
+    }
+    *done = i;
+    return (int64_t)reduce_hsum_epi64_avx2(acc) + (bias ? (int64_t)i * 0x8000 : 0);
+}
+
+RT_DSP_TARGET_AVX2
+void minmax_q31_block_avx2(const q31_t *x, uint32_t n, minmax_result_t *r) {
+    const __m256i eight = _mm256_set1_epi32(8);
+    __m256i vmin = _mm256_set1_epi32(INT32_MAX), vmax = _mm256_set1_epi32(INT32_MIN);
+    __m256i vk = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), kmin = vk, kmax = vk;
+    int32_t bmin[8], bmax[8];
+    uint32_t jmin[8], jmax[8];
+    uint32_t i = 0;
+
+    reduce_init(r, INT32_MIN, INT32_MAX);
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        kmin = _mm256_blendv_epi8(kmin, vk, _mm256_cmpgt_epi32(vmin, v));
+        kmax = _mm256_blendv_epi8(kmax, vk, _mm256_cmpgt_epi32(v, vmax));
+        vmin = _mm256_min_epi32(vmin, v);
+        vmax = _mm256_max_epi32(vmax, v);
+        vk = _mm256_add_epi32(vk, eight);
+    }
+    if (i > 0) {
+        _mm256_storeu_si256((__m256i *)bmin, vmin);
+        _mm256_storeu_si256((__m256i *)bmax, vmax);
+        _mm256_storeu_si256((__m256i *)jmin, kmin);
+        _mm256_storeu_si256((__m256i *)jmax, kmax);
+        for (int l = 0; l < 8; l++) {
+            reduce_merge(r, bmin[l], jmin[l], bmax[l], jmax[l]);
+        }
+    }
+    minmax_q31_step(x, i, n, r);
+}
+
+RT_DSP_TARGET_AVX2
+void minmax_i16_block_avx2(const int16_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, INT16_MIN, INT16_MAX);
+    minmax_i16_step(x, minmax_16_avx2(x, n, r, 0), n, r);
+}
+
+RT_DSP_TARGET_AVX2
+void minmax_u16_block_avx2(const uint16_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, 0, UINT16_MAX);
+    minmax_u16_step(x, minmax_16_avx2((const int16_t *)x, n, r, INT16_MIN), n, r);
+}
+
+RT_DSP_TARGET_AVX2
+int64_t sum64_q31_block_avx2(const q31_t *x, uint32_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    return (int64_t)reduce_hsum_epi64_avx2(acc) + sum64_q31_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+int64_t sum64_i16_block_avx2(const int16_t *x, uint32_t n) {
+    uint32_t i;
+    int64_t sum = sum64_16_avx2(x, n, &i, 0);
+    return sum + sum64_i16_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+int64_t sum64_u16_block_avx2(const uint16_t *x, uint32_t n) {
+    uint32_t i;
+    int64_t sum = sum64_16_avx2((const int16_t *)x, n, &i, INT16_MIN);
+    return sum + sum64_u16_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+uint64_t sumsq_q31_block_avx2(const q31_t *x, uint32_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i h = _mm256_srli_epi64(v, 32);
+        acc = _mm256_add_epi64(acc, _mm256_srli_epi64(_mm256_mul_epi32(v, v), 31));
+        acc = _mm256_add_epi64(acc, _mm256_srli_epi64(_mm256_mul_epi32(h, h), 31));
+    }
+    return reduce_hsum_epi64_avx2(acc) + sumsq_q31_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+uint64_t sumsq_i16_block_avx2(const int16_t *x, uint32_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        acc = reduce_add_u32_avx2(acc, _mm256_madd_epi16(v, v));
+    }
+    return reduce_hsum_epi64_avx2(acc) + sumsq_i16_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX2
+uint64_t sumsq_u16_block_avx2(const uint16_t *x, uint32_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&x[i]);
+        __m256i lo = _mm256_mullo_epi16(v, v);
+        __m256i hi = _mm256_mulhi_epu16(v, v);
+        acc = reduce_add_u32_avx2(acc, _mm256_unpacklo_epi16(lo, hi));
+        acc = reduce_add_u32_avx2(acc, _mm256_unpackhi_epi16(lo, hi));
+    }
+    return reduce_hsum_epi64_avx2(acc) + sumsq_u16_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+static uint32_t minmax_16_avx512(const int16_t *x, uint32_t n, minmax_result_t *r, int16_t bias) {
+    const __m512i vb = _mm512_set1_epi16(bias);
+    const __m512i one = _mm512_set1_epi16(1);
+    int16_t bmin[32], bmax[32];
+    uint16_t jmin[32], jmax[32];
+    uint32_t i = 0;
+
+    while (i + 32 <= n) {
+        uint32_t m = (n - i) / 32;
+        if (m > 65536) {
+            m = 65536;
+        }
+        __m512i vmin = _mm512_set1_epi16(INT16_MAX), vmax = _mm512_set1_epi16(INT16_MIN);
+        __m512i kmin = _mm512_setzero_si512(), kmax = kmin, vj = kmin;
+        for (uint32_t j = 0; j < m; j++) {
+            __m512i v = _mm512_xor_si512(_mm512_loadu_si512((const void *)&x[i + j * 32]), vb);
+            kmin = _mm512_mask_mov_epi16(kmin, _mm512_cmplt_epi16_mask(v, vmin), vj);
+            kmax = _mm512_mask_mov_epi16(kmax, _mm512_cmpgt_epi16_mask(v, vmax), vj);
+            vmin = _mm512_min_epi16(vmin, v);
+            vmax = _mm512_max_epi16(vmax, v);
+            vj = _mm512_add_epi16(vj, one);
+        }
+        _mm512_storeu_si512((void *)bmin, vmin);
+        _mm512_storeu_si512((void *)bmax, vmax);
+        _mm512_storeu_si512((void *)jmin, kmin);
+        _mm512_storeu_si512((void *)jmax, kmax);
+        reduce_merge16(r, bmin, jmin, bmax, jmax, 32, i, bias);
+        i += m * 32;
+    }
+    return i;
+}
+
+RT_DSP_TARGET_AVX512
+static int64_t sum64_16_avx512(const int16_t *x, uint32_t n, uint32_t *done, int16_t bias) {
+    const __m512i vb = _mm512_set1_epi16(bias);
+    const __m512i one = _mm512_set1_epi16(1);
+    __m512i acc = _mm512_setzero_si512();
+    uint32_t i = 0;
+
+    while (i + 32 <= n) {
+        uint32_t m = (n - i) / 32;
+        if (m > REDUCE_CHUNK) {
+            m = REDUCE_CHUNK;
+        }
+        __m512i s = _mm512_setzero_si512();
+        for (uint32_t j = 0; j < m; j++) {
+            __m512i v = _mm512_xor_si512(_mm512_loadu_si512((const void *)&x[i + j * 32]), vb);
+            s = _mm512_add_epi32(s, _mm512_madd_epi16(v, one));
+        }
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(s)));
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(s, 1)));
+        i += m * 32;
+    }
+    *done = i;
+    return (int64_t)_mm512_reduce_add_epi64(acc) + (bias ? (int64_t)i * 0x8000 : 0);
+}
+
+RT_DSP_TARGET_AVX512
+void minmax_q31_block_avx512(const q31_t *x, uint32_t n, minmax_result_t *r) {
+    const __m512i sixteen = _mm512_set1_epi32(16);
+    __m512i vmin = _mm512_set1_epi32(INT32_MAX), vmax = _mm512_set1_epi32(INT32_MIN);
+    __m512i vk = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i kmin = vk, kmax = vk;
+    int32_t bmin[16], bmax[16];
+    uint32_t jmin[16], jmax[16];
+    uint32_t i = 0;
+
+    reduce_init(r, INT32_MIN, INT32_MAX);
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        kmin = _mm512_mask_mov_epi32(kmin, _mm512_cmplt_epi32_mask(v, vmin), vk);
+        kmax = _mm512_mask_mov_epi32(kmax, _mm512_cmpgt_epi32_mask(v, vmax), vk);
+        vmin = _mm512_min_epi32(vmin, v);
+        vmax = _mm512_max_epi32(vmax, v);
+        vk = _mm512_add_epi32(vk, sixteen);
+    }
+    if (i > 0) {
+        _mm512_storeu_si512((void *)bmin, vmin);
+        _mm512_storeu_si512((void *)bmax, vmax);
+        _mm512_storeu_si512((void *)jmin, kmin);
+        _mm512_storeu_si512((void *)jmax, kmax);
+        for (int l = 0; l < 16; l++) {
+            reduce_merge(r, bmin[l], jmin[l], bmax[l], jmax[l]);
+        }
+    }
+    minmax_q31_step(x, i, n, r);
+}
+
+RT_DSP_TARGET_AVX512
+void minmax_i16_block_avx512(const int16_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, INT16_MIN, INT16_MAX);
+    minmax_i16_step(x, minmax_16_avx512(x, n, r, 0), n, r);
+}
+
+RT_DSP_TARGET_AVX512
+void minmax_u16_block_avx512(const uint16_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, 0, UINT16_MAX);
+    minmax_u16_step(x, minmax_16_avx512((const int16_t *)x, n, r, INT16_MIN), n, r);
+}
+
+RT_DSP_TARGET_AVX512
+int64_t sum64_q31_block_avx512(const q31_t *x, uint32_t n) {
+    __m512i acc = _mm512_setzero_si512();
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)));
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+    }
+    return (int64_t)_mm512_reduce_add_epi64(acc) + sum64_q31_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+int64_t sum64_i16_block_avx512(const int16_t *x, uint32_t n) {
+    uint32_t i;
+    int64_t sum = sum64_16_avx512(x, n, &i, 0);
+    return sum + sum64_i16_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+int64_t sum64_u16_block_avx512(const uint16_t *x, uint32_t n) {
+    uint32_t i;
+    int64_t sum = sum64_16_avx512((const int16_t *)x, n, &i, INT16_MIN);
+    return sum + sum64_u16_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+uint64_t sumsq_q31_block_avx512(const q31_t *x, uint32_t n) {
+    __m512i acc = _mm512_setzero_si512();
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        __m512i h = _mm512_srli_epi64(v, 32);
+        acc = _mm512_add_epi64(acc, _mm512_srli_epi64(_mm512_mul_epi32(v, v), 31));
+        acc = _mm512_add_epi64(acc, _mm512_srli_epi64(_mm512_mul_epi32(h, h), 31));
+    }
+    return (uint64_t)_mm512_reduce_add_epi64(acc) + sumsq_q31_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+uint64_t sumsq_i16_block_avx512(const int16_t *x, uint32_t n) {
+    __m512i acc = _mm512_setzero_si512();
+    uint32_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        acc = reduce_add_u32_avx512(acc, _mm512_madd_epi16(v, v));
+    }
+    return (uint64_t)_mm512_reduce_add_epi64(acc) + sumsq_i16_block_scalar(&x[i], n - i);
+}
+
+RT_DSP_TARGET_AVX512
+uint64_t sumsq_u16_block_avx512(const uint16_t *x, uint32_t n) {
+    __m512i acc = _mm512_setzero_si512();
+    uint32_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i v = _mm512_loadu_si512((const void *)&x[i]);
+        __m512i lo = _mm512_mullo_epi16(v, v);
+        __m512i hi = _mm512_mulhi_epu16(v, v);
+        acc = reduce_add_u32_avx512(acc, _mm512_unpacklo_epi16(lo, hi));
+        acc = reduce_add_u32_avx512(acc, _mm512_unpackhi_epi16(lo, hi));
+    }
+    return (uint64_t)_mm512_reduce_add_epi64(acc) + sumsq_u16_block_scalar(&x[i], n - i);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+Same scheme as the x86 kernels.  The 16-bit sums use pairwise add and
+accumulate into 32-bit lanes, widened every REDUCE_CHUNK vectors, and the
+squares are widening multiplies into pairwise 64-bit accumulates.
+-----------------------------------------------------------------------------*/
+static uint32_t minmax_16_neon(const int16_t *x, uint32_t n, minmax_result_t *r, int16_t bias) {
+    const int16x8_t vb = vdupq_n_s16(bias);
+    int16_t bmin[8], bmax[8];
+    uint16_t jmin[8], jmax[8];
+    uint32_t i = 0;
+
+    while (i + 8 <= n) {
+        uint32_t m = (n - i) / 8;
+        if (m > 65536) {
+            m = 65536;
+        }
+        int16x8_t vmin = vdupq_n_s16(INT16_MAX), vmax = vdupq_n_s16(INT16_MIN);
+        uint16x8_t kmin = vdupq_n_u16(0), kmax = kmin, vj = kmin;
+        for (uint32_t j = 0; j < m; j++) {
+            int16x8_t v = veorq_s16(vld1q_s16(&x[i + j * 8]), vb);
+            kmin = vbslq_u16(vcltq_s16(v, vmin), vj, kmin);
+            kmax = vbslq_u16(vcgtq_s16(v, vmax), vj, kmax);
+            vmin = vminq_s16(vmin, v);
+            vmax = vmaxq_s16(vmax, v);
+            vj = vaddq_u16(vj, vdupq_n_u16(1));
+        }
+        vst1q_s16(bmin, vmin);
+        vst1q_s16(bmax, vmax);
+        vst1q_u16(jmin, kmin);
+        vst1q_u16(jmax, kmax);
+        reduce_merge16(r, bmin, jmin, bmax, jmax, 8, i, bias);
+        i += m * 8;
+    }
+    return i;
+}
+
+static int64_t sum64_16_neon(const int16_t *x, uint32_t n, uint32_t *done, int16_t bias) {
+    const int16x8_t vb = vdupq_n_s16(bias);
+    int64x2_t acc = vdupq_n_s64(0);
+    uint32_t i = 0;
+
+    while (i + 8 <= n) {
+        uint32_t m = (n - i) / 8;
+        if (m > REDUCE_CHUNK) {
+            m = REDUCE_CHUNK;
+        }
+        int32x4_t s = vdupq_n_s32(0);
+        for (uint32_t j = 0; j < m; j++) {
+            s = vpadalq_s16(s, veorq_s16(vld1q_s16(&x[i + j * 8]), vb));
+        }
+        acc = vpadalq_s32(acc, s);
+        i += m * 8;
+    }
+    *done = i;
+    return vaddvq_s64(acc) + (bias ? (int64_t)i * 0x8000 : 0);
+}
+
+void minmax_q31_block_neon(const q31_t *x, uint32_t n, minmax_result_t *r) {
+    static const uint32_t lanes[4] = { 0, 1, 2, 3 };
+    int32x4_t vmin = vdupq_n_s32(INT32_MAX), vmax = vdupq_n_s32(INT32_MIN);
+    uint32x4_t vk = vld1q_u32(lanes), kmin = vk, kmax = vk;
+    int32_t bmin[4], bmax[4];
+    uint32_t jmin[4], jmax[4];
+    uint32_t i = 0;
+
+    reduce_init(r, INT32_MIN, INT32_MAX);
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t v = vld1q_s32(&x[i]);
+        kmin = vbslq_u32(vcltq_s32(v, vmin), vk, kmin);
+        kmax = vbslq_u32(vcgtq_s32(v, vmax), vk, kmax);
+        vmin = vminq_s32(vmin, v);
+        vmax = vmaxq_s32(vmax, v);
+        vk = vaddq_u32(vk, vdupq_n_u32(4));
+    }
+    if (i > 0) {
+        vst1q_s32(bmin, vmin);
+        vst1q_s32(bmax, vmax);
+        vst1q_u32(jmin, kmin);
+        vst1q_u32(jmax, kmax);
+        for (int l = 0; l < 4; l++) {
+            reduce_merge(r, bmin[l], jmin[l], bmax[l], jmax[l]);
+        }
+    }
+    minmax_q31_step(x, i, n, r);
+}
+
+void minmax_i16_block_neon(const int16_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, INT16_MIN, INT16_MAX);
+    minmax_i16_step(x, minmax_16_neon(x, n, r, 0), n, r);
+}
+
+void minmax_u16_block_neon(const uint16_t *x, uint32_t n, minmax_result_t *r) {
+    reduce_init(r, 0, UINT16_MAX);
+    minmax_u16_step(x, minmax_16_neon((const int16_t *)x, n, r, INT16_MIN), n, r);
+}
+
+int64_t sum64_q31_block_neon(const q31_t *x, uint32_t n) {
+    int64x2_t acc = vdupq_n_s64(0);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vpadalq_s32(acc, vld1q_s32(&x[i]));
+    }
+    return vaddvq_s64(acc) + sum64_q31_block_scalar(&x[i], n - i);
+}
+
+int64_t sum64_i16_block_neon(const int16_t *x, uint32_t n) {
+    uint32_t i;
+    int64_t sum = sum64_16_neon(x, n, &i, 0);
+    return sum + sum64_i16_block_scalar(&x[i], n - i);
+}
+
+int64_t sum64_u16_block_neon(const uint16_t *x, uint32_t n) {
+    uint32_t i;
+    int64_t sum = sum64_16_neon((const int16_t *)x, n, &i, INT16_MIN);
+    return sum + sum64_u16_block_scalar(&x[i], n - i);
+}
+
+uint64_t sumsq_q31_block_neon(const q31_t *x, uint32_t n) {
+    uint64x2_t acc = vdupq_n_u64(0);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t v = vld1q_s32(&x[i]);
+        acc = vaddq_u64(acc, vshrq_n_u64(vreinterpretq_u64_s64(vmull_s32(vget_low_s32(v), vget_low_s32(v))), 31));
+        acc = vaddq_u64(acc, vshrq_n_u64(vreinterpretq_u64_s64(vmull_high_s32(v, v)), 31));
+    }
+    return vaddvq_u64(acc) + sumsq_q31_block_scalar(&x[i], n - i);
+}
+
+uint64_t sumsq_i16_block_neon(const int16_t *x, uint32_t n) {
+    uint64x2_t acc = vdupq_n_u64(0);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t v = vld1q_s16(&x[i]);
+        acc = vpadalq_u32(acc, vreinterpretq_u32_s32(vmull_s16(vget_low_s16(v), vget_low_s16(v))));
+        acc = vpadalq_u32(acc, vreinterpretq_u32_s32(vmull_high_s16(v, v)));
+    }
+    return vaddvq_u64(acc) + sumsq_i16_block_scalar(&x[i], n - i);
+}
+
+uint64_t sumsq_u16_block_neon(const uint16_t *x, uint32_t n) {
+    uint64x2_t acc = vdupq_n_u64(0);
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vld1q_u16(&x[i]);
+        acc = vpadalq_u32(acc, vmull_u16(vget_low_u16(v), vget_low_u16(v)));
+        acc = vpadalq_u32(acc, vmull_high_u16(v, v));
+    }
+    return vaddvq_u64(acc) + sumsq_u16_block_scalar(&x[i], n - i);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.  Q15
+and int16_t share the kernels.
+-----------------------------------------------------------------------------*/
+void minmax_q31_block(const q31_t *x, uint32_t n, minmax_result_t *r) {
+    dsp_kernels.minmax_q31_block(x, n, r);
+}
+
+void minmax_q15_block(const q15_t *x, uint32_t n, minmax_result_t *r) {
+    dsp_kernels.minmax_i16_block(x, n, r);
+}
+
+void minmax_i16_block(const int16_t *x, uint32_t n, minmax_result_t *r) {
+    dsp_kernels.minmax_i16_block(x, n, r);
+}
+
+void minmax_u16_block(const uint16_t *x, uint32_t n, minmax_result_t *r) {
+    dsp_kernels.minmax_u16_block(x, n, r);
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+These run the fused kernel.  It is bound by the loads, so the other half of
+the result costs next to nothing.
+-----------------------------------------------------------------------------*/
+q31_t min_q31_block(const q31_t *x, uint32_t n, uint32_t *argmin) {
+    minmax_result_t r;
+    minmax_q31_block(x, n, &r);
+    if (argmin != NULL) {
+        *argmin = r.argmin;
+    }
+    return r.min;
+}
+
+q31_t max_q31_block(const q31_t *x, uint32_t n, uint32_t *argmax) {
+    minmax_result_t r;
+    minmax_q31_block(x, n, &r);
+    if (argmax != NULL) {
+        *argmax = r.argmax;
+    }
+    return r.max;
+}
+
+q15_t min_q15_block(const q15_t *x, uint32_t n, uint32_t *argmin) {
+    return min_i16_block(x, n, argmin);
+}
+
+q15_t max_q15_block(const q15_t *x, uint32_t n, uint32_t *argmax) {
+    return max_i16_block(x, n, argmax);
+}
+
+int16_t min_i16_block(const int16_t *x, uint32_t n, uint32_t *argmin) {
+    minmax_result_t r;
+    minmax_i16_block(x, n, &r);
+    if (argmin != NULL) {
+        *argmin = r.argmin;
+    }
+    return (int16_t)r.min;
+}
+
+int16_t max_i16_block(const int16_t *x, uint32_t n, uint32_t *argmax) {
+    minmax_result_t r;
+    minmax_i16_block(x, n, &r);
+    if (argmax != NULL) {
+        *argmax = r.argmax;
+    }
+    return (int16_t)r.max;
+}
+
+uint16_t min_u16_block(const uint16_t *x, uint32_t n, uint32_t *argmin) {
+    minmax_result_t r;
+    minmax_u16_block(x, n, &r);
+    if (argmin != NULL) {
+        *argmin = r.argmin;
+    }
+    return (uint16_t)r.min;
+}
+
+uint16_t max_u16_block(const uint16_t *x, uint32_t n, uint32_t *argmax) {
+    minmax_result_t r;
+    minmax_u16_block(x, n, &r);
+    if (argmax != NULL) {
+        *argmax = r.argmax;
+    }
+    return (uint16_t)r.max;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernels sum exactly in 64 bits and the result is saturated once, so it
+doesn't depend on the order of the additions like saturating every step
+would.
+-----------------------------------------------------------------------------*/
+q31_t sum_q31_block(const q31_t *x, uint32_t n) {
+    return (q31_t)ssat_i64(dsp_kernels.sum64_q31_block(x, n), 32);
+}
+
+q15_t sum_q15_block(const q15_t *x, uint32_t n) {
+    return sum_i16_block(x, n);
+}
+
+int16_t sum_i16_block(const int16_t *x, uint32_t n) {
+    return (int16_t)ssat_i64(dsp_kernels.sum64_i16_block(x, n), 16);
+}
+
+uint16_t sum_u16_block(const uint16_t *x, uint32_t n) {
+    int64_t sum = dsp_kernels.sum64_u16_block(x, n);
+    return (sum > UINT16_MAX) ? UINT16_MAX : (uint16_t)sum;
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+uint64_t sumsq_q31_block(const q31_t *x, uint32_t n) {
+    return dsp_kernels.sumsq_q31_block(x, n);
+}
+
+uint64_t sumsq_q15_block(const q15_t *x, uint32_t n) {
+    return dsp_kernels.sumsq_i16_block(x, n);
+}
+
+uint64_t sumsq_i16_block(const int16_t *x, uint32_t n) {
+    return dsp_kernels.sumsq_i16_block(x, n);
+}
+
+uint64_t sumsq_u16_block(const uint16_t *x, uint32_t n) {
+    return dsp_kernels.sumsq_u16_block(x, n);
+}
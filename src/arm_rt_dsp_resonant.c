@@ -0,0 +1,302 @@
+/**
+ * \file arm_rt_dsp_resonant.c
+ * \brief Proportional resonant controller with several harmonics in one call.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Same derived gains as iir_pr_init_q31, one harmonic at a time.  The harmonic
+frequency is the fundamental phase times h, which wraps modulo 2^32 exactly like
+the angle it stands for.
+-----------------------------------------------------------------------------*/
+void iir_pr_multi_init_q31(iir_pr_multi_instance_q31 *S, int32_t resetStateFlag)
+{
+  for (uint32_t i = 0; i < S->H; i++)
+  {
+    q31_t c, s;
+
+    sincos_q30(S->phase * S->h[i], &c, &s);
+    S->A0[i] = S->Kr[i];
+    S->A1[i] = (acc32_t)(-(((int64_t)S->Kr[i] * c) >> 30));
+    S->C[i] = c;
+  }
+
+  if (resetStateFlag)
+  {
+    S->x1 = 0;
+    memset(S->y1, 0, S->H * sizeof(q31_t));
+    memset(S->y2, 0, S->H * sizeof(q31_t));
+  }
+}
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernel.  Each harmonic is stepped exactly like the resonator of
+iir_pr_q31 and the sum is saturated once.
+-----------------------------------------------------------------------------*/
+static inline q31_t iir_pr_multi_step_q31(iir_pr_multi_instance_q31 *S, q31_t x, q31_t x1)
+{
+    int64_t acc = ((int64_t)S->Kp * (int64_t)x) >> 15;
+
+    for (uint32_t i = 0; i < S->H; i++) {
+        q31_t r = iir_resonant_step_q31(S->A0[i], S->A1[i], S->C[i], x, x1, S->y1[i], S->y2[i]);
+        S->y2[i] = S->y1[i];
+        S->y1[i] = r;
+        acc += r;
+    }
+    return (q31_t)ssat_i64(acc, 32);
+}
+
+void iir_pr_multi_q31_run_scalar(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out,
+                                 uint32_t n) {
+    q31_t x1 = S->x1;
+
+    for (uint32_t k = 0; k < n; k++) {
+        q31_t x = in[k];
+        out[k] = iir_pr_multi_step_q31(S, x, x1);
+        x1 = x;
+    }
+    S->x1 = x1;
+}
+
+
+/*-----------------------------------------------------------------------------
+The SIMD kernels copy the coefficients and state into IIR_PR_MAX_HARMONICS
+zero padded lanes.  A padding lane has zero gains and state, so its resonator
+output stays zero and does not change the sum.
+-----------------------------------------------------------------------------*/
+typedef struct {
+    q31_t A0[IIR_PR_MAX_HARMONICS];
+    q31_t A1[IIR_PR_MAX_HARMONICS];
+    q31_t C[IIR_PR_MAX_HARMONICS];
+    q31_t y1[IIR_PR_MAX_HARMONICS];
+    q31_t y2[IIR_PR_MAX_HARMONICS];
+} iir_pr_lanes_q31;
+
+static inline void iir_pr_lanes_load(const iir_pr_multi_instance_q31 *S, iir_pr_lanes_q31 *L)
+{
+    memset(L, 0, sizeof(*L));
+    memcpy(L->A0, S->A0, S->H * sizeof(q31_t));
+    memcpy(L->A1, S->A1, S->H * sizeof(q31_t));
+    memcpy(L->C, S->C, S->H * sizeof(q31_t));
+    memcpy(L->y1, S->y1, S->H * sizeof(q31_t));
+    memcpy(L->y2, S->y2, S->H * sizeof(q31_t));
+}
+
+static inline void iir_pr_lanes_store(iir_pr_multi_instance_q31 *S, const iir_pr_lanes_q31 *L)
+{
+    memcpy(S->y1, L->y1, S->H * sizeof(q31_t));
+    memcpy(S->y2, L->y2, S->H * sizeof(q31_t));
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+The lanes are 64 bits wide and hold sign extended 32 bit values, so PMULDQ
+gives the full products.  AVX2 has no 64-bit arithmetic shift: for shifts
+under 32 the high half of the result is the 32-bit arithmetic shift of the
+high half, so one blend of the two shifts stands in for it.  The accumulator is
+clamped to the range whose >> 15 fits in 32 bits before the final shift, which
+is the ssat_i64 of the scalar code.
+-----------------------------------------------------------------------------*/
+#define IIR_PR_SRA64_AVX2(p, s) \
+    _mm256_blend_epi32(_mm256_srli_epi64((p), (s)), _mm256_srai_epi32((p), (s)), 0xAA)
+
+RT_DSP_TARGET_AVX2
+static inline __m256i iir_pr_resonant_avx2(__m256i a0, __m256i a1, __m256i c, __m256i x,
+                                           __m256i x1, __m256i y1, __m256i y2) {
+    const __m256i vmax = _mm256_set1_epi64x(((int64_t)INT32_MAX << 15) | 0x7FFF);
+    const __m256i vmin = _mm256_set1_epi64x((int64_t)INT32_MIN * 32768);
+
+    __m256i p = _mm256_mul_epi32(c, y1);
+    __m256i acc = _mm256_add_epi64(_mm256_mul_epi32(a0, x), _mm256_mul_epi32(a1, x1));
+    acc = _mm256_add_epi64(acc, IIR_PR_SRA64_AVX2(p, 14));
+    acc = _mm256_sub_epi64(acc, _mm256_slli_epi64(y2, 15));
+
+    acc = _mm256_blendv_epi8(acc, vmax, _mm256_cmpgt_epi64(acc, vmax));
+    acc = _mm256_blendv_epi8(acc, vmin, _mm256_cmpgt_epi64(vmin, acc));
+    return IIR_PR_SRA64_AVX2(acc, 15);
+}
+
+RT_DSP_TARGET_AVX2
+void iir_pr_multi_q31_run_avx2(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out,
+                               uint32_t n) {
+    const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    iir_pr_lanes_q31 L;
+    q31_t x1 = S->x1;
+
+    if (S->H > IIR_PR_MAX_HARMONICS) {
+        iir_pr_multi_q31_run_scalar(S, in, out, n);
+        return;
+    }
+    iir_pr_lanes_load(S, &L);
+
+#define IIR_PR_LOAD_AVX2(a, i) _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&(a)[i]))
+    __m256i a0l = IIR_PR_LOAD_AVX2(L.A0, 0), a0h = IIR_PR_LOAD_AVX2(L.A0, 4);
+    __m256i a1l = IIR_PR_LOAD_AVX2(L.A1, 0), a1h = IIR_PR_LOAD_AVX2(L.A1, 4);
+    __m256i cl = IIR_PR_LOAD_AVX2(L.C, 0), ch = IIR_PR_LOAD_AVX2(L.C, 4);
+    __m256i y1l = IIR_PR_LOAD_AVX2(L.y1, 0), y1h = IIR_PR_LOAD_AVX2(L.y1, 4);
+    __m256i y2l = IIR_PR_LOAD_AVX2(L.y2, 0), y2h = IIR_PR_LOAD_AVX2(L.y2, 4);
+#undef IIR_PR_LOAD_AVX2
+
+    for (uint32_t k = 0; k < n; k++) {
+        q31_t x = in[k];
+        __m256i xv = _mm256_set1_epi64x(x);
+        __m256i x1v = _mm256_set1_epi64x(x1);
+
+        __m256i rl = iir_pr_resonant_avx2(a0l, a1l, cl, xv, x1v, y1l, y2l);
+        __m256i rh = iir_pr_resonant_avx2(a0h, a1h, ch, xv, x1v, y1h, y2h);
+        y2l = y1l;
+        y2h = y1h;
+        y1l = rl;
+        y1h = rh;
+
+        __m256i s4 = _mm256_add_epi64(rl, rh);
+        __m128i s2 = _mm_add_epi64(_mm256_castsi256_si128(s4), _mm256_extracti128_si256(s4, 1));
+        s2 = _mm_add_epi64(s2, _mm_unpackhi_epi64(s2, s2));
+
+        int64_t acc = (((int64_t)S->Kp * (int64_t)x) >> 15) + _mm_cvtsi128_si64(s2);
+        out[k] = (q31_t)ssat_i64(acc, 32);
+        x1 = x;
+    }
+
+#define IIR_PR_STORE_AVX2(a, i, v) \
+    _mm_storeu_si128((__m128i *)&(a)[i], _mm256_castsi256_si128(_mm256_permutevar8x32_epi32((v), even)))
+    IIR_PR_STORE_AVX2(L.y1, 0, y1l);
+    IIR_PR_STORE_AVX2(L.y1, 4, y1h);
+    IIR_PR_STORE_AVX2(L.y2, 0, y2l);
+    IIR_PR_STORE_AVX2(L.y2, 4, y2h);
+#undef IIR_PR_STORE_AVX2
+    iir_pr_lanes_store(S, &L);
+    S->x1 = x1;
+}
+
+RT_DSP_TARGET_AVX512
+void iir_pr_multi_q31_run_avx512(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out,
+                                 uint32_t n) {
+    const __m512i vmax = _mm512_set1_epi64(INT32_MAX);
+    const __m512i vmin = _mm512_set1_epi64(INT32_MIN);
+    iir_pr_lanes_q31 L;
+    q31_t x1 = S->x1;
+
+    if (S->H > IIR_PR_MAX_HARMONICS) {
+        iir_pr_multi_q31_run_scalar(S, in, out, n);
+        return;
+    }
+    iir_pr_lanes_load(S, &L);
+
+    __m512i a0 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)L.A0));
+    __m512i a1 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)L.A1));
+    __m512i c = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)L.C));
+    __m512i y1 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)L.y1));
+    __m512i y2 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)L.y2));
+
+    for (uint32_t k = 0; k < n; k++) {
+        q31_t x = in[k];
+
+        __m512i acc = _mm512_add_epi64(_mm512_mul_epi32(a0, _mm512_set1_epi64(x)),
+                                       _mm512_mul_epi32(a1, _mm512_set1_epi64(x1)));
+        acc = _mm512_add_epi64(acc, _mm512_srai_epi64(_mm512_mul_epi32(c, y1), 14));
+        acc = _mm512_sub_epi64(acc, _mm512_slli_epi64(y2, 15));
+
+        __m512i r = _mm512_srai_epi64(acc, 15);
+        r = _mm512_min_epi64(_mm512_max_epi64(r, vmin), vmax);
+        y2 = y1;
+        y1 = r;
+
+        int64_t sum = (((int64_t)S->Kp * (int64_t)x) >> 15) + _mm512_reduce_add_epi64(r);
+        out[k] = (q31_t)ssat_i64(sum, 32);
+        x1 = x;
+    }
+
+    _mm256_storeu_si256((__m256i *)L.y1, _mm512_cvtepi64_epi32(y1));
+    _mm256_storeu_si256((__m256i *)L.y2, _mm512_cvtepi64_epi32(y2));
+    iir_pr_lanes_store(S, &L);
+    S->x1 = x1;
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+The state stays in 32-bit lanes, SMULL/SMLAL widen the products and SQXTN is
+the final ssat_i64.
+-----------------------------------------------------------------------------*/
+static inline int32x4_t iir_pr_resonant_neon(int32x4_t a0, int32x4_t a1, int32x4_t c, int32_t x,
+                                             int32_t x1, int32x4_t y1, int32x4_t y2) {
+    int64x2_t al = vmlal_n_s32(vmull_n_s32(vget_low_s32(a0), x), vget_low_s32(a1), x1);
+    int64x2_t ah = vmlal_high_n_s32(vmull_high_n_s32(a0, x), a1, x1);
+
+    al = vaddq_s64(al, vshrq_n_s64(vmull_s32(vget_low_s32(c), vget_low_s32(y1)), 14));
+    ah = vaddq_s64(ah, vshrq_n_s64(vmull_high_s32(c, y1), 14));
+    al = vsubq_s64(al, vshll_n_s32(vget_low_s32(y2), 15));
+    ah = vsubq_s64(ah, vshll_high_n_s32(y2, 15));
+
+    return vcombine_s32(vqmovn_s64(vshrq_n_s64(al, 15)), vqmovn_s64(vshrq_n_s64(ah, 15)));
+}
+
+void iir_pr_multi_q31_run_neon(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out,
+                               uint32_t n) {
+    iir_pr_lanes_q31 L;
+    q31_t x1 = S->x1;
+
+    if (S->H > IIR_PR_MAX_HARMONICS) {
+        iir_pr_multi_q31_run_scalar(S, in, out, n);
+        return;
+    }
+    iir_pr_lanes_load(S, &L);
+
+    int32x4_t a0l = vld1q_s32(&L.A0[0]), a0h = vld1q_s32(&L.A0[4]);
+    int32x4_t a1l = vld1q_s32(&L.A1[0]), a1h = vld1q_s32(&L.A1[4]);
+    int32x4_t cl = vld1q_s32(&L.C[0]), ch = vld1q_s32(&L.C[4]);
+    int32x4_t y1l = vld1q_s32(&L.y1[0]), y1h = vld1q_s32(&L.y1[4]);
+    int32x4_t y2l = vld1q_s32(&L.y2[0]), y2h = vld1q_s32(&L.y2[4]);
+
+    for (uint32_t k = 0; k < n; k++) {
+        q31_t x = in[k];
+
+        int32x4_t rl = iir_pr_resonant_neon(a0l, a1l, cl, x, x1, y1l, y2l);
+        int32x4_t rh = iir_pr_resonant_neon(a0h, a1h, ch, x, x1, y1h, y2h);
+        y2l = y1l;
+        y2h = y1h;
+        y1l = rl;
+        y1h = rh;
+
+        int64x2_t s = vaddq_s64(vpaddlq_s32(rl), vpaddlq_s32(rh));
+        int64_t acc = (((int64_t)S->Kp * (int64_t)x) >> 15) + vaddvq_s64(s);
+        out[k] = (q31_t)ssat_i64(acc, 32);
+        x1 = x;
+    }
+
+    vst1q_s32(&L.y1[0], y1l);
+    vst1q_s32(&L.y1[4], y1h);
+    vst1q_s32(&L.y2[0], y2l);
+    vst1q_s32(&L.y2[4], y2h);
+    iir_pr_lanes_store(S, &L);
+    S->x1 = x1;
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+void iir_pr_multi_q31_run(iir_pr_multi_instance_q31 *S, const q31_t *in, q31_t *out, uint32_t n) {
+    dsp_kernels.iir_pr_multi_q31_run(S, in, out, n);
+}
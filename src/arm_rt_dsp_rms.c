@@ -0,0 +1,343 @@
+/**
+ * \file arm_rt_dsp_rms.c
+ * \brief Streaming RMS, mean and peak detector bank.
+*/
+#include <stdint.h>
+#include <string.h>
+#include "arm_rt_dsp.h"
+#include "arm_rt_dsp_kernels.h"
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+
+-----------------------------------------------------------------------------*/
+void rms_bank_init_q31(rms_bank_instance_q31 *S)
+{
+  memset(S->pSumSq, 0, S->M * sizeof(acc64_t));
+  memset(S->pSum, 0, S->M * sizeof(acc64_t));
+  memset(S->pMax, 0, S->M * sizeof(uint32_t));
+  memset(S->pCount, 0, S->M * sizeof(uint32_t));
+  memset(S->pLast, 0, S->M * sizeof(q31_t));
+  memset(S->pRms, 0, S->M * sizeof(q31_t));
+  memset(S->pMean, 0, S->M * sizeof(q31_t));
+  memset(S->pPeak, 0, S->M * sizeof(q31_t));
+  memset(S->pLen, 0, S->M * sizeof(uint32_t));
+  memset(S->pSeq, 0, S->M * sizeof(uint32_t));
+}
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+Closes the open window of channel j.  The mean square is back in Q62 before the
+square root, so the RMS is a Q31.  Only an RMS of exactly full scale saturates.
+Returns 1 if a window was closed, 0 if it was empty.
+-----------------------------------------------------------------------------*/
+static uint32_t rms_bank_close(rms_bank_instance_q31 *S, uint32_t j)
+{
+  const uint32_t n = S->pCount[j];
+  uint32_t rms;
+
+  if (n == 0)
+  {
+    return 0;
+  }
+  rms = sqrt_u64((uint64_t)(S->pSumSq[j] / n) << RMS_BANK_SQ_SHIFT);
+  S->pRms[j] = (q31_t)((rms > INT32_MAX) ? INT32_MAX : rms);
+  S->pMean[j] = (q31_t)(S->pSum[j] / (int64_t)n);
+  S->pPeak[j] = (q31_t)((S->pMax[j] > INT32_MAX) ? INT32_MAX : S->pMax[j]);
+  S->pLen[j] = n;
+  S->pSeq[j]++;
+
+  S->pSumSq[j] = 0;
+  S->pSum[j] = 0;
+  S->pMax[j] = 0;
+  S->pCount[j] = 0;
+  return 1;
+}
+
+
+/*-----------------------------------------------------------------------------
+Scalar kernel.
+
+Notes:
+Channel by channel over the whole block.  A crossing is checked before the
+sample goes in, since it starts the next window, and the length after.
+-----------------------------------------------------------------------------*/
+static inline uint32_t rms_bank_step_q31(rms_bank_instance_q31 *S, const q31_t *in,
+                                         uint32_t nFrames, uint32_t m)
+{
+    const uint32_t M = S->M;
+    uint32_t closed = 0;
+
+    for (uint32_t j = m; j < M; j++) {
+        for (uint32_t t = 0; t < nFrames; t++) {
+            q31_t x = in[t * M + j];
+            if (S->zeroCross && S->pLast[j] < 0 && x >= 0 && S->pCount[j] >= S->minLen) {
+                closed += rms_bank_close(S, j);
+            }
+            uint32_t ax = (x < 0) ? 0U - (uint32_t)x : (uint32_t)x;
+            S->pSumSq[j] += ((int64_t)x * x) >> RMS_BANK_SQ_SHIFT;
+            S->pSum[j] += x;
+            S->pMax[j] = (ax > S->pMax[j]) ? ax : S->pMax[j];
+            S->pLast[j] = x;
+            if (++S->pCount[j] >= S->maxLen) {
+                closed += rms_bank_close(S, j);
+            }
+        }
+    }
+    return closed;
+}
+
+uint32_t rms_bank_q31_scalar(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    return rms_bank_step_q31(S, in, nFrames, 0);
+}
+
+
+// Closes the windows of the channels m + i for each bit i set in lanes.  The vector
+// kernels store their registers before and load them again after.
+static inline uint32_t rms_bank_close_lanes(rms_bank_instance_q31 *S, uint32_t m, uint32_t lanes) {
+    uint32_t closed = 0;
+    while (lanes != 0) {
+        closed += rms_bank_close(S, m + (uint32_t)__builtin_ctz(lanes));
+        lanes &= lanes - 1U;
+    }
+    return closed;
+}
+
+
+#ifdef RT_DSP_HAVE_X86
+/*-----------------------------------------------------------------------------
+x86 kernels.
+
+Notes:
+Four (AVX2) or eight (AVX-512) channels at a time with the state in registers
+for the whole block.  PMULDQ squares the sign extended samples, the squares are
+positive so a logical shift does.  PMAXUD on PABSD keeps |INT32_MIN| as 2^31
+like the unsigned scalar.  Window ends are rare, the registers only go back to
+memory when one of the lanes has one.
+-----------------------------------------------------------------------------*/
+RT_DSP_TARGET_AVX2
+uint32_t rms_bank_q31_avx2(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i minLen = _mm_set1_epi32((int32_t)S->minLen - 1);
+    const __m128i maxLen = _mm_set1_epi32((int32_t)S->maxLen);
+    uint32_t closed = 0;
+    uint32_t m = 0;
+
+    for (; m + 4 <= M; m += 4) {
+        __m256i sq = _mm256_loadu_si256((const __m256i *)&S->pSumSq[m]);
+        __m256i sm = _mm256_loadu_si256((const __m256i *)&S->pSum[m]);
+        __m128i mx = _mm_loadu_si128((const __m128i *)&S->pMax[m]);
+        __m128i cnt = _mm_loadu_si128((const __m128i *)&S->pCount[m]);
+        __m128i last = _mm_loadu_si128((const __m128i *)&S->pLast[m]);
+
+#define RMS_BANK_SPILL_AVX2(mask)                                                   \
+        do {                                                                        \
+            _mm256_storeu_si256((__m256i *)&S->pSumSq[m], sq);                      \
+            _mm256_storeu_si256((__m256i *)&S->pSum[m], sm);                        \
+            _mm_storeu_si128((__m128i *)&S->pMax[m], mx);                           \
+            _mm_storeu_si128((__m128i *)&S->pCount[m], cnt);                        \
+            closed += rms_bank_close_lanes(S, m, (uint32_t)(mask));                 \
+            sq = _mm256_loadu_si256((const __m256i *)&S->pSumSq[m]);                \
+            sm = _mm256_loadu_si256((const __m256i *)&S->pSum[m]);                  \
+            mx = _mm_loadu_si128((const __m128i *)&S->pMax[m]);                     \
+            cnt = _mm_loadu_si128((const __m128i *)&S->pCount[m]);                  \
+        } while (0)
+
+        for (uint32_t t = 0; t < nFrames; t++) {
+            __m128i x = _mm_loadu_si128((const __m128i *)&in[t * M + m]);
+            if (S->zeroCross) {
+                __m128i pre = _mm_andnot_si128(_mm_cmpgt_epi32(zero, x), _mm_cmpgt_epi32(zero, last));
+                pre = _mm_and_si128(pre, _mm_cmpgt_epi32(cnt, minLen));
+                int lanes = _mm_movemask_ps(_mm_castsi128_ps(pre));
+                if (lanes) {
+                    RMS_BANK_SPILL_AVX2(lanes);
+                }
+            }
+            __m256i x64 = _mm256_cvtepi32_epi64(x);
+            sq = _mm256_add_epi64(sq, _mm256_srli_epi64(_mm256_mul_epi32(x64, x64), RMS_BANK_SQ_SHIFT));
+            sm = _mm256_add_epi64(sm, x64);
+            mx = _mm_max_epu32(mx, _mm_abs_epi32(x));
+            cnt = _mm_add_epi32(cnt, one);
+            last = x;
+            int lanes = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(cnt, maxLen)));
+            if (lanes) {
+                RMS_BANK_SPILL_AVX2(lanes);
+            }
+        }
+#undef RMS_BANK_SPILL_AVX2
+
+        _mm256_storeu_si256((__m256i *)&S->pSumSq[m], sq);
+        _mm256_storeu_si256((__m256i *)&S->pSum[m], sm);
+        _mm_storeu_si128((__m128i *)&S->pMax[m], mx);
+        _mm_storeu_si128((__m128i *)&S->pCount[m], cnt);
+        _mm_storeu_si128((__m128i *)&S->pLast[m], last);
+    }
+    return closed + rms_bank_step_q31(S, in, nFrames, m);
+}
+
+RT_DSP_TARGET_AVX512
+uint32_t rms_bank_q31_avx512(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i minLen = _mm256_set1_epi32((int32_t)S->minLen - 1);
+    const __m256i maxLen = _mm256_set1_epi32((int32_t)S->maxLen);
+    uint32_t closed = 0;
+    uint32_t m = 0;
+
+    for (; m + 8 <= M; m += 8) {
+        __m512i sq = _mm512_loadu_si512((const void *)&S->pSumSq[m]);
+        __m512i sm = _mm512_loadu_si512((const void *)&S->pSum[m]);
+        __m256i mx = _mm256_loadu_si256((const __m256i *)&S->pMax[m]);
+        __m256i cnt = _mm256_loadu_si256((const __m256i *)&S->pCount[m]);
+        __m256i last = _mm256_loadu_si256((const __m256i *)&S->pLast[m]);
+
+#define RMS_BANK_SPILL_AVX512(mask)                                                 \
+        do {                                                                        \
+            _mm512_storeu_si512((void *)&S->pSumSq[m], sq);                         \
+            _mm512_storeu_si512((void *)&S->pSum[m], sm);                           \
+            _mm256_storeu_si256((__m256i *)&S->pMax[m], mx);                        \
+            _mm256_storeu_si256((__m256i *)&S->pCount[m], cnt);                     \
+            closed += rms_bank_close_lanes(S, m, (uint32_t)(mask));                 \
+            sq = _mm512_loadu_si512((const void *)&S->pSumSq[m]);                   \
+            sm = _mm512_loadu_si512((const void *)&S->pSum[m]);                     \
+            mx = _mm256_loadu_si256((const __m256i *)&S->pMax[m]);                  \
+            cnt = _mm256_loadu_si256((const __m256i *)&S->pCount[m]);               \
+        } while (0)
+
+        for (uint32_t t = 0; t < nFrames; t++) {
+            __m256i x = _mm256_loadu_si256((const __m256i *)&in[t * M + m]);
+            if (S->zeroCross) {
+                __m256i pre = _mm256_andnot_si256(_mm256_cmpgt_epi32(zero, x), _mm256_cmpgt_epi32(zero, last));
+                pre = _mm256_and_si256(pre, _mm256_cmpgt_epi32(cnt, minLen));
+                int lanes = _mm256_movemask_ps(_mm256_castsi256_ps(pre));
+                if (lanes) {
+                    RMS_BANK_SPILL_AVX512(lanes);
+                }
+            }
+            __m512i x64 = _mm512_cvtepi32_epi64(x);
+            sq = _mm512_add_epi64(sq, _mm512_srli_epi64(_mm512_mul_epi32(x64, x64), RMS_BANK_SQ_SHIFT));
+            sm = _mm512_add_epi64(sm, x64);
+            mx = _mm256_max_epu32(mx, _mm256_abs_epi32(x));
+            cnt = _mm256_add_epi32(cnt, one);
+            last = x;
+            int lanes = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(cnt, maxLen)));
+            if (lanes) {
+                RMS_BANK_SPILL_AVX512(lanes);
+            }
+        }
+#undef RMS_BANK_SPILL_AVX512
+
+        _mm512_storeu_si512((void *)&S->pSumSq[m], sq);
+        _mm512_storeu_si512((void *)&S->pSum[m], sm);
+        _mm256_storeu_si256((__m256i *)&S->pMax[m], mx);
+        _mm256_storeu_si256((__m256i *)&S->pCount[m], cnt);
+        _mm256_storeu_si256((__m256i *)&S->pLast[m], last);
+    }
+    return closed + rms_bank_step_q31(S, in, nFrames, m);
+}
+#endif // RT_DSP_HAVE_X86
+
+
+#ifdef RT_DSP_HAVE_NEON
+/*-----------------------------------------------------------------------------
+NEON kernels.
+
+Notes:
+Same layout as the AVX2 kernel, SMLAL is not used because the squares are
+shifted before they are added.
+-----------------------------------------------------------------------------*/
+static inline uint32_t rms_bank_lanes_neon(uint32x4_t mask) {
+    const uint32x4_t bit = { 1, 2, 4, 8 };
+    return vaddvq_u32(vandq_u32(mask, bit));
+}
+
+uint32_t rms_bank_q31_neon(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    const uint32_t M = S->M;
+    const uint32x4_t minLen = vdupq_n_u32(S->minLen);
+    const uint32x4_t maxLen = vdupq_n_u32(S->maxLen);
+    uint32_t closed = 0;
+    uint32_t m = 0;
+
+    for (; m + 4 <= M; m += 4) {
+        int64x2_t sql = vld1q_s64(&S->pSumSq[m]);
+        int64x2_t sqh = vld1q_s64(&S->pSumSq[m + 2]);
+        int64x2_t sml = vld1q_s64(&S->pSum[m]);
+        int64x2_t smh = vld1q_s64(&S->pSum[m + 2]);
+        uint32x4_t mx = vld1q_u32(&S->pMax[m]);
+        uint32x4_t cnt = vld1q_u32(&S->pCount[m]);
+        int32x4_t last = vld1q_s32(&S->pLast[m]);
+
+#define RMS_BANK_SPILL_NEON(mask)                                                   \
+        do {                                                                        \
+            vst1q_s64(&S->pSumSq[m], sql);                                          \
+            vst1q_s64(&S->pSumSq[m + 2], sqh);                                      \
+            vst1q_s64(&S->pSum[m], sml);                                            \
+            vst1q_s64(&S->pSum[m + 2], smh);                                        \
+            vst1q_u32(&S->pMax[m], mx);                                             \
+            vst1q_u32(&S->pCount[m], cnt);                                          \
+            closed += rms_bank_close_lanes(S, m, (mask));                           \
+            sql = vld1q_s64(&S->pSumSq[m]);                                         \
+            sqh = vld1q_s64(&S->pSumSq[m + 2]);                                     \
+            sml = vld1q_s64(&S->pSum[m]);                                           \
+            smh = vld1q_s64(&S->pSum[m + 2]);                                       \
+            mx = vld1q_u32(&S->pMax[m]);                                            \
+            cnt = vld1q_u32(&S->pCount[m]);                                         \
+        } while (0)
+
+        for (uint32_t t = 0; t < nFrames; t++) {
+            int32x4_t x = vld1q_s32(&in[t * M + m]);
+            if (S->zeroCross) {
+                uint32x4_t pre = vandq_u32(vcltzq_s32(last), vcgezq_s32(x));
+                pre = vandq_u32(pre, vcgeq_u32(cnt, minLen));
+                uint32_t lanes = rms_bank_lanes_neon(pre);
+                if (lanes) {
+                    RMS_BANK_SPILL_NEON(lanes);
+                }
+            }
+            sql = vaddq_s64(sql, vreinterpretq_s64_u64(vshrq_n_u64(
+                      vreinterpretq_u64_s64(vmull_s32(vget_low_s32(x), vget_low_s32(x))), RMS_BANK_SQ_SHIFT)));
+            sqh = vaddq_s64(sqh, vreinterpretq_s64_u64(vshrq_n_u64(
+                      vreinterpretq_u64_s64(vmull_high_s32(x, x)), RMS_BANK_SQ_SHIFT)));
+            sml = vaddw_s32(sml, vget_low_s32(x));
+            smh = vaddw_high_s32(smh, x);
+            mx = vmaxq_u32(mx, vreinterpretq_u32_s32(vabsq_s32(x)));
+            cnt = vaddq_u32(cnt, vdupq_n_u32(1));
+            last = x;
+            uint32_t lanes = rms_bank_lanes_neon(vceqq_u32(cnt, maxLen));
+            if (lanes) {
+                RMS_BANK_SPILL_NEON(lanes);
+            }
+        }
+#undef RMS_BANK_SPILL_NEON
+
+        vst1q_s64(&S->pSumSq[m], sql);
+        vst1q_s64(&S->pSumSq[m + 2], sqh);
+        vst1q_s64(&S->pSum[m], sml);
+        vst1q_s64(&S->pSum[m + 2], smh);
+        vst1q_u32(&S->pMax[m], mx);
+        vst1q_u32(&S->pCount[m], cnt);
+        vst1q_s32(&S->pLast[m], last);
+    }
+    return closed + rms_bank_step_q31(S, in, nFrames, m);
+}
+#endif // RT_DSP_HAVE_NEON
+
+
+/*-----------------------------------------------------------------------------
+History:
+
+Notes:
+The kernel is picked by the dispatch table, see arm_rt_dsp_dispatch.c.
+-----------------------------------------------------------------------------*/
+uint32_t rms_bank_q31(rms_bank_instance_q31 *S, const q31_t *in, uint32_t nFrames) {
+    return dsp_kernels.rms_bank_q31(S, in, nFrames);
+}
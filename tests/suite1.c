@@ -196,6 +196,73 @@ void test_mulsat_q31() {
     // Placeholder for additional test cases if required.
 }
 
+// Saturating Intrinsic Test Functions
+
+void test_qadd_qsub() {
+    q31_t test_data_x[] =   {1, INT32_MAX, INT32_MIN, INT32_MIN};
+    q31_t test_data_y[] =   {2, 1, -1, 1};
+    q31_t expected_add[] =  {3, INT32_MAX, INT32_MIN, INT32_MIN + 1};
+    q31_t expected_sub[] =  {-1, INT32_MAX - 1, INT32_MIN + 1, INT32_MIN};
+
+    for (size_t i = 0; i < sizeof(test_data_x) / sizeof(test_data_x[0]); i++) {
+        CU_ASSERT_EQUAL(__QADD(test_data_x[i], test_data_y[i]), expected_add[i]);
+        CU_ASSERT_EQUAL(__QSUB(test_data_x[i], test_data_y[i]), expected_sub[i]);
+    }
+    CU_ASSERT_EQUAL(__QSUB(INT32_MAX, -1), INT32_MAX);
+}
+
+void test_qadd16_qsub16() {
+    // Lanes are independent, the high lane saturates and the low lane doesn't.
+    CU_ASSERT_EQUAL(__QADD16(0x7FF00001U, 0x00200002U), 0x7FFF0003U);
+    CU_ASSERT_EQUAL(__QADD16(0x80000001U, 0xFFFF7FFFU), 0x80007FFFU);
+    CU_ASSERT_EQUAL(__QSUB16(0x80000000U, 0x00010001U), 0x8000FFFFU);
+    CU_ASSERT_EQUAL(__QSUB16(0x7FFF0000U, 0xFFFF8000U), 0x7FFF7FFFU);
+}
+
+void test_q_flag() {
+    dsp_q_flag_clear();
+    __QADD(1, 2);
+    __QSUB16(0x80000000U, 0x00010001U);  // QSUB16 doesn't set Q on ARM.
+    CU_ASSERT_EQUAL(dsp_q_flag_get(), 0);
+
+    CU_ASSERT_EQUAL(__SSAT(40000, 16), 32767);
+    CU_ASSERT_EQUAL(__SSAT(INT32_MIN, 32), INT32_MIN);
+    __QADD(INT32_MAX, 1);
+    mulsat_q31(INT32_MIN, INT32_MIN);
+    CU_ASSERT_EQUAL(dsp_q_flag_get(), 1);
+    CU_ASSERT_EQUAL(dsp_q_count_get(), 3);
+
+    dsp_q_flag_clear();
+    CU_ASSERT_EQUAL(dsp_q_flag_get(), 0);
+}
+
+// Packed Dual Q15 Test Functions
+
+void test_q15x2_arith() {
+    q15x2_t x = q15x2_pack(Q15(0.5), Q15(-0.75));
+    q15x2_t y = q15x2_pack(Q15(0.75), Q15(-0.5));
+
+    CU_ASSERT_EQUAL(q15x2_lo(x), Q15(0.5));
+    CU_ASSERT_EQUAL(q15x2_hi(x), Q15(-0.75));
+    CU_ASSERT_EQUAL(add_q15x2(x, y), q15x2_pack(INT16_MAX, INT16_MIN));
+    CU_ASSERT_EQUAL(sub_q15x2(x, y), q15x2_pack(Q15(-0.25), Q15(-0.25)));
+    CU_ASSERT_EQUAL(max_q15x2(x, y), q15x2_pack(Q15(0.75), Q15(-0.5)));
+    CU_ASSERT_EQUAL(min_q15x2(x, y), q15x2_pack(Q15(0.5), Q15(-0.75)));
+    CU_ASSERT_EQUAL(mul_q15x2(x, y), q15x2_pack(mul_q15(Q15(0.5), Q15(0.75)), mul_q15(Q15(-0.75), Q15(-0.5))));
+    CU_ASSERT_EQUAL(mulsat_q15x2(x, y), q15x2_pack(mulsat_q15(Q15(0.5), Q15(0.75)), mulsat_q15(Q15(-0.75), Q15(-0.5))));
+
+    // 0.5 * 0.75 + -0.75 * -0.5 = 0.75 in 2.30 format.
+    CU_ASSERT_EQUAL(dot_q15x2(x, y), 0x30000000);
+    CU_ASSERT_EQUAL(mac_q15x2(x, y, 1), 0x30000001);
+    CU_ASSERT_EQUAL(mac64_q15x2(x, y, INT64_C(0x100000000)), INT64_C(0x130000000));
+
+    // Only -1.0 * -1.0 twice overflows SMUAD.
+    dsp_q_flag_clear();
+    dot_q15x2(q15x2_pack(INT16_MIN, INT16_MIN), q15x2_pack(INT16_MIN, INT16_MIN));
+    CU_ASSERT_EQUAL(dsp_q_flag_get(), 1);
+    dsp_q_flag_clear();
+}
+
 // Min/Max Test Functions
 
 void test_max_q31() {
@@ -252,4 +252,353 @@ void test_check_delta_f32() {
     for(int i = 0; i < num_tests; ++i) {
         CU_ASSERT_EQUAL(check_delta_f32(input_values[i], nominal, delta), expected_results[i]);
     }
-}
\ No newline at end of file
+}
+
+// Test case: the dual ramp matches two ramp_limit_q15 ramps lane for lane.
+void test_ramp_limit_q15x2(void) {
+    ramp_limit_q15_t ramp0 = {Q15(-0.5), Q15(0.5), Q15(0.01), 0};
+    ramp_limit_q15_t ramp1 = {Q15(-1.0), Q15(0.25), Q15(0.2), 0};
+    ramp_limit_q15x2_t ramp2;
+    q15_t targets[] = {Q15(0.9), Q15(-0.9), Q15(0.1), INT16_MIN, INT16_MAX, 0};
+    int errors = 0;
+
+    ramp2.llim = q15x2_pack(ramp0.llim, ramp1.llim);
+    ramp2.ulim = q15x2_pack(ramp0.ulim, ramp1.ulim);
+    ramp2.inc = q15x2_pack(ramp0.inc, ramp1.inc);
+    ramp_limit_init_q15(Q15(0.75), &ramp0);
+    ramp_limit_init_q15(Q15(-0.1), &ramp1);
+    ramp_limit_init_q15x2(q15x2_pack(Q15(0.75), Q15(-0.1)), &ramp2);
+    CU_ASSERT_EQUAL(q15x2_lo(ramp2.y), ramp0.y);
+    CU_ASSERT_EQUAL(q15x2_hi(ramp2.y), ramp1.y);
+
+    for (int i = 0; i < 600; i++) {
+        q15_t x0 = targets[(i / 50) % 6];
+        q15_t x1 = targets[(i / 20) % 6];
+        q15x2_t y = ramp_limit_q15x2(q15x2_pack(x0, x1), &ramp2);
+        errors += q15x2_lo(y) != ramp_limit_q15(x0, &ramp0);
+        errors += q15x2_hi(y) != ramp_limit_q15(x1, &ramp1);
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+}
+
+// Test case: the block ramps match the per-sample ramps, including the cases
+// that fall back to them.
+static uint32_t ramp_test_seed;
+
+static uint32_t ramp_test_rand(void) {
+    ramp_test_seed = ramp_test_seed * 1664525U + 1013904223U;
+    return ramp_test_seed;
+}
+
+void test_ramp_block(void) {
+    q31_t out31[300];
+    int16_t out16[300];
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        ramp_test_seed = 5;
+        for (int i = 0; i < 400; i++) {
+            uint32_t n = ramp_test_rand() % 300;
+            uint32_t sh = ramp_test_rand() % 32;
+            q31_t x = (q31_t)ramp_test_rand();
+            ramp_q31_t a = { (q31_t)(ramp_test_rand() >> sh), (q31_t)ramp_test_rand() }, b;
+
+            if (i % 10 == 0) a.inc = 0;
+            if (i % 10 == 1) a.inc = -a.inc;
+            if (i % 10 == 2) a.inc = INT32_MAX;
+            b = a;
+            ramp_q31_block(x, &b, out31, n);
+            for (uint32_t k = 0; k < n; k++) {
+                errors += out31[k] != ramp_q31(x, &a);
+            }
+            errors += a.y != b.y;
+
+            int16_t lim0 = (int16_t)ramp_test_rand(), lim1 = (int16_t)ramp_test_rand();
+            ramp_limit_q15_t c = { (lim0 < lim1) ? lim0 : lim1, (lim0 < lim1) ? lim1 : lim0,
+                                   (int16_t)((ramp_test_rand() & 0x7FFF) >> (sh / 2)), 0 }, d;
+            ramp_limit_i16_t e, f;
+            int16_t x16 = (int16_t)ramp_test_rand();
+
+            ramp_limit_init_q15((q15_t)ramp_test_rand(), &c);
+            if (i % 10 == 0) c.inc = 0;
+            if (i % 10 == 1) c.inc = (int16_t)-c.inc;
+            if (i % 10 == 3) c.y = (int16_t)ramp_test_rand();
+            if (i % 10 == 4) c.llim = c.ulim + 1;
+            d = c;
+            ramp_limit_q15_block(x16, &d, out16, n);
+            for (uint32_t k = 0; k < n; k++) {
+                errors += out16[k] != ramp_limit_q15(x16, &c);
+            }
+            errors += c.y != d.y;
+
+            e = f = (ramp_limit_i16_t){ d.llim, d.ulim, d.inc, d.y };
+            ramp_limit_i16_block((int16_t)-x16, &e, out16, n);
+            for (uint32_t k = 0; k < n; k++) {
+                errors += out16[k] != ramp_limit_i16((int16_t)-x16, &f);
+            }
+            errors += e.y != f.y;
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+// Test case: the S-curve ramp keeps both limits, lands exactly on the target
+// without overshoot when started from rest, and the block form matches.
+void test_ramp_scurve_q31(void) {
+    q31_t out[500];
+    int errors = 0;
+
+    ramp_test_seed = 9;
+    for (int i = 0; i < 200; i++) {
+        ramp_scurve_q31_t a, b;
+        q31_t y0 = (q31_t)ramp_test_rand() >> 1;
+        q31_t x = (q31_t)ramp_test_rand() >> 1;
+        q31_t y, v = 0;
+        int settled = -1;
+
+        a.vmax = (q31_t)(ramp_test_rand() >> (1 + ramp_test_rand() % 20)) + 1;
+        a.amax = (q31_t)(ramp_test_rand() >> (1 + ramp_test_rand() % 26)) + 1;
+        if (i % 4 == 0) {
+            // Distances that never reach full rate, down to a few LSB.
+            x = y0 + (q31_t)(ramp_test_rand() % (uint32_t)(a.amax * 8 + 1));
+        }
+        ramp_scurve_init_q31(y0, &a);
+        b = a;
+
+        y = y0;
+        for (int k = 0; k < 500; k++) {
+            q31_t y1 = ramp_scurve_q31(x, &a);
+            q31_t v1 = y1 - y;
+
+            errors += (v1 > a.vmax || v1 < -a.vmax);
+            errors += ((int64_t)v1 - v > a.amax || (int64_t)v1 - v < -(int64_t)a.amax);
+            errors += (x >= y0) ? (y1 > x || y1 < y) : (y1 < x || y1 > y);
+            if (settled < 0 && y1 == x && v1 == 0) {
+                settled = k;
+            }
+            out[k] = y1;
+            y = y1;
+            v = v1;
+        }
+
+        // Either landed and stayed, or still on the way because the limits are small.
+        int64_t d = ((int64_t)x > y0) ? (int64_t)x - y0 : (int64_t)y0 - x;
+        if (settled >= 0) {
+            errors += a.y != x || a.v != 0;
+        } else {
+            errors += d / a.vmax + a.vmax / a.amax + 3 < 500;
+        }
+
+        ramp_scurve_q31_block(x, &b, out, 123);
+        ramp_scurve_q31_block(x, &b, &out[123], 500 - 123);
+        errors += b.y != a.y || b.v != a.v || out[499] != a.y;
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+
+    // From rest to a far target the rate goes up in steps of amax, holds vmax and
+    // comes down again.
+    ramp_scurve_q31_t r = { 100, 10, 0, 0, 0 };
+    q31_t prev = 0;
+    int accel = 0, cruise = 0, decel = 0, k;
+
+    ramp_scurve_init_q31(0, &r);
+    for (k = 0; k < 200 && r.y != 10000; k++) {
+        ramp_scurve_q31(10000, &r);
+        accel += r.v > prev;
+        cruise += r.v == 100;
+        decel += r.v < prev;
+        prev = r.v;
+    }
+    CU_ASSERT_EQUAL(r.y, 10000);
+    CU_ASSERT_EQUAL(accel, 10);
+    CU_ASSERT_EQUAL(cruise, 91);
+    CU_ASSERT_EQUAL(decel, 9);
+    CU_ASSERT_EQUAL(k, 109);
+    CU_ASSERT_EQUAL(ramp_scurve_q31(10000, &r), 10000);
+    CU_ASSERT_EQUAL(r.v, 0);
+}
+
+// Test case: the ramp bank matches one ramp_limit_q15 per channel, and the
+// remaining count is zero exactly when a channel is at its target.
+#define RAMP_BANK_TEST_SIZE 2000
+
+RAMP_LIMIT_BANK_Q15_DEFINE(test_ramp_bank, RAMP_BANK_TEST_SIZE);
+
+void test_ramp_limit_bank_q15(void) {
+    static ramp_limit_q15_t ref[RAMP_BANK_TEST_SIZE];
+    static q15_t x[RAMP_BANK_TEST_SIZE];
+    int errors = 0;
+
+    ramp_test_seed = 21;
+    for (int i = 0; i < RAMP_BANK_TEST_SIZE; i++) {
+        q15_t a = (q15_t)ramp_test_rand(), b = (q15_t)ramp_test_rand();
+        test_ramp_bank.llim[i] = (a < b) ? a : b;
+        test_ramp_bank.ulim[i] = (a < b) ? b : a;
+        test_ramp_bank.inc[i] = (q15_t)((ramp_test_rand() & 0x7FFF) >> (ramp_test_rand() % 6));
+        if (i % 97 == 0) test_ramp_bank.inc[i] = 0;
+        if (i % 101 == 0) test_ramp_bank.inc[i] = -5;
+        if (i % 103 == 0) test_ramp_bank.llim[i] = test_ramp_bank.ulim[i] + 1;
+        x[i] = (q15_t)ramp_test_rand();
+    }
+    ramp_limit_bank_init_q15(&test_ramp_bank, x);
+    for (int i = 0; i < RAMP_BANK_TEST_SIZE; i++) {
+        ref[i] = (ramp_limit_q15_t){ test_ramp_bank.llim[i], test_ramp_bank.ulim[i],
+                                     test_ramp_bank.inc[i], 0 };
+        ramp_limit_init_q15(x[i], &ref[i]);
+        errors += ref[i].y != test_ramp_bank.y[i];
+    }
+
+    for (int k = 0; k < 300; k++) {
+        uint32_t active = 0;
+
+        // A few targets move every step, sometimes all of them.
+        for (int j = 0; j < 20; j++) {
+            x[ramp_test_rand() % RAMP_BANK_TEST_SIZE] = (q15_t)ramp_test_rand();
+        }
+        if (k == 150) {
+            for (int i = 0; i < RAMP_BANK_TEST_SIZE; i++) {
+                x[i] = (q15_t)ramp_test_rand();
+            }
+        }
+        if (k % 2) {
+            ramp_limit_bank_targets_q15(&test_ramp_bank, x);
+        } else {
+            for (int i = 0; i < RAMP_BANK_TEST_SIZE; i++) {
+                ramp_limit_bank_target_q15(&test_ramp_bank, (uint32_t)i, x[i]);
+            }
+        }
+        // One channel whose limits change under it.
+        if (k == 40) {
+            test_ramp_bank.llim[1] = ref[1].llim = ref[1].y + 1;
+            test_ramp_bank.ulim[1] = ref[1].ulim = INT16_MAX;
+            ramp_limit_bank_target_q15(&test_ramp_bank, 1, x[1]);
+        }
+
+        uint32_t n = ramp_limit_bank_q15(&test_ramp_bank);
+        for (int i = 0; i < RAMP_BANK_TEST_SIZE; i++) {
+            q15_t lo = ref[i].llim, hi = ref[i].ulim;
+            uint32_t rem = ramp_limit_bank_remaining_q15(&test_ramp_bank, (uint32_t)i);
+
+            errors += ramp_limit_q15(x[i], &ref[i]) != test_ramp_bank.y[i];
+            active += (test_ramp_bank.active[i / 64] >> (i % 64)) & 1U;
+            if (ref[i].inc > 0 && lo <= hi) {
+                q15_t t = (x[i] < lo) ? lo : (x[i] > hi) ? hi : x[i];
+                errors += (rem == 0) != (ref[i].y == t);
+            }
+        }
+        errors += n != active || n != test_ramp_bank.nActive;
+        if (k == 299) {
+            // Most of the bank has settled by now.
+            CU_ASSERT(n < RAMP_BANK_TEST_SIZE / 10);
+        }
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+}
+
+// Test case: the hysteresis banks match one hysteresis_threshold per channel,
+// and the changed bits and count are exactly the edges.
+#define HYST_BANK_TEST_SIZE 4005
+
+HYSTERESIS_BANK_DEFINE(test_hyst_bank, HYST_BANK_TEST_SIZE);
+HYSTERESIS_BANK_I16_DEFINE(test_hyst_bank_i16, HYST_BANK_TEST_SIZE);
+
+void test_hysteresis_bank(void) {
+    static hysteresis_thresh_t ref[HYST_BANK_TEST_SIZE];
+    static hysteresis_thresh_i16_t ref16[HYST_BANK_TEST_SIZE];
+    static q31_t val[HYST_BANK_TEST_SIZE];
+    static int16_t val16[HYST_BANK_TEST_SIZE];
+    static uint64_t changed[(HYST_BANK_TEST_SIZE + 63) / 64], changed16[(HYST_BANK_TEST_SIZE + 63) / 64];
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        ramp_test_seed = 99;
+        for (int i = 0; i < HYST_BANK_TEST_SIZE; i++) {
+            q31_t a = (q31_t)ramp_test_rand(), b = (q31_t)ramp_test_rand();
+            q31_t lo = (a < b) ? a : b, hi = (a < b) ? b : a;
+            // Some channels have the thresholds the wrong way round, on still wins.
+            if (i % 13 == 0) {
+                hysteresis_init(hi, lo, &ref[i]);
+            } else {
+                hysteresis_init(lo, hi, &ref[i]);
+            }
+            hysteresis_init_i16((int16_t)(ref[i].hyst_off >> 16), (int16_t)(ref[i].hyst_on >> 16), &ref16[i]);
+            test_hyst_bank.hyst_on[i] = ref[i].hyst_on;
+            test_hyst_bank.hyst_off[i] = ref[i].hyst_off;
+            test_hyst_bank_i16.hyst_on[i] = ref16[i].hyst_on;
+            test_hyst_bank_i16.hyst_off[i] = ref16[i].hyst_off;
+        }
+        hysteresis_bank_init(&test_hyst_bank);
+        hysteresis_bank_init_i16(&test_hyst_bank_i16);
+
+        for (int k = 0; k < 50; k++) {
+            uint32_t edges = 0, edges16 = 0;
+
+            for (int i = 0; i < HYST_BANK_TEST_SIZE; i++) {
+                val[i] = (q31_t)ramp_test_rand();
+                // Values on the thresholds keep their state.
+                if (i % 7 == 0 && k % 3 != 0) val[i] = (k % 3 == 1) ? ref[i].hyst_on : ref[i].hyst_off;
+                val16[i] = (int16_t)(val[i] >> 16);
+            }
+            uint32_t n = hysteresis_bank(&test_hyst_bank, val, changed);
+            uint32_t n16 = hysteresis_bank_i16(&test_hyst_bank_i16, val16, changed16);
+            for (int i = 0; i < HYST_BANK_TEST_SIZE; i++) {
+                int32_t before = ref[i].out_state, before16 = ref16[i].out_state;
+                int32_t s = hysteresis_threshold(val[i], &ref[i]);
+                int32_t s16 = hysteresis_threshold_i16(val16[i], &ref16[i]);
+
+                errors += hysteresis_bank_state(test_hyst_bank.state, (uint32_t)i) != s;
+                errors += hysteresis_bank_state(test_hyst_bank_i16.state, (uint32_t)i) != s16;
+                errors += (int32_t)((changed[i / 64] >> (i % 64)) & 1) != (s != before);
+                errors += (int32_t)((changed16[i / 64] >> (i % 64)) & 1) != (s16 != before16);
+                edges += s != before;
+                edges16 += s16 != before16;
+            }
+            errors += n != edges || n16 != edges16;
+            // Nothing past the last channel.
+            errors += (test_hyst_bank.state[HYST_BANK_TEST_SIZE / 64] >> (HYST_BANK_TEST_SIZE % 64)) != 0;
+            errors += (changed16[HYST_BANK_TEST_SIZE / 64] >> (HYST_BANK_TEST_SIZE % 64)) != 0;
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+// Test case: a zero increment channel outside its limits is clamped by one step
+// and then leaves the active set.
+RAMP_LIMIT_BANK_Q15_DEFINE(test_ramp_bank_stuck, 3);
+
+void test_ramp_limit_bank_stuck_q15(void) {
+    ramp_limit_q15_t ref = { -1000, 1000, 0, 0 };
+    q15_t y0[3] = { 500, 0, -500 };
+
+    for (int i = 0; i < 3; i++) {
+        test_ramp_bank_stuck.llim[i] = -1000;
+        test_ramp_bank_stuck.ulim[i] = 1000;
+        test_ramp_bank_stuck.inc[i] = 0;
+    }
+    ramp_limit_bank_init_q15(&test_ramp_bank_stuck, y0);
+    CU_ASSERT_EQUAL(test_ramp_bank_stuck.nActive, 0);
+
+    // The limits move below the output, which is stuck short of the new target.
+    test_ramp_bank_stuck.ulim[0] = ref.ulim = 200;
+    ref.y = 500;
+    ramp_limit_bank_target_q15(&test_ramp_bank_stuck, 0, 0);
+    CU_ASSERT_EQUAL(test_ramp_bank_stuck.nActive, 1);
+    CU_ASSERT_EQUAL(ramp_limit_bank_remaining_q15(&test_ramp_bank_stuck, 0), 1);
+
+    CU_ASSERT_EQUAL(ramp_limit_bank_q15(&test_ramp_bank_stuck), 0);
+    CU_ASSERT_EQUAL(test_ramp_bank_stuck.nActive, 0);
+    CU_ASSERT_EQUAL(test_ramp_bank_stuck.active[0], 0);
+    CU_ASSERT_EQUAL(test_ramp_bank_stuck.y[0], ramp_limit_q15(0, &ref));
+    CU_ASSERT_EQUAL(ramp_limit_bank_remaining_q15(&test_ramp_bank_stuck, 0), 0);
+
+    // Settled for good, the per-sample ramp does not move either.
+    ramp_limit_bank_q15(&test_ramp_bank_stuck);
+    CU_ASSERT_EQUAL(test_ramp_bank_stuck.y[0], ramp_limit_q15(0, &ref));
+    CU_ASSERT_EQUAL(test_ramp_bank_stuck.y[0], 200);
+}
@@ -68,4 +68,273 @@ void test_adc_process_sample_i16_q31() {
         //printf("raw_value: %d, offset: %d, slope: %d, result: %d\n", raw_value[i], offset[i], slope[i], r);
         CU_ASSERT_EQUAL(r, expected[i]);
     }
-}
\ No newline at end of file
+}
+void test_adc_process_block() {
+    // Odd scan counts so the vector kernels run their scalar tails.
+    static const uint32_t channels[] = { 1, 2, 3, 4, 7, 16 };
+    static const uint32_t scans[] = { 1, 9, 33, 101 };
+    static uint16_t raw[16 * 101];
+    static q15_t out15[16 * 101];
+    static q31_t out31[16 * 101];
+    ADC_CAL_TABLE_Q15_DEFINE(cal15, 16);
+    ADC_CAL_TABLE_Q31_DEFINE(cal31, 16);
+    uint32_t seed = 99;
+
+    for (uint32_t i = 0; i < 16 * 101; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        raw[i] = (i % 5 == 0) ? (uint16_t)(seed >> 16) : (uint16_t)((seed >> 16) & 0xFFF);
+    }
+    for (uint32_t c = 0; c < 16; c++) {
+        seed = seed * 1664525U + 1013904223U;
+        cal15.pOffset[c] = cal31.pOffset[c] = (int16_t)(2048 + (int32_t)(seed >> 24) - 128);
+        cal15.pSlope[c] = (q15_t)(seed >> 8);
+        cal31.pSlope[c] = (q31_t)(seed * 2654435761U);
+    }
+    // The saturating corner, -1.0 * -1.0.
+    raw[0] = 0;
+    cal15.pOffset[0] = cal31.pOffset[0] = 2048;
+    cal15.pSlope[0] = INT16_MIN;
+    cal31.pSlope[0] = INT32_MIN;
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        for (int m = 0; m < 6; m++) {
+            for (int k = 0; k < 4; k++) {
+                uint32_t M = channels[m], n = scans[k];
+                cal15.M = cal31.M = M;
+
+                adc_process_block_q15(&cal15, raw, n, out15);
+                for (uint32_t c = 0; c < M; c++) {
+                    for (uint32_t s = 0; s < n; s++) {
+                        errors += out15[c * n + s] != adc_process_sample_q15(raw[s * M + c], cal15.pOffset[c], cal15.pSlope[c]);
+                    }
+                }
+                adc_process_block_q31(&cal31, raw, n, out31);
+                for (uint32_t c = 0; c < M; c++) {
+                    for (uint32_t s = 0; s < n; s++) {
+                        errors += out31[c * n + s] != adc_process_sample_q31(raw[s * M + c], cal31.pOffset[c], cal31.pSlope[c]);
+                    }
+                }
+                adc_process_block_u_q31(&cal31, raw, n, out31);
+                for (uint32_t c = 0; c < M; c++) {
+                    for (uint32_t s = 0; s < n; s++) {
+                        errors += out31[c * n + s] != adc_process_sample_u_q31(raw[s * M + c], cal31.pOffset[c], cal31.pSlope[c]);
+                    }
+                }
+                adc_process_block_i16_q31(&cal31, (const int16_t *)raw, n, out31);
+                for (uint32_t c = 0; c < M; c++) {
+                    for (uint32_t s = 0; s < n; s++) {
+                        errors += out31[c * n + s] != adc_process_sample_i16_q31((int16_t)raw[s * M + c], cal31.pOffset[c], cal31.pSlope[c]);
+                    }
+                }
+            }
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+// Checks the generated scalar conversions against the count based formula and the
+// block forms against the scalar ones.
+#define ADC_WIDTH_TEST(BITS, J, LEFT) do { \
+        for (uint32_t i = 0; i < 4 * 67; i++) { \
+            uint32_t c = i % 4; \
+            uint32_t cnt = (LEFT) ? raw[i] >> (16 - (BITS)) : raw[i]; \
+            uint32_t d = cnt - (uint32_t)(q31_t)cal15.pOffset[c]; \
+            errors += adc_process_sample_q15_##BITS##J(raw[i], cal15.pOffset[c], cal15.pSlope[c]) != \
+                      mulsat_q15((q15_t)(d << (16 - (BITS))), cal15.pSlope[c]); \
+            errors += adc_process_sample_q31_##BITS##J(raw[i], cal31.pOffset[c], cal31.pSlope[c]) != \
+                      mulsat_q31((q31_t)(d << (32 - (BITS))), cal31.pSlope[c]); \
+            errors += adc_process_sample_u_q31_##BITS##J(raw[i], cal31.pOffset[c], cal31.pSlope[c]) != \
+                      mulsat_q31((q31_t)(d << (31 - (BITS))), cal31.pSlope[c]); \
+        } \
+        adc_process_block_q15_##BITS##J(&cal15, raw, 67, out15); \
+        adc_process_block_q31_##BITS##J(&cal31, raw, 67, out31); \
+        adc_process_block_u_q31_##BITS##J(&cal31, raw, 67, out31u); \
+        for (uint32_t c = 0; c < 4; c++) { \
+            for (uint32_t s = 0; s < 67; s++) { \
+                uint16_t x = raw[s * 4 + c]; \
+                errors += out15[c * 67 + s] != adc_process_sample_q15_##BITS##J(x, cal15.pOffset[c], cal15.pSlope[c]); \
+                errors += out31[c * 67 + s] != adc_process_sample_q31_##BITS##J(x, cal31.pOffset[c], cal31.pSlope[c]); \
+                errors += out31u[c * 67 + s] != adc_process_sample_u_q31_##BITS##J(x, cal31.pOffset[c], cal31.pSlope[c]); \
+            } \
+        } \
+    } while (0)
+
+void test_adc_conversion_widths() {
+    static uint16_t raw[4 * 67];
+    static q15_t out15[4 * 67];
+    static q31_t out31[4 * 67], out31u[4 * 67];
+    ADC_CAL_TABLE_Q15_DEFINE(cal15, 4);
+    ADC_CAL_TABLE_Q31_DEFINE(cal31, 4);
+    uint32_t seed = 4242;
+
+    for (uint32_t i = 0; i < 4 * 67; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        raw[i] = (uint16_t)(seed >> 16);
+    }
+    for (uint32_t c = 0; c < 4; c++) {
+        seed = seed * 1664525U + 1013904223U;
+        cal15.pOffset[c] = cal31.pOffset[c] = (int16_t)((seed >> 20) - 2048);
+        cal15.pSlope[c] = (q15_t)(seed >> 8);
+        cal31.pSlope[c] = (q31_t)(seed * 2654435761U);
+    }
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        ADC_WIDTH_TEST(10, r, 0);
+        ADC_WIDTH_TEST(10, l, 1);
+        ADC_WIDTH_TEST(12, r, 0);
+        ADC_WIDTH_TEST(12, l, 1);
+        ADC_WIDTH_TEST(14, r, 0);
+        ADC_WIDTH_TEST(14, l, 1);
+        ADC_WIDTH_TEST(16, r, 0);
+        ADC_WIDTH_TEST(16, l, 1);
+
+        // The 12-bit right justified routines are the original ones.
+        for (uint32_t i = 0; i < 4 * 67; i++) {
+            uint16_t x = raw[i] & 0xFFF;
+            errors += adc_process_sample_q15_12r(x, 2048, cal15.pSlope[0]) != adc_process_sample_q15(x, 2048, cal15.pSlope[0]);
+            errors += adc_process_sample_q31_12r(x, 2048, cal31.pSlope[0]) != adc_process_sample_q31(x, 2048, cal31.pSlope[0]);
+            errors += adc_process_sample_u_q31_12r(x, 0, cal31.pSlope[0]) != adc_process_sample_u_q31(x, 0, cal31.pSlope[0]);
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+void test_convert_recip() {
+    static uint16_t xu[203];
+    static int16_t xs[203];
+    static int32_t xi[203];
+    static q31_t out[203];
+    int32_t scales[16] = {1, -1, 2, 3, -7, 1000, -1000, 4095, 65535, 65536, 1000003,
+                          INT32_MAX, INT32_MIN, INT32_MIN + 1};
+    uint32_t seed = 777;
+
+    for (uint32_t k = 14; k < 16; k++) {
+        seed = seed * 1664525U + 1013904223U;
+        scales[k] = (int32_t)seed | 1;
+    }
+    for (uint32_t i = 0; i < 203; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        xu[i] = (uint16_t)(seed >> 16);
+        xs[i] = (int16_t)(seed >> 8);
+        xi[i] = (int32_t)(seed * 2654435761U);
+    }
+    xu[0] = 0; xu[1] = UINT16_MAX;
+    xs[0] = INT16_MIN; xs[1] = INT16_MAX; xs[2] = -1;
+    xi[0] = INT32_MIN; xi[1] = INT32_MAX; xi[2] = -1; xi[3] = 0;
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        for (uint32_t k = 0; k < 16; k++) {
+            convert_recip_t R;
+            convert_recip_init(scales[k], &R);
+            for (uint32_t n = 195; n <= 203; n += 8) {
+                convert_u16_to_q31_block(xu, &R, out, n);
+                for (uint32_t i = 0; i < n; i++) {
+                    errors += out[i] != convert_u16_to_q31(xu[i], scales[k]);
+                    errors += convert_u16_to_q31_recip(xu[i], &R) != convert_u16_to_q31(xu[i], scales[k]);
+                }
+                convert_i16_to_q31_block(xs, &R, out, n);
+                for (uint32_t i = 0; i < n; i++) {
+                    errors += out[i] != convert_i16_to_q31(xs[i], scales[k]);
+                }
+                convert_i32_to_q31_block(xi, &R, out, n);
+                for (uint32_t i = 0; i < n; i++) {
+                    errors += out[i] != convert_i32_to_q31(xi[i], scales[k]);
+                    errors += convert_i32_to_q31_recip(xi[i], &R) != convert_i32_to_q31(xi[i], scales[k]);
+                }
+            }
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+static int64_t convert_q31_ref(q31_t x, uint32_t scale, convert_round_t mode, int64_t lo, int64_t hi) {
+    int64_t p = (int64_t)x * scale;
+    int64_t v = p >> 31;
+    int64_t f = p & 0x7FFFFFFF;
+    if (mode == CONVERT_ROUND_HALF_UP && f >= 0x40000000) v++;
+    if (mode == CONVERT_ROUND_HALF_EVEN && (f > 0x40000000 || (f == 0x40000000 && (v & 1)))) v++;
+    return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+void test_convert_q31_block() {
+    static q31_t x[203];
+    static uint32_t scale[203];
+    static int16_t o16[203];
+    static uint16_t ou16[203];
+    static uint32_t ou32[203];
+    static int32_t o32[203];
+    uint32_t seed = 31337;
+
+    for (uint32_t i = 0; i < 203; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        x[i] = (q31_t)((seed >> 16) | (seed << 16));
+        seed = seed * 1664525U + 1013904223U;
+        // Mostly telemetry sized scales, some large enough to saturate.
+        scale[i] = (i % 4 == 3) ? seed : (seed >> 14);
+    }
+    x[0] = INT32_MIN; scale[0] = UINT32_MAX;
+    x[1] = INT32_MAX; scale[1] = UINT32_MAX;
+    x[2] = Q31(0.5); scale[2] = 1;      // Exactly one half.
+    x[3] = Q31(0.5); scale[3] = 3;      // 1.5
+    x[4] = Q31(-0.5); scale[4] = 5;     // -2.5
+    x[5] = -1; scale[5] = 1;
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        for (convert_round_t mode = CONVERT_TRUNC; mode <= CONVERT_ROUND_HALF_EVEN; mode++) {
+            for (uint32_t n = 195; n <= 203; n += 8) {
+                convert_q31_to_i16_block(x, scale, mode, o16, n);
+                convert_q31_to_u16_block(x, scale, mode, ou16, n);
+                convert_q31_to_u32_block(x, scale, mode, ou32, n);
+                convert_q31_to_i32_block(x, scale, mode, o32, n);
+                for (uint32_t i = 0; i < n; i++) {
+                    errors += o16[i] != convert_q31_ref(x[i], scale[i], mode, INT16_MIN, INT16_MAX);
+                    errors += ou16[i] != convert_q31_ref(x[i], scale[i], mode, 0, UINT16_MAX);
+                    errors += ou32[i] != convert_q31_ref(x[i], scale[i], mode, 0, UINT32_MAX);
+                    errors += o32[i] != convert_q31_ref(x[i], scale[i], mode, INT32_MIN, INT32_MAX);
+                }
+            }
+        }
+
+        // The existing per value conversions where they do not wrap.
+        convert_q31_to_i16_block(x, scale, CONVERT_TRUNC, o16, 203);
+        convert_q31_to_i32_block(x, scale, CONVERT_ROUND_HALF_UP, o32, 203);
+        for (uint32_t i = 0; i < 203; i++) {
+            if (o16[i] != INT16_MIN && o16[i] != INT16_MAX) {
+                errors += o16[i] != convert_q31_to_i16(x[i], scale[i]);
+            }
+            if (o32[i] != INT32_MIN && o32[i] != INT32_MAX) {
+                errors += o32[i] != convert_round_q31_to_i32(x[i], scale[i]);
+            }
+        }
+
+        convert_q31_to_i32_block(x, scale, CONVERT_ROUND_HALF_EVEN, o32, 6);
+        errors += o32[2] != 0;
+        errors += o32[3] != 2;
+        errors += o32[4] != -2;
+        errors += o32[0] != INT32_MIN;
+        errors += o32[1] != INT32_MAX;
+        convert_q31_to_i32_block(x, scale, CONVERT_ROUND_HALF_UP, o32, 6);
+        errors += o32[2] != 1;
+        errors += o32[4] != -2;
+        convert_q31_to_i32_block(x, scale, CONVERT_TRUNC, o32, 6);
+        errors += o32[4] != -3;
+        errors += o32[5] != -1;
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
@@ -156,4 +156,35 @@ void test_sequence_iir_pi_q31(void)
     {
         CU_PASS("Test sequence written to file successfully");
     }
-}
\ No newline at end of file
+}
+
+void test_iir_pi_q15x2(void)
+{
+    iir_pi_instance_q15 pi0;
+    iir_pi_instance_q15 pi1;
+    iir_pi_instance_q15x2 pi2;
+    int errors = 0;
+
+    // Different gains on each lane, large enough that the outputs saturate.
+    pi0.Kp = ACC16(0.25);
+    pi0.Ki = ACC16(0.1);
+    pi1.Kp = ACC16(3.5);
+    pi1.Ki = ACC16(0.75);
+    iir_pi_init_q15(&pi0, 1);
+    iir_pi_init_q15(&pi1, 1);
+    pi2.Kp = q15x2_pack(pi0.Kp, pi1.Kp);
+    pi2.Ki = q15x2_pack(pi0.Ki, pi1.Ki);
+    iir_pi_init_q15x2(&pi2, 1);
+
+    uint32_t seed = 1;
+    for (int i = 0; i < TEST_SEQUENCE_LENGTH * 10; i++)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        q15_t in0 = (q15_t)(seed >> 16);
+        q15_t in1 = (q15_t)seed >> 2;
+        q15x2_t out = iir_pi_q15x2(&pi2, q15x2_pack(in0, in1));
+        errors += q15x2_lo(out) != iir_pi_q15(&pi0, in0);
+        errors += q15x2_hi(out) != iir_pi_q15(&pi1, in1);
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+}
@@ -0,0 +1,360 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include "common.h"
+#include "arm_rt_dsp.h"
+
+// Odd length so the vector kernels also run their scalar tail.
+#define BLOCK_TEST_LENGTH 4103
+
+static q15_t block_x_q15[BLOCK_TEST_LENGTH];
+static q15_t block_y_q15[BLOCK_TEST_LENGTH];
+static q15_t block_out_q15[BLOCK_TEST_LENGTH];
+static q31_t block_x_q31[BLOCK_TEST_LENGTH];
+static q31_t block_y_q31[BLOCK_TEST_LENGTH];
+static q31_t block_out_q31[BLOCK_TEST_LENGTH];
+
+// Fills the test arrays with pseudo random data and the corner cases at the front.
+static void block_test_fill(void) {
+    uint32_t seed = 12345;
+    for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        block_x_q31[i] = (q31_t)seed;
+        block_x_q15[i] = (q15_t)(seed >> 16);
+        seed = seed * 1664525U + 1013904223U;
+        block_y_q31[i] = (q31_t)seed;
+        block_y_q15[i] = (q15_t)(seed >> 16);
+    }
+    block_x_q15[0] = INT16_MIN; block_y_q15[0] = INT16_MIN;
+    block_x_q15[1] = INT16_MAX; block_y_q15[1] = INT16_MIN;
+    block_x_q15[2] = INT16_MIN; block_y_q15[2] = 0;
+    block_x_q31[0] = INT32_MIN; block_y_q31[0] = INT32_MIN;
+    block_x_q31[1] = INT32_MAX; block_y_q31[1] = INT32_MIN;
+    block_x_q31[2] = INT32_MIN; block_y_q31[2] = 0;
+}
+
+// The block tests run once for every kernel level the CPU supports.
+void test_mul_q15_block() {
+    block_test_fill();
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+        mul_q15_block(block_x_q15, block_y_q15, block_out_q15, BLOCK_TEST_LENGTH);
+        for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+            errors += block_out_q15[i] != mul_q15(block_x_q15[i], block_y_q15[i]);
+        }
+        mulsat_q15_block(block_x_q15, block_y_q15, block_out_q15, BLOCK_TEST_LENGTH);
+        for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+            errors += block_out_q15[i] != mulsat_q15(block_x_q15[i], block_y_q15[i]);
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+void test_mul_q31_block() {
+    block_test_fill();
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+        mul_q31_block(block_x_q31, block_y_q31, block_out_q31, BLOCK_TEST_LENGTH);
+        for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+            errors += block_out_q31[i] != mul_q31(block_x_q31[i], block_y_q31[i]);
+        }
+        mulsat_q31_block(block_x_q31, block_y_q31, block_out_q31, BLOCK_TEST_LENGTH);
+        for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+            errors += block_out_q31[i] != mulsat_q31(block_x_q31[i], block_y_q31[i]);
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+void test_abs_sat_block() {
+    block_test_fill();
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+        abs_sat_q15_block(block_x_q15, block_out_q15, BLOCK_TEST_LENGTH);
+        abs_sat_q31_block(block_x_q31, block_out_q31, BLOCK_TEST_LENGTH);
+        for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+            errors += block_out_q15[i] != abs_sat_q15(block_x_q15[i]);
+            errors += block_out_q31[i] != abs_sat_q31(block_x_q31[i]);
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+// One vector of the widest Q15 kernel and a tail, every element saturates.
+#define Q_FLAG_TEST_LENGTH 37
+
+IIR_PI_BANK_Q31_DEFINE(q_flag_bank_q31, Q_FLAG_TEST_LENGTH);
+IIR_PI_BANK_Q15_DEFINE(q_flag_bank_q15, Q_FLAG_TEST_LENGTH);
+
+// Counts a miss unless the last call counted exactly n saturations, then clears the flag.
+static int q_flag_check(uint32_t n) {
+    int miss = dsp_q_flag_get() != 1 || dsp_q_count_get() != n;
+    dsp_q_flag_clear();
+    return miss;
+}
+
+void test_q_flag_block() {
+    static q15_t x15[Q_FLAG_TEST_LENGTH], out15[Q_FLAG_TEST_LENGTH];
+    static q31_t x31[Q_FLAG_TEST_LENGTH], out31[Q_FLAG_TEST_LENGTH];
+    static uint16_t raw[Q_FLAG_TEST_LENGTH];
+    ADC_CAL_TABLE_Q15_DEFINE(cal15, 1);
+    ADC_CAL_TABLE_Q31_DEFINE(cal31, 1);
+    const uint32_t n = Q_FLAG_TEST_LENGTH;
+
+    // raw 0 less the mid-rail offset is -1.0, times a -1.0 slope.
+    cal15.pOffset[0] = cal31.pOffset[0] = 2048;
+    cal15.pSlope[0] = INT16_MIN;
+    cal31.pSlope[0] = INT32_MIN;
+    for (uint32_t i = 0; i < n; i++) {
+        x15[i] = INT16_MIN;
+        x31[i] = INT32_MIN;
+        raw[i] = 0;
+        q_flag_bank_q31.Kp[i] = 0;
+        q_flag_bank_q31.Ki[i] = INT32_MAX;
+        q_flag_bank_q15.Kp[i] = 0;
+        q_flag_bank_q15.Ki[i] = INT16_MAX;
+    }
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+        dsp_q_flag_clear();
+
+        mulsat_q15_block(x15, x15, out15, n);
+        errors += q_flag_check(n);
+        mulsat_q31_block(x31, x31, out31, n);
+        errors += q_flag_check(n);
+        abs_sat_q15_block(x15, out15, n);
+        errors += q_flag_check(n);
+        abs_sat_q31_block(x31, out31, n);
+        errors += q_flag_check(n);
+
+        // The largest gain on the largest input overflows every controller in one step.
+        iir_pi_bank_init_q31(&q_flag_bank_q31, 1);
+        iir_pi_bank_init_q15(&q_flag_bank_q15, 1);
+        for (uint32_t i = 0; i < n; i++) {
+            out31[i] = INT32_MAX;
+            out15[i] = INT16_MAX;
+        }
+        iir_pi_bank_q31(&q_flag_bank_q31, out31, out31);
+        errors += q_flag_check(n);
+        iir_pi_bank_q15(&q_flag_bank_q15, out15, out15);
+        errors += q_flag_check(n);
+
+        adc_process_block_q15(&cal15, raw, n, out15);
+        errors += q_flag_check(n);
+        adc_process_block_q31(&cal31, raw, n, out31);
+        errors += q_flag_check(n);
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+void test_dispatch_set_isa() {
+    // Scalar is always available and the name round trips.
+    CU_ASSERT_EQUAL(dsp_dispatch_set_isa(DSP_ISA_SCALAR), DSP_ISA_SCALAR);
+    CU_ASSERT_EQUAL(dsp_kernels.isa, DSP_ISA_SCALAR);
+    CU_ASSERT_EQUAL(dsp_isa_from_name(dsp_isa_name(DSP_ISA_AVX2)), DSP_ISA_AVX2);
+    CU_ASSERT_EQUAL(dsp_isa_from_name("mmx"), DSP_ISA_COUNT);
+
+    // An unsupported level falls back to one that is supported.
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        dsp_isa_t bound = dsp_dispatch_set_isa(isa);
+        CU_ASSERT(dsp_isa_supported(bound));
+        CU_ASSERT_EQUAL(bound == isa, dsp_isa_supported(isa));
+    }
+    dsp_dispatch_init();
+}
+
+void test_limit_block() {
+    static float fx[BLOCK_TEST_LENGTH], fout[BLOCK_TEST_LENGTH];
+    static uint16_t ux[BLOCK_TEST_LENGTH], uout[BLOCK_TEST_LENGTH];
+    // The last pair is out of order, the lower limit wins like in the scalar functions.
+    static const q31_t lim31[][2] = { { -(1 << 28), 1 << 29 }, { INT32_MIN, INT32_MAX }, { 5, -5 } };
+    static const int16_t lim16[][2] = { { -9000, 20000 }, { INT16_MIN, INT16_MAX }, { 5, -5 } };
+
+    block_test_fill();
+    for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+        fx[i] = (float)block_y_q31[i] / 2147483648.0f;
+        ux[i] = (uint16_t)block_y_q15[i];
+    }
+    fx[3] = __builtin_nanf("");
+    fx[4] = -0.0f;
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        for (int k = 0; k < 3; k++) {
+            q31_t l31 = lim31[k][0], u31 = lim31[k][1];
+            int16_t l16 = lim16[k][0], u16 = lim16[k][1];
+            float lf = (float)l31 / 2147483648.0f, uf = (float)u31 / 2147483648.0f;
+            uint32_t ref[8] = { 0 }, cnt[8] = { 0 };
+
+            for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+                q31_t t31 = upper_limit_q31(block_x_q31[i], u31);
+                int16_t t16 = (block_x_q15[i] > u16) ? u16 : block_x_q15[i];
+                uint16_t tu = (ux[i] > (uint16_t)u16) ? (uint16_t)u16 : ux[i];
+                float tf = (fx[i] > uf) ? uf : fx[i];
+                ref[0] += block_x_q31[i] > u31;
+                ref[1] += t31 < l31;
+                ref[2] += block_x_q15[i] > u16;
+                ref[3] += t16 < l16;
+                ref[4] += ux[i] > (uint16_t)u16;
+                ref[5] += tu < (uint16_t)l16;
+                ref[6] += fx[i] > uf;
+                ref[7] += tf < lf;
+            }
+
+            limit_q31_block(block_x_q31, l31, u31, block_out_q31, BLOCK_TEST_LENGTH, &cnt[0], &cnt[1]);
+            limit_i16_block(block_x_q15, l16, u16, block_out_q15, BLOCK_TEST_LENGTH, &cnt[2], &cnt[3]);
+            limit_u16_block(ux, (uint16_t)l16, (uint16_t)u16, uout, BLOCK_TEST_LENGTH, &cnt[4], &cnt[5]);
+            limit_f32_block(fx, lf, uf, fout, BLOCK_TEST_LENGTH, &cnt[6], &cnt[7]);
+            for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+                float f = limit_f32(fx[i], lf, uf);
+                errors += block_out_q31[i] != limit_q31(block_x_q31[i], l31, u31);
+                errors += block_out_q15[i] != limit_i16(block_x_q15[i], l16, u16);
+                errors += uout[i] != limit_u16(ux[i], (uint16_t)l16, (uint16_t)u16);
+                errors += memcmp(&fout[i], &f, sizeof(f)) != 0;
+            }
+            errors += memcmp(cnt, ref, sizeof(ref)) != 0;
+
+            // In place, and the one sided limits.
+            memcpy(block_y_q31, block_x_q31, sizeof(block_y_q31));
+            upper_limit_q31_block(block_y_q31, u31, block_y_q31, BLOCK_TEST_LENGTH, &cnt[0]);
+            lower_limit_q31_block(block_y_q31, l31, block_y_q31, BLOCK_TEST_LENGTH, &cnt[1]);
+            limit_q31_block(block_x_q31, l31, u31, block_out_q31, BLOCK_TEST_LENGTH, NULL, NULL);
+            for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+                errors += block_y_q31[i] != lower_limit_q31(upper_limit_q31(block_x_q31[i], u31), l31);
+            }
+            errors += cnt[0] != ref[0] || cnt[1] != ref[1];
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+// Long enough that the 16-bit kernels merge and widen more than once.
+#define REDUCE_TEST_LENGTH ((1 << 21) + 77)
+
+static uint16_t reduce_u16[REDUCE_TEST_LENGTH];
+
+// First index of the min and max, the reference for the minmax functions.
+#define REDUCE_TEST_REF(x, n, r) do { \
+        (r).argmin = 0; (r).argmax = 0; \
+        for (uint32_t k = 0; k < (n); k++) { \
+            if ((x)[k] < (x)[(r).argmin]) (r).argmin = k; \
+            if ((x)[k] > (x)[(r).argmax]) (r).argmax = k; \
+        } \
+        (r).min = (n) ? (x)[(r).argmin] : 0; \
+        (r).max = (n) ? (x)[(r).argmax] : 0; \
+    } while (0)
+
+// Random values inside (lo, hi), the extremes only where planted.
+static void reduce_test_fill(uint16_t lo, uint16_t hi) {
+    uint32_t seed = 777;
+    for (uint32_t k = 0; k < REDUCE_TEST_LENGTH; k++) {
+        seed = seed * 1664525U + 1013904223U;
+        reduce_u16[k] = (uint16_t)(lo + 1 + (seed >> 16) % (uint32_t)(hi - lo - 1));
+    }
+}
+
+void test_reduce_block() {
+    static const uint32_t lengths[] = { 0, 1, 7, 37, 700, BLOCK_TEST_LENGTH };
+    const int16_t *s16 = (const int16_t *)reduce_u16;
+    minmax_result_t r, ref;
+    uint32_t a;
+
+    block_test_fill();
+    // Ties in the same lane, across lanes and in the tail.
+    memcpy(block_y_q31, block_x_q31, sizeof(block_y_q31));
+    block_y_q31[0] = block_y_q31[1] = block_y_q31[2] = 0;
+    block_y_q31[701] = block_y_q31[700] = block_y_q31[716] = block_y_q31[2000] = block_y_q31[4101] = INT32_MIN + 5;
+    block_y_q31[1501] = block_y_q31[1500] = block_y_q31[1532] = block_y_q31[4102] = INT32_MAX;
+    for (int i = 0; i < BLOCK_TEST_LENGTH; i++) {
+        block_out_q31[i] = block_x_q31[i] >> 13;
+    }
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        for (int k = 0; k < 6; k++) {
+            uint32_t n = lengths[k];
+            int64_t s31 = 0, s15 = 0, s13 = 0;
+            uint64_t q31 = 0, q15 = 0;
+
+            for (uint32_t i = 0; i < n; i++) {
+                s31 += block_y_q31[i];
+                s13 += block_out_q31[i];
+                s15 += block_x_q15[i];
+                q31 += (uint64_t)(((int64_t)block_x_q31[i] * block_x_q31[i]) >> 31);
+                q15 += (uint64_t)((int32_t)block_x_q15[i] * block_x_q15[i]);
+            }
+            minmax_q31_block(block_y_q31, n, &r);
+            REDUCE_TEST_REF(block_y_q31, n, ref);
+            errors += n && memcmp(&r, &ref, sizeof(r)) != 0;
+            errors += n && min_q31_block(block_y_q31, n, &a) != ref.min;
+            errors += n && a != ref.argmin;
+            errors += n && max_q31_block(block_y_q31, n, &a) != ref.max;
+            errors += n && a != ref.argmax;
+            minmax_q15_block(block_x_q15, n, &r);
+            REDUCE_TEST_REF(block_x_q15, n, ref);
+            errors += n && memcmp(&r, &ref, sizeof(r)) != 0;
+            errors += sum_q31_block(block_y_q31, n) != (q31_t)ssat_i64(s31, 32);
+            errors += sum_q31_block(block_out_q31, n) != (q31_t)s13;
+            errors += sum_q15_block(block_x_q15, n) != (q15_t)ssat_i64(s15, 16);
+            errors += sumsq_q31_block(block_x_q31, n) != q31;
+            errors += sumsq_q15_block(block_x_q15, n) != q15;
+        }
+        minmax_q31_block(block_y_q31, 0, &r);
+        errors += r.min != INT32_MAX || r.max != INT32_MIN || r.argmin != 0 || r.argmax != 0;
+
+        // Planted extremes past the first 65536 vectors of every kernel, and ties.
+        reduce_test_fill(0, 65535);
+        reduce_u16[2097160] = reduce_u16[2097192] = reduce_u16[2097225] = 0;
+        reduce_u16[123] = reduce_u16[187] = reduce_u16[2097200] = 65535;
+        minmax_u16_block(reduce_u16, REDUCE_TEST_LENGTH, &r);
+        errors += r.min != 0 || r.argmin != 2097160 || r.max != 65535 || r.argmax != 123;
+        REDUCE_TEST_REF(reduce_u16, 100U, ref);
+        errors += min_u16_block(reduce_u16, 100, &a) != ref.min || a != ref.argmin;
+        errors += max_u16_block(reduce_u16, 100, &a) != ref.max || a != ref.argmax;
+        minmax_i16_block(s16, REDUCE_TEST_LENGTH, &r);
+        REDUCE_TEST_REF(s16, REDUCE_TEST_LENGTH, ref);
+        errors += memcmp(&r, &ref, sizeof(r)) != 0;
+        errors += max_i16_block(s16, REDUCE_TEST_LENGTH, NULL) != ref.max;
+
+        uint64_t q16 = 0, qu16 = 0;
+        int64_t su16 = 0;
+        for (uint32_t i = 0; i < REDUCE_TEST_LENGTH; i++) {
+            q16 += (uint64_t)((int32_t)s16[i] * s16[i]);
+            qu16 += (uint32_t)reduce_u16[i] * reduce_u16[i];
+        }
+        errors += sumsq_i16_block(s16, REDUCE_TEST_LENGTH) != q16;
+        errors += sumsq_u16_block(reduce_u16, REDUCE_TEST_LENGTH) != qu16;
+        errors += sum_u16_block(reduce_u16, REDUCE_TEST_LENGTH) != UINT16_MAX;
+
+        // Sparse data so the long sums stay in range, the uint16_t zeros are the
+        // far end of the biased signed range.
+        memset(reduce_u16, 0, sizeof(reduce_u16));
+        for (uint32_t i = 0; i < 40; i++) {
+            reduce_u16[(i * 52391U) % REDUCE_TEST_LENGTH] = 1500;
+            su16 += 1500;
+        }
+        errors += sum_u16_block(reduce_u16, REDUCE_TEST_LENGTH) != su16;
+        for (uint32_t i = 0; i < 40; i++) {
+            reduce_u16[(i * 52391U + 7) % REDUCE_TEST_LENGTH] = (uint16_t)-1600;
+        }
+        errors += sum_i16_block(s16, REDUCE_TEST_LENGTH) != -4000;
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
@@ -0,0 +1,508 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include "common.h"
+#include "arm_rt_dsp.h"
+
+#define FIR_TEST_LENGTH 203
+#define FIR_TEST_TAPS 23        // 4K + 3 so it also works as a half-band filter.
+#define FIR_TEST_M 3
+
+FIR_DECIMATE_Q15_DEFINE(test_dec_q15, FIR_TEST_TAPS, FIR_TEST_M);
+FIR_DECIMATE_Q31_DEFINE(test_dec_q31, FIR_TEST_TAPS, FIR_TEST_M);
+FIR_DECIMATE_Q15_DEFINE(test_dec2_q15, FIR_TEST_TAPS, 2);
+FIR_DECIMATE_Q31_DEFINE(test_dec2_q31, FIR_TEST_TAPS, 2);
+FIR_INTERPOLATE_Q15_DEFINE(test_int_q15, FIR_TEST_TAPS, FIR_TEST_M);
+FIR_INTERPOLATE_Q31_DEFINE(test_int_q31, FIR_TEST_TAPS, FIR_TEST_M);
+FIR_INTERPOLATE_Q15_DEFINE(test_int2_q15, FIR_TEST_TAPS, 2);
+FIR_INTERPOLATE_Q31_DEFINE(test_int2_q31, FIR_TEST_TAPS, 2);
+FIR_HALFBAND_Q15_DEFINE(test_hb_q15, FIR_TEST_TAPS);
+FIR_HALFBAND_Q31_DEFINE(test_hb_q31, FIR_TEST_TAPS);
+
+static q15_t fir_h_q15[FIR_TEST_TAPS];
+static q31_t fir_h_q31[FIR_TEST_TAPS];
+static q15_t fir_x_q15[FIR_TEST_LENGTH];
+static q31_t fir_x_q31[FIR_TEST_LENGTH];
+static q15_t fir_out_q15[FIR_TEST_LENGTH * FIR_TEST_M];
+static q31_t fir_out_q31[FIR_TEST_LENGTH * FIR_TEST_M];
+static q15_t fir_ref_q15[FIR_TEST_LENGTH * FIR_TEST_M];
+static q31_t fir_ref_q31[FIR_TEST_LENGTH * FIR_TEST_M];
+
+// Pseudo random half-band taps, the odd taps other than the centre are zero.  The q31_t
+// taps are scaled down by 5 bits so the 2.62 sums don't wrap.
+static void fir_test_fill(void) {
+    uint32_t seed = 4321;
+    for (int k = 0; k < FIR_TEST_TAPS; k++) {
+        seed = seed * 1664525U + 1013904223U;
+        int keep = (k % 2 == 0) || (k == FIR_TEST_TAPS / 2);
+        fir_h_q31[k] = keep ? (q31_t)seed >> 5 : 0;
+        fir_h_q15[k] = keep ? (q15_t)(seed >> 16) : 0;
+    }
+    for (int i = 0; i < FIR_TEST_LENGTH; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        fir_x_q31[i] = (q31_t)seed;
+        fir_x_q15[i] = (q15_t)(seed >> 16);
+    }
+    fir_x_q15[0] = INT16_MIN;
+    fir_x_q15[1] = INT16_MIN;
+    fir_h_q15[0] = INT16_MIN;
+    fir_h_q15[2] = INT16_MIN;
+}
+
+// Direct convolution of the zero stuffed input, keeping every M-th output of the zero
+// stuffed rate, with L = 1 for a decimator and M = 1 for an interpolator.
+static int64_t fir_ref_acc_q15(int n, int L) {
+    int64_t acc = 0;
+    for (int k = 0; k < FIR_TEST_TAPS; k++) {
+        if ((n - k) >= 0 && (n - k) % L == 0) acc += (int32_t)fir_h_q15[k] * fir_x_q15[(n - k) / L];
+    }
+    return acc;
+}
+
+static int64_t fir_ref_acc_q31(int n, int L) {
+    uint64_t acc = 0;
+    for (int k = 0; k < FIR_TEST_TAPS; k++) {
+        if ((n - k) >= 0 && (n - k) % L == 0) acc += (uint64_t)((int64_t)fir_h_q31[k] * fir_x_q31[(n - k) / L]);
+    }
+    return (int64_t)acc;
+}
+
+void test_dot_block(void) {
+    fir_test_fill();
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+        for (uint32_t n = 0; n <= 40; n++) {
+            int64_t ref15 = 0;
+            uint64_t ref31 = 0;
+            for (uint32_t i = 0; i < n; i++) {
+                ref15 += (int32_t)fir_x_q15[i] * fir_x_q15[i + 1];
+                ref31 += (uint64_t)((int64_t)fir_x_q31[i] * fir_x_q31[i + 1]);
+            }
+            errors += dot_q15_block(fir_x_q15, &fir_x_q15[1], n) != ref15;
+            errors += dot_q31_block(fir_x_q31, &fir_x_q31[1], n) != (int64_t)ref31;
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+void test_fir_decimate(void) {
+    fir_test_fill();
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        uint32_t m15, m31;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        fir_decimate_init_q15(&test_dec_q15, fir_h_q15);
+        fir_decimate_init_q31(&test_dec_q31, fir_h_q31);
+
+        // Two calls with lengths that aren't multiples of M.
+        m15 = fir_decimate_q15(&test_dec_q15, fir_x_q15, fir_out_q15, 50);
+        m15 += fir_decimate_q15(&test_dec_q15, &fir_x_q15[50], &fir_out_q15[m15], FIR_TEST_LENGTH - 50);
+        m31 = fir_decimate_q31(&test_dec_q31, fir_x_q31, fir_out_q31, 50);
+        m31 += fir_decimate_q31(&test_dec_q31, &fir_x_q31[50], &fir_out_q31[m31], FIR_TEST_LENGTH - 50);
+        CU_ASSERT_EQUAL(m15, FIR_TEST_LENGTH / FIR_TEST_M);
+        CU_ASSERT_EQUAL(m31, FIR_TEST_LENGTH / FIR_TEST_M);
+
+        for (uint32_t m = 0; m < m31; m++) {
+            int n = (int)((m + 1) * FIR_TEST_M - 1);
+            errors += fir_out_q15[m] != (q15_t)ssat_i64(fir_ref_acc_q15(n, 1) >> 15, 16);
+            errors += fir_out_q31[m] != (q31_t)ssat_i64(fir_ref_acc_q31(n, 1) >> 31, 32);
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+void test_fir_interpolate(void) {
+    fir_test_fill();
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        fir_interpolate_init_q15(&test_int_q15, fir_h_q15);
+        fir_interpolate_init_q31(&test_int_q31, fir_h_q31);
+        fir_interpolate_q15(&test_int_q15, fir_x_q15, fir_out_q15, 50);
+        fir_interpolate_q15(&test_int_q15, &fir_x_q15[50], &fir_out_q15[50 * FIR_TEST_M], FIR_TEST_LENGTH - 50);
+        fir_interpolate_q31(&test_int_q31, fir_x_q31, fir_out_q31, 50);
+        fir_interpolate_q31(&test_int_q31, &fir_x_q31[50], &fir_out_q31[50 * FIR_TEST_M], FIR_TEST_LENGTH - 50);
+
+        for (int n = 0; n < FIR_TEST_LENGTH * FIR_TEST_M; n++) {
+            errors += fir_out_q15[n] != (q15_t)ssat_i64(fir_ref_acc_q15(n, FIR_TEST_M) >> 15, 16);
+            errors += fir_out_q31[n] != (q31_t)ssat_i64(fir_ref_acc_q31(n, FIR_TEST_M) >> 31, 32);
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+void test_fir_halfband(void) {
+    fir_test_fill();
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        int errors = 0;
+        uint32_t m;
+        if (dsp_dispatch_set_isa(isa) != isa) continue;
+
+        // The half-band decimator matches the general one with M = 2, in place.
+        fir_decimate_init_q15(&test_dec2_q15, fir_h_q15);
+        fir_decimate_init_q31(&test_dec2_q31, fir_h_q31);
+        fir_halfband_init_q15(&test_hb_q15, fir_h_q15);
+        fir_halfband_init_q31(&test_hb_q31, fir_h_q31);
+        m = fir_decimate_q15(&test_dec2_q15, fir_x_q15, fir_ref_q15, FIR_TEST_LENGTH);
+        memcpy(fir_out_q15, fir_x_q15, sizeof(fir_x_q15));
+        CU_ASSERT_EQUAL(fir_halfband_decimate_q15(&test_hb_q15, fir_out_q15, fir_out_q15, 51), 25);
+        CU_ASSERT_EQUAL(fir_halfband_decimate_q15(&test_hb_q15, &fir_out_q15[51], &fir_out_q15[25],
+                                                  FIR_TEST_LENGTH - 51), m - 25);
+        errors += memcmp(fir_out_q15, fir_ref_q15, m * sizeof(q15_t)) != 0;
+
+        m = fir_decimate_q31(&test_dec2_q31, fir_x_q31, fir_ref_q31, FIR_TEST_LENGTH);
+        memcpy(fir_out_q31, fir_x_q31, sizeof(fir_x_q31));
+        CU_ASSERT_EQUAL(fir_halfband_decimate_q31(&test_hb_q31, fir_out_q31, fir_out_q31, 51), 25);
+        CU_ASSERT_EQUAL(fir_halfband_decimate_q31(&test_hb_q31, &fir_out_q31[51], &fir_out_q31[25],
+                                                  FIR_TEST_LENGTH - 51), m - 25);
+        errors += memcmp(fir_out_q31, fir_ref_q31, m * sizeof(q31_t)) != 0;
+
+        // The half-band interpolator matches the general one with L = 2.
+        fir_interpolate_init_q15(&test_int2_q15, fir_h_q15);
+        fir_interpolate_init_q31(&test_int2_q31, fir_h_q31);
+        fir_halfband_init_q15(&test_hb_q15, fir_h_q15);
+        fir_halfband_init_q31(&test_hb_q31, fir_h_q31);
+        fir_interpolate_q15(&test_int2_q15, fir_x_q15, fir_ref_q15, FIR_TEST_LENGTH);
+        fir_halfband_interpolate_q15(&test_hb_q15, fir_x_q15, fir_out_q15, FIR_TEST_LENGTH);
+        errors += memcmp(fir_out_q15, fir_ref_q15, 2 * FIR_TEST_LENGTH * sizeof(q15_t)) != 0;
+        fir_interpolate_q31(&test_int2_q31, fir_x_q31, fir_ref_q31, FIR_TEST_LENGTH);
+        fir_halfband_interpolate_q31(&test_hb_q31, fir_x_q31, fir_out_q31, FIR_TEST_LENGTH);
+        errors += memcmp(fir_out_q31, fir_ref_q31, 2 * FIR_TEST_LENGTH * sizeof(q31_t)) != 0;
+
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+#define CIC_TEST_WORDS 40
+
+// Bit at a time reference CIC filter.
+static uint32_t cic_reference(uint32_t order, uint32_t R, int msbFirst, const uint64_t *in,
+                              q31_t *out31, int16_t *out16) {
+    uint64_t integ[CIC_MAX_ORDER] = { 0 };
+    uint64_t comb[CIC_MAX_ORDER] = { 0 };
+    uint64_t gain = 1;
+    uint32_t bits = 0, phase = 0, m = 0;
+
+    for (uint32_t k = 0; k < order; k++) gain *= R;
+    while (((uint64_t)1 << bits) < gain) bits++;
+
+    for (uint32_t i = 0; i < 64 * CIC_TEST_WORDS; i++) {
+        uint32_t b = msbFirst ? 63 - (i % 64) : i % 64;
+        uint64_t acc = (in[i / 64] >> b) & 1U;
+        for (uint32_t k = 0; k < order; k++) {
+            integ[k] += acc;
+            acc = integ[k];
+        }
+        if (++phase == R) {
+            uint64_t y = integ[order - 1];
+            for (uint32_t k = 0; k < order; k++) {
+                uint64_t t = y - comb[k];
+                comb[k] = y;
+                y = t;
+            }
+            int64_t v = 2 * (int64_t)y - (int64_t)gain;
+            int64_t v31 = (bits <= 31) ? v * ((int64_t)1 << (31 - bits)) : v >> (bits - 31);
+            int64_t v16 = (bits <= 15) ? v * ((int64_t)1 << (15 - bits)) : v >> (bits - 15);
+            out31[m] = (q31_t)ssat_i64(v31, 32);
+            out16[m] = (int16_t)ssat_i64(v16, 16);
+            m++;
+            phase = 0;
+        }
+    }
+    return m;
+}
+
+void test_cic_decimate(void) {
+    static const uint16_t rates[] = { 1, 5, 16, 20, 64, 100, 256 };
+    static uint64_t in[CIC_TEST_WORDS];
+    static q31_t out31[64 * CIC_TEST_WORDS], ref31[64 * CIC_TEST_WORDS];
+    static int16_t out16[64 * CIC_TEST_WORDS], ref16[64 * CIC_TEST_WORDS];
+    cic_decimate_instance cic;
+    uint64_t seed = 99;
+    uint32_t nOut = 0;
+    int errors = 0;
+
+    // Biased so the output isn't always near zero.
+    for (int i = 0; i < CIC_TEST_WORDS; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        in[i] = seed | (seed << 7);
+    }
+
+    for (uint16_t order = 1; order <= CIC_MAX_ORDER; order++) {
+        for (uint32_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            for (int msb = 0; msb < 2; msb++) {
+                uint32_t m = cic_reference(order, rates[r], msb, in, ref31, ref16);
+                uint32_t m31, m16;
+
+                cic_decimate_init(&cic, order, rates[r], msb);
+                m31 = cic_decimate_q31(&cic, in, out31, 7);
+                m31 += cic_decimate_q31(&cic, &in[7], &out31[m31], CIC_TEST_WORDS - 7);
+                cic_decimate_init(&cic, order, rates[r], msb);
+                m16 = cic_decimate_i16(&cic, in, out16, CIC_TEST_WORDS);
+
+                errors += (m31 != m) + (m16 != m);
+                errors += memcmp(out31, ref31, m * sizeof(q31_t)) != 0;
+                errors += memcmp(out16, ref16, m * sizeof(int16_t)) != 0;
+            }
+        }
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+
+    // Full scale in, full scale out once the filter has settled.
+    memset(in, 0xFF, sizeof(in));
+    cic_decimate_init(&cic, 3, 64, 0);
+    CU_ASSERT_EQUAL(cic_decimate_q31(&cic, in, out31, 8), 8);
+    CU_ASSERT_EQUAL(out31[7], INT32_MAX);
+    memset(in, 0, sizeof(in));
+    CU_ASSERT_EQUAL(cic_decimate_i16(&cic, in, out16, 8), 8);
+    CU_ASSERT_EQUAL(out16[7], INT16_MIN);
+
+    // Out of range arguments are clamped rather than hanging or reading past integ.
+    cic_decimate_init(&cic, 0, 0, 0);
+    CU_ASSERT_EQUAL(cic.order, 1);
+    CU_ASSERT_EQUAL(cic.R, 1);
+    CU_ASSERT_EQUAL(cic_decimate_i16(&cic, in, out16, 1), 64);
+    CU_ASSERT_EQUAL(out16[63], INT16_MIN);
+    cic_decimate_init(&cic, CIC_MAX_ORDER + 1, 4, 0);
+    CU_ASSERT_EQUAL(cic.order, CIC_MAX_ORDER);
+    CU_ASSERT_EQUAL(cic.gain, 1024);
+    CU_ASSERT_EQUAL(cic.bits, 10);
+
+    // Rates whose R^N would overflow are lowered to keep R^N below 2^62.
+    cic_decimate_init(&cic, 5, 10000, 0);
+    CU_ASSERT_EQUAL(cic.R, 5404);
+    CU_ASSERT_EQUAL(cic.bits, 62);
+    cic_decimate_init(&cic, 4, 65535, 0);
+    CU_ASSERT_EQUAL(cic.R, 46340);
+    CU_ASSERT_EQUAL(cic.gain, 4611307862899360000ULL);
+    CU_ASSERT_EQUAL(cic.bits, 62);
+    cic_decimate_init(&cic, 3, 65535, 0);
+    CU_ASSERT_EQUAL(cic.R, 65535);
+
+    // Full scale still comes out as the top of the range at the largest gain.
+    memset(in, 0xFF, sizeof(in));
+    cic_decimate_init(&cic, 4, 65535, 0);
+    for (int k = 0; k < 100; k++) {
+        nOut += cic_decimate_q31(&cic, in, &out31[nOut], CIC_TEST_WORDS);
+    }
+    CU_ASSERT_EQUAL(nOut, 100 * 64 * CIC_TEST_WORDS / 46340);
+    CU_ASSERT_EQUAL(out31[nOut - 1], (q31_t)(cic.gain >> 31));
+}
+
+
+FILTER_BOXCAR_A63_DEFINE(test_box1, 1);
+FILTER_BOXCAR_A63_DEFINE(test_box7, 7);
+FILTER_BOXCAR_A63_DEFINE(test_box256, 256);
+FILTER_BOXCAR_A63_DEFINE(test_box333, 333);
+FILTER_BOXCAR_A63_DEFINE(test_box65535, 65535);
+
+#define BOXCAR_TEST_N 333
+#define BOXCAR_TEST_LENGTH 1000
+#define BOXCAR_TEST_CH 19
+
+FILTER_BOXCAR_BANK_A63_DEFINE(test_box_bank, BOXCAR_TEST_CH, BOXCAR_TEST_N);
+
+static int64_t boxcar_floor_div(int64_t sum, int64_t N) {
+    int64_t q = sum / N;
+    return (q * N > sum) ? q - 1 : q;
+}
+
+void test_filter_boxcar_div(void) {
+    filter_boxcar_a63_t *box[] = { &test_box1, &test_box7, &test_box256, &test_box333, &test_box65535 };
+    uint32_t seed = 99;
+    int errors = 0;
+
+    for (unsigned b = 0; b < sizeof(box) / sizeof(box[0]); b++) {
+        filter_boxcar_a63_t *f = box[b];
+        int64_t lo = (int64_t)f->N * INT32_MIN;
+        int64_t hi = (int64_t)f->N * INT32_MAX;
+
+        filter_boxcar_init_q31(0, f);
+        for (int64_t d = 0; d < 3000; d++) {
+            int64_t s[4] = { lo + d, hi - d, d - 1500, 0 };
+            seed = seed * 1664525U + 1013904223U;
+            s[3] = (int64_t)(q31_t)seed * f->N + (int64_t)(seed % f->N);
+            for (int k = 0; k < 4; k++) {
+                errors += filter_boxcar_div(s[k], f->magic, f->l, f->N) != boxcar_floor_div(s[k], f->N);
+            }
+        }
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+}
+
+void test_filter_boxcar_q31(void) {
+    static q31_t x[BOXCAR_TEST_CH][BOXCAR_TEST_LENGTH];
+    static q31_t box_state[BOXCAR_TEST_CH][BOXCAR_TEST_N];
+    filter_boxcar_a63_t box[BOXCAR_TEST_CH];
+    q31_t y0[BOXCAR_TEST_CH], io[BOXCAR_TEST_CH];
+    uint32_t seed = 7;
+    int errors = 0;
+
+    for (int i = 0; i < BOXCAR_TEST_CH; i++) {
+        for (int k = 0; k < BOXCAR_TEST_LENGTH; k++) {
+            seed = seed * 1664525U + 1013904223U;
+            x[i][k] = (k < 400) ? (q31_t)seed : (q31_t)((i & 1) ? INT32_MIN : INT32_MAX);
+        }
+        y0[i] = (q31_t)(seed ^ (uint32_t)i);
+        box[i] = (filter_boxcar_a63_t){ 0, BOXCAR_TEST_N, 0, 0, 0, box_state[i] };
+        filter_boxcar_init_q31(y0[i], &box[i]);
+    }
+    filter_boxcar_bank_init_q31(&test_box_bank, y0);
+
+    for (int k = 0; k < BOXCAR_TEST_LENGTH; k++) {
+        for (int i = 0; i < BOXCAR_TEST_CH; i++) {
+            int64_t sum = 0;
+            for (int j = k - BOXCAR_TEST_N + 1; j <= k; j++) {
+                sum += (j < 0) ? y0[i] : x[i][j];
+            }
+            q31_t y = filter_boxcar_q31(x[i][k], &box[i]);
+            errors += y != (q31_t)boxcar_floor_div(sum, BOXCAR_TEST_N);
+            io[i] = x[i][k];
+        }
+        // The bank in place matches the single channel filters.
+        filter_boxcar_bank_q31(&test_box_bank, io, io);
+        for (int i = 0; i < BOXCAR_TEST_CH; i++) {
+            errors += io[i] != (q31_t)boxcar_floor_div(box[i].sum, BOXCAR_TEST_N);
+        }
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+
+    // Zero start, NULL y0.
+    filter_boxcar_bank_init_q31(&test_box_bank, NULL);
+    for (int i = 0; i < BOXCAR_TEST_CH; i++) {
+        io[i] = 1000;
+    }
+    filter_boxcar_bank_q31(&test_box_bank, io, io);
+    CU_ASSERT_EQUAL(io[0], 1000 / BOXCAR_TEST_N);
+}
+
+
+#define RANK_TEST_LENGTH 700
+
+FILTER_MEDIAN_Q31_DEFINE(test_med1, 1);
+FILTER_MEDIAN_Q31_DEFINE(test_med2, 2);
+FILTER_MEDIAN_Q31_DEFINE(test_med3, 3);
+FILTER_MEDIAN_Q31_DEFINE(test_med5, 5);
+FILTER_MEDIAN_Q31_DEFINE(test_med8, 8);
+FILTER_MEDIAN_Q31_DEFINE(test_med33, 33);
+FILTER_MEDIAN_Q31_DEFINE(test_med64, 64);
+FILTER_MINMAX_Q31_DEFINE(test_minmax1, 1);
+FILTER_MINMAX_Q31_DEFINE(test_minmax3, 3);
+FILTER_MINMAX_Q31_DEFINE(test_minmax17, 17);
+FILTER_MINMAX_Q31_DEFINE(test_minmax64, 64);
+
+static int rank_cmp(const void *a, const void *b) {
+    q31_t x = *(const q31_t *)a, y = *(const q31_t *)b;
+    return (x > y) - (x < y);
+}
+
+// The input is random with a few spikes, and drawn from a small range in the second
+// half so there are plenty of equal samples.
+static void rank_test_fill(q31_t *x, int n) {
+    uint32_t seed = 2024;
+    for (int k = 0; k < n; k++) {
+        seed = seed * 1664525U + 1013904223U;
+        x[k] = (k < n / 2) ? (q31_t)seed : (q31_t)(seed >> 29) - 4;
+        if (seed % 41 == 0) {
+            x[k] = (seed & 64) ? INT32_MAX : INT32_MIN;
+        }
+    }
+}
+
+void test_median3_median5(void) {
+    int errors = 0;
+
+    // Every combination of five values from a range of five covers all orders and ties.
+    for (int i = 0; i < 5 * 5 * 5 * 5 * 5; i++) {
+        q31_t v[5], s[5];
+        int r = i;
+        for (int k = 0; k < 5; k++) {
+            v[k] = s[k] = (r % 5 - 2) * 0x20000000;
+            r /= 5;
+        }
+        qsort(s, 5, sizeof(q31_t), rank_cmp);
+        errors += median5_q31(v[0], v[1], v[2], v[3], v[4]) != s[2];
+        errors += median5_q15((q15_t)(v[0] >> 16), (q15_t)(v[1] >> 16), (q15_t)(v[2] >> 16),
+                              (q15_t)(v[3] >> 16), (q15_t)(v[4] >> 16)) != (q15_t)(s[2] >> 16);
+        if (i < 5 * 5 * 5) {
+            // The first three values of the same combinations.
+            memcpy(s, v, 3 * sizeof(q31_t));
+            qsort(s, 3, sizeof(q31_t), rank_cmp);
+            errors += median3_q31(v[0], v[1], v[2]) != s[1];
+            errors += median3_q15((q15_t)(v[0] >> 16), (q15_t)(v[1] >> 16),
+                                  (q15_t)(v[2] >> 16)) != (q15_t)(s[1] >> 16);
+        }
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+}
+
+void test_filter_median_q31(void) {
+    filter_median_instance_q31 *med[] = { &test_med1, &test_med2, &test_med3, &test_med5,
+                                          &test_med8, &test_med33, &test_med64 };
+    static q31_t x[RANK_TEST_LENGTH], y[RANK_TEST_LENGTH];
+    int errors = 0;
+
+    rank_test_fill(x, RANK_TEST_LENGTH);
+    for (unsigned m = 0; m < sizeof(med) / sizeof(med[0]); m++) {
+        const int N = med[m]->N;
+        const q31_t y0 = -12345;
+
+        filter_median_init_q31(y0, med[m]);
+        memcpy(y, x, sizeof(y));
+        filter_median_q31_block(med[m], y, y, 123);
+        filter_median_q31_block(med[m], &y[123], &y[123], RANK_TEST_LENGTH - 123);
+        for (int k = 0; k < RANK_TEST_LENGTH; k++) {
+            q31_t w[FILTER_RANK_MAX_N];
+            for (int j = 0; j < N; j++) {
+                w[j] = (k - j < 0) ? y0 : x[k - j];
+            }
+            qsort(w, (size_t)N, sizeof(q31_t), rank_cmp);
+            q31_t ref = (N & 1) ? w[N / 2] : (q31_t)(((int64_t)w[N / 2 - 1] + w[N / 2]) >> 1);
+            errors += y[k] != ref;
+        }
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+}
+
+void test_filter_minmax_q31(void) {
+    filter_minmax_instance_q31 *f[] = { &test_minmax1, &test_minmax3, &test_minmax17, &test_minmax64 };
+    static q31_t x[RANK_TEST_LENGTH], y[RANK_TEST_LENGTH];
+    int errors = 0;
+
+    rank_test_fill(x, RANK_TEST_LENGTH);
+    for (unsigned m = 0; m < 2 * sizeof(f) / sizeof(f[0]); m++) {
+        filter_minmax_instance_q31 *S = f[m / 2];
+        const int N = S->N;
+        const int isMin = m & 1;
+        const q31_t y0 = 777;
+
+        if (isMin) {
+            filter_min_init_q31(y0, S);
+        } else {
+            filter_max_init_q31(y0, S);
+        }
+        memcpy(y, x, sizeof(y));
+        filter_minmax_q31_block(S, y, y, 55);
+        for (int k = 55; k < RANK_TEST_LENGTH; k++) {
+            y[k] = filter_minmax_q31(x[k], S);
+        }
+        for (int k = 0; k < RANK_TEST_LENGTH; k++) {
+            q31_t ref = (k - N + 1 < 0) ? y0 : x[k - N + 1];
+            for (int j = k - N + 2; j <= k; j++) {
+                q31_t v = (j < 0) ? y0 : x[j];
+                ref = isMin ? min_q31(ref, v) : max_q31(ref, v);
+            }
+            errors += y[k] != ref;
+        }
+    }
+    CU_ASSERT_EQUAL(errors, 0);
+}
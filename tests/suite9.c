@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include "common.h"
+#include "arm_rt_dsp.h"
+
+#define DFT_TEST_CH 21
+#define GOERTZEL_TEST_K 6
+#define GOERTZEL_TEST_L 64
+#define SDFT_TEST_N 60
+#define SDFT_TEST_K 5
+#define SDFT_TEST_FRAMES 250
+
+GOERTZEL_BANK_Q31_DEFINE(test_goertzel, DFT_TEST_CH, GOERTZEL_TEST_K, 14);
+SDFT_BANK_Q31_DEFINE(test_sdft, DFT_TEST_CH, SDFT_TEST_N, SDFT_TEST_K);
+SDFT_BANK_Q31_DEFINE(test_sdft64, 1, GOERTZEL_TEST_L, 1);
+
+static uint32_t dft_test_seed;
+
+static uint32_t dft_test_rand(void) {
+    dft_test_seed = dft_test_seed * 1664525U + 1013904223U;
+    return dft_test_seed;
+}
+
+static double dft_test_abs(double x) {
+    return (x < 0) ? -x : x;
+}
+
+void test_goertzel_bank_q31(void) {
+    static const uint16_t bins[GOERTZEL_TEST_K] = { 0, 1, 3, 5, 31, 32 };
+    static q31_t x[GOERTZEL_TEST_L * DFT_TEST_CH];
+    static q31_t re[GOERTZEL_TEST_K * DFT_TEST_CH], im[GOERTZEL_TEST_K * DFT_TEST_CH];
+    static q31_t ref_re[GOERTZEL_TEST_K * DFT_TEST_CH], ref_im[GOERTZEL_TEST_K * DFT_TEST_CH];
+    uint32_t phase[GOERTZEL_TEST_K];
+    const uint16_t one = 1;
+    double worst = 0;
+
+    dft_test_seed = 5;
+    for (int i = 0; i < GOERTZEL_TEST_L * DFT_TEST_CH; i++) {
+        x[i] = (q31_t)dft_test_rand() >> 1;
+    }
+    for (int k = 0; k < GOERTZEL_TEST_K; k++) {
+        phase[k] = (uint32_t)bins[k] << 26;
+    }
+    // The twiddles of a 64 point DFT give the reference.
+    sdft_bank_init_q31(&test_sdft64, &one);
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        if (dsp_dispatch_set_isa(isa) != isa) {
+            continue;
+        }
+        int errors = 0;
+        goertzel_bank_init_q31(&test_goertzel, phase);
+        goertzel_bank_q31(&test_goertzel, x, 17);
+        goertzel_bank_q31(&test_goertzel, &x[17 * DFT_TEST_CH], GOERTZEL_TEST_L - 17);
+        goertzel_bank_result_q31(&test_goertzel, re, im);
+        if (isa == DSP_ISA_SCALAR) {
+            memcpy(ref_re, re, sizeof(re));
+            memcpy(ref_im, im, sizeof(im));
+        }
+        errors += memcmp(re, ref_re, sizeof(re)) != 0;
+        errors += memcmp(im, ref_im, sizeof(im)) != 0;
+        for (int i = 0; i < GOERTZEL_TEST_K * DFT_TEST_CH; i++) {
+            errors += test_goertzel.pS1[i] != 0 || test_goertzel.pS2[i] != 0;
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+
+    // Against the DFT sum with the phase taken at the last sample.
+    for (int k = 0; k < GOERTZEL_TEST_K; k++) {
+        for (int m = 0; m < DFT_TEST_CH; m++) {
+            double a = 0, b = 0;
+            for (int n = 0; n < GOERTZEL_TEST_L; n++) {
+                int p = (bins[k] * (GOERTZEL_TEST_L - 1 - n)) % GOERTZEL_TEST_L;
+                double xs = (double)(x[n * DFT_TEST_CH + m] >> 14);
+                a += xs * test_sdft64.pCos[p] / 1073741824.0;
+                b += xs * test_sdft64.pSin[p] / 1073741824.0;
+            }
+            int i = k * DFT_TEST_CH + m;
+            double e = dft_test_abs(re[i] - a) + dft_test_abs(im[i] - b);
+            worst = (e > worst) ? e : worst;
+        }
+    }
+    CU_ASSERT(worst < 4096.0);
+}
+
+void test_sdft_bank_q31(void) {
+    static const uint16_t bins[SDFT_TEST_K] = { 0, 1, 7, 30, 59 };
+    static const uint32_t chunks[] = { 1, 13, 97, 139 };
+    static q31_t x[SDFT_TEST_FRAMES * DFT_TEST_CH];
+    static acc64_t ref_re[SDFT_TEST_K * DFT_TEST_CH], ref_im[SDFT_TEST_K * DFT_TEST_CH];
+    static q31_t re[SDFT_TEST_K * DFT_TEST_CH], im[SDFT_TEST_K * DFT_TEST_CH];
+    static q31_t zero[SDFT_TEST_N * DFT_TEST_CH];
+
+    dft_test_seed = 77;
+    for (int i = 0; i < SDFT_TEST_FRAMES * DFT_TEST_CH; i++) {
+        x[i] = (q31_t)dft_test_rand();
+        if (i % 97 == 0) {
+            x[i] = INT32_MIN;
+        }
+    }
+
+    for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+        if (dsp_dispatch_set_isa(isa) != isa) {
+            continue;
+        }
+        int errors = 0;
+        const q31_t *px = x;
+        sdft_bank_init_q31(&test_sdft, bins);
+        for (unsigned c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+            sdft_bank_q31(&test_sdft, px, chunks[c]);
+            px += chunks[c] * DFT_TEST_CH;
+        }
+        // The twiddles are on the unit circle, with cos(60 deg) = 1 / 2 and cos(90 deg) = 0.
+        for (int n = 0; n < SDFT_TEST_N; n++) {
+            double c = test_sdft.pCos[n] / 1073741824.0, s = test_sdft.pSin[n] / 1073741824.0;
+            errors += dft_test_abs(c * c + s * s - 1.0) > 4e-9;
+        }
+        errors += dft_test_abs(test_sdft.pCos[SDFT_TEST_N / 6] - 536870912.0) > 1.0;
+        errors += dft_test_abs(test_sdft.pCos[SDFT_TEST_N / 4]) > 1.0;
+        if (isa == DSP_ISA_SCALAR) {
+            memcpy(ref_re, test_sdft.pRe, sizeof(ref_re));
+            memcpy(ref_im, test_sdft.pIm, sizeof(ref_im));
+        }
+        errors += memcmp(test_sdft.pRe, ref_re, sizeof(ref_re)) != 0;
+        errors += memcmp(test_sdft.pIm, ref_im, sizeof(ref_im)) != 0;
+
+        // Against the DFT of the last N frames, divided by N.
+        sdft_bank_result_q31(&test_sdft, re, im);
+        for (int k = 0; k < SDFT_TEST_K; k++) {
+            for (int m = 0; m < DFT_TEST_CH; m++) {
+                double a = 0, b = 0;
+                for (int n = 0; n < SDFT_TEST_N; n++) {
+                    int p = (bins[k] * n) % SDFT_TEST_N;
+                    double v = x[(SDFT_TEST_FRAMES - SDFT_TEST_N + n) * DFT_TEST_CH + m];
+                    a += v * test_sdft.pCos[p] / 1073741824.0;
+                    b -= v * test_sdft.pSin[p] / 1073741824.0;
+                }
+                int i = k * DFT_TEST_CH + m;
+                errors += dft_test_abs(re[i] - a / SDFT_TEST_N) > 4.0;
+                errors += dft_test_abs(im[i] - b / SDFT_TEST_N) > 4.0;
+            }
+        }
+
+        // A window of zeros takes every sum back to exactly zero.
+        sdft_bank_q31(&test_sdft, zero, SDFT_TEST_N);
+        for (int i = 0; i < SDFT_TEST_K * DFT_TEST_CH; i++) {
+            errors += test_sdft.pRe[i] != 0 || test_sdft.pIm[i] != 0;
+        }
+        CU_ASSERT_EQUAL(errors, 0);
+    }
+    dsp_dispatch_init();
+}
+
+
+#define RMS_TEST_CH 13
+#define RMS_TEST_FRAMES 900
+
+RMS_BANK_Q31_DEFINE(test_rms_zc, RMS_TEST_CH, 20, 400, 1);
+RMS_BANK_Q31_DEFINE(test_rms_fixed, RMS_TEST_CH, 0, 64, 0);
+
+void test_sqrt_q31(void) {
+    int errors = 0;
+
+    dft_test_seed = 11;
+    for (int i = 0; i < 20000; i++) {
+        uint64_t x = ((uint64_t)dft_test_rand() << 32 | dft_test_rand()) >> (i % 64);
+        uint64_t r = sqrt_u64(x);
+        errors += r * r > x || (r + 1) * (r + 1) <= x;
+    }
+    errors += sqrt_u64(UINT64_MAX) != UINT32_MAX;
+    errors += sqrt_u64(0) != 0 || sqrt_u64(1) != 1 || sqrt_u64(3) != 1 || sqrt_u64(4) != 2;
+    errors += sqrt_q31(0x20000000) != 0x40000000;   // sqrt(0.25) = 0.5
+    errors += sqrt_q31(-5) != 0;
+    errors += sqrt_q31(INT32_MAX) != 0x7FFFFFFF;
+    CU_ASSERT_EQUAL(errors, 0);
+}
+
+// Straight from the definition, one channel at a time.
+static void rms_reference_close(const q31_t *x, uint32_t M, uint32_t j, uint32_t start, uint32_t end,
+                                uint32_t *seq, q31_t *rms, q31_t *mean, q31_t *peak, uint32_t *len) {
+    int64_t sq = 0, sum = 0;
+    uint32_t mx = 0;
+    uint32_t n = end - start;
+    for (uint32_t k = start; k < end; k++) {
+        q31_t v = x[k * M + j];
+        uint32_t a = (v < 0) ? 0U - (uint32_t)v : (uint32_t)v;
+        sq += ((int64_t)v * v) >> RMS_BANK_SQ_SHIFT;
+        sum += v;
+        mx = (a > mx) ? a : mx;
+    }
+    uint32_t r = sqrt_u64((uint64_t)(sq / n) << RMS_BANK_SQ_SHIFT);
+    *rms = (q31_t)((r > INT32_MAX) ? INT32_MAX : r);
+    *mean = (q31_t)(sum / (int64_t)n);
+    *peak = (q31_t)((mx > INT32_MAX) ? INT32_MAX : mx);
+    *len = n;
+    (*seq)++;
+}
+
+static void rms_reference(const rms_bank_instance_q31 *S, const q31_t *x, uint32_t j,
+                          uint32_t *seq, q31_t *rms, q31_t *mean, q31_t *peak, uint32_t *len) {
+    uint32_t start = 0;
+    *seq = 0;
+    for (uint32_t t = 0; t < RMS_TEST_FRAMES; t++) {
+        if (S->zeroCross && t > start && t - start >= S->minLen &&
+            x[(t - 1) * S->M + j] < 0 && x[t * S->M + j] >= 0) {
+            rms_reference_close(x, S->M, j, start, t, seq, rms, mean, peak, len);
+            start = t;
+        }
+        if (t + 1 - start >= S->maxLen) {
+            rms_reference_close(x, S->M, j, start, t + 1, seq, rms, mean, peak, len);
+            start = t + 1;
+        }
+    }
+}
+
+void test_rms_bank_q31(void) {
+    static q31_t x[RMS_TEST_FRAMES * RMS_TEST_CH];
+    rms_bank_instance_q31 *banks[] = { &test_rms_zc, &test_rms_fixed };
+
+    // A slow square-ish wave with noise on top, a different period on each channel, and
+    // full scale negative samples now and then.
+    dft_test_seed = 3;
+    for (int t = 0; t < RMS_TEST_FRAMES; t++) {
+        for (int j = 0; j < RMS_TEST_CH; j++) {
+            int period = 50 + 7 * j;
+            q31_t base = ((t % period) < period / 2) ? 0x30000000 : -0x30000000;
+            q31_t v = base + ((q31_t)dft_test_rand() >> 4);
+            x[t * RMS_TEST_CH + j] = (dft_test_rand() % 101 == 0) ? INT32_MIN : v;
+        }
+    }
+
+    for (unsigned b = 0; b < 2; b++) {
+        rms_bank_instance_q31 *S = banks[b];
+        for (dsp_isa_t isa = DSP_ISA_SCALAR; isa < DSP_ISA_COUNT; isa++) {
+            if (dsp_dispatch_set_isa(isa) != isa) {
+                continue;
+            }
+            int errors = 0;
+            uint32_t total = 0, seqs = 0;
+            rms_bank_init_q31(S);
+            total += rms_bank_q31(S, x, 333);
+            total += rms_bank_q31(S, &x[333 * RMS_TEST_CH], RMS_TEST_FRAMES - 333);
+            for (uint32_t j = 0; j < RMS_TEST_CH; j++) {
+                uint32_t seq = 0, len = 0;
+                q31_t rms = 0, mean = 0, peak = 0;
+                rms_reference(S, x, j, &seq, &rms, &mean, &peak, &len);
+                errors += S->pSeq[j] != seq || S->pRms[j] != rms || S->pMean[j] != mean;
+                errors += S->pPeak[j] != peak || S->pLen[j] != len;
+                seqs += S->pSeq[j];
+            }
+            errors += total != seqs;
+            errors += seqs < RMS_TEST_CH * 5;
+            CU_ASSERT_EQUAL(errors, 0);
+        }
+    }
+    dsp_dispatch_init();
+
+    // A +-A square wave over whole windows has an RMS and peak of A and a mean of 0.
+    for (int t = 0; t < 128; t++) {
+        for (int j = 0; j < RMS_TEST_CH; j++) {
+            x[t * RMS_TEST_CH + j] = ((t / 4) & 1) ? -0x40000000 : 0x40000000;
+        }
+    }
+    rms_bank_init_q31(&test_rms_fixed);
+    CU_ASSERT_EQUAL(rms_bank_q31(&test_rms_fixed, x, 128), 2 * RMS_TEST_CH);
+    CU_ASSERT_EQUAL(test_rms_fixed.pRms[5], 0x40000000);
+    CU_ASSERT_EQUAL(test_rms_fixed.pPeak[5], 0x40000000);
+    CU_ASSERT_EQUAL(test_rms_fixed.pMean[5], 0);
+}
@@ -16,12 +16,20 @@ void test_mul_q15();
 void test_mul_q31();
 void test_mulsat_q15();
 void test_mulsat_q31();
+void test_qadd_qsub();
+void test_qadd16_qsub16();
+void test_q_flag();
+void test_q15x2_arith();
 void test_min_q31();
 void test_max_q31();
 void test_adc_process_sample_q15();
 void test_adc_process_sample_q31();
 void test_adc_process_sample_u_q31();
 void test_adc_process_sample_i16_q31();
+void test_adc_process_block();
+void test_adc_conversion_widths();
+void test_convert_recip();
+void test_convert_q31_block();
 void test_limit_f32();
 void test_upper_limit_q31();
 void test_lower_limit_q31();
@@ -46,11 +54,50 @@ void test_ramp_init_q31();
 void test_ramp_q31();
 void test_check_delta_q31();
 void test_check_delta_f32();
+void test_ramp_limit_q15x2(void);
+void test_ramp_block(void);
+void test_ramp_scurve_q31(void);
+void test_ramp_limit_bank_q15(void);
+void test_ramp_limit_bank_stuck_q15(void);
+void test_hysteresis_bank(void);
 
 void test_sequence_limit_i16(void);
 
 void test_sequence_iir_pi_q15(void);
 void test_sequence_iir_pi_q31(void);
+void test_iir_pi_q15x2(void);
+
+void test_mul_q15_block();
+void test_mul_q31_block();
+void test_abs_sat_block();
+void test_q_flag_block();
+void test_dispatch_set_isa();
+void test_limit_block();
+void test_reduce_block();
+
+void test_iir_pi_bank_q31(void);
+void test_iir_pi_bank_q15(void);
+void test_controller_run(void);
+void test_filter_pma_bank_q31(void);
+void test_filter_pma_precharge_q31(void);
+void test_filter_biquad_q31(void);
+void test_filter_biquad_bank_q31(void);
+void test_iir_pr_multi_q31(void);
+void test_iir_notch_q31(void);
+void test_dot_block(void);
+void test_fir_decimate(void);
+void test_fir_interpolate(void);
+void test_fir_halfband(void);
+void test_cic_decimate(void);
+void test_filter_boxcar_div(void);
+void test_filter_boxcar_q31(void);
+void test_median3_median5(void);
+void test_filter_median_q31(void);
+void test_filter_minmax_q31(void);
+void test_goertzel_bank_q31(void);
+void test_sdft_bank_q31(void);
+void test_sqrt_q31(void);
+void test_rms_bank_q31(void);
 
 
 // Test functions for each suite
@@ -63,6 +110,10 @@ Test suite1_tests[] = {
     {"test_mul_q31", test_mul_q31},
     {"test_mulsat_q15", test_mulsat_q15},
     {"test_mulsat_q31", test_mulsat_q31},
+    {"test_qadd_qsub", test_qadd_qsub},
+    {"test_qadd16_qsub16", test_qadd16_qsub16},
+    {"test_q_flag", test_q_flag},
+    {"test_q15x2_arith", test_q15x2_arith},
     {"test_min_q31", test_min_q31},
     {"test_max_q31", test_max_q31},
     {"test_limit_f32", test_limit_f32},
@@ -92,6 +143,12 @@ Test suite2_tests[] = {
     {"test_ramp_q31", test_ramp_q31},
     {"test_check_delta_q31", test_check_delta_q31},
     {"test_check_delta_i32", test_check_delta_f32},
+    {"test_ramp_limit_q15x2", test_ramp_limit_q15x2},
+    {"test_ramp_block", test_ramp_block},
+    {"test_ramp_scurve_q31", test_ramp_scurve_q31},
+    {"test_ramp_limit_bank_q15", test_ramp_limit_bank_q15},
+    {"test_ramp_limit_bank_stuck_q15", test_ramp_limit_bank_stuck_q15},
+    {"test_hysteresis_bank", test_hysteresis_bank},
     // Add more tests here as needed
 };
   
@@ -100,6 +157,10 @@ Test suite3_tests[] = {
     {"test_adc_process_sample_q31", test_adc_process_sample_q31},
     {"test_adc_process_sample_u_q31", test_adc_process_sample_u_q31},
     {"test_adc_process_sample_i16_q31", test_adc_process_sample_i16_q31},
+    {"test_adc_process_block", test_adc_process_block},
+    {"test_adc_conversion_widths", test_adc_conversion_widths},
+    {"test_convert_recip", test_convert_recip},
+    {"test_convert_q31_block", test_convert_q31_block},
     // Add more tests here as needed
 };
 
@@ -110,6 +171,49 @@ Test suite4_tests[] = {
 Test suite5_tests[] = {
     {"test_sequence_iir_pi_q15", test_sequence_iir_pi_q15},
     {"test_sequence_iir_pi_q31", test_sequence_iir_pi_q31},
+    {"test_iir_pi_q15x2", test_iir_pi_q15x2},
+};
+
+Test suite6_tests[] = {
+    {"test_mul_q15_block", test_mul_q15_block},
+    {"test_mul_q31_block", test_mul_q31_block},
+    {"test_abs_sat_block", test_abs_sat_block},
+    {"test_q_flag_block", test_q_flag_block},
+    {"test_dispatch_set_isa", test_dispatch_set_isa},
+    {"test_limit_block", test_limit_block},
+    {"test_reduce_block", test_reduce_block},
+};
+
+Test suite7_tests[] = {
+    {"test_iir_pi_bank_q31", test_iir_pi_bank_q31},
+    {"test_iir_pi_bank_q15", test_iir_pi_bank_q15},
+    {"test_controller_run", test_controller_run},
+    {"test_filter_pma_bank_q31", test_filter_pma_bank_q31},
+    {"test_filter_pma_precharge_q31", test_filter_pma_precharge_q31},
+    {"test_filter_biquad_q31", test_filter_biquad_q31},
+    {"test_filter_biquad_bank_q31", test_filter_biquad_bank_q31},
+    {"test_iir_pr_multi_q31", test_iir_pr_multi_q31},
+    {"test_iir_notch_q31", test_iir_notch_q31},
+};
+
+Test suite8_tests[] = {
+    {"test_dot_block", test_dot_block},
+    {"test_fir_decimate", test_fir_decimate},
+    {"test_fir_interpolate", test_fir_interpolate},
+    {"test_fir_halfband", test_fir_halfband},
+    {"test_cic_decimate", test_cic_decimate},
+    {"test_filter_boxcar_div", test_filter_boxcar_div},
+    {"test_filter_boxcar_q31", test_filter_boxcar_q31},
+    {"test_median3_median5", test_median3_median5},
+    {"test_filter_median_q31", test_filter_median_q31},
+    {"test_filter_minmax_q31", test_filter_minmax_q31},
+};
+
+Test suite9_tests[] = {
+    {"test_goertzel_bank_q31", test_goertzel_bank_q31},
+    {"test_sdft_bank_q31", test_sdft_bank_q31},
+    {"test_sqrt_q31", test_sqrt_q31},
+    {"test_rms_bank_q31", test_rms_bank_q31},
 };
 
 // Suites
@@ -119,6 +223,10 @@ Suite suites[] = {
     {"Suite_3", suite3_tests, sizeof(suite3_tests) / sizeof(Test)},
     {"Suite_4", suite4_tests, sizeof(suite4_tests) / sizeof(Test)},
     {"Suite_5", suite5_tests, sizeof(suite5_tests) / sizeof(Test)},
+    {"Suite_6", suite6_tests, sizeof(suite6_tests) / sizeof(Test)},
+    {"Suite_7", suite7_tests, sizeof(suite7_tests) / sizeof(Test)},
+    {"Suite_8", suite8_tests, sizeof(suite8_tests) / sizeof(Test)},
+    {"Suite_9", suite9_tests, sizeof(suite9_tests) / sizeof(Test)},
     // Add more suites here as needed
 };
 